@@ -24,6 +24,7 @@
 
 #define GLM_FORCE_RADIANS
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -49,16 +50,16 @@
 #include "common.h"
 #include "3d_cache.h"
 #include "3d_info.h"
+#include "3d_mesh_cache.h"
 #include "sg/scenegraph.h"
 #include "filename_resolver.h"
 #include "3d_plugin_manager.h"
 #include "plugins/3dapi/ifsg_api.h"
+#include <thread_pool.h>
 
 
 #define MASK_3D_CACHE "3D_CACHE"
 
-static wxCriticalSection lock3D_cache;
-
 
 static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 {
@@ -70,14 +71,23 @@ static bool isSHA1Same( const unsigned char* shaA, const unsigned char* shaB )
 }
 
 
-static bool checkTag( const char* aTag, void* aPluginMgrPtr )
+// the plugin tag of a cache file being read
+struct CACHE_TAG
+{
+    S3D_PLUGIN_MANAGER* plugins;
+    std::string         tag;
+};
+
+
+static bool checkTag( const char* aTag, void* aCacheTagPtr )
 {
-    if( NULL == aTag || NULL == aPluginMgrPtr )
+    if( NULL == aTag || NULL == aCacheTagPtr )
         return false;
 
-    S3D_PLUGIN_MANAGER *pp = (S3D_PLUGIN_MANAGER*) aPluginMgrPtr;
+    CACHE_TAG* ct = (CACHE_TAG*) aCacheTagPtr;
+    ct->tag = aTag;
 
-    return pp->CheckTag( aTag );
+    return ct->plugins->CheckTag( aTag );
 }
 
 
@@ -131,29 +141,55 @@ public:
     void SetSHA1( const unsigned char* aSHA1Sum );
     const wxString GetCacheBaseName( void );
 
+    // frees the scene and render data, so they are loaded again
+    void ClearData();
+
     wxDateTime    modTime;      // file modification time
     unsigned char sha1sum[20];
+    bool          hasSHA1;      // false if the file could not be hashed
     std::string   pluginInfo;   // PluginName:Version string
     SCENEGRAPH*   sceneData;
-    S3DMODEL*     renderData;
+    bool          sceneLoaded;  // true once loading sceneData was attempted
+    S3DMODEL*     renderData;   // owned, unless it is the model of meshFile
+    bool          meshLoaded;   // true once reading meshFile was attempted
+    std::unique_ptr<S3D_MESH_CACHE_FILE> meshFile;
+    std::mutex    mutex;        // held while the entry is loaded, reloaded or converted
 };
 
 
 S3D_CACHE_ENTRY::S3D_CACHE_ENTRY()
 {
+    hasSHA1 = false;
     sceneData = NULL;
+    sceneLoaded = false;
     renderData = NULL;
+    meshLoaded = false;
     memset( sha1sum, 0, 20 );
 }
 
 
 S3D_CACHE_ENTRY::~S3D_CACHE_ENTRY()
+{
+    ClearData();
+}
+
+
+void S3D_CACHE_ENTRY::ClearData()
 {
     if( NULL != sceneData )
-        delete sceneData;
+    {
+        S3D::DestroyNode( sceneData );
+        sceneData = NULL;
+    }
 
-    if( NULL != renderData )
+    if( meshFile )
+        renderData = NULL;
+    else if( NULL != renderData )
         S3D::Destroy3DModel( &renderData );
+
+    meshFile.reset();
+    sceneLoaded = false;
+    meshLoaded = false;
 }
 
 
@@ -168,6 +204,8 @@ void S3D_CACHE_ENTRY::SetSHA1( const unsigned char* aSHA1Sum )
     }
 
     memcpy( sha1sum, aSHA1Sum, 20 );
+    hasSHA1 = true;
+    m_CacheBaseName.clear();
     return;
 }
 
@@ -205,14 +243,13 @@ S3D_CACHE::~S3D_CACHE()
 }
 
 
-SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
+S3D_CACHE_ENTRY* S3D_CACHE::getEntry( const wxString& aModelFile,
+                                      std::unique_lock<std::mutex>& aEntryLock,
+                                      wxString& aFullPath )
 {
-    if( aCachePtr )
-        *aCachePtr = NULL;
+    aFullPath = m_FNResolver->ResolvePath( aModelFile );
 
-    wxString full3Dpath = m_FNResolver->ResolvePath( aModelFile );
-
-    if( full3Dpath.empty() )
+    if( aFullPath.empty() )
     {
         // the model cannot be found; we cannot proceed
         wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [3D model] could not find model '%s'\n",
@@ -220,134 +257,134 @@ SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCach
         return NULL;
     }
 
-    // check cache if file is already loaded
-    wxCriticalSectionLocker lock( lock3D_cache );
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
+    S3D_CACHE_ENTRY* ep = NULL;
 
-    if( mi != m_CacheMap.end() )
     {
-        wxFileName fname( full3Dpath );
+        // check cache if file is already loaded
+        std::lock_guard<std::mutex> lock( m_mutex );
+        std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
+        mi = m_CacheMap.find( aFullPath );
 
-        if( fname.FileExists() )    // Only check if file exists. If not, it will
-        {                           // use the same model in cache.
-            bool reload = false;
-            wxDateTime fmdate = fname.GetModificationTime();
+        if( mi != m_CacheMap.end() )
+        {
+            ep = mi->second;
+        }
+        else
+        {
+            // a cache item does not exist; it is created locked, so other threads
+            // asking for the same file wait until it is set up
+            ep = new S3D_CACHE_ENTRY;
+            m_CacheList.push_back( ep );
+            m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >( aFullPath, ep ) );
+            aEntryLock = std::unique_lock<std::mutex>( ep->mutex );
+        }
+    }
 
-            if( fmdate != mi->second->modTime )
-            {
-                unsigned char hashSum[20];
-                getSHA1( full3Dpath, hashSum );
-                mi->second->modTime = fmdate;
-
-                if( !isSHA1Same( hashSum, mi->second->sha1sum ) )
-                {
-                    mi->second->SetSHA1( hashSum );
-                    reload = true;
-                }
-            }
+    if( aEntryLock.owns_lock() )
+    {
+        wxFileName fname( aFullPath );
+        ep->modTime = fname.GetModificationTime();
 
-            if( reload )
-            {
-                if( NULL != mi->second->sceneData )
-                {
-                    S3D::DestroyNode( mi->second->sceneData );
-                    mi->second->sceneData = NULL;
-                }
+        unsigned char sha1sum[20];
 
-                if( NULL != mi->second->renderData )
-                    S3D::Destroy3DModel( &mi->second->renderData );
+        // just in case we can't get a hash digest (for example, on access issues)
+        // the entry stays empty to prevent further attempts at loading the file
+        if( getSHA1( aFullPath, sha1sum ) )
+            ep->SetSHA1( sha1sum );
 
-                mi->second->sceneData = m_Plugins->Load3DModel( full3Dpath, mi->second->pluginInfo );
-            }
-        }
+        return ep;
+    }
 
-        if( NULL != aCachePtr )
-            *aCachePtr = mi->second;
+    aEntryLock = std::unique_lock<std::mutex>( ep->mutex );
+    wxFileName fname( aFullPath );
 
-        return mi->second->sceneData;
-    }
+    if( fname.FileExists() )    // Only check if file exists. If not, it will
+    {                           // use the same model in cache.
+        wxDateTime fmdate = fname.GetModificationTime();
 
-    // a cache item does not exist; search the Filename->Cachename map
-    return checkCache( full3Dpath, aCachePtr );
-}
+        if( fmdate != ep->modTime )
+        {
+            unsigned char hashSum[20];
+            getSHA1( aFullPath, hashSum );
+            ep->modTime = fmdate;
 
+            if( !isSHA1Same( hashSum, ep->sha1sum ) )
+            {
+                ep->SetSHA1( hashSum );
+                ep->ClearData();
+            }
+        }
+    }
 
-SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
-{
-    return load( aModelFile );
+    return ep;
 }
 
 
-SCENEGRAPH* S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr )
+SCENEGRAPH* S3D_CACHE::load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr )
 {
     if( aCachePtr )
         *aCachePtr = NULL;
 
-    unsigned char sha1sum[20];
+    std::unique_lock<std::mutex> entryLock;
+    wxString full3Dpath;
+    S3D_CACHE_ENTRY* ep = getEntry( aModelFile, entryLock, full3Dpath );
 
-    if( !getSHA1( aFileName, sha1sum ) || m_CacheDir.empty() )
-    {
-        // just in case we can't get a hash digest (for example, on access issues)
-        // or we do not have a configured cache file directory, we create an
-        // entry to prevent further attempts at loading the file
-        S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-        m_CacheList.push_back( ep );
-        wxFileName fname( aFileName );
-        ep->modTime = fname.GetModificationTime();
+    if( NULL == ep )
+        return NULL;
 
-        if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-            ( aFileName, ep ) ).second == false )
-        {
-            wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                        __FILE__, __FUNCTION__, __LINE__, aFileName );
+    checkCache( full3Dpath, ep );
 
-            m_CacheList.pop_back();
-            delete ep;
-        }
-        else
-        {
-            if( aCachePtr )
-                *aCachePtr = ep;
+    if( NULL != aCachePtr )
+        *aCachePtr = ep;
 
-        }
+    return ep->sceneData;
+}
 
-        return NULL;
-    }
 
-    S3D_CACHE_ENTRY* ep = new S3D_CACHE_ENTRY;
-    m_CacheList.push_back( ep );
-    wxFileName fname( aFileName );
-    ep->modTime = fname.GetModificationTime();
+SCENEGRAPH* S3D_CACHE::Load( const wxString& aModelFile )
+{
+    return load( aModelFile );
+}
 
-    if( m_CacheMap.insert( std::pair< wxString, S3D_CACHE_ENTRY* >
-                               ( aFileName, ep ) ).second == false )
-    {
-        wxLogTrace( MASK_3D_CACHE, "%s:%s:%d\n * [BUG] duplicate entry in map file; key = '%s'",
-                    __FILE__, __FUNCTION__, __LINE__, aFileName );
 
-        m_CacheList.pop_back();
-        delete ep;
-        return NULL;
-    }
+void S3D_CACHE::LoadModels( const std::vector<wxString>& aModelFiles )
+{
+    std::vector<wxString> files( aModelFiles );
 
-    if( aCachePtr )
-        *aCachePtr = ep;
+    // different names resolving to the same file wait for each other on the entry lock
+    std::sort( files.begin(), files.end() );
+    files.erase( std::unique( files.begin(), files.end() ), files.end() );
+    files.erase( std::remove( files.begin(), files.end(), wxEmptyString ), files.end() );
 
-    ep->SetSHA1( sha1sum );
+    THREAD_POOL::GetPool().ParallelFor( files.size(),
+            [&]( size_t i )
+            {
+                GetModel( files[i] );
+            } );
+}
 
-    wxString bname = ep->GetCacheBaseName();
-    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
 
-    if( wxFileName::FileExists( cachename ) && loadCacheData( ep ) )
-        return ep->sceneData;
+void S3D_CACHE::checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem )
+{
+    if( aCacheItem->sceneLoaded )
+        return;
 
-    ep->sceneData = m_Plugins->Load3DModel( aFileName, ep->pluginInfo );
+    aCacheItem->sceneLoaded = true;
 
-    if( NULL != ep->sceneData )
-        saveCacheData( ep );
+    // we do not load files we cannot hash or without a configured cache file directory
+    if( !aCacheItem->hasSHA1 || m_CacheDir.empty() )
+        return;
 
-    return ep->sceneData;
+    wxString bname = aCacheItem->GetCacheBaseName();
+    wxString cachename = m_CacheDir + bname + wxT( ".3dc" );
+
+    if( wxFileName::FileExists( cachename ) && loadCacheData( aCacheItem ) )
+        return;
+
+    aCacheItem->sceneData = m_Plugins->Load3DModel( aFileName, aCacheItem->pluginInfo );
+
+    if( NULL != aCacheItem->sceneData )
+        saveCacheData( aCacheItem );
 }
 
 
@@ -439,15 +476,57 @@ bool S3D_CACHE::loadCacheData( S3D_CACHE_ENTRY* aCacheItem )
     if( NULL != aCacheItem->sceneData )
         S3D::DestroyNode( (SGNODE*) aCacheItem->sceneData );
 
-    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), m_Plugins, checkTag );
+    CACHE_TAG cacheTag = { m_Plugins, std::string() };
+
+    aCacheItem->sceneData = (SCENEGRAPH*)S3D::ReadCache( fname.ToUTF8(), &cacheTag, checkTag );
 
     if( NULL == aCacheItem->sceneData )
         return false;
 
+    aCacheItem->pluginInfo = cacheTag.tag;
+    return true;
+}
+
+
+bool S3D_CACHE::loadMeshData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    aCacheItem->meshLoaded = true;
+
+    if( !aCacheItem->hasSHA1 || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+    std::string pluginInfo;
+
+    std::unique_ptr<S3D_MESH_CACHE_FILE> file = S3D_MESH_CACHE_FILE::Read( fname, pluginInfo );
+
+    // a mesh file made by another version of the plugin is rewritten
+    if( !file || !m_Plugins->CheckTag( pluginInfo.c_str() ) )
+        return false;
+
+    aCacheItem->meshFile = std::move( file );
+    aCacheItem->pluginInfo = pluginInfo;
+    aCacheItem->renderData = const_cast<S3DMODEL*>( aCacheItem->meshFile->GetModel() );
+
     return true;
 }
 
 
+bool S3D_CACHE::saveMeshData( S3D_CACHE_ENTRY* aCacheItem )
+{
+    // without the plugin tag the file could never be used
+    if( NULL == aCacheItem->renderData || aCacheItem->pluginInfo.empty()
+            || !aCacheItem->hasSHA1 || m_CacheDir.empty() )
+        return false;
+
+    wxString fname = m_CacheDir + aCacheItem->GetCacheBaseName() + wxT( ".3dm" );
+
+    std::lock_guard<std::mutex> lock( m_cacheFileMutex );
+
+    return S3D_MESH_CACHE_FILE::Write( fname, *aCacheItem->renderData, aCacheItem->pluginInfo );
+}
+
+
 bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
 {
     if( NULL == aCacheItem )
@@ -497,6 +576,8 @@ bool S3D_CACHE::saveCacheData( S3D_CACHE_ENTRY* aCacheItem )
         }
     }
 
+    std::lock_guard<std::mutex> lock( m_cacheFileMutex );
+
     return S3D::WriteCache( fname.ToUTF8(), true, (SGNODE*)aCacheItem->sceneData,
         aCacheItem->pluginInfo.c_str() );
 }
@@ -647,6 +728,8 @@ bool S3D_CACHE::SetProjectDir( const wxString& aProjDir )
 
     if( m_FNResolver->SetProjectDir( aProjDir, &hasChanged ) && hasChanged )
     {
+        std::lock_guard<std::mutex> lock( m_mutex );
+
         m_CacheMap.clear();
 
         std::list< S3D_CACHE_ENTRY* >::iterator sL = m_CacheList.begin();
@@ -694,6 +777,8 @@ std::list< wxString > const* S3D_CACHE::GetFileFilters( void ) const
 
 void S3D_CACHE::FlushCache( bool closePlugins )
 {
+    std::unique_lock<std::mutex> lock( m_mutex );
+
     std::list< S3D_CACHE_ENTRY* >::iterator sCL = m_CacheList.begin();
     std::list< S3D_CACHE_ENTRY* >::iterator eCL = m_CacheList.end();
 
@@ -705,6 +790,7 @@ void S3D_CACHE::FlushCache( bool closePlugins )
 
     m_CacheList.clear();
     m_CacheMap.clear();
+    lock.unlock();
 
     if( closePlugins )
         ClosePlugins();
@@ -724,28 +810,29 @@ void S3D_CACHE::ClosePlugins( void )
 
 S3DMODEL* S3D_CACHE::GetModel( const wxString& aModelFileName )
 {
-    S3D_CACHE_ENTRY* cp = NULL;
-    SCENEGRAPH* sp = load( aModelFileName, &cp );
-
-    if( !sp )
-        return NULL;
-
-    if( !cp )
-    {
-        wxLogTrace( MASK_3D_CACHE,
-                    "%s:%s:%d\n  * [BUG] model loaded with no associated S3D_CACHE_ENTRY",
-                    __FILE__, __FUNCTION__, __LINE__ );
+    std::unique_lock<std::mutex> entryLock;
+    wxString full3Dpath;
+    S3D_CACHE_ENTRY* cp = getEntry( aModelFileName, entryLock, full3Dpath );
 
+    if( NULL == cp )
         return NULL;
-    }
 
     if( cp->renderData )
         return cp->renderData;
 
-    S3DMODEL* mp = S3D::GetModel( sp );
-    cp->renderData = mp;
+    // the mesh cache file is used in place, without loading the scene data
+    if( !cp->meshLoaded && loadMeshData( cp ) )
+        return cp->renderData;
+
+    checkCache( full3Dpath, cp );
+
+    if( NULL == cp->sceneData )
+        return NULL;
 
-    return mp;
+    cp->renderData = S3D::GetModel( cp->sceneData );
+    saveMeshData( cp );
+
+    return cp->renderData;
 }
 
 
@@ -756,16 +843,10 @@ wxString S3D_CACHE::GetModelHash( const wxString& aModelFileName )
     if( full3Dpath.empty() || !wxFileName::FileExists( full3Dpath ) )
         return wxEmptyString;
 
-    // check cache if file is already loaded
-    std::map< wxString, S3D_CACHE_ENTRY*, rsort_wxString >::iterator mi;
-    mi = m_CacheMap.find( full3Dpath );
-
-    if( mi != m_CacheMap.end() )
-        return mi->second->GetCacheBaseName();
-
-    // a cache item does not exist; search the Filename->Cachename map
-    S3D_CACHE_ENTRY* cp = NULL;
-    checkCache( full3Dpath, &cp );
+    // find or create the cache item; the hash does not need the model to be loaded
+    std::unique_lock<std::mutex> entryLock;
+    wxString resolvedPath;
+    S3D_CACHE_ENTRY* cp = getEntry( full3Dpath, entryLock, resolvedPath );
 
     if( NULL != cp )
         return cp->GetCacheBaseName();
@@ -31,6 +31,8 @@
 
 #include <list>
 #include <map>
+#include <mutex>
+#include <vector>
 #include <wx/string.h>
 #include "kicad_string.h"
 #include "filename_resolver.h"
@@ -73,18 +75,39 @@ private:
     /// current KiCad project dir
     wxString m_ProjDir;
 
+    /// protects m_CacheList and m_CacheMap; entries have their own lock for their data
+    std::mutex m_mutex;
+
+    /// serializes writes of cache files (the scene graph writer renames nodes globally)
+    std::mutex m_cacheFileMutex;
+
     /** Find or create cache entry for file name
      *
-     * Searches the cache list for the given filename and retrieves
-     * the cache data; a cache entry is created if one does not
-     * already exist.
+     * Searches the cache list for the given filename; a cache entry is
+     * created and the file hashed if one does not already exist.  The
+     * data of an existing entry is freed if the file was modified.
      *
-     * @param[in]   aFileName   file name (full or partial path)
-     * @param[out]  aCachePtr   optional return address for cache entry pointer
-     * @return      SCENEGRAPH object associated with file name
-     * @retval      NULL    on error
+     * @param[in]   aModelFile  file name (full or partial path)
+     * @param[out]  aEntryLock  receives the lock of the entry
+     * @param[out]  aFullPath   receives the resolved file name
+     * @return      the entry, locked
+     * @retval      NULL    if the file cannot be found
+     */
+    S3D_CACHE_ENTRY* getEntry( const wxString& aModelFile,
+                               std::unique_lock<std::mutex>& aEntryLock, wxString& aFullPath );
+
+    /** Load the scene data of a cache entry
+     *
+     * Retrieves the scene data of the given file from the cache file
+     * directory, or loads it with the plugins and saves it in the cache
+     * file directory.  This is only attempted once: the entry is left
+     * without scene data on error, which prevents further attempts at
+     * loading the file.
+     *
+     * @param[in]   aFileName   file name (full path)
+     * @param[in]   aCacheItem  the entry, locked by the caller
      */
-    SCENEGRAPH* checkCache( const wxString& aFileName, S3D_CACHE_ENTRY** aCachePtr = NULL );
+    void checkCache( const wxString& aFileName, S3D_CACHE_ENTRY* aCacheItem );
 
     /**
      * Function getSHA1
@@ -103,6 +126,12 @@ private:
     // save scene data to a cache file
     bool saveCacheData( S3D_CACHE_ENTRY* aCacheItem );
 
+    // map the render data from a mesh cache file
+    bool loadMeshData( S3D_CACHE_ENTRY* aCacheItem );
+
+    // save render data to a mesh cache file
+    bool saveMeshData( S3D_CACHE_ENTRY* aCacheItem );
+
     // the real load function (can supply a cache entry pointer to member functions)
     SCENEGRAPH* load( const wxString& aModelFile, S3D_CACHE_ENTRY** aCachePtr = NULL );
 
@@ -167,6 +196,20 @@ public:
      */
     SCENEGRAPH* Load( const wxString& aModelFile );
 
+    /**
+     * Function LoadModels
+     * loads the scene and render data of several models on the thread pool,
+     * so that the following calls to GetModel() for these files return
+     * immediately.  Files listed several times are only loaded once.
+     *
+     * The plugins themselves are not reentrant, so models which are not in
+     * the cache file directory yet still go through them one at a time;
+     * resolving, hashing and reading cached models runs in parallel.
+     *
+     * @param aModelFiles [in] are the partial or full paths of the models
+     */
+    void LoadModels( const std::vector<wxString>& aModelFiles );
+
     FILENAME_RESOLVER* GetResolver( void );
 
     /**
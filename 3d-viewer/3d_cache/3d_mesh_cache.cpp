@@ -0,0 +1,362 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <cstdio>
+#include <cstring>
+
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+#include <ki_exception.h>
+#include "3d_mesh_cache.h"
+
+
+#define MASK_3D_CACHE "3D_CACHE"
+
+// The arrays are used in place, so their elements must not have any padding
+static_assert( sizeof( SFVEC2F ) == 2 * sizeof( float ), "unexpected SFVEC2F layout" );
+static_assert( sizeof( SFVEC3F ) == 3 * sizeof( float ), "unexpected SFVEC3F layout" );
+static_assert( sizeof( SMATERIAL ) == 14 * sizeof( float ), "unexpected SMATERIAL layout" );
+
+
+static const char     MESH_CACHE_MAGIC[8] = { 'K', 'I', '3', 'D', 'M', 'E', 'S', 'H' };
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// All the blocks of the file start on a multiple of this
+static const size_t   BLOCK_ALIGNMENT = 8;
+
+
+/*
+ * File layout:
+ *
+ *  FILE_HEADER
+ *  plugin info (m_pluginInfoSize chars)
+ *  SMATERIAL[m_materialCount]
+ *  MESH_RECORD[m_meshCount]
+ *  the arrays of the meshes
+ *
+ * Array offsets are counted from the start of the file; 0 stands for a NULL array.
+ */
+struct FILE_HEADER
+{
+    char     m_magic[8];
+    uint32_t m_version;
+    uint32_t m_byteOrder;
+    uint32_t m_pluginInfoSize;
+    uint32_t m_materialCount;
+    uint32_t m_meshCount;
+    uint32_t m_reserved;
+};
+
+
+struct MESH_RECORD
+{
+    uint32_t m_vertexCount;
+    uint32_t m_faceIdxCount;
+    uint32_t m_materialIdx;
+    uint32_t m_reserved;
+    uint64_t m_positions;
+    uint64_t m_normals;
+    uint64_t m_texcoords;
+    uint64_t m_colors;
+    uint64_t m_faceIdx;
+};
+
+
+static size_t alignBlock( size_t aOffset )
+{
+    return ( aOffset + BLOCK_ALIGNMENT - 1 ) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+}
+
+
+/**
+ * Writes the blocks of a file, keeping track of their offsets.
+ */
+class BLOCK_WRITER
+{
+public:
+    BLOCK_WRITER( FILE* aFile ) :
+        m_file( aFile ), m_offset( 0 ), m_ok( true )
+    {}
+
+    /// @return the offset of the block
+    size_t Write( const void* aData, size_t aSize )
+    {
+        static const char padding[BLOCK_ALIGNMENT] = {};
+
+        size_t start = alignBlock( m_offset );
+
+        if( start > m_offset )
+            m_ok &= fwrite( padding, 1, start - m_offset, m_file ) == start - m_offset;
+
+        if( aSize )
+            m_ok &= fwrite( aData, 1, aSize, m_file ) == aSize;
+
+        m_offset = start + aSize;
+        return start;
+    }
+
+    /// @return where the next block will start
+    size_t NextBlock() const { return alignBlock( m_offset ); }
+
+    bool IsOk() const { return m_ok; }
+
+private:
+    FILE*   m_file;
+    size_t  m_offset;
+    bool    m_ok;
+};
+
+
+S3D_MESH_CACHE_FILE::S3D_MESH_CACHE_FILE( const wxString& aFileName ) :
+    m_file( aFileName )
+{
+    m_model.m_MeshesSize = 0;
+    m_model.m_Meshes = NULL;
+    m_model.m_MaterialsSize = 0;
+    m_model.m_Materials = NULL;
+}
+
+
+std::unique_ptr<S3D_MESH_CACHE_FILE> S3D_MESH_CACHE_FILE::Read( const wxString& aFileName,
+                                                                std::string& aPluginInfo )
+{
+    if( !wxFileName::FileExists( aFileName ) )
+        return nullptr;
+
+    std::unique_ptr<S3D_MESH_CACHE_FILE> file;
+
+    try
+    {
+        file.reset( new S3D_MESH_CACHE_FILE( aFileName ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] %s", ioe.What() );
+        return nullptr;
+    }
+
+    if( !file->parse( aPluginInfo ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] ignoring invalid mesh cache file '%s'",
+                    aFileName );
+        return nullptr;
+    }
+
+    return file;
+}
+
+
+bool S3D_MESH_CACHE_FILE::parse( std::string& aPluginInfo )
+{
+    const char*    data = m_file.Data();
+    const uint64_t size = m_file.Size();
+
+    // @return true if aCount elements of aElemSize bytes at aOffset are in the file
+    auto inFile = [&]( uint64_t aOffset, uint64_t aCount, size_t aElemSize )
+    {
+        return aOffset % BLOCK_ALIGNMENT == 0 && aOffset <= size
+                && aCount <= ( size - aOffset ) / aElemSize;
+    };
+
+    if( size < sizeof( FILE_HEADER ) )
+        return false;
+
+    FILE_HEADER header;
+    memcpy( &header, data, sizeof( header ) );
+
+    if( memcmp( header.m_magic, MESH_CACHE_MAGIC, sizeof( header.m_magic ) )
+            || header.m_version != VERSION || header.m_byteOrder != BYTE_ORDER_MARK )
+        return false;
+
+    uint64_t offset = sizeof( FILE_HEADER );
+
+    if( !inFile( offset, header.m_pluginInfoSize, 1 ) )
+        return false;
+
+    aPluginInfo.assign( data + offset, header.m_pluginInfoSize );
+    offset = alignBlock( offset + header.m_pluginInfoSize );
+
+    if( !inFile( offset, header.m_materialCount, sizeof( SMATERIAL ) ) )
+        return false;
+
+    m_model.m_MaterialsSize = header.m_materialCount;
+    m_model.m_Materials = header.m_materialCount ? (SMATERIAL*) ( data + offset ) : NULL;
+    offset = alignBlock( offset + (uint64_t) header.m_materialCount * sizeof( SMATERIAL ) );
+
+    if( !inFile( offset, header.m_meshCount, sizeof( MESH_RECORD ) ) )
+        return false;
+
+    const MESH_RECORD* records = (const MESH_RECORD*) ( data + offset );
+
+    m_meshes.resize( header.m_meshCount );
+
+    for( uint32_t ii = 0; ii < header.m_meshCount; ++ii )
+    {
+        const MESH_RECORD& record = records[ii];
+        SMESH&             mesh = m_meshes[ii];
+
+        if( record.m_materialIdx >= header.m_materialCount )
+            return false;
+
+        // @return the array at aOffset, or NULL
+        auto array = [&]( uint64_t aOffset, uint64_t aCount, size_t aElemSize, bool& aOk )
+        {
+            if( aOffset == 0 || !inFile( aOffset, aCount, aElemSize ) )
+            {
+                aOk &= aOffset == 0;
+                return (const char*) NULL;
+            }
+
+            return data + aOffset;
+        };
+
+        bool ok = true;
+
+        mesh.m_VertexSize = record.m_vertexCount;
+        mesh.m_Positions = (SFVEC3F*) array( record.m_positions, record.m_vertexCount,
+                                             sizeof( SFVEC3F ), ok );
+        mesh.m_Normals = (SFVEC3F*) array( record.m_normals, record.m_vertexCount,
+                                           sizeof( SFVEC3F ), ok );
+        mesh.m_Texcoords = (SFVEC2F*) array( record.m_texcoords, record.m_vertexCount,
+                                             sizeof( SFVEC2F ), ok );
+        mesh.m_Color = (SFVEC3F*) array( record.m_colors, record.m_vertexCount,
+                                         sizeof( SFVEC3F ), ok );
+        mesh.m_FaceIdxSize = record.m_faceIdxCount;
+        mesh.m_FaceIdx = (unsigned int*) array( record.m_faceIdx, record.m_faceIdxCount,
+                                                sizeof( unsigned int ), ok );
+        mesh.m_MaterialIdx = record.m_materialIdx;
+
+        if( !ok )
+            return false;
+
+        // The renderers trust the indexes
+        if( mesh.m_FaceIdx )
+        {
+            for( uint32_t jj = 0; jj < mesh.m_FaceIdxSize; ++jj )
+            {
+                if( mesh.m_FaceIdx[jj] >= mesh.m_VertexSize )
+                    return false;
+            }
+        }
+    }
+
+    m_model.m_MeshesSize = header.m_meshCount;
+    m_model.m_Meshes = m_meshes.empty() ? NULL : m_meshes.data();
+
+    return true;
+}
+
+
+bool S3D_MESH_CACHE_FILE::Write( const wxString& aFileName, const S3DMODEL& aModel,
+                                 const std::string& aPluginInfo )
+{
+    wxString tmpName = aFileName + wxT( ".tmp" );
+    FILE*    fp = wxFopen( tmpName, wxT( "wb" ) );
+
+    if( !fp )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write mesh cache file '%s'", tmpName );
+        return false;
+    }
+
+    BLOCK_WRITER writer( fp );
+
+    FILE_HEADER header;
+    memset( &header, 0, sizeof( header ) );
+    memcpy( header.m_magic, MESH_CACHE_MAGIC, sizeof( header.m_magic ) );
+    header.m_version = VERSION;
+    header.m_byteOrder = BYTE_ORDER_MARK;
+    header.m_pluginInfoSize = aPluginInfo.size();
+    header.m_materialCount = aModel.m_MaterialsSize;
+    header.m_meshCount = aModel.m_MeshesSize;
+
+    writer.Write( &header, sizeof( header ) );
+    writer.Write( aPluginInfo.data(), aPluginInfo.size() );
+    writer.Write( aModel.m_Materials, aModel.m_MaterialsSize * sizeof( SMATERIAL ) );
+
+    // The arrays follow the mesh table: lay them out first
+    std::vector<MESH_RECORD> records( aModel.m_MeshesSize );
+    size_t offset = alignBlock( writer.NextBlock() + records.size() * sizeof( MESH_RECORD ) );
+
+    auto place = [&]( const void* aArray, size_t aSize ) -> uint64_t
+    {
+        if( !aArray )
+            return 0;
+
+        size_t start = offset;
+        offset = alignBlock( offset + aSize );
+        return start;
+    };
+
+    for( unsigned int ii = 0; ii < aModel.m_MeshesSize; ++ii )
+    {
+        const SMESH& mesh = aModel.m_Meshes[ii];
+        MESH_RECORD& record = records[ii];
+
+        memset( &record, 0, sizeof( record ) );
+        record.m_vertexCount = mesh.m_VertexSize;
+        record.m_faceIdxCount = mesh.m_FaceIdxSize;
+        record.m_materialIdx = mesh.m_MaterialIdx;
+        record.m_positions = place( mesh.m_Positions, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+        record.m_normals = place( mesh.m_Normals, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+        record.m_texcoords = place( mesh.m_Texcoords, mesh.m_VertexSize * sizeof( SFVEC2F ) );
+        record.m_colors = place( mesh.m_Color, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+        record.m_faceIdx = place( mesh.m_FaceIdx, mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    writer.Write( records.data(), records.size() * sizeof( MESH_RECORD ) );
+
+    for( unsigned int ii = 0; ii < aModel.m_MeshesSize; ++ii )
+    {
+        const SMESH& mesh = aModel.m_Meshes[ii];
+
+        if( mesh.m_Positions )
+            writer.Write( mesh.m_Positions, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+
+        if( mesh.m_Normals )
+            writer.Write( mesh.m_Normals, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+
+        if( mesh.m_Texcoords )
+            writer.Write( mesh.m_Texcoords, mesh.m_VertexSize * sizeof( SFVEC2F ) );
+
+        if( mesh.m_Color )
+            writer.Write( mesh.m_Color, mesh.m_VertexSize * sizeof( SFVEC3F ) );
+
+        if( mesh.m_FaceIdx )
+            writer.Write( mesh.m_FaceIdx, mesh.m_FaceIdxSize * sizeof( unsigned int ) );
+    }
+
+    bool ok = writer.IsOk();
+    ok &= fclose( fp ) == 0;
+
+    if( !ok || !wxRenameFile( tmpName, aFileName, true ) )
+    {
+        wxLogTrace( MASK_3D_CACHE, " * [3D model] cannot write mesh cache file '%s'", aFileName );
+        wxRemoveFile( tmpName );
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,104 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file 3d_mesh_cache.h
+ * defines the cache files holding the render data of 3D models
+ */
+
+#ifndef MESH_CACHE_3D_H
+#define MESH_CACHE_3D_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/string.h>
+
+#include <mapped_file.h>
+#include "plugins/3dapi/c3dmodel.h"
+
+
+/**
+ * Class S3D_MESH_CACHE_FILE
+ * is a cache file holding the render data (S3DMODEL) of a model, as the renderers use it.
+ *
+ * The .3dc cache files hold the scene graph of a model, node by node, which must be parsed
+ * and then flattened into meshes each time.  The meshes of a S3D_MESH_CACHE_FILE are stored
+ * as contiguous vertex, normal, colour and index arrays: the file is memory mapped and the
+ * arrays are used in place.
+ *
+ * The file is written in the native byte order, with a header recording it and a format
+ * version; a file not matching them is ignored and rewritten.
+ */
+class S3D_MESH_CACHE_FILE
+{
+public:
+    /// bumped whenever the file layout or the conversion of scene graphs to meshes changes
+    static const uint32_t VERSION = 1;
+
+    /**
+     * Function Read
+     * maps a mesh cache file.
+     *
+     * @param aFileName is the full path of the file.
+     * @param aPluginInfo receives the PluginName:Version string of the plugin which loaded
+     * the model, for the caller to check it is still current.
+     * @return the file, or NULL if it is missing, of another version or corrupt.
+     */
+    static std::unique_ptr<S3D_MESH_CACHE_FILE> Read( const wxString& aFileName,
+                                                      std::string& aPluginInfo );
+
+    /**
+     * Function Write
+     * writes the render data of a model to a mesh cache file.  The file is written under a
+     * temporary name first, so other instances never map a partial file.
+     *
+     * @return true on success.
+     */
+    static bool Write( const wxString& aFileName, const S3DMODEL& aModel,
+                       const std::string& aPluginInfo );
+
+    /**
+     * Function GetModel
+     * @return the render data of the model, which is valid as long as this object exists.
+     */
+    const S3DMODEL* GetModel() const { return &m_model; }
+
+    /**
+     * Function IsMapped
+     * @return true if the file content is mapped, false if it had to be read in a buffer.
+     */
+    bool IsMapped() const { return m_file.IsMapped(); }
+
+private:
+    S3D_MESH_CACHE_FILE( const wxString& aFileName );
+
+    bool parse( std::string& aPluginInfo );
+
+    MAPPED_FILE         m_file;
+    std::vector<SMESH>  m_meshes;   ///< mesh descriptors, pointing to the arrays of m_file
+    S3DMODEL            m_model;
+};
+
+#endif  // MESH_CACHE_3D_H
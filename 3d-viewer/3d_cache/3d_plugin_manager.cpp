@@ -495,6 +495,8 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
     std::pair < std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* >::iterator,
         std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* >::iterator > items;
 
+    std::lock_guard<std::mutex> lock( m_mutex );
+
     items = m_ExtMap.equal_range( ext );
     std::multimap< const wxString, KICAD_PLUGIN_LDR_3D* >::iterator sL = items.first;
 
@@ -520,6 +522,8 @@ SCENEGRAPH* S3D_PLUGIN_MANAGER::Load3DModel( const wxString& aFileName, std::str
 
 void S3D_PLUGIN_MANAGER::ClosePlugins( void )
 {
+    std::lock_guard<std::mutex> lock( m_mutex );
+
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator sP = m_Plugins.begin();
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator eP = m_Plugins.end();
 
@@ -559,6 +563,8 @@ bool S3D_PLUGIN_MANAGER::CheckTag( const char* aTag )
     pname = tname.substr( 0, cpos );
     std::string ptag;   // tag from the plugin
 
+    std::lock_guard<std::mutex> lock( m_mutex );
+
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator pS = m_Plugins.begin();
     std::list< KICAD_PLUGIN_LDR_3D* >::iterator pE = m_Plugins.end();
 
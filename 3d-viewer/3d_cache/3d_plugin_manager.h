@@ -31,6 +31,7 @@
 
 #include <map>
 #include <list>
+#include <mutex>
 #include <string>
 #include <wx/string.h>
 
@@ -50,6 +51,10 @@ private:
     /// list of file filters
     std::list< wxString > m_FileFilters;
 
+    /// serializes the calls to the plugins: they are not reentrant (they switch the
+    /// process locale while parsing) and are reopened on demand after ClosePlugins()
+    std::mutex m_mutex;
+
     /// load plugins
     void loadPlugins( void );
 
@@ -82,6 +87,12 @@ public:
      */
     std::list< wxString > const* GetFileFilters( void ) const;
 
+    /**
+     * Function Load3DModel
+     * loads a model with the first plugin supporting its extension which
+     * succeeds.  It may be called from any thread, but plugins only load one
+     * model at a time.
+     */
     SCENEGRAPH* Load3DModel( const wxString& aFileName, std::string& aPluginInfo );
 
     /**
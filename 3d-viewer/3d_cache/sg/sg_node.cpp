@@ -22,6 +22,7 @@
  */
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstring>
 #include <iostream>
@@ -45,7 +46,8 @@ static const std::string node_names[S3D::SGTYPE_END + 1] = {
 };
 
 
-static unsigned int node_counts[S3D::SGTYPE_END] = { 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+// number of names given to each node type; models may be loaded by several threads
+static std::atomic<unsigned int> node_counts[S3D::SGTYPE_END];
 
 
 char const* S3D::GetNodeTypeName( S3D::SGTYPES aType )
@@ -62,8 +64,7 @@ static void getNodeName( S3D::SGTYPES nodeType, std::string& aName )
         return;
     }
 
-    unsigned int seqNum = node_counts[nodeType];
-    ++node_counts[nodeType];
+    unsigned int seqNum = ++node_counts[nodeType];
 
     std::ostringstream ostr;
     ostr << node_names[nodeType] << "_" << seqNum;
@@ -304,7 +305,7 @@ void SGNODE::DisassociateWrapper( SGNODE** aWrapperRef )
 void SGNODE::ResetNodeIndex( void )
 {
     for( int i = 0; i < (int)S3D::SGTYPE_END; ++i )
-        node_counts[i] = 1;
+        node_counts[i] = 0;
 
     return;
 }
@@ -422,6 +422,18 @@ class CINFO3D_VISU
     void createLayers( REPORTER *aStatusTextReporter );
     void destroyLayers();
 
+    /**
+     * Add the objects and contours of a copper layer, and build the BVH of its holes.
+     * The containers are created by createLayers(); the layers are built in parallel.
+     */
+    void createCopperLayer( PCB_LAYER_ID aLayerId,
+                            const std::vector< const TRACK *> &aTrackList );
+
+    /**
+     * Add the objects and contours of a technical layer, as createCopperLayer().
+     */
+    void createTechLayer( PCB_LAYER_ID aLayerId );
+
     // Helper functions to create the board
     COBJECT2D *createNewTrack( const TRACK* aTrack , int aClearanceValue ) const;
 
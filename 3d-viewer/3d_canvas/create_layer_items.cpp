@@ -50,11 +50,10 @@
 #include <class_text_mod.h>
 #include <convert_basic_shapes_to_polygon.h>
 #include <trigo.h>
+#include <thread_pool.h>
 #include <utility>
 #include <vector>
-#include <thread>
 #include <algorithm>
-#include <atomic>
 
 #include <profile.h>
 
@@ -138,18 +137,21 @@ void CINFO3D_VISU::destroyLayers()
 }
 
 
+// Number of segments to draw a circle using segments (used on countour zones
+// and text copper elements )
+static const int segcountforcircle = 12;
+
+// segments to draw a circle to build texts. Is is used only to build
+// the shape of each segment of the stroke font, therefore no need to have
+// many segments per circle.
+static const int segcountInStrokeFont = 12;
+
+
 void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 {
-    // Number of segments to draw a circle using segments (used on countour zones
-    // and text copper elements )
-    const int    segcountforcircle = 12;
-    const double correctionFactor  = GetCircleCorrectionFactor( segcountforcircle );
-
-    // segments to draw a circle to build texts. Is is used only to build
-    // the shape of each segment of the stroke font, therefore no need to have
-    // many segments per circle.
-    const int segcountInStrokeFont  = 12;
-    const double correctionFactorStroke = GetCircleCorrectionFactor( segcountInStrokeFont );
+    const double correctionFactor = GetCircleCorrectionFactor( segcountforcircle );
+
+    const unsigned startTime = GetRunningMicroSecs();
 
     destroyLayers();
 
@@ -157,12 +159,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L692
     // /////////////////////////////////////////////////////////////////////////
 
-    #ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startCopperLayersTime = GetRunningMicroSecs();
-
-    unsigned start_Time = stats_startCopperLayersTime;
-#endif
-
     PCB_LAYER_ID cu_seq[MAX_CU_LAYERS];
     LSET     cu_set = LSET::AllCuMask( m_copperLayersCount );
 
@@ -208,11 +204,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( m_stats_nr_vias )
         m_stats_via_med_hole_diameter /= (float)m_stats_nr_vias;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T01: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Prepare copper layers index and containers
     // /////////////////////////////////////////////////////////////////////////
     std::vector< PCB_LAYER_ID > layer_id;
@@ -242,277 +233,103 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T02: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     if( aStatusTextReporter )
         aStatusTextReporter->Report( _( "Create tracks and vias" ) );
 
-    // Create tracks as objects and add it to container
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
-
-            // NOTE: Vias can be on multiple layers
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            // Add object item to layer container
-            layerContainer->Add( createNewTrack( track, 0.0f ) );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T03: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Create VIAS and THTs objects and add it to holes containers
+    // Create the hole containers of the layers crossed by blind and buried vias.
+    // The layers are built in parallel and fill them later.
     // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    for( const TRACK *track : trackList )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        // ADD TRACKS
-        unsigned int nTracks = trackList.size();
-
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-        {
-            const TRACK *track = trackList[trackIdx];
-
-            if( !track->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
-            {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE_T viatype = via->GetViaType();
-                const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
-                const float thickness = GetCopperThickness3DU();
-                const float hole_inner_radius = ( holediameter / 2.0f );
-
-                const SFVEC2F via_center(  via->GetStart().x * m_biuTo3Dunits,
-                                          -via->GetStart().y * m_biuTo3Dunits );
-
-                if( viatype != VIA_THROUGH )
-                {
-
-                    // Add hole objects
-                    // /////////////////////////////////////////////////////////
-
-                    CBVHCONTAINER2D *layerHoleContainer = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_holes2D.find( curr_layer_id ) == m_layers_holes2D.end() )
-                    {
-                        // not found, create a new container
-                        layerHoleContainer = new CBVHCONTAINER2D;
-                        m_layers_holes2D[curr_layer_id] = layerHoleContainer;
-                    }
-                    else
-                    {
-                        // found
-                        layerHoleContainer = m_layers_holes2D[curr_layer_id];
-                    }
-
-                    // Add a hole for this layer
-                    layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
-                                                                  hole_inner_radius + thickness,
-                                                                  *track ) );
-                }
-                else if( lIdx == 0 ) // it only adds once the THT holes
-                {
-                    // Add through hole object
-                    // /////////////////////////////////////////////////////////
-                    m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius + thickness,
-                                                                    *track ) );
-
-                    m_through_holes_vias_outer.Add(
-                                new CFILLEDCIRCLE2D( via_center,
-                                                     hole_inner_radius + thickness,
-                                                     *track ) );
-
-                    m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                                                                    hole_inner_radius,
-                                                                    *track ) );
-
-                    //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
-                    //                                                     hole_inner_radius,
-                    //                                                     *track ) );
-                }
-            }
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T04: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Create VIAS and THTs objects and add it to holes containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        // ADD TRACKS
-        const unsigned int nTracks = trackList.size();
+        if( track->Type() != PCB_VIA_T
+                || static_cast< const VIA*>( track )->GetViaType() == VIA_THROUGH )
+            continue;
 
-        for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
+        for( PCB_LAYER_ID curr_layer_id : layer_id )
         {
-            const TRACK *track = trackList[trackIdx];
-
-            if( !track->IsOnLayer( curr_layer_id ) )
+            if( !track->IsOnLayer( curr_layer_id )
+                    || m_layers_holes2D.find( curr_layer_id ) != m_layers_holes2D.end() )
                 continue;
 
-            // ADD VIAS and THT
-            if( track->Type() == PCB_VIA_T )
-            {
-                const VIA *via = static_cast< const VIA*>( track );
-                const VIATYPE_T viatype = via->GetViaType();
-
-                if( viatype != VIA_THROUGH )
-                {
-
-                    // Add VIA hole contourns
-                    // /////////////////////////////////////////////////////////
-
-                    // Add outter holes of VIAs
-                    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
-                    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
-
-                    // Check if the layer is already created
-                    if( m_layers_outer_holes_poly.find( curr_layer_id ) ==
-                        m_layers_outer_holes_poly.end() )
-                    {
-                        // not found, create a new container
-                        layerOuterHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_outer_holes_poly[curr_layer_id] = layerOuterHolesPoly;
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
-                                  m_layers_inner_holes_poly.end() );
-
-                        layerInnerHolesPoly = new SHAPE_POLY_SET;
-                        m_layers_inner_holes_poly[curr_layer_id] = layerInnerHolesPoly;
-                    }
-                    else
-                    {
-                        // found
-                        layerOuterHolesPoly = m_layers_outer_holes_poly[curr_layer_id];
-
-                        wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                                  m_layers_inner_holes_poly.end() );
-
-                        layerInnerHolesPoly = m_layers_inner_holes_poly[curr_layer_id];
-                    }
-
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2) + GetCopperThicknessBIU();
+            m_layers_holes2D[curr_layer_id] = new CBVHCONTAINER2D;
 
-                    TransformCircleToPolygon( *layerOuterHolesPoly,
-                                              via->GetStart(),
-                                              hole_outer_radius,
-                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
+            wxASSERT( m_layers_outer_holes_poly.find( curr_layer_id ) ==
+                      m_layers_outer_holes_poly.end() );
+            wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) ==
+                      m_layers_inner_holes_poly.end() );
 
-                    TransformCircleToPolygon( *layerInnerHolesPoly,
-                                              via->GetStart(),
-                                              holediameter / 2,
-                                              GetNrSegmentsCircle( holediameter ) );
-                }
-                else if( lIdx == 0 ) // it only adds once the THT holes
-                {
-                    const int holediameter = via->GetDrillValue();
-                    const int hole_outer_radius = (holediameter / 2)+ GetCopperThicknessBIU();
-
-                    // Add through hole contourns
-                    // /////////////////////////////////////////////////////////
-                    TransformCircleToPolygon( m_through_outer_holes_poly,
-                                              via->GetStart(),
-                                              hole_outer_radius,
-                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
-
-                    TransformCircleToPolygon( m_through_inner_holes_poly,
-                                              via->GetStart(),
-                                              holediameter / 2,
-                                              GetNrSegmentsCircle( holediameter ) );
-
-                    // Add samething for vias only
-
-                    TransformCircleToPolygon( m_through_outer_holes_vias_poly,
-                                              via->GetStart(),
-                                              hole_outer_radius,
-                                              GetNrSegmentsCircle( hole_outer_radius * 2 ) );
-
-                    //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
-                    //                          via->GetStart(),
-                    //                          holediameter / 2,
-                    //                          GetNrSegmentsCircle( holediameter ) );
-                }
-            }
+            m_layers_outer_holes_poly[curr_layer_id] = new SHAPE_POLY_SET;
+            m_layers_inner_holes_poly[curr_layer_id] = new SHAPE_POLY_SET;
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T05: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Creates outline contours of the tracks and add it to the poly of the layer
+    // Create through VIAS objects and add it to holes containers.
+    // They are on every copper layer, so they are only added once.
     // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    for( const TRACK *track : trackList )
     {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
-
-            // ADD TRACKS
-            unsigned int nTracks = trackList.size();
+        if( track->Type() != PCB_VIA_T || layer_id.empty() || !track->IsOnLayer( layer_id[0] ) )
+            continue;
 
-            for( unsigned int trackIdx = 0; trackIdx < nTracks; ++trackIdx )
-            {
-                const TRACK *track = trackList[trackIdx];
+        const VIA *via = static_cast< const VIA*>( track );
 
-                if( !track->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                // Add the track contour
-                int nrSegments = GetNrSegmentsCircle( track->GetWidth() );
+        if( via->GetViaType() != VIA_THROUGH )
+            continue;
 
-                track->TransformShapeWithClearanceToPolygon(
-                            *layerPoly,
-                            0,
-                            nrSegments,
-                            GetCircleCorrectionFactor( nrSegments ) );
-            }
-        }
+        const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
+        const float thickness = GetCopperThickness3DU();
+        const float hole_inner_radius = ( holediameter / 2.0f );
+
+        const SFVEC2F via_center(  via->GetStart().x * m_biuTo3Dunits,
+                                  -via->GetStart().y * m_biuTo3Dunits );
+
+        // Add through hole object
+        // /////////////////////////////////////////////////////////
+        m_through_holes_outer.Add( new CFILLEDCIRCLE2D( via_center,
+                                                        hole_inner_radius + thickness,
+                                                        *track ) );
+
+        m_through_holes_vias_outer.Add(
+                    new CFILLEDCIRCLE2D( via_center,
+                                         hole_inner_radius + thickness,
+                                         *track ) );
+
+        m_through_holes_inner.Add( new CFILLEDCIRCLE2D( via_center,
+                                                        hole_inner_radius,
+                                                        *track ) );
+
+        //m_through_holes_vias_inner.Add( new CFILLEDCIRCLE2D( via_center,
+        //                                                     hole_inner_radius,
+        //                                                     *track ) );
+
+        const int hole_diameter = via->GetDrillValue();
+        const int hole_outer_radius = (hole_diameter / 2)+ GetCopperThicknessBIU();
+
+        // Add through hole contourns
+        // /////////////////////////////////////////////////////////
+        TransformCircleToPolygon( m_through_outer_holes_poly,
+                                  via->GetStart(),
+                                  hole_outer_radius,
+                                  GetNrSegmentsCircle( hole_outer_radius * 2 ) );
+
+        TransformCircleToPolygon( m_through_inner_holes_poly,
+                                  via->GetStart(),
+                                  hole_diameter / 2,
+                                  GetNrSegmentsCircle( hole_diameter ) );
+
+        // Add samething for vias only
+
+        TransformCircleToPolygon( m_through_outer_holes_vias_poly,
+                                  via->GetStart(),
+                                  hole_outer_radius,
+                                  GetNrSegmentsCircle( hole_outer_radius * 2 ) );
+
+        //TransformCircleToPolygon( m_through_inner_holes_vias_poly,
+        //                          via->GetStart(),
+        //                          hole_diameter / 2,
+        //                          GetNrSegmentsCircle( hole_diameter ) );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T06: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Add holes of modules
     // /////////////////////////////////////////////////////////////////////////
     for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
@@ -542,11 +359,6 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
     if( m_stats_nr_holes )
         m_stats_hole_med_diameter /= (float)m_stats_nr_holes;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T07: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
     // Add contours of the pad holes (pads can be Circle or Segment holes)
     // /////////////////////////////////////////////////////////////////////////
     for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
@@ -589,200 +401,76 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
         }
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T08: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs objects to containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-    {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD PADS
-        for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
-        {
-            // Note: NPTH pads are not drawn on copper layers when the pad
-            // has same shape as its hole
-            AddPadsShapesWithClearanceToContainer( module,
-                                                   layerContainer,
-                                                   curr_layer_id,
-                                                   0,
-                                                   true );
-
-            // Micro-wave modules may have items on copper layers
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
-        }
-    }
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T09: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add modules PADs poly contourns
+    // Prepare tech layers index and containers
     // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
 
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
-
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+    // draw graphic items, on technical layers
+    static const PCB_LAYER_ID teckLayerList[] = {
+            B_Adhes,
+            F_Adhes,
+            B_Paste,
+            F_Paste,
+            B_SilkS,
+            F_SilkS,
+            B_Mask,
+            F_Mask,
 
-            // ADD PADS
-            for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
-            {
-                // Construct polys
-                // /////////////////////////////////////////////////////////////
-
-                // Note: NPTH pads are not drawn on copper layers when the pad
-                // has same shape as its hole
-                transformPadsShapesWithClearanceToPolygon( module->PadsList(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           true );
-
-                // Micro-wave modules may have items on copper layers
-                module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                        *layerPoly,
-                                                                        0,
-                                                                        segcountforcircle,
-                                                                        correctionFactor );
-
-                transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
-            }
-        }
-    }
+            // Aux Layers
+            Dwgs_User,
+            Cmts_User,
+            Eco1_User,
+            Eco2_User,
+            Edge_Cuts,
+            Margin
+        };
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T10: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    // User layers are not drawn here, only technical layers
+    std::vector< PCB_LAYER_ID > tech_layer_id;
 
-    // Add graphic item on copper layers to object containers
-    // /////////////////////////////////////////////////////////////////////////
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
+         seq;
+         ++seq )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
-
-        wxASSERT( m_layers_container2D.find( curr_layer_id ) != m_layers_container2D.end() );
-
-        CBVHCONTAINER2D *layerContainer = m_layers_container2D[curr_layer_id];
-
-        // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-        for( auto item : m_board->Drawings() )
-        {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
+        const PCB_LAYER_ID curr_layer_id = *seq;
 
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-            {
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            }
-            break;
+        if( !Is3DLayerEnabled( curr_layer_id ) )
+                    continue;
 
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+        tech_layer_id.push_back( curr_layer_id );
 
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-            break;
+        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
+        m_layers_container2D[curr_layer_id] = layerContainer;
 
-            default:
-                wxLogTrace( m_logTrace,
-                            wxT( "createLayers: item type: %d not implemented" ),
-                            item->Type() );
-            break;
-            }
-        }
+        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
+        m_layers_poly[curr_layer_id] = layerPoly;
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T11: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
-
-    // Add graphic item on copper layers to poly contourns
-    // /////////////////////////////////////////////////////////////////////////
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
-        {
-            const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+    const unsigned layersStartTime = GetRunningMicroSecs();
 
-            wxASSERT( m_layers_poly.find( curr_layer_id ) != m_layers_poly.end() );
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Create copper and tech layers" ) );
 
-            SHAPE_POLY_SET *layerPoly = m_layers_poly[curr_layer_id];
+    // Build the layers, and the BVH of their holes.  A layer only reads the board items
+    // and writes its own containers, so the copper layers, the tech layers and the BVH of
+    // the through holes are all built by independent tasks.
+    // /////////////////////////////////////////////////////////////////////////
+    const size_t nCopperTasks = layer_id.size();
+    const size_t nLayerTasks  = nCopperTasks + tech_layer_id.size();
 
-            // ADD GRAPHIC ITEMS ON COPPER LAYERS (texts)
-            for( auto item : m_board->Drawings() )
+    THREAD_POOL::GetPool().ParallelFor( nLayerTasks + 2,
+            [&]( size_t aTask )
             {
-                if( !item->IsOnLayer( curr_layer_id ) )
-                    continue;
-
-                switch( item->Type() )
-                {
-                case PCB_LINE_T:
-                {
-                    const int nrSegments =
-                            GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
-
-                    ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
-                                *layerPoly,
-                                0,
-                                nrSegments,
-                                GetCircleCorrectionFactor( nrSegments ) );
-                }
-                break;
-
-                case PCB_TEXT_T:
-                    ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet(
-                                *layerPoly,
-                                0,
-                                segcountforcircle,
-                                correctionFactor );
-                break;
-
-                default:
-                    wxLogTrace( m_logTrace,
-                                wxT( "createLayers: item type: %d not implemented" ),
-                                item->Type() );
-                break;
-                }
-            }
-        }
-    }
+                if( aTask < nCopperTasks )
+                    createCopperLayer( layer_id[aTask], trackList );
+                else if( aTask < nLayerTasks )
+                    createTechLayer( tech_layer_id[aTask - nCopperTasks] );
+                else if( aTask == nLayerTasks )
+                    m_through_holes_inner.BuildBVH();
+                else
+                    m_through_holes_outer.BuildBVH();
+            } );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T12: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    const unsigned zonesStartTime = GetRunningMicroSecs();
 
     if( GetFlag( FL_ZONE ) )
     {
@@ -791,434 +479,536 @@ void CINFO3D_VISU::createLayers( REPORTER *aStatusTextReporter )
 
         // Add zones objects
         // /////////////////////////////////////////////////////////////////////
-        std::atomic<size_t> nextZone( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
-
-        size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&]()
-            {
-                for( size_t areaId = nextZone.fetch_add( 1 );
-                            areaId < static_cast<size_t>( m_board->GetAreaCount() );
-                            areaId = nextZone.fetch_add( 1 ) )
+        THREAD_POOL::GetPool().ParallelFor( m_board->GetAreaCount(),
+                [&]( size_t areaId )
                 {
                     const ZONE_CONTAINER* zone = m_board->GetArea( areaId );
 
                     if( zone == nullptr )
-                        break;
+                        return;
 
                     auto layerContainer = m_layers_container2D.find( zone->GetLayer() );
 
-                    if( layerContainer != m_layers_container2D.end() )
+                    if( layerContainer != m_layers_container2D.end()
+                            && IsCopperLayer( zone->GetLayer() ) )
                         AddSolidAreasShapesToContainer( zone, layerContainer->second,
                                                         zone->GetLayer() );
-                }
+                } );
+    }
 
-                threadsFinished++;
-            } );
+    // Add the copper zones contours, and simplify the layer polygons
+    // /////////////////////////////////////////////////////////////////////////
 
-            t.detach();
-        }
+    if( aStatusTextReporter )
+        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    THREAD_POOL::GetPool().ParallelFor( layer_id.size(),
+            [&]( size_t i )
+            {
+                const PCB_LAYER_ID curr_layer_id = layer_id[i];
 
-    }
+                // Only with the OpenGL copper thickness
+                auto layerPoly = m_layers_poly.find( curr_layer_id );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "fill zones T13: %.3f ms\n", (float)( GetRunningMicroSecs()  - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+                if( layerPoly != m_layers_poly.end() )
+                {
+                    // ADD COPPER ZONES
+                    if( GetFlag( FL_ZONE ) )
+                    {
+                        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+                        {
+                            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+                            if( zone == nullptr )
+                                break;
+
+                            if( zone->GetLayer() == curr_layer_id )
+                                zone->TransformSolidAreasShapesToPolygonSet(
+                                        *layerPoly->second, segcountforcircle,
+                                        correctionFactor );
+                        }
+                    }
 
-    if( GetFlag( FL_ZONE ) &&
-        GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
-    {
-        // ADD COPPER ZONES
-        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-        {
-            const ZONE_CONTAINER* zone = m_board->GetArea( ii );
+                    // This will make a union of all added contours
+                    layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
+                }
 
-            if( zone == nullptr )
-                break;
+                // Simplify holes polygon contours
+                auto outerHolesPoly = m_layers_outer_holes_poly.find( curr_layer_id );
 
-            auto layerContainer = m_layers_poly.find( zone->GetLayer() );
+                if( outerHolesPoly != m_layers_outer_holes_poly.end() )
+                {
+                    outerHolesPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
 
-            if( layerContainer != m_layers_poly.end() )
-                zone->TransformSolidAreasShapesToPolygonSet( *layerContainer->second, segcountforcircle, correctionFactor );
-        }
-    }
+                    wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
+                              m_layers_inner_holes_poly.end() );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T14: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time  ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+                    m_layers_inner_holes_poly.find( curr_layer_id )->second->Simplify(
+                            SHAPE_POLY_SET::PM_FAST );
+                }
+            } );
 
-    // Simplify layer polygons
-    // /////////////////////////////////////////////////////////////////////////
+    // This will make a union of all added contourns
+    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
+    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
+    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplifying copper layers polygons" ) );
+    const unsigned endTime = GetRunningMicroSecs();
 
-    if( GetFlag( FL_RENDER_OPENGL_COPPER_THICKNESS ) &&
-        (m_render_engine == RENDER_ENGINE_OPENGL_LEGACY) )
+    if( aStatusTextReporter )
     {
-        std::atomic<size_t> nextItem( 0 );
-        std::atomic<size_t> threadsFinished( 0 );
+        aStatusTextReporter->Report( wxString::Format(
+                _( "Create layers time %.3f s (layers %.3f s, zones %.3f s)" ),
+                (double)( endTime - startTime ) / 1e6,
+                (double)( zonesStartTime - layersStartTime ) / 1e6,
+                (double)( endTime - zonesStartTime ) / 1e6 ) );
+    }
 
-        size_t parallelThreadCount = std::min<size_t>(
-                std::max<size_t>( std::thread::hardware_concurrency(), 2 ),
-                layer_id.size() );
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            std::thread t = std::thread( [&nextItem, &threadsFinished, &layer_id, this]()
-            {
-                for( size_t i = nextItem.fetch_add( 1 );
-                            i < layer_id.size();
-                            i = nextItem.fetch_add( 1 ) )
-                {
-                    auto layerPoly = m_layers_poly.find( layer_id[i] );
+#ifdef PRINT_STATISTICS_3D_VIEWER
+    printf( "CINFO3D_VISU::createLayers times\n" );
+    printf( "  Tracks and holes:       %.3f ms\n",
+            (float)( layersStartTime - startTime      ) / 1e3 );
+    printf( "  Layers and holes BVH:   %.3f ms\n",
+            (float)( zonesStartTime  - layersStartTime ) / 1e3 );
+    printf( "  Zones and polygons:     %.3f ms\n",
+            (float)( endTime         - zonesStartTime ) / 1e3 );
+    printf( "Statistics:\n" );
+    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
+    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
+    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
+    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
+    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
+    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
+    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
+#endif
+}
 
-                    if( layerPoly != m_layers_poly.end() )
-                        // This will make a union of all added contours
-                        layerPoly->second->Simplify( SHAPE_POLY_SET::PM_FAST );
-                }
 
-                threadsFinished++;
-            } );
+void CINFO3D_VISU::createCopperLayer( PCB_LAYER_ID aLayerId,
+                                      const std::vector< const TRACK *> &aTrackList )
+{
+    const double correctionFactor = GetCircleCorrectionFactor( segcountforcircle );
 
-            t.detach();
-        }
+    wxASSERT( m_layers_container2D.find( aLayerId ) != m_layers_container2D.end() );
 
-        while( threadsFinished < parallelThreadCount )
-            std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
-    }
+    CBVHCONTAINER2D *layerContainer = m_layers_container2D.find( aLayerId )->second;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T15: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-    start_Time = GetRunningMicroSecs();
-#endif
+    // Only with the OpenGL copper thickness
+    auto polyIt = m_layers_poly.find( aLayerId );
+    SHAPE_POLY_SET *layerPoly = ( polyIt != m_layers_poly.end() ) ? polyIt->second : NULL;
 
-    // Simplify holes polygon contours
-    // /////////////////////////////////////////////////////////////////////////
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Simplify holes contours" ) );
+    // Only if blind or buried vias cross the layer
+    auto holesIt = m_layers_holes2D.find( aLayerId );
+    CBVHCONTAINER2D *layerHoleContainer = NULL;
+    SHAPE_POLY_SET *layerOuterHolesPoly = NULL;
+    SHAPE_POLY_SET *layerInnerHolesPoly = NULL;
 
-    for( unsigned int lIdx = 0; lIdx < layer_id.size(); ++lIdx )
+    if( holesIt != m_layers_holes2D.end() )
     {
-        const PCB_LAYER_ID curr_layer_id = layer_id[lIdx];
+        layerHoleContainer = holesIt->second;
 
-        if( m_layers_outer_holes_poly.find( curr_layer_id ) !=
-            m_layers_outer_holes_poly.end() )
-        {
-            // found
-            SHAPE_POLY_SET *polyLayer = m_layers_outer_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
+        wxASSERT( m_layers_outer_holes_poly.find( aLayerId ) != m_layers_outer_holes_poly.end() );
+        wxASSERT( m_layers_inner_holes_poly.find( aLayerId ) != m_layers_inner_holes_poly.end() );
 
-            wxASSERT( m_layers_inner_holes_poly.find( curr_layer_id ) !=
-                      m_layers_inner_holes_poly.end() );
+        layerOuterHolesPoly = m_layers_outer_holes_poly.find( aLayerId )->second;
+        layerInnerHolesPoly = m_layers_inner_holes_poly.find( aLayerId )->second;
+    }
 
-            polyLayer = m_layers_inner_holes_poly[curr_layer_id];
-            polyLayer->Simplify( SHAPE_POLY_SET::PM_FAST );
-        }
+    // Create tracks as objects and add it to container
+    // /////////////////////////////////////////////////////////////////////////
+    for( const TRACK *track : aTrackList )
+    {
+        // NOTE: Vias can be on multiple layers
+        if( !track->IsOnLayer( aLayerId ) )
+            continue;
+
+        // Add object item to layer container
+        layerContainer->Add( createNewTrack( track, 0.0f ) );
     }
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    printf( "T16: %.3f ms\n", (float)( GetRunningMicroSecs() - start_Time ) / 1e3 );
-#endif
-    // End Build Copper layers
+    // Create the holes and the hole contours of the blind and buried vias
+    // /////////////////////////////////////////////////////////////////////////
+    if( layerHoleContainer )
+    {
+        for( const TRACK *track : aTrackList )
+        {
+            if( track->Type() != PCB_VIA_T || !track->IsOnLayer( aLayerId ) )
+                continue;
 
+            const VIA *via = static_cast< const VIA*>( track );
 
-    // This will make a union of all added contourns
-    m_through_inner_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_poly_NPTH.Simplify( SHAPE_POLY_SET::PM_FAST );
-    m_through_outer_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST );
-    //m_through_inner_holes_vias_poly.Simplify( SHAPE_POLY_SET::PM_FAST ); // Not in use
+            if( via->GetViaType() == VIA_THROUGH )
+                continue;
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endCopperLayersTime = GetRunningMicroSecs();
-#endif
+            const float holediameter = via->GetDrillValue() * BiuTo3Dunits();
+            const float thickness = GetCopperThickness3DU();
+            const float hole_inner_radius = ( holediameter / 2.0f );
 
-    // Build Tech layers
-    // Based on: https://github.com/KiCad/kicad-source-mirror/blob/master/3d-viewer/3d_draw.cpp#L1059
-    // /////////////////////////////////////////////////////////////////////////
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startTechLayersTime = GetRunningMicroSecs();
-#endif
+            const SFVEC2F via_center(  via->GetStart().x * m_biuTo3Dunits,
+                                      -via->GetStart().y * m_biuTo3Dunits );
 
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build Tech layers" ) );
+            // Add a hole for this layer
+            layerHoleContainer->Add( new CFILLEDCIRCLE2D( via_center,
+                                                          hole_inner_radius + thickness,
+                                                          *track ) );
 
-    // draw graphic items, on technical layers
-    static const PCB_LAYER_ID teckLayerList[] = {
-            B_Adhes,
-            F_Adhes,
-            B_Paste,
-            F_Paste,
-            B_SilkS,
-            F_SilkS,
-            B_Mask,
-            F_Mask,
+            const int hole_diameter = via->GetDrillValue();
+            const int hole_outer_radius = (hole_diameter / 2) + GetCopperThicknessBIU();
 
-            // Aux Layers
-            Dwgs_User,
-            Cmts_User,
-            Eco1_User,
-            Eco2_User,
-            Edge_Cuts,
-            Margin
-        };
+            TransformCircleToPolygon( *layerOuterHolesPoly,
+                                      via->GetStart(),
+                                      hole_outer_radius,
+                                      GetNrSegmentsCircle( hole_outer_radius * 2 ) );
 
-    // User layers are not drawn here, only technical layers
+            TransformCircleToPolygon( *layerInnerHolesPoly,
+                                      via->GetStart(),
+                                      hole_diameter / 2,
+                                      GetNrSegmentsCircle( hole_diameter ) );
+        }
+    }
 
-    for( LSEQ seq = LSET::AllNonCuMask().Seq( teckLayerList, arrayDim( teckLayerList ) );
-         seq;
-         ++seq )
+    // Creates outline contours of the tracks and add it to the poly of the layer
+    // /////////////////////////////////////////////////////////////////////////
+    if( layerPoly )
     {
-        const PCB_LAYER_ID curr_layer_id = *seq;
+        for( const TRACK *track : aTrackList )
+        {
+            if( !track->IsOnLayer( aLayerId ) )
+                continue;
 
-        if( !Is3DLayerEnabled( curr_layer_id ) )
-                    continue;
+            // Add the track contour
+            int nrSegments = GetNrSegmentsCircle( track->GetWidth() );
 
-        CBVHCONTAINER2D *layerContainer = new CBVHCONTAINER2D;
-        m_layers_container2D[curr_layer_id] = layerContainer;
+            track->TransformShapeWithClearanceToPolygon(
+                        *layerPoly,
+                        0,
+                        nrSegments,
+                        GetCircleCorrectionFactor( nrSegments ) );
+        }
+    }
 
-        SHAPE_POLY_SET *layerPoly = new SHAPE_POLY_SET;
-        m_layers_poly[curr_layer_id] = layerPoly;
+    // Add modules PADs objects to containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        // Note: NPTH pads are not drawn on copper layers when the pad
+        // has same shape as its hole
+        AddPadsShapesWithClearanceToContainer( module,
+                                               layerContainer,
+                                               aLayerId,
+                                               0,
+                                               true );
+
+        // Micro-wave modules may have items on copper layers
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   layerContainer,
+                                                   aLayerId,
+                                                   0 );
+    }
 
-        // Add drawing objects
-        // /////////////////////////////////////////////////////////////////////
-        for( auto item : m_board->Drawings() )
+    // Add modules PADs poly contourns
+    // /////////////////////////////////////////////////////////////////////////
+    if( layerPoly )
+    {
+        for( const MODULE* module = m_board->m_Modules; module; module = module->Next() )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
-                continue;
-
-            switch( item->Type() )
-            {
-            case PCB_LINE_T:
-                AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
+            // Note: NPTH pads are not drawn on copper layers when the pad
+            // has same shape as its hole
+            transformPadsShapesWithClearanceToPolygon( module->PadsList(),
+                                                       aLayerId,
+                                                       *layerPoly,
+                                                       0,
+                                                       true );
 
-            case PCB_TEXT_T:
-                AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
-
-            case PCB_DIMENSION_T:
-                AddShapeWithClearanceToContainer( (DIMENSION*) item,
-                                                  layerContainer,
-                                                  curr_layer_id,
-                                                  0 );
-                break;
+            // Micro-wave modules may have items on copper layers
+            module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId,
+                                                                    *layerPoly,
+                                                                    0,
+                                                                    segcountforcircle,
+                                                                    correctionFactor );
 
-            default:
-                break;
-            }
+            transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *layerPoly );
         }
+    }
 
+    // Add graphic item on copper layers to object containers
+    // /////////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-        // Add drawing contours
-        // /////////////////////////////////////////////////////////////////////
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+        {
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        }
+        break;
+
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+        break;
+
+        default:
+            wxLogTrace( m_logTrace,
+                        wxT( "createLayers: item type: %d not implemented" ),
+                        item->Type() );
+        break;
+        }
+    }
+
+    // Add graphic item on copper layers to poly contourns
+    // /////////////////////////////////////////////////////////////////////////
+    if( layerPoly )
+    {
         for( auto item : m_board->Drawings() )
         {
-            if( !item->IsOnLayer( curr_layer_id ) )
+            if( !item->IsOnLayer( aLayerId ) )
                 continue;
 
             switch( item->Type() )
             {
             case PCB_LINE_T:
             {
-                const unsigned int nr_segments =
+                const int nrSegments =
                         GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
 
-                ((DRAWSEGMENT*) item)->TransformShapeWithClearanceToPolygon( *layerPoly,
-                                                                             0,
-                                                                             nr_segments,
-                                                                             0.0 );
+                ( (DRAWSEGMENT*) item )->TransformShapeWithClearanceToPolygon(
+                            *layerPoly,
+                            0,
+                            nrSegments,
+                            GetCircleCorrectionFactor( nrSegments ) );
             }
-                break;
+            break;
 
             case PCB_TEXT_T:
-                ((TEXTE_PCB*) item)->TransformShapeWithClearanceToPolygonSet( *layerPoly,
-                                                                              0,
-                                                                              segcountInStrokeFont,
-                                                                              1.0 );
-                break;
+                ( (TEXTE_PCB*) item )->TransformShapeWithClearanceToPolygonSet(
+                            *layerPoly,
+                            0,
+                            segcountforcircle,
+                            correctionFactor );
+            break;
 
             default:
-                break;
+                wxLogTrace( m_logTrace,
+                            wxT( "createLayers: item type: %d not implemented" ),
+                            item->Type() );
+            break;
             }
         }
+    }
 
+    // The holes of the layer are complete
+    if( layerHoleContainer )
+        layerHoleContainer->BuildBVH();
+}
 
-        // Add modules tech layers - objects
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+
+void CINFO3D_VISU::createTechLayer( PCB_LAYER_ID aLayerId )
+{
+    const double correctionFactorStroke = GetCircleCorrectionFactor( segcountInStrokeFont );
+
+    wxASSERT( m_layers_container2D.find( aLayerId ) != m_layers_container2D.end() );
+    wxASSERT( m_layers_poly.find( aLayerId ) != m_layers_poly.end() );
+
+    CBVHCONTAINER2D *layerContainer = m_layers_container2D.find( aLayerId )->second;
+    SHAPE_POLY_SET *layerPoly = m_layers_poly.find( aLayerId )->second;
+
+    // Add drawing objects
+    // /////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
+
+        switch( item->Type() )
         {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                D_PAD*  pad = module->PadsList();
-                int     linewidth = g_DrawDefaultLineThickness;
+        case PCB_LINE_T:
+            AddShapeWithClearanceToContainer( (DRAWSEGMENT*)item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-                for( ; pad; pad = pad->Next() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+        case PCB_TEXT_T:
+            AddShapeWithClearanceToContainer( (TEXTE_PCB*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-                    buildPadShapeThickOutlineAsSegments( pad,
-                                                         layerContainer,
-                                                         linewidth );
-                }
-            }
-            else
-            {
-                AddPadsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0,
-                                                       false );
-            }
+        case PCB_DIMENSION_T:
+            AddShapeWithClearanceToContainer( (DIMENSION*) item,
+                                              layerContainer,
+                                              aLayerId,
+                                              0 );
+            break;
 
-            AddGraphicsShapesWithClearanceToContainer( module,
-                                                       layerContainer,
-                                                       curr_layer_id,
-                                                       0 );
+        default:
+            break;
         }
+    }
 
 
-        // Add modules tech layers - contours
-        // /////////////////////////////////////////////////////////////////////
-        for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
-        {
-            if( (curr_layer_id == F_SilkS) || (curr_layer_id == B_SilkS) )
-            {
-                D_PAD*  pad = module->PadsList();
-                const int linewidth = g_DrawDefaultLineThickness;
+    // Add drawing contours
+    // /////////////////////////////////////////////////////////////////////
+    for( auto item : m_board->Drawings() )
+    {
+        if( !item->IsOnLayer( aLayerId ) )
+            continue;
 
-                for( ; pad; pad = pad->Next() )
-                {
-                    if( !pad->IsOnLayer( curr_layer_id ) )
-                        continue;
+        switch( item->Type() )
+        {
+        case PCB_LINE_T:
+        {
+            const unsigned int nr_segments =
+                    GetNrSegmentsCircle( item->GetBoundingBox().GetSizeMax() );
 
-                    buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
-                }
-            }
-            else
-            {
-                transformPadsShapesWithClearanceToPolygon( module->PadsList(),
-                                                           curr_layer_id,
-                                                           *layerPoly,
-                                                           0,
-                                                           false );
-            }
+            ((DRAWSEGMENT*) item)->TransformShapeWithClearanceToPolygon( *layerPoly,
+                                                                         0,
+                                                                         nr_segments,
+                                                                         0.0 );
+        }
+            break;
 
-            // On tech layers, use a poor circle approximation, only for texts (stroke font)
-            module->TransformGraphicTextWithClearanceToPolygonSet( curr_layer_id,
-                                                                   *layerPoly,
-                                                                   0,
-                                                                   segcountInStrokeFont,
-                                                                   correctionFactorStroke,
-                                                                   segcountInStrokeFont );
+        case PCB_TEXT_T:
+            ((TEXTE_PCB*) item)->TransformShapeWithClearanceToPolygonSet( *layerPoly,
+                                                                          0,
+                                                                          segcountInStrokeFont,
+                                                                          1.0 );
+            break;
 
-            // Add the remaining things with dynamic seg count for circles
-            transformGraphicModuleEdgeToPolygonSet( module, curr_layer_id, *layerPoly );
+        default:
+            break;
         }
+    }
 
 
-        // Draw non copper zones
-        // /////////////////////////////////////////////////////////////////////
-        if( GetFlag( FL_ZONE ) )
+    // Add modules tech layers - objects
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
         {
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
+            D_PAD*  pad = module->PadsList();
+            int     linewidth = g_DrawDefaultLineThickness;
 
-                if( !zone->IsOnLayer( curr_layer_id ) )
+            for( ; pad; pad = pad->Next() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
                     continue;
 
-                AddSolidAreasShapesToContainer( zone,
-                                                layerContainer,
-                                                curr_layer_id );
+                buildPadShapeThickOutlineAsSegments( pad,
+                                                     layerContainer,
+                                                     linewidth );
             }
+        }
+        else
+        {
+            AddPadsShapesWithClearanceToContainer( module,
+                                                   layerContainer,
+                                                   aLayerId,
+                                                   0,
+                                                   false );
+        }
 
-            for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
-            {
-                ZONE_CONTAINER* zone = m_board->GetArea( ii );
+        AddGraphicsShapesWithClearanceToContainer( module,
+                                                   layerContainer,
+                                                   aLayerId,
+                                                   0 );
+    }
 
-                if( !zone->IsOnLayer( curr_layer_id ) )
+
+    // Add modules tech layers - contours
+    // /////////////////////////////////////////////////////////////////////
+    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
+    {
+        if( (aLayerId == F_SilkS) || (aLayerId == B_SilkS) )
+        {
+            D_PAD*  pad = module->PadsList();
+            const int linewidth = g_DrawDefaultLineThickness;
+
+            for( ; pad; pad = pad->Next() )
+            {
+                if( !pad->IsOnLayer( aLayerId ) )
                     continue;
 
-                zone->TransformSolidAreasShapesToPolygonSet( *layerPoly,
-                                                             // Use the same segcount as stroke font
-                                                             segcountInStrokeFont,
-                                                             correctionFactorStroke );
+                buildPadShapeThickOutlineAsPolygon( pad, *layerPoly, linewidth );
             }
         }
+        else
+        {
+            transformPadsShapesWithClearanceToPolygon( module->PadsList(),
+                                                       aLayerId,
+                                                       *layerPoly,
+                                                       0,
+                                                       false );
+        }
 
-        // This will make a union of all added contours
-        layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
-    }
-    // End Build Tech layers
+        // On tech layers, use a poor circle approximation, only for texts (stroke font)
+        module->TransformGraphicTextWithClearanceToPolygonSet( aLayerId,
+                                                               *layerPoly,
+                                                               0,
+                                                               segcountInStrokeFont,
+                                                               correctionFactorStroke,
+                                                               segcountInStrokeFont );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endTechLayersTime = GetRunningMicroSecs();
-#endif
+        // Add the remaining things with dynamic seg count for circles
+        transformGraphicModuleEdgeToPolygonSet( module, aLayerId, *layerPoly );
+    }
 
 
-    // Build BVH for holes and vias
-    // /////////////////////////////////////////////////////////////////////////
+    // Draw non copper zones
+    // /////////////////////////////////////////////////////////////////////
+    if( GetFlag( FL_ZONE ) )
+    {
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
+        {
+            ZONE_CONTAINER* zone = m_board->GetArea( ii );
 
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_startHolesBVHTime = GetRunningMicroSecs();
-#endif
-    if( aStatusTextReporter )
-        aStatusTextReporter->Report( _( "Build BVH for holes and vias" ) );
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
 
-    m_through_holes_inner.BuildBVH();
-    m_through_holes_outer.BuildBVH();
+            AddSolidAreasShapesToContainer( zone,
+                                            layerContainer,
+                                            aLayerId );
+        }
 
-    if( !m_layers_holes2D.empty() )
-    {
-        for( MAP_CONTAINER_2D::iterator ii = m_layers_holes2D.begin();
-             ii != m_layers_holes2D.end();
-             ++ii )
+        for( int ii = 0; ii < m_board->GetAreaCount(); ++ii )
         {
-            ((CBVHCONTAINER2D *)(ii->second))->BuildBVH();
+            ZONE_CONTAINER* zone = m_board->GetArea( ii );
+
+            if( !zone->IsOnLayer( aLayerId ) )
+                continue;
+
+            zone->TransformSolidAreasShapesToPolygonSet( *layerPoly,
+                                                         // Use the same segcount as stroke font
+                                                         segcountInStrokeFont,
+                                                         correctionFactorStroke );
         }
     }
 
+    // This will make a union of all added contours
+    layerPoly->Simplify( SHAPE_POLY_SET::PM_FAST );
+
     // We only need the Solder mask to initialize the BVH
     // because..?
-    if( (CBVHCONTAINER2D *)m_layers_container2D[B_Mask] )
-        ((CBVHCONTAINER2D *)m_layers_container2D[B_Mask])->BuildBVH();
-
-    if( (CBVHCONTAINER2D *)m_layers_container2D[F_Mask] )
-        ((CBVHCONTAINER2D *)m_layers_container2D[F_Mask])->BuildBVH();
-
-#ifdef PRINT_STATISTICS_3D_VIEWER
-    unsigned stats_endHolesBVHTime = GetRunningMicroSecs();
-
-    printf( "CINFO3D_VISU::createLayers times\n" );
-    printf( "  Copper Layers:          %.3f ms\n",
-            (float)( stats_endCopperLayersTime  - stats_startCopperLayersTime  ) / 1e3 );
-    printf( "  Holes BVH creation:     %.3f ms\n",
-            (float)( stats_endHolesBVHTime      - stats_startHolesBVHTime      ) / 1e3 );
-    printf( "  Tech Layers:            %.3f ms\n",
-            (float)( stats_endTechLayersTime    - stats_startTechLayersTime    ) / 1e3 );
-    printf( "Statistics:\n" );
-    printf( "  m_stats_nr_tracks                   %u\n", m_stats_nr_tracks );
-    printf( "  m_stats_nr_vias                     %u\n", m_stats_nr_vias );
-    printf( "  m_stats_nr_holes                    %u\n", m_stats_nr_holes );
-    printf( "  m_stats_via_med_hole_diameter (3DU) %f\n", m_stats_via_med_hole_diameter );
-    printf( "  m_stats_hole_med_diameter     (3DU) %f\n", m_stats_hole_med_diameter );
-    printf( "  m_calc_seg_min_factor3DU      (3DU) %f\n", m_calc_seg_min_factor3DU );
-    printf( "  m_calc_seg_max_factor3DU      (3DU) %f\n", m_calc_seg_max_factor3DU );
-#endif
+    if( (aLayerId == B_Mask) || (aLayerId == F_Mask) )
+        layerContainer->BuildBVH();
 }
@@ -38,7 +38,8 @@
 
 
 // set the initial seed to whatever you like
-static int s_randSeed = 1;
+// The seeds are per thread: the renderers call these functions from several threads
+static thread_local unsigned int s_randSeed = 1;
 
 // fast rand float, using full 32bit precision
 // returns in the range [-1, 1] (not confirmed)
@@ -46,14 +47,14 @@ float Fast_RandFloat()
 {
     s_randSeed *= 16807;
 
-    return (float)s_randSeed * 4.6566129e-010f;
+    return (float)(int)s_randSeed * 4.6566129e-010f;
 }
 
 
 // Fast rand, as described here:
 // http://wiki.osdev.org/Random_Number_Generator
 
-static unsigned long int s_nextRandSeed = 1;
+static thread_local unsigned long int s_nextRandSeed = 1;
 
 int Fast_rand( void ) // RAND_MAX assumed to be 32767
 {
@@ -65,4 +66,7 @@ int Fast_rand( void ) // RAND_MAX assumed to be 32767
 void Fast_srand( unsigned int seed )
 {
     s_nextRandSeed = seed;
+
+    // Fast_RandFloat() is a multiplicative generator, a zero seed would stay zero
+    s_randSeed = seed ? seed : 1;
 }
@@ -49,10 +49,13 @@
 
 // Fast Float Random Numbers
 // a small and fast implementation for random float numbers in the range [-1,1]
-// This is not thread safe
+// The generators are per thread: a sequence seeded with Fast_srand() on a thread is
+// reproducible, whatever the other threads do
 float Fast_RandFloat();
 
 int Fast_rand( void );
+
+/// Seed both Fast_rand() and Fast_RandFloat() of the calling thread
 void Fast_srand( unsigned int seed );
 
 /**
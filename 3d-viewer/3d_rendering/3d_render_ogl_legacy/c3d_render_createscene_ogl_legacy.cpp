@@ -909,6 +909,25 @@ void C3D_RENDER_OGL_LEGACY::load_3D_models( REPORTER *aStatusTextReporter )
         (!m_settings.GetFlag( FL_MODULE_ATTRIBUTES_VIRTUAL )) )
         return;
 
+    // Load the models of all the modules in parallel first
+    std::vector<wxString> modelFiles;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module; module = module->Next() )
+    {
+        for( const MODULE_3D_SETTINGS& model : module->Models() )
+        {
+            if( !model.m_Filename.empty()
+                    && m_3dmodel_map.find( model.m_Filename ) == m_3dmodel_map.end() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    if( aStatusTextReporter && !modelFiles.empty() )
+        aStatusTextReporter->Report( _( "Loading 3D models" ) );
+
+    m_settings.Get3DCacheManager()->LoadModels( modelFiles );
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module; module = module->Next() )
@@ -28,6 +28,7 @@
  */
 
 #include "cbvh_pbrt.h"
+#include "../raypacket_simd.h"
 #include <wx/debug.h>
 
 
@@ -109,11 +110,30 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
     unsigned int ia = 0;
 
+    // With the vectorised tests, the boxes are tested on all the rays at once and the
+    // distances of the current hits are kept in an array for them
+    const bool useSimd = RAYPACKET_GetSimd() != RAYPACKET_SIMD_NONE;
+    float tHit[RAYPACKET_RAYS_PER_PACKET];
+
+    if( useSimd )
+        for( unsigned int i = 0; i < RAYPACKET_RAYS_PER_PACKET; ++i )
+            tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+
     while( true )
     {
         const LinearBVHNode *curCell = &m_nodes[nodeNum];
 
-        ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
+        uint64_t boxHits = 0;
+
+        if( useSimd )
+        {
+            if( aRayPacket.m_Frustum.Intersect( curCell->bounds ) )
+                boxHits = RAYPACKET_IntersectBBox( aRayPacket, curCell->bounds, ia, tHit );
+
+            ia = boxHits ? RAYPACKET_FirstRay( boxHits ) : RAYPACKET_RAYS_PER_PACKET;
+        }
+        else
+            ia = getFirstHit( aRayPacket, curCell->bounds, ia, aHitInfoPacket );
 
         if( ia < RAYPACKET_RAYS_PER_PACKET )
         {
@@ -127,10 +147,11 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
             }
             else
             {
-                const unsigned int ie = getLastHit( aRayPacket,
-                                                    curCell->bounds,
-                                                    ia,
-                                                    aHitInfoPacket );
+                const unsigned int ie = useSimd ? RAYPACKET_LastRay( boxHits ) + 1 :
+                                                  getLastHit( aRayPacket,
+                                                              curCell->bounds,
+                                                              ia,
+                                                              aHitInfoPacket );
 
                 for( int j = 0; j < curCell->nPrimitives; ++j )
                 {
@@ -138,20 +159,25 @@ bool CBVH_PBRT::Intersect( const RAYPACKET &aRayPacket,
 
                     if( aRayPacket.m_Frustum.Intersect( obj->GetBBox() ) )
                     {
-                        for( unsigned int i = ia; i < ie; ++i )
+                        uint64_t hits = obj->IntersectPacket( aRayPacket, ia, ie,
+                                                              aHitInfoPacket );
+
+                        if( hits )
+                            anyHitted = true;
+
+                        for( ; hits; hits &= hits - 1 )
                         {
-                            const bool hitted = obj->Intersect( aRayPacket.m_ray[i],
-                                                                aHitInfoPacket[i].m_HitInfo );
+                            const unsigned int i = RAYPACKET_FirstRay( hits );
 
-                            if( hitted )
-                            {
-                                anyHitted |= hitted;
-                                aHitInfoPacket[i].m_hitresult |= hitted;
-                                aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
-                            }
+                            aHitInfoPacket[i].m_hitresult = true;
+                            aHitInfoPacket[i].m_HitInfo.m_acc_node_info = nodeNum;
                         }
                     }
                 }
+
+                if( useSimd )
+                    for( unsigned int i = ia; i < ie; ++i )
+                        tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
             }
         }
 
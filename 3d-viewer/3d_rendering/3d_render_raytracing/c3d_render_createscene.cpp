@@ -1198,6 +1198,26 @@ void C3D_RENDER_RAYTRACING::add_3D_vias_and_pads_to_container()
 
 void C3D_RENDER_RAYTRACING::load_3D_models()
 {
+    // Headless renders may have no model cache, and then render the bare board
+    if( !m_settings.Get3DCacheManager() )
+        return;
+
+    // Load the models of all the displayed modules in parallel first
+    std::vector<wxString> modelFiles;
+
+    for( const MODULE* module = m_settings.GetBoard()->m_Modules;
+         module;
+         module = module->Next() )
+    {
+        if( m_settings.ShouldModuleBeDisplayed( (MODULE_ATTR_T)module->GetAttributes() ) )
+        {
+            for( const MODULE_3D_SETTINGS& model : module->Models() )
+                modelFiles.push_back( model.m_Filename );
+        }
+    }
+
+    m_settings.Get3DCacheManager()->LoadModels( modelFiles );
+
     // Go for all modules
     for( const MODULE* module = m_settings.GetBoard()->m_Modules;
          module;
@@ -164,6 +164,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         // revert to preview mode the first time the Redraw is called
         m_oldWindowsSize = m_windowSize;
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
     wxBusyCursor dummy;
@@ -190,6 +191,7 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
         requestRedraw = true;
 
         initialize_block_positions();
+        opengl_init_pbo();
     }
 
 
@@ -297,6 +299,74 @@ bool C3D_RENDER_RAYTRACING::Redraw( bool aIsMoving, REPORTER *aStatusTextReporte
 }
 
 
+void C3D_RENDER_RAYTRACING::RenderToImage( const wxSize &aSize,
+                                           wxImage &aImage,
+                                           REPORTER *aStatusTextReporter )
+{
+    wxASSERT( aSize.x > 0 && aSize.y > 0 );
+
+    // The blocks must cover the whole image (there are no margins to fill with the
+    // background as on the canvas), so render a size multiple of the block size and
+    // crop it in the middle
+    const wxSize renderSize( ( aSize.x + RAYPACKET_DIM - 1 ) & RAYPACKET_INVMASK,
+                             ( aSize.y + RAYPACKET_DIM - 1 ) & RAYPACKET_INVMASK );
+
+    m_windowSize = renderSize;
+    m_settings.CameraGet().SetCurWindowSize( renderSize );
+
+    // Make the next Redraw() rebuild the blocks of its window
+    m_oldWindowsSize = wxSize( 0, 0 );
+
+    if( m_reloadRequested )
+    {
+        if( aStatusTextReporter )
+            aStatusTextReporter->Report( _( "Loading..." ) );
+
+        reload( aStatusTextReporter );
+    }
+
+    m_blockPositionsFast.clear();
+    m_realBufferSize = SFVEC2UI( renderSize.x, renderSize.y );
+    m_fastPreviewModeSize = m_realBufferSize;
+    m_xoffset = 0;
+    m_yoffset = 0;
+
+    initialize_render_buffers();
+
+    // Same layout as the PBO: RGBA, bottom row first
+    std::vector<GLubyte> buffer( m_realBufferSize.x * m_realBufferSize.y * 4 );
+
+    // Set to an invalid state, so it will restart from the first block
+    m_rt_render_state = RT_RENDER_STATE_MAX;
+
+    do
+    {
+        render( buffer.data(), aStatusTextReporter );
+    }
+    while( m_rt_render_state != RT_RENDER_STATE_FINISH );
+
+    const int xCrop = ( renderSize.x - aSize.x ) / 2;
+    const int yCrop = ( renderSize.y - aSize.y ) / 2;
+
+    aImage.Create( aSize.x, aSize.y, false );
+
+    unsigned char *dst = aImage.GetData();
+
+    for( int y = 0; y < aSize.y; ++y )
+    {
+        const GLubyte *src = &buffer[ ( ( yCrop + aSize.y - 1 - y ) * renderSize.x + xCrop ) * 4 ];
+
+        for( int x = 0; x < aSize.x; ++x )
+        {
+            *dst++ = src[0];
+            *dst++ = src[1];
+            *dst++ = src[2];
+            src += 4;
+        }
+    }
+}
+
+
 void C3D_RENDER_RAYTRACING::render( GLubyte *ptrPBO , REPORTER *aStatusTextReporter )
 {
     if( (m_rt_render_state == RT_RENDER_STATE_FINISH) ||
@@ -657,6 +727,10 @@ void C3D_RENDER_RAYTRACING::rt_trace_AA_packet( const SFVEC3F *aBgColorY,
 void C3D_RENDER_RAYTRACING::rt_render_trace_block( GLubyte *ptrPBO ,
                                                    signed int iBlock )
 {
+    // Seed the random displacements by block, so a render does not depend on which
+    // thread traced which block
+    Fast_srand( iBlock + 1 );
+
     // Initialize ray packets
     // /////////////////////////////////////////////////////////////////////////
     const SFVEC2UI &blockPos = m_blockPositions[iBlock];
@@ -935,6 +1009,9 @@ void C3D_RENDER_RAYTRACING::rt_render_post_process_shade( GLubyte *ptrPBO,
                 {
                     SFVEC3F *ptr = &m_shaderBuffer[ y * m_realBufferSize.x ];
 
+                    // The shader samples randomly too
+                    Fast_srand( y + 1 );
+
                     for( signed int x = 0; x < (int)m_realBufferSize.x; ++x )
                     {
                         *ptr = m_postshader_ssao.Shade( SFVEC2I( x, y ) );
@@ -2120,6 +2197,12 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     m_xoffset = (m_windowSize.x - m_realBufferSize.x) / 2;
     m_yoffset = (m_windowSize.y - m_realBufferSize.y) / 2;
 
+    initialize_render_buffers();
+}
+
+
+void C3D_RENDER_RAYTRACING::initialize_render_buffers()
+{
     m_postshader_ssao.UpdateSize( m_realBufferSize );
 
 
@@ -2129,7 +2212,7 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     m_blockPositions.reserve( (m_realBufferSize.x / RAYPACKET_DIM) *
                               (m_realBufferSize.y / RAYPACKET_DIM) );
 
-    i = 0;
+    unsigned int i = 0;
 
     while(1)
     {
@@ -2147,6 +2230,4 @@ void C3D_RENDER_RAYTRACING::initialize_block_positions()
     // Create m_shader buffer
     delete[] m_shaderBuffer;
     m_shaderBuffer = new SFVEC3F[m_realBufferSize.x * m_realBufferSize.y];
-
-    opengl_init_pbo();
 }
@@ -40,6 +40,7 @@
 #include <plugins/3dapi/c3dmodel.h>
 
 #include <map>
+#include <wx/image.h>
 
 /// Vector of materials
 typedef std::vector< CBLINN_PHONG_MATERIAL > MODEL_MATERIALS;
@@ -69,6 +70,17 @@ public:
 
     int GetWaitForEditingTimeOut() override;
 
+    /**
+     * Render the board at the current camera to an image, without OpenGL: the blocks are
+     * traced until the render (and its post processing) is complete.  The result depends
+     * only on the board, the settings and the camera, not on the number of threads.
+     *
+     * @param aSize is the size of the image in pixels.
+     * @param aImage receives the rendered image.
+     * @param aStatusTextReporter reports the progress, may be NULL.
+     */
+    void RenderToImage( const wxSize &aSize, wxImage &aImage, REPORTER *aStatusTextReporter );
+
 private:
     bool initializeOpenGL();
     void initializeNewWindowSize();
@@ -202,6 +214,7 @@ private:
     MAP_MODEL_MATERIALS m_model_materials;
 
     void initialize_block_positions();
+    void initialize_render_buffers();
 
     void render( GLubyte *ptrPBO, REPORTER *aStatusTextReporter );
     void render_preview( GLubyte *ptrPBO );
@@ -45,6 +45,12 @@ struct RAYPACKET
     CFRUSTUM    m_Frustum;
     RAY         m_ray[RAYPACKET_RAYS_PER_PACKET];
 
+    /// Coordinates of the rays, as one array per axis for the vectorised tests
+    /// (see raypacket_simd.h)
+    float       m_OriginSoA[3][RAYPACKET_RAYS_PER_PACKET];
+    float       m_DirSoA[3][RAYPACKET_RAYS_PER_PACKET];
+    float       m_InvDirSoA[3][RAYPACKET_RAYS_PER_PACKET];
+
     RAYPACKET( const CCAMERA &aCamera,
                const SFVEC2I &aWindowsPosition );
 
@@ -62,6 +68,9 @@ struct RAYPACKET
     RAYPACKET( const CCAMERA &aCamera,
                const SFVEC2F &aWindowsPosition,
                const SFVEC2F &a2DWindowsPosDisplacementFactor );
+
+private:
+    void initArrays();
 };
 
 void RAYPACKET_InitRays( const CCAMERA &aCamera,
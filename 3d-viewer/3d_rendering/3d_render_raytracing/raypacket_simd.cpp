@@ -0,0 +1,432 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.cpp
+ * @brief Vectorised tests of the rays of a packet against boxes and triangles
+ */
+
+#include "raypacket_simd.h"
+#include "shapes3D/cbbox.h"
+
+#include <atomic>
+#include <limits>
+#include <wx/debug.h>
+
+#if defined( __x86_64__ ) || defined( _M_X64 ) || defined( __i386__ ) || defined( _M_IX86 )
+#define RAYPACKET_SIMD_X86
+#include <immintrin.h>
+
+#if defined( _MSC_VER )
+#include <intrin.h>
+// MSVC compiles the intrinsics of any instruction set without options
+#define TARGET_SSE
+#define TARGET_AVX
+#else
+#define TARGET_SSE __attribute__(( target( "sse2" ) ))
+#define TARGET_AVX __attribute__(( target( "avx" ) ))
+#endif
+#endif
+
+
+static RAYPACKET_SIMD detectSimd()
+{
+#if !defined( RAYPACKET_SIMD_X86 )
+    return RAYPACKET_SIMD_NONE;
+#elif defined( _MSC_VER )
+    int info[4];
+    __cpuid( info, 1 );
+
+    const bool sse2    = ( info[3] & ( 1 << 26 ) ) != 0;
+    const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+    const bool avx     = ( info[2] & ( 1 << 28 ) ) != 0;
+
+    // AVX also needs the system to save the YMM registers
+    if( sse2 && osxsave && avx && ( _xgetbv( 0 ) & 6 ) == 6 )
+        return RAYPACKET_SIMD_AVX;
+
+    return sse2 ? RAYPACKET_SIMD_SSE : RAYPACKET_SIMD_NONE;
+#else
+    __builtin_cpu_init();
+
+    // The avx feature is only reported when the system saves the YMM registers
+    if( __builtin_cpu_supports( "avx" ) )
+        return RAYPACKET_SIMD_AVX;
+
+    return __builtin_cpu_supports( "sse2" ) ? RAYPACKET_SIMD_SSE : RAYPACKET_SIMD_NONE;
+#endif
+}
+
+
+static RAYPACKET_SIMD supportedSimd()
+{
+    static const RAYPACKET_SIMD s_supported = detectSimd();
+
+    return s_supported;
+}
+
+
+static std::atomic<int> s_simd( -1 );
+
+
+RAYPACKET_SIMD RAYPACKET_GetSimd()
+{
+    int simd = s_simd.load( std::memory_order_relaxed );
+
+    if( simd < 0 )
+    {
+        simd = supportedSimd();
+        s_simd.store( simd, std::memory_order_relaxed );
+    }
+
+    return (RAYPACKET_SIMD) simd;
+}
+
+
+RAYPACKET_SIMD RAYPACKET_SetSimd( RAYPACKET_SIMD aSimd )
+{
+    if( aSimd > supportedSimd() )
+        aSimd = supportedSimd();
+
+    s_simd.store( aSimd, std::memory_order_relaxed );
+
+    return aSimd;
+}
+
+
+/// @return the mask of the rays of [aFirst, aLast)
+static inline uint64_t rayRange( unsigned int aFirst, unsigned int aLast )
+{
+    const uint64_t belowLast = ( aLast >= 64 ) ? ~(uint64_t) 0 : ( ( (uint64_t) 1 << aLast ) - 1 );
+
+    return belowLast & ( ~(uint64_t) 0 << aFirst );
+}
+
+
+#if defined( RAYPACKET_SIMD_X86 )
+
+// Slab test.  A ray parallel to an axis gets an infinite inverse direction, and a NaN
+// distance if its origin is on a side of the box: min and max return their second operand
+// for NaN, so such an axis leaves the range unchanged.
+
+TARGET_SSE static uint64_t intersectBBoxSSE( const RAYPACKET &aRayPacket,
+                                             const CBBOX &aBBox,
+                                             unsigned int aFirst,
+                                             const float *aTHit )
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 inf  = _mm_set1_ps( std::numeric_limits<float>::infinity() );
+
+    __m128 boxMin[3], boxMax[3];
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        boxMin[axis] = _mm_set1_ps( aBBox.Min()[axis] );
+        boxMax[axis] = _mm_set1_ps( aBBox.Max()[axis] );
+    }
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < RAYPACKET_RAYS_PER_PACKET; i += 4 )
+    {
+        __m128 tNear = _mm_sub_ps( zero, inf );
+        __m128 tFar  = inf;
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m128 origin = _mm_loadu_ps( &aRayPacket.m_OriginSoA[axis][i] );
+            const __m128 invDir = _mm_loadu_ps( &aRayPacket.m_InvDirSoA[axis][i] );
+
+            const __m128 t0 = _mm_mul_ps( _mm_sub_ps( boxMin[axis], origin ), invDir );
+            const __m128 t1 = _mm_mul_ps( _mm_sub_ps( boxMax[axis], origin ), invDir );
+
+            tNear = _mm_max_ps( _mm_min_ps( t0, t1 ), tNear );
+            tFar  = _mm_min_ps( _mm_max_ps( t0, t1 ), tFar );
+        }
+
+        __m128 hit = _mm_and_ps( _mm_cmpge_ps( tFar, tNear ), _mm_cmpge_ps( tFar, zero ) );
+        hit = _mm_and_ps( hit, _mm_cmplt_ps( tNear, _mm_loadu_ps( &aTHit[i] ) ) );
+
+        mask |= (uint64_t) _mm_movemask_ps( hit ) << i;
+    }
+
+    return mask & rayRange( aFirst, RAYPACKET_RAYS_PER_PACKET );
+}
+
+
+TARGET_AVX static uint64_t intersectBBoxAVX( const RAYPACKET &aRayPacket,
+                                             const CBBOX &aBBox,
+                                             unsigned int aFirst,
+                                             const float *aTHit )
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 inf  = _mm256_set1_ps( std::numeric_limits<float>::infinity() );
+
+    __m256 boxMin[3], boxMax[3];
+
+    for( unsigned int axis = 0; axis < 3; ++axis )
+    {
+        boxMin[axis] = _mm256_set1_ps( aBBox.Min()[axis] );
+        boxMax[axis] = _mm256_set1_ps( aBBox.Max()[axis] );
+    }
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < RAYPACKET_RAYS_PER_PACKET; i += 8 )
+    {
+        __m256 tNear = _mm256_sub_ps( zero, inf );
+        __m256 tFar  = inf;
+
+        for( unsigned int axis = 0; axis < 3; ++axis )
+        {
+            const __m256 origin = _mm256_loadu_ps( &aRayPacket.m_OriginSoA[axis][i] );
+            const __m256 invDir = _mm256_loadu_ps( &aRayPacket.m_InvDirSoA[axis][i] );
+
+            const __m256 t0 = _mm256_mul_ps( _mm256_sub_ps( boxMin[axis], origin ), invDir );
+            const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( boxMax[axis], origin ), invDir );
+
+            tNear = _mm256_max_ps( _mm256_min_ps( t0, t1 ), tNear );
+            tFar  = _mm256_min_ps( _mm256_max_ps( t0, t1 ), tFar );
+        }
+
+        __m256 hit = _mm256_and_ps( _mm256_cmp_ps( tFar, tNear, _CMP_GE_OQ ),
+                                    _mm256_cmp_ps( tFar, zero, _CMP_GE_OQ ) );
+        hit = _mm256_and_ps( hit, _mm256_cmp_ps( tNear, _mm256_loadu_ps( &aTHit[i] ),
+                                                 _CMP_LT_OQ ) );
+
+        mask |= (uint64_t) _mm256_movemask_ps( hit ) << i;
+    }
+
+    return mask & rayRange( aFirst, RAYPACKET_RAYS_PER_PACKET );
+}
+
+
+// The triangle tests do the operations of CTRIANGLE::Intersect() in the same order, without
+// fused multiply-adds, so they give the same results.  The rejections written there as
+// "if( x < 0 ) return false" keep NaNs, hence the "not less than" comparisons.
+
+TARGET_SSE static uint64_t intersectTriangleSSE( const RAYPACKET &aRayPacket,
+                                                 const RAYPACKET_TRIANGLE &aTri,
+                                                 unsigned int aFirst,
+                                                 unsigned int aLast,
+                                                 const float *aTHit,
+                                                 float *aOutT,
+                                                 float *aOutU,
+                                                 float *aOutV )
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one  = _mm_set1_ps( 1.0f );
+    const __m128 nu   = _mm_set1_ps( aTri.nu );
+    const __m128 nv   = _mm_set1_ps( aTri.nv );
+    const __m128 nd   = _mm_set1_ps( aTri.nd );
+    const __m128 au   = _mm_set1_ps( aTri.au );
+    const __m128 av   = _mm_set1_ps( aTri.av );
+    const __m128 bnu  = _mm_set1_ps( aTri.bnu );
+    const __m128 bnv  = _mm_set1_ps( aTri.bnv );
+    const __m128 cnu  = _mm_set1_ps( aTri.cnu );
+    const __m128 cnv  = _mm_set1_ps( aTri.cnv );
+    const __m128 nx   = _mm_set1_ps( aTri.nx );
+    const __m128 ny   = _mm_set1_ps( aTri.ny );
+    const __m128 nz   = _mm_set1_ps( aTri.nz );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~3u; i < aLast; i += 4 )
+    {
+        const __m128 dk  = _mm_loadu_ps( &aRayPacket.m_DirSoA[aTri.k][i] );
+        const __m128 dku = _mm_loadu_ps( &aRayPacket.m_DirSoA[aTri.ku][i] );
+        const __m128 dkv = _mm_loadu_ps( &aRayPacket.m_DirSoA[aTri.kv][i] );
+        const __m128 ok  = _mm_loadu_ps( &aRayPacket.m_OriginSoA[aTri.k][i] );
+        const __m128 oku = _mm_loadu_ps( &aRayPacket.m_OriginSoA[aTri.ku][i] );
+        const __m128 okv = _mm_loadu_ps( &aRayPacket.m_OriginSoA[aTri.kv][i] );
+
+        const __m128 lnd = _mm_div_ps( one, _mm_add_ps( _mm_add_ps( dk, _mm_mul_ps( nu, dku ) ),
+                                                        _mm_mul_ps( nv, dkv ) ) );
+        const __m128 t = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( _mm_sub_ps( nd, ok ),
+                                                             _mm_mul_ps( nu, oku ) ),
+                                                 _mm_mul_ps( nv, okv ) ),
+                                     lnd );
+
+        __m128 valid = _mm_and_ps( _mm_cmpgt_ps( _mm_loadu_ps( &aTHit[i] ), t ),
+                                   _mm_cmpgt_ps( t, zero ) );
+
+        const __m128 hu = _mm_sub_ps( _mm_add_ps( oku, _mm_mul_ps( t, dku ) ), au );
+        const __m128 hv = _mm_sub_ps( _mm_add_ps( okv, _mm_mul_ps( t, dkv ) ), av );
+        const __m128 beta  = _mm_add_ps( _mm_mul_ps( hv, bnu ), _mm_mul_ps( hu, bnv ) );
+        const __m128 gamma = _mm_add_ps( _mm_mul_ps( hu, cnu ), _mm_mul_ps( hv, cnv ) );
+
+        valid = _mm_and_ps( valid, _mm_cmpnlt_ps( beta, zero ) );
+        valid = _mm_and_ps( valid, _mm_cmpnlt_ps( gamma, zero ) );
+        valid = _mm_and_ps( valid, _mm_cmpngt_ps( _mm_add_ps( beta, gamma ), one ) );
+
+        // Back faces
+        const __m128 dx = _mm_loadu_ps( &aRayPacket.m_DirSoA[0][i] );
+        const __m128 dy = _mm_loadu_ps( &aRayPacket.m_DirSoA[1][i] );
+        const __m128 dz = _mm_loadu_ps( &aRayPacket.m_DirSoA[2][i] );
+        const __m128 dot = _mm_add_ps( _mm_add_ps( _mm_mul_ps( dx, nx ), _mm_mul_ps( dy, ny ) ),
+                                       _mm_mul_ps( dz, nz ) );
+
+        valid = _mm_and_ps( valid, _mm_cmpngt_ps( dot, zero ) );
+
+        const int lanes = _mm_movemask_ps( valid );
+
+        if( lanes )
+        {
+            _mm_storeu_ps( &aOutT[i], t );
+            _mm_storeu_ps( &aOutU[i], beta );
+            _mm_storeu_ps( &aOutV[i], gamma );
+
+            mask |= (uint64_t) lanes << i;
+        }
+    }
+
+    return mask & rayRange( aFirst, aLast );
+}
+
+
+TARGET_AVX static uint64_t intersectTriangleAVX( const RAYPACKET &aRayPacket,
+                                                 const RAYPACKET_TRIANGLE &aTri,
+                                                 unsigned int aFirst,
+                                                 unsigned int aLast,
+                                                 const float *aTHit,
+                                                 float *aOutT,
+                                                 float *aOutU,
+                                                 float *aOutV )
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one  = _mm256_set1_ps( 1.0f );
+    const __m256 nu   = _mm256_set1_ps( aTri.nu );
+    const __m256 nv   = _mm256_set1_ps( aTri.nv );
+    const __m256 nd   = _mm256_set1_ps( aTri.nd );
+    const __m256 au   = _mm256_set1_ps( aTri.au );
+    const __m256 av   = _mm256_set1_ps( aTri.av );
+    const __m256 bnu  = _mm256_set1_ps( aTri.bnu );
+    const __m256 bnv  = _mm256_set1_ps( aTri.bnv );
+    const __m256 cnu  = _mm256_set1_ps( aTri.cnu );
+    const __m256 cnv  = _mm256_set1_ps( aTri.cnv );
+    const __m256 nx   = _mm256_set1_ps( aTri.nx );
+    const __m256 ny   = _mm256_set1_ps( aTri.ny );
+    const __m256 nz   = _mm256_set1_ps( aTri.nz );
+
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst & ~7u; i < aLast; i += 8 )
+    {
+        const __m256 dk  = _mm256_loadu_ps( &aRayPacket.m_DirSoA[aTri.k][i] );
+        const __m256 dku = _mm256_loadu_ps( &aRayPacket.m_DirSoA[aTri.ku][i] );
+        const __m256 dkv = _mm256_loadu_ps( &aRayPacket.m_DirSoA[aTri.kv][i] );
+        const __m256 ok  = _mm256_loadu_ps( &aRayPacket.m_OriginSoA[aTri.k][i] );
+        const __m256 oku = _mm256_loadu_ps( &aRayPacket.m_OriginSoA[aTri.ku][i] );
+        const __m256 okv = _mm256_loadu_ps( &aRayPacket.m_OriginSoA[aTri.kv][i] );
+
+        const __m256 lnd = _mm256_div_ps( one,
+                                          _mm256_add_ps( _mm256_add_ps( dk,
+                                                                        _mm256_mul_ps( nu, dku ) ),
+                                                         _mm256_mul_ps( nv, dkv ) ) );
+        const __m256 t = _mm256_mul_ps(
+                _mm256_sub_ps( _mm256_sub_ps( _mm256_sub_ps( nd, ok ), _mm256_mul_ps( nu, oku ) ),
+                               _mm256_mul_ps( nv, okv ) ),
+                lnd );
+
+        __m256 valid = _mm256_and_ps(
+                _mm256_cmp_ps( _mm256_loadu_ps( &aTHit[i] ), t, _CMP_GT_OQ ),
+                _mm256_cmp_ps( t, zero, _CMP_GT_OQ ) );
+
+        const __m256 hu = _mm256_sub_ps( _mm256_add_ps( oku, _mm256_mul_ps( t, dku ) ), au );
+        const __m256 hv = _mm256_sub_ps( _mm256_add_ps( okv, _mm256_mul_ps( t, dkv ) ), av );
+        const __m256 beta  = _mm256_add_ps( _mm256_mul_ps( hv, bnu ), _mm256_mul_ps( hu, bnv ) );
+        const __m256 gamma = _mm256_add_ps( _mm256_mul_ps( hu, cnu ), _mm256_mul_ps( hv, cnv ) );
+
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( beta, zero, _CMP_NLT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( gamma, zero, _CMP_NLT_UQ ) );
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( _mm256_add_ps( beta, gamma ), one,
+                                                     _CMP_NGT_UQ ) );
+
+        // Back faces
+        const __m256 dx = _mm256_loadu_ps( &aRayPacket.m_DirSoA[0][i] );
+        const __m256 dy = _mm256_loadu_ps( &aRayPacket.m_DirSoA[1][i] );
+        const __m256 dz = _mm256_loadu_ps( &aRayPacket.m_DirSoA[2][i] );
+        const __m256 dot = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( dx, nx ),
+                                                         _mm256_mul_ps( dy, ny ) ),
+                                          _mm256_mul_ps( dz, nz ) );
+
+        valid = _mm256_and_ps( valid, _mm256_cmp_ps( dot, zero, _CMP_NGT_UQ ) );
+
+        const int lanes = _mm256_movemask_ps( valid );
+
+        if( lanes )
+        {
+            _mm256_storeu_ps( &aOutT[i], t );
+            _mm256_storeu_ps( &aOutU[i], beta );
+            _mm256_storeu_ps( &aOutV[i], gamma );
+
+            mask |= (uint64_t) lanes << i;
+        }
+    }
+
+    return mask & rayRange( aFirst, aLast );
+}
+
+#endif // RAYPACKET_SIMD_X86
+
+
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET &aRayPacket,
+                                  const CBBOX &aBBox,
+                                  unsigned int aFirst,
+                                  const float *aTHit )
+{
+#if defined( RAYPACKET_SIMD_X86 )
+    if( RAYPACKET_GetSimd() == RAYPACKET_SIMD_AVX )
+        return intersectBBoxAVX( aRayPacket, aBBox, aFirst, aTHit );
+
+    if( RAYPACKET_GetSimd() == RAYPACKET_SIMD_SSE )
+        return intersectBBoxSSE( aRayPacket, aBBox, aFirst, aTHit );
+#endif
+
+    wxASSERT_MSG( false, "no instruction set for the packet tests" );
+    return 0;
+}
+
+
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET &aRayPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      unsigned int aFirst,
+                                      unsigned int aLast,
+                                      const float *aTHit,
+                                      float *aOutT,
+                                      float *aOutU,
+                                      float *aOutV )
+{
+#if defined( RAYPACKET_SIMD_X86 )
+    if( RAYPACKET_GetSimd() == RAYPACKET_SIMD_AVX )
+        return intersectTriangleAVX( aRayPacket, aTriangle, aFirst, aLast, aTHit,
+                                     aOutT, aOutU, aOutV );
+
+    if( RAYPACKET_GetSimd() == RAYPACKET_SIMD_SSE )
+        return intersectTriangleSSE( aRayPacket, aTriangle, aFirst, aLast, aTHit,
+                                     aOutT, aOutU, aOutV );
+#endif
+
+    wxASSERT_MSG( false, "no instruction set for the packet tests" );
+    return 0;
+}
@@ -0,0 +1,148 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file  raypacket_simd.h
+ * @brief Vectorised tests of the rays of a packet against boxes and triangles
+ *
+ * The tests run on 4 (SSE) or 8 (AVX) rays at once, using the per axis arrays of
+ * RAYPACKET.  The instruction set is selected at run time from the CPU features; when
+ * none is available (or on other architectures) the callers keep their scalar tests.
+ */
+
+#ifndef _RAYPACKET_SIMD_H_
+#define _RAYPACKET_SIMD_H_
+
+#include "raypacket.h"
+#include <stdint.h>
+
+class CBBOX;
+
+static_assert( RAYPACKET_RAYS_PER_PACKET <= 64, "the ray masks are 64 bit" );
+
+
+enum RAYPACKET_SIMD
+{
+    RAYPACKET_SIMD_NONE,    ///< scalar tests, one ray at a time
+    RAYPACKET_SIMD_SSE,     ///< 4 rays at a time
+    RAYPACKET_SIMD_AVX      ///< 8 rays at a time
+};
+
+
+/**
+ * @return the instruction set used by the packet tests.  It defaults to the best one
+ * supported by the CPU.
+ */
+RAYPACKET_SIMD RAYPACKET_GetSimd();
+
+/**
+ * Select the instruction set of the packet tests, to compare them.
+ * @return the instruction set used, which is @a aSimd if the CPU supports it, or the
+ * best supported one below it.
+ */
+RAYPACKET_SIMD RAYPACKET_SetSimd( RAYPACKET_SIMD aSimd );
+
+
+/**
+ * Test the rays of a packet against a box.  Must not be called with RAYPACKET_SIMD_NONE.
+ *
+ * @param aFirst is the first ray to test.
+ * @param aTHit is the distance of the current hit of each ray of the packet.
+ * @return the mask of the rays from aFirst that enter the box before their current hit.
+ */
+uint64_t RAYPACKET_IntersectBBox( const RAYPACKET &aRayPacket,
+                                  const CBBOX &aBBox,
+                                  unsigned int aFirst,
+                                  const float *aTHit );
+
+
+/// The constants of a triangle for the test of CTRIANGLE::Intersect()
+struct RAYPACKET_TRIANGLE
+{
+    unsigned int k, ku, kv;     ///< projection axis and the two other axes
+    float nu, nv, nd;
+    float au, av;               ///< first vertex on the ku and kv axes
+    float bnu, bnv;
+    float cnu, cnv;
+    float nx, ny, nz;           ///< face normal, to cull the back faces
+};
+
+
+/**
+ * Test the rays of a packet against a triangle.  Must not be called with
+ * RAYPACKET_SIMD_NONE.  The results are the same as the ones of CTRIANGLE::Intersect().
+ *
+ * The arrays are indexed as the rays of the packet.  The rays around the range (to the
+ * multiples of 8) may be read and computed too, but are not reported.
+ *
+ * @param aFirst, aLast is the range of rays to test, aLast excluded.
+ * @param aTHit is the distance of the current hit of each ray.
+ * @param aOutT, aOutU, aOutV receive the distance and the barycentric coordinates of the
+ * hits.
+ * @return the mask of the rays which hit the triangle before their current hit.
+ */
+uint64_t RAYPACKET_IntersectTriangle( const RAYPACKET &aRayPacket,
+                                      const RAYPACKET_TRIANGLE &aTriangle,
+                                      unsigned int aFirst,
+                                      unsigned int aLast,
+                                      const float *aTHit,
+                                      float *aOutT,
+                                      float *aOutU,
+                                      float *aOutV );
+
+
+/// @return the index of the lowest ray of a non-empty mask
+inline unsigned int RAYPACKET_FirstRay( uint64_t aMask )
+{
+#if defined( __GNUC__ )
+    return __builtin_ctzll( aMask );
+#else
+    unsigned int i = 0;
+
+    while( !( aMask & 1 ) )
+    {
+        aMask >>= 1;
+        ++i;
+    }
+
+    return i;
+#endif
+}
+
+
+/// @return the index of the highest ray of a non-empty mask
+inline unsigned int RAYPACKET_LastRay( uint64_t aMask )
+{
+#if defined( __GNUC__ )
+    return 63 - __builtin_clzll( aMask );
+#else
+    unsigned int i = 63;
+
+    while( !( aMask >> i ) )
+        --i;
+
+    return i;
+#endif
+}
+
+#endif // _RAYPACKET_SIMD_H_
@@ -31,6 +31,7 @@
 #define _COBJECT2D_H_
 
 #include "cbbox2d.h"
+#include <atomic>
 #include <string.h>
 
 #include <class_board_item.h>
@@ -129,10 +130,15 @@ public:
 
 /// Implements a class for object statistics
 /// using Singleton pattern
+/// The layers are built from several threads, so the counters are atomic.
 class COBJECT2D_STATS
 {
 public:
-    void ResetStats() { memset( m_counter, 0, sizeof( unsigned int ) * OBJ2D_MAX ); }
+    void ResetStats()
+    {
+        for( unsigned int i = 0; i < OBJ2D_MAX; ++i )
+            m_counter[i] = 0;
+    }
 
     unsigned int GetCountOf( OBJECT2D_TYPE aObjType ) const
     {
@@ -145,10 +151,9 @@ public:
 
     static COBJECT2D_STATS &Instance()
     {
-        if( !s_instance )
-            s_instance = new COBJECT2D_STATS;
+        static COBJECT2D_STATS s_instance;
 
-        return *s_instance;
+        return s_instance;
     }
 
 private:
@@ -158,9 +163,7 @@ private:
     ~COBJECT2D_STATS(){}
 
 private:
-    unsigned int m_counter[OBJ2D_MAX];
-
-    static COBJECT2D_STATS *s_instance;
+    std::atomic<unsigned int> m_counter[OBJ2D_MAX];
 };
 
 #endif // _COBJECT2D_H_
@@ -43,6 +43,21 @@ COBJECT::COBJECT( OBJECT3D_TYPE aObjType )
 }
 
 
+uint64_t COBJECT::IntersectPacket( const RAYPACKET &aRayPacket,
+                                   unsigned int aFirst,
+                                   unsigned int aLast,
+                                   HITINFO_PACKET *aHitInfoPacket ) const
+{
+    uint64_t mask = 0;
+
+    for( unsigned int i = aFirst; i < aLast; ++i )
+        if( Intersect( aRayPacket.m_ray[i], aHitInfoPacket[i].m_HitInfo ) )
+            mask |= (uint64_t) 1 << i;
+
+    return mask;
+}
+
+
 static const char *OBJECT3D_STR[OBJ3D_MAX] =
 {
     "OBJ3D_CYLINDER",
@@ -33,6 +33,7 @@
 #include "cbbox.h"
 #include "../hitinfo.h"
 #include "../cmaterial.h"
+#include <stdint.h>
 
 
 enum OBJECT3D_TYPE
@@ -91,6 +92,20 @@ public:
      */
     virtual bool IntersectP( const RAY &aRay, float aMaxDistance ) const = 0;
 
+    /** Function IntersectPacket
+     * @brief Intersect a range of rays of a packet, updating their hit information.
+     * The default implementation tests the rays one by one with Intersect().
+     * @param aRayPacket
+     * @param aFirst - first ray of the range
+     * @param aLast - end of the range, excluded
+     * @param aHitInfoPacket - hit information of each ray of the packet
+     * @return the mask of the rays that intersect the object
+     */
+    virtual uint64_t IntersectPacket( const RAYPACKET &aRayPacket,
+                                      unsigned int aFirst,
+                                      unsigned int aLast,
+                                      HITINFO_PACKET *aHitInfoPacket ) const;
+
     const CBBOX &GetBBox() const { return m_bbox; }
 
     const SFVEC3F &GetCentroid() const { return m_centroid; }
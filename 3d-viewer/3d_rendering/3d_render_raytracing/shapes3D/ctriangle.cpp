@@ -32,6 +32,8 @@
 
 
 #include "ctriangle.h"
+#include "../raypacket_simd.h"
+#include <algorithm>
 
 
 void CTRIANGLE::pre_calc_const()
@@ -251,21 +253,80 @@ bool CTRIANGLE::Intersect( const RAY &aRay, HITINFO &aHitInfo ) const
     if( glm::dot( D, m_n ) > 0.0f )
         return false;
 
-    aHitInfo.m_tHit = t;
-    aHitInfo.m_HitPoint = aRay.at( t );
+    setHit( aRay, t, u, v, aHitInfo );
+
+    return true;
+#undef ku
+#undef kv
+}
+
+
+void CTRIANGLE::setHit( const RAY &aRay, float aT, float aU, float aV, HITINFO &aHitInfo ) const
+{
+    aHitInfo.m_tHit = aT;
+    aHitInfo.m_HitPoint = aRay.at( aT );
 
     // interpolate vertex normals with UVW using Gouraud's shading
-    aHitInfo.m_HitNormal = glm::normalize( (1.0f - u - v) * m_normal[0] +
-                                            u * m_normal[1] +
-                                            v * m_normal[2] );
+    aHitInfo.m_HitNormal = glm::normalize( (1.0f - aU - aV) * m_normal[0] +
+                                            aU * m_normal[1] +
+                                            aV * m_normal[2] );
 
     m_material->PerturbeNormal( aHitInfo.m_HitNormal, aRay, aHitInfo );
 
     aHitInfo.pHitObject = this;
+}
 
-    return true;
-#undef ku
-#undef kv
+
+uint64_t CTRIANGLE::IntersectPacket( const RAYPACKET &aRayPacket,
+                                     unsigned int aFirst,
+                                     unsigned int aLast,
+                                     HITINFO_PACKET *aHitInfoPacket ) const
+{
+    if( RAYPACKET_GetSimd() == RAYPACKET_SIMD_NONE )
+        return COBJECT::IntersectPacket( aRayPacket, aFirst, aLast, aHitInfoPacket );
+
+    RAYPACKET_TRIANGLE tri;
+
+    tri.k   = m_k;
+    tri.ku  = s_modulo[m_k + 1];
+    tri.kv  = s_modulo[m_k + 2];
+    tri.nu  = m_nu;
+    tri.nv  = m_nv;
+    tri.nd  = m_nd;
+    tri.au  = m_vertex[0][tri.ku];
+    tri.av  = m_vertex[0][tri.kv];
+    tri.bnu = m_bnu;
+    tri.bnv = m_bnv;
+    tri.cnu = m_cnu;
+    tri.cnv = m_cnv;
+    tri.nx  = m_n.x;
+    tri.ny  = m_n.y;
+    tri.nz  = m_n.z;
+
+    // The kernels work on whole groups of 8 rays around the range
+    const unsigned int groupFirst = aFirst & ~7u;
+    const unsigned int groupLast  = std::min( ( aLast + 7u ) & ~7u,
+                                              (unsigned int) RAYPACKET_RAYS_PER_PACKET );
+
+    float tHit[RAYPACKET_RAYS_PER_PACKET];
+    float hitT[RAYPACKET_RAYS_PER_PACKET];
+    float hitU[RAYPACKET_RAYS_PER_PACKET];
+    float hitV[RAYPACKET_RAYS_PER_PACKET];
+
+    for( unsigned int i = groupFirst; i < groupLast; ++i )
+        tHit[i] = aHitInfoPacket[i].m_HitInfo.m_tHit;
+
+    const uint64_t mask = RAYPACKET_IntersectTriangle( aRayPacket, tri, aFirst, aLast, tHit,
+                                                       hitT, hitU, hitV );
+
+    for( uint64_t hits = mask; hits; hits &= hits - 1 )
+    {
+        const unsigned int i = RAYPACKET_FirstRay( hits );
+
+        setHit( aRayPacket.m_ray[i], hitT[i], hitU[i], hitV[i], aHitInfoPacket[i].m_HitInfo );
+    }
+
+    return mask;
 }
 
 
@@ -65,6 +65,10 @@ public:
 
     // Imported from COBJECT
     bool Intersect( const RAY &aRay, HITINFO &aHitInfo ) const override;
+    uint64_t IntersectPacket( const RAYPACKET &aRayPacket,
+                              unsigned int aFirst,
+                              unsigned int aLast,
+                              HITINFO_PACKET *aHitInfoPacket ) const override;
     bool IntersectP(const RAY &aRay , float aMaxDistance ) const override;
     bool Intersects( const CBBOX &aBBox ) const override;
     SFVEC3F GetDiffuseColor( const HITINFO &aHitInfo ) const override;
@@ -72,6 +76,9 @@ public:
 private:
     void pre_calc_const();
 
+    /// Record a hit at distance aT, with barycentric coordinates aU and aV
+    void setHit( const RAY &aRay, float aT, float aU, float aV, HITINFO &aHitInfo ) const;
+
 private:
     SFVEC3F m_normal[3];                // 36
     SFVEC3F m_vertex[3];                // 36
@@ -65,6 +65,59 @@ static const wxChar EnableSvgImport[] = wxT( "EnableSvgImport" );
  */
 static const wxChar RealtimeConnectivity[] = wxT( "RealtimeConnectivity" );
 
+/**
+ * Debugging mode for the incremental connectivity update.  Setting this to on rebuilds the
+ * connectivity from scratch after each incremental update (e.g. when running the DRC) and
+ * reports any difference to the "CN" trace.  This is much slower.
+ */
+static const wxChar VerifyIncrementalConnectivity[] = wxT( "VerifyIncrementalConnectivity" );
+
+/**
+ * Read board, footprint and legacy schematic/library files through a memory mapped reader.
+ * Setting this to off falls back to reading them line by line with stdio.
+ */
+static const wxChar UseMmapLineReader[] = wxT( "UseMmapLineReader" );
+
+/**
+ * Parse the items of board files on several threads.  Setting this to off parses them
+ * serially, one at a time.
+ */
+static const wxChar ParallelBoardParser[] = wxT( "ParallelBoardParser" );
+
+/**
+ * Keep the Delaunay triangulation of each net between ratsnest updates, and only insert
+ * and remove the anchors which moved.  Setting this to off triangulates the whole net
+ * again at every update.
+ */
+static const wxChar IncrementalRatsnest[] = wxT( "IncrementalRatsnest" );
+
+/**
+ * Reuse the previous fill of a zone when its outline, its settings and the shapes knocked
+ * out of it did not change since that fill.  Setting this to off recomputes every zone.
+ */
+static const wxChar ZoneFillCache[] = wxT( "ZoneFillCache" );
+
+/**
+ * Fill the zones which have thousands of knockouts in tiles, on several threads, and merge
+ * the tiles at the end.  The filled area does not change, but the polygons get more
+ * vertices along the tile edges.
+ */
+static const wxChar TiledZoneFill[] = wxT( "TiledZoneFill" );
+
+/**
+ * Record the start, move, fix and stop events of the interactive router in a pns_events_*.log
+ * file of the temporary directory, written when the board is closed or reloaded.  The
+ * router_replay QA tool replays them on the board file as it was when opened.
+ */
+static const wxChar RecordRouterEvents[] = wxT( "RecordRouterEvents" );
+
+/**
+ * Run the clockwise and counter-clockwise walkaround searches of the interactive router on
+ * two threads, and in shove mode, the walkaround replacing a failed shove during the shove.
+ * The search losing the race is cancelled.
+ */
+static const wxChar ConcurrentRouterSearch[] = wxT( "ConcurrentRouterSearch" );
+
 /**
  * Allow legacy canvas to be shown in GTK3. Legacy canvas is generally pretty
  * broken, but this avoids code in an ifdef where it could become broken
@@ -152,6 +205,14 @@ ADVANCED_CFG::ADVANCED_CFG()
     m_enableSvgImport = false;
     m_allowLegacyCanvasInGtk3 = false;
     m_realTimeConnectivity = true;
+    m_verifyIncrementalConnectivity = false;
+    m_useMmapLineReader = true;
+    m_parallelBoardParser = true;
+    m_incrementalRatsnest = true;
+    m_zoneFillCache = true;
+    m_tiledZoneFill = false;
+    m_recordRouterEvents = false;
+    m_concurrentRouterSearch = false;
 
     loadFromConfigFile();
 }
@@ -194,6 +255,30 @@ void ADVANCED_CFG::loadSettings( wxConfigBase& aCfg )
     configParams.push_back(
             new PARAM_CFG_BOOL( true, AC_KEYS::RealtimeConnectivity, &m_realTimeConnectivity, false ) );
 
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::VerifyIncrementalConnectivity,
+            &m_verifyIncrementalConnectivity, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::UseMmapLineReader,
+            &m_useMmapLineReader, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ParallelBoardParser,
+            &m_parallelBoardParser, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::IncrementalRatsnest,
+            &m_incrementalRatsnest, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ZoneFillCache,
+            &m_zoneFillCache, true ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::TiledZoneFill,
+            &m_tiledZoneFill, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::RecordRouterEvents,
+            &m_recordRouterEvents, false ) );
+
+    configParams.push_back( new PARAM_CFG_BOOL( true, AC_KEYS::ConcurrentRouterSearch,
+            &m_concurrentRouterSearch, false ) );
+
     wxConfigLoadSetups( &aCfg, configParams );
 
     dumpCfg( configParams );
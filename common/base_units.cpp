@@ -39,6 +39,7 @@
 #include <title_block.h>
 #include <common.h>
 #include <base_units.h>
+#include <numeric_io.h>
 #include "libeval/numeric_evaluator.h"
 
 
@@ -69,7 +70,7 @@ std::string Double2Str( double aValue )
     {
         // For these small values, %f works fine,
         // and %g gives an exponent
-        len = sprintf( buf,  "%.16f", aValue );
+        len = SnprintfC( buf, sizeof(buf), "%.16f", aValue );
 
         while( --len > 0 && buf[len] == '0' )
             buf[len] = '\0';
@@ -83,7 +84,8 @@ std::string Double2Str( double aValue )
     {
         // For these values, %g works fine, and sometimes %f
         // gives a bad value (try aValue = 1.222222222222, with %.16f format!)
-        len = sprintf( buf, "%.16g", aValue );
+        // FormatDouble() uses the fewest %g digits which read back to aValue.
+        return FormatDouble( aValue );
     }
 
     return std::string( buf, len );
@@ -466,7 +468,7 @@ std::string FormatInternalUnits( int aValue )
 
     if( engUnits != 0.0 && fabs( engUnits ) <= 0.0001 )
     {
-        len = snprintf( buf, sizeof(buf), "%.10f", engUnits );
+        len = SnprintfC( buf, sizeof(buf), "%.10f", engUnits );
 
         while( --len > 0 && buf[len] == '0' )
             buf[len] = '\0';
@@ -480,7 +482,7 @@ std::string FormatInternalUnits( int aValue )
     }
     else
     {
-        len = snprintf( buf, sizeof(buf), "%.10g", engUnits );
+        len = SnprintfC( buf, sizeof(buf), "%.10g", engUnits );
     }
 
     return std::string( buf, len );
@@ -492,7 +494,7 @@ std::string FormatAngle( double aAngle )
     char temp[50];
     int len;
 
-    len = snprintf( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
+    len = SnprintfC( temp, sizeof(temp), "%.10g", aAngle / 10.0 );
 
     return std::string( temp, len );
 }
@@ -36,6 +36,12 @@
 #include <reporter.h>
 #include <mutex>
 
+#include <locale.h>
+
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
 #include <wx/process.h>
 #include <wx/config.h>
 #include <wx/utils.h>
@@ -72,7 +78,22 @@ void KiAssertFilter( const wxString &file, int line,
 #endif
 
 
-std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
+namespace
+{
+
+// The nesting depth of the LOCALE_IO instances of each thread, and the locale of the thread
+// before the outermost one
+thread_local unsigned int s_localeIoDepth = 0;
+
+#if defined( _WIN32 )
+thread_local int          s_threadLocaleMode;
+thread_local std::string  s_userLocale;
+#else
+thread_local locale_t     s_cNumericLocale;
+thread_local locale_t     s_userLocale;
+#endif
+
+} // namespace
 
 
 // Note on Windows, setlocale( LC_NUMERIC, "C" ) works fine to read/write
@@ -82,31 +103,55 @@ std::atomic<unsigned int> LOCALE_IO::m_c_count( 0 );
 
 LOCALE_IO::LOCALE_IO()
 {
-    // use thread safe, atomic operation
-    if( m_c_count++ == 0 )
+    if( s_localeIoDepth++ == 0 )
     {
+#if defined( _WIN32 )
+        // Once per-thread locales are enabled, setlocale() only changes the calling thread
+        s_threadLocaleMode = _configthreadlocale( _ENABLE_PER_THREAD_LOCALE );
+
         // Store the user locale name, to restore this locale later, in dtor
-        m_user_locale = setlocale( LC_NUMERIC, nullptr );
-#if defined( _WIN32 ) && defined( DEBUG )
+        s_userLocale = setlocale( LC_NUMERIC, nullptr );
+#if defined( DEBUG )
         // Disable wxWidgets alerts
         wxSetAssertHandler( KiAssertFilter );
 #endif
         // Switch the locale to C locale, to read/write files with fp numbers
         setlocale( LC_NUMERIC, "C" );
+#else
+        // A copy of the thread locale, with the "C" numeric conventions
+        s_userLocale = uselocale( (locale_t) 0 );
+
+        locale_t userCopy = duplocale( s_userLocale );
+
+        s_cNumericLocale = userCopy ? newlocale( LC_NUMERIC_MASK, "C", userCopy ) : (locale_t) 0;
+
+        if( s_cNumericLocale )
+            uselocale( s_cNumericLocale );
+        else if( userCopy )
+            freelocale( userCopy );
+#endif
     }
 }
 
 
 LOCALE_IO::~LOCALE_IO()
 {
-    // use thread safe, atomic operation
-    if( --m_c_count == 0 )
+    if( --s_localeIoDepth == 0 )
     {
+#if defined( _WIN32 )
         // revert to the user locale
-        setlocale( LC_NUMERIC, m_user_locale.c_str() );
-#if defined( _WIN32 ) && defined( DEBUG )
+        setlocale( LC_NUMERIC, s_userLocale.c_str() );
+        _configthreadlocale( s_threadLocaleMode );
+#if defined( DEBUG )
         // Enable wxWidgets alerts
         wxSetDefaultAssertHandler();
+#endif
+#else
+        if( s_cNumericLocale )
+        {
+            uselocale( s_userLocale );
+            freelocale( s_cNumericLocale );
+        }
 #endif
     }
 }
@@ -118,10 +118,19 @@ EDGE_PTR TRIANGULATION::InitTwoEnclosingTriangles( NODES_CONTAINER::iterator aFi
     double dx = ( xmax - xmin ) / fac;
     double dy = ( ymax - ymin ) / fac;
 
-    NODE_PTR n1 = std::make_shared<NODE>( xmin - dx, ymin - dy );
-    NODE_PTR n2 = std::make_shared<NODE>( xmax + dx, ymin - dy );
-    NODE_PTR n3 = std::make_shared<NODE>( xmax + dx, ymax + dy );
-    NODE_PTR n4 = std::make_shared<NODE>( xmin - dx, ymax + dy );
+    return InitRectangle( xmin - dx, ymin - dy, xmax + dx, ymax + dy );
+}
+
+
+EDGE_PTR TRIANGULATION::InitRectangle( int aXmin, int aYmin, int aXmax, int aYmax )
+{
+    cleanAll();
+    m_leadingEdges.clear();
+
+    NODE_PTR n1 = std::make_shared<NODE>( aXmin, aYmin );
+    NODE_PTR n2 = std::make_shared<NODE>( aXmax, aYmin );
+    NODE_PTR n3 = std::make_shared<NODE>( aXmax, aYmax );
+    NODE_PTR n4 = std::make_shared<NODE>( aXmin, aYmax );
 
     // diagonal
     EDGE_PTR e1d = std::make_shared<EDGE>();
@@ -212,6 +221,38 @@ void TRIANGULATION::CreateDelaunay( NODES_CONTAINER::iterator aFirst,
 }
 
 
+bool TRIANGULATION::InsertNode( const NODE_PTR& aNode, DART& aDart )
+{
+    NODE_PTR node = aNode;
+
+    return m_helper->InsertNode<TTLtraits>( aDart, node );
+}
+
+
+bool TRIANGULATION::RemoveNode( const NODE_PTR& aNode, DART& aDart )
+{
+    if( !m_helper->LocateTriangle<TTLtraits>( aNode, aDart ) )
+        return false;
+
+    // The node is a corner of the located triangle, find the CCW dart leaving it
+    for( int i = 0; i < 3; ++i )
+    {
+        if( aDart.GetNode() == aNode )
+        {
+            m_helper->RemoveNode<TTLtraits>( aDart );
+
+            // The dart may point to a deleted edge now
+            aDart = CreateDart();
+            return true;
+        }
+
+        aDart.Alpha0().Alpha1();
+    }
+
+    return false;
+}
+
+
 void TRIANGULATION::RemoveTriangle( EDGE_PTR& aEdge )
 {
   EDGE_PTR e1 = getLeadingEdgeInTriangle( aEdge );
@@ -297,24 +338,15 @@ bool TRIANGULATION::removeLeadingEdgeFromList( EDGE_PTR& aLeadingEdge )
     // Remove the edge from the list of leading edges,
     // but don't delete it.
     // Also set flag for leading edge to false.
-    // Must search from start of list. Since edges are added to the
-    // start of the list during triangulation, this operation will
-    // normally be fast (when used in the triangulation algorithm)
-    std::list<EDGE_PTR>::iterator it;
-    for( it = m_leadingEdges.begin(); it != m_leadingEdges.end(); ++it )
-    {
-        EDGE_PTR edge = *it;
-
-        if( edge == aLeadingEdge )
-        {
-            edge->SetAsLeadingEdge( false );
-            it = m_leadingEdges.erase( it );
+    // Each leading edge knows its position in the list, so no search is needed
+    // (this matters when nodes are inserted in or removed from a large triangulation).
+    if( !aLeadingEdge || !aLeadingEdge->IsLeadingEdge() )
+        return false;
 
-            return true;
-        }
-    }
+    m_leadingEdges.erase( aLeadingEdge->GetLeadingEdgePos() );
+    aLeadingEdge->SetAsLeadingEdge( false );
 
-    return false;
+    return true;
 }
 
 
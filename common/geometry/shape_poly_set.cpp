@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <cstdio>
+#include <cmath>
 #include <set>
 #include <list>
 #include <algorithm>
@@ -647,13 +648,97 @@ struct FractureEdge
     bool m_connected;
     VECTOR2I m_p1, m_p2;
     FractureEdge* m_next;
+    int m_index;        ///< creation order, to break ties as a scan of all the edges would
 };
 
 
 typedef std::vector<FractureEdge*> FractureEdgeSet;
 
 
-static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
+/**
+ * The edges of a polygon being fractured.  They are also sorted in buckets by their
+ * vertical extent, so the edges crossing a horizontal line are found without looking at
+ * all the edges of the polygon, which made fracturing quadratic in the number of holes.
+ */
+struct FractureEdgeIndex
+{
+    ~FractureEdgeIndex()
+    {
+        for( FractureEdge* edge : m_edges )
+            delete edge;
+    }
+
+    void Add( FractureEdge* aEdge )
+    {
+        aEdge->m_index = m_edges.size();
+        m_edges.push_back( aEdge );
+
+        if( !m_buckets.empty() )
+            addToBuckets( aEdge );
+    }
+
+    /**
+     * Sort the edges added so far in buckets.  Edges added later must be within the
+     * vertical extent of these edges.
+     */
+    void BuildBuckets()
+    {
+        if( m_edges.empty() )
+            return;
+
+        int y_min = std::numeric_limits<int>::max();
+        int y_max = std::numeric_limits<int>::min();
+
+        for( FractureEdge* edge : m_edges )
+        {
+            y_min = std::min( { y_min, edge->m_p1.y, edge->m_p2.y } );
+            y_max = std::max( { y_max, edge->m_p1.y, edge->m_p2.y } );
+        }
+
+        int64_t count = std::max<int64_t>( 1, std::sqrt( (double) m_edges.size() ) );
+
+        m_yMin = y_min;
+        m_bucketHeight = ( (int64_t) y_max - y_min ) / count + 1;
+        m_buckets.resize( ( (int64_t) y_max - y_min ) / m_bucketHeight + 1 );
+
+        for( FractureEdge* edge : m_edges )
+            addToBuckets( edge );
+    }
+
+    ///> @return the edges which may cross the horizontal line at \a aY
+    const FractureEdgeSet& Candidates( int aY ) const
+    {
+        if( m_buckets.empty() )
+            return m_edges;
+
+        return m_buckets[bucket( aY )];
+    }
+
+    FractureEdgeSet m_edges;
+
+private:
+    size_t bucket( int aY ) const
+    {
+        int64_t index = ( (int64_t) aY - m_yMin ) / m_bucketHeight;
+        return std::min<int64_t>( std::max<int64_t>( index, 0 ), m_buckets.size() - 1 );
+    }
+
+    void addToBuckets( FractureEdge* aEdge )
+    {
+        size_t first = bucket( std::min( aEdge->m_p1.y, aEdge->m_p2.y ) );
+        size_t last = bucket( std::max( aEdge->m_p1.y, aEdge->m_p2.y ) );
+
+        for( size_t ii = first; ii <= last; ++ii )
+            m_buckets[ii].push_back( aEdge );
+    }
+
+    std::vector<FractureEdgeSet> m_buckets;
+    int m_yMin = 0;
+    int64_t m_bucketHeight = 1;
+};
+
+
+static int processEdge( FractureEdgeIndex& edges, FractureEdge* edge )
 {
     int x   = edge->m_p1.x;
     int y   = edge->m_p1.y;
@@ -662,26 +747,28 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
     FractureEdge* e_nearest = NULL;
 
-    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
+    for( FractureEdge* candidate : edges.Candidates( y ) )
     {
-        if( !(*i)->matches( y ) )
+        if( !candidate->matches( y ) )
             continue;
 
         int x_intersect;
 
-        if( (*i)->m_p1.y == (*i)->m_p2.y ) // horizontal edge
-            x_intersect = std::max( (*i)->m_p1.x, (*i)->m_p2.x );
+        if( candidate->m_p1.y == candidate->m_p2.y ) // horizontal edge
+            x_intersect = std::max( candidate->m_p1.x, candidate->m_p2.x );
         else
-            x_intersect = (*i)->m_p1.x + rescale( (*i)->m_p2.x - (*i)->m_p1.x, y - (*i)->m_p1.y,
-                    (*i)->m_p2.y - (*i)->m_p1.y );
+            x_intersect = candidate->m_p1.x + rescale( candidate->m_p2.x - candidate->m_p1.x,
+                    y - candidate->m_p1.y, candidate->m_p2.y - candidate->m_p1.y );
 
         int dist = ( x - x_intersect );
 
-        if( dist >= 0 && dist < min_dist && (*i)->m_connected )
+        if( dist >= 0 && candidate->m_connected
+                && ( dist < min_dist
+                     || ( dist == min_dist && candidate->m_index < e_nearest->m_index ) ) )
         {
             min_dist    = dist;
             x_nearest   = x_intersect;
-            e_nearest   = (*i);
+            e_nearest   = candidate;
         }
     }
 
@@ -696,9 +783,9 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
         FractureEdge* split_2 =
             new FractureEdge( true, VECTOR2I( x_nearest, y ), e_nearest->m_p2 );
 
-        edges.push_back( split_2 );
-        edges.push_back( lead1 );
-        edges.push_back( lead2 );
+        edges.Add( split_2 );
+        edges.Add( lead1 );
+        edges.Add( lead2 );
 
         FractureEdge* link = e_nearest->m_next;
 
@@ -728,7 +815,7 @@ static int processEdge( FractureEdgeSet& edges, FractureEdge* edge )
 
 void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 {
-    FractureEdgeSet edges;
+    FractureEdgeIndex edges;
     FractureEdgeSet border_edges;
     FractureEdge*   root = NULL;
 
@@ -772,7 +859,7 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
                 fe->m_next = first_edge;
 
             prev = fe;
-            edges.push_back( fe );
+            edges.Add( fe );
 
             if( !first )
             {
@@ -787,24 +874,26 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
         first = false;    // first path is always the outline
     }
 
+    edges.BuildBuckets();
+
+    // Holes are connected from left to right.  A connected hole stays connected, so the
+    // left-most unconnected hole edge is the next one in this order.
+    std::stable_sort( border_edges.begin(), border_edges.end(),
+            []( const FractureEdge* a, const FractureEdge* b )
+            {
+                return a->m_p1.x < b->m_p1.x;
+            } );
+
+    FractureEdgeSet::iterator next_border = border_edges.begin();
+
     // keep connecting holes to the main outline, until there's no holes left...
     while( num_unconnected > 0 )
     {
-        int x_min = std::numeric_limits<int>::max();
-
-        FractureEdge* smallestX = NULL;
-
         // find the left-most hole edge and merge with the outline
-        for( FractureEdgeSet::iterator i = border_edges.begin(); i != border_edges.end(); ++i )
-        {
-            int xt = (*i)->m_p1.x;
+        while( next_border != border_edges.end() && (*next_border)->m_connected )
+            ++next_border;
 
-            if( ( xt < x_min ) && !(*i)->m_connected )
-            {
-                x_min = xt;
-                smallestX = *i;
-            }
-        }
+        FractureEdge* smallestX = next_border != border_edges.end() ? *next_border : NULL;
 
         num_unconnected -= processEdge( edges, smallestX );
     }
@@ -821,9 +910,6 @@ void SHAPE_POLY_SET::fractureSingle( POLYGON& paths )
 
     newPath.Append( e->m_p1 );
 
-    for( FractureEdgeSet::iterator i = edges.begin(); i != edges.end(); ++i )
-        delete *i;
-
     paths.push_back( newPath );
 }
 
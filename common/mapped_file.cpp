@@ -0,0 +1,150 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <mapped_file.h>
+
+#include <cstring>
+#include <limits>
+
+#include <wx/ffile.h>
+#include <wx/intl.h>
+
+#include <ki_exception.h>
+
+#if defined( _WIN32 )
+#define WIN32_LEAN_AND_MEAN 1
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+
+MAPPED_FILE::MAPPED_FILE( const wxString& aFileName, bool aSequential ) :
+    m_data( NULL ), m_size( 0 ), m_mapping( NULL )
+{
+#if defined( _WIN32 )
+    HANDLE file = CreateFileW( aFileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+                               OPEN_EXISTING,
+                               aSequential ? FILE_FLAG_SEQUENTIAL_SCAN : FILE_ATTRIBUTE_NORMAL,
+                               NULL );
+
+    if( file != INVALID_HANDLE_VALUE )
+    {
+        LARGE_INTEGER size;
+
+        if( GetFileSizeEx( file, &size ) && size.QuadPart > 0
+                && (ULONGLONG) size.QuadPart <= std::numeric_limits<size_t>::max() )
+        {
+            HANDLE mapping = CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+
+            if( mapping )
+            {
+                m_mapping = MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 );
+
+                if( m_mapping )
+                    m_size = (size_t) size.QuadPart;
+
+                // the view keeps the mapping alive
+                CloseHandle( mapping );
+            }
+        }
+
+        CloseHandle( file );
+    }
+#else
+    int fd = open( aFileName.fn_str(), O_RDONLY );
+
+    if( fd >= 0 )
+    {
+        struct stat st;
+
+        if( fstat( fd, &st ) == 0 && S_ISREG( st.st_mode ) && st.st_size > 0
+                && (unsigned long long) st.st_size <= std::numeric_limits<size_t>::max() )
+        {
+            void* view = mmap( NULL, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+
+            if( view != MAP_FAILED )
+            {
+                m_mapping = view;
+                m_size    = (size_t) st.st_size;
+
+                if( aSequential )
+                    madvise( view, m_size, MADV_SEQUENTIAL );
+            }
+        }
+
+        // the mapping keeps its own reference to the file
+        close( fd );
+    }
+#endif
+
+    if( m_mapping )
+    {
+        m_data = (const char*) m_mapping;
+        return;
+    }
+
+    // Empty files cannot be mapped, and neither can some special files: read those in one go.
+    FILE* fp = wxFopen( aFileName, wxT( "rb" ) );
+
+    if( !fp )
+    {
+        wxString msg = wxString::Format(
+            _( "Unable to open filename \"%s\" for reading" ), aFileName.GetData() );
+        THROW_IO_ERROR( msg );
+    }
+
+    std::vector<char> content;
+    char              chunk[16384];
+    size_t            count;
+
+    while( ( count = fread( chunk, 1, sizeof( chunk ), fp ) ) > 0 )
+        content.insert( content.end(), chunk, chunk + count );
+
+    fclose( fp );
+
+    // copied to a buffer of doubles for the alignment
+    m_buffer.resize( ( content.size() + sizeof( double ) - 1 ) / sizeof( double ) );
+
+    if( !content.empty() )
+        memcpy( m_buffer.data(), content.data(), content.size() );
+
+    m_data = (const char*) m_buffer.data();
+    m_size = content.size();
+}
+
+
+MAPPED_FILE::~MAPPED_FILE()
+{
+    if( !m_mapping )
+        return;
+
+#if defined( _WIN32 )
+    UnmapViewOfFile( m_mapping );
+#else
+    munmap( m_mapping, m_size );
+#endif
+}
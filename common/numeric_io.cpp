@@ -0,0 +1,366 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <numeric_io.h>
+
+#include <cerrno>
+#include <cfloat>
+#include <climits>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <locale.h>
+
+#if defined( __APPLE__ )
+#include <xlocale.h>
+#endif
+
+
+namespace
+{
+
+#if defined( _WIN32 )
+
+_locale_t cLocale()
+{
+    static _locale_t locale = _create_locale( LC_ALL, "C" );
+    return locale;
+}
+
+#else
+
+locale_t cLocale()
+{
+    static locale_t locale = newlocale( LC_ALL_MASK, "C", (locale_t) 0 );
+    return locale;
+}
+
+
+/**
+ * Switches the calling thread to the "C" locale during its lifetime.  POSIX has no
+ * strtod_l() nor vsnprintf_l(), but uselocale() only affects the calling thread.
+ */
+class THREAD_C_LOCALE
+{
+public:
+    THREAD_C_LOCALE() :
+        m_previous( uselocale( cLocale() ) )
+    {
+    }
+
+    ~THREAD_C_LOCALE()
+    {
+        uselocale( m_previous );
+    }
+
+private:
+    locale_t m_previous;
+};
+
+#endif
+
+
+double strtodC( const char* aText, const char** aEnd )
+{
+    char*  end;
+
+#if defined( _WIN32 )
+    double value = _strtod_l( aText, &end, cLocale() );
+#else
+    THREAD_C_LOCALE scope;
+    double value = strtod( aText, &end );
+#endif
+
+    if( aEnd )
+        *aEnd = end;
+
+    return value;
+}
+
+
+inline bool isSpace( char c )
+{
+    return c == ' ' || ( c >= '\t' && c <= '\r' );
+}
+
+
+inline bool isDigit( char c )
+{
+    return c >= '0' && c <= '9';
+}
+
+
+/// @return the value of the digit or letter c, or INT_MAX if c is neither
+inline int digitValue( char c )
+{
+    if( c >= '0' && c <= '9' )
+        return c - '0';
+
+    if( c >= 'a' && c <= 'z' )
+        return c - 'a' + 10;
+
+    if( c >= 'A' && c <= 'Z' )
+        return c - 'A' + 10;
+
+    return INT_MAX;
+}
+
+
+/// The powers of ten which are exact doubles
+const double exactPowersOf10[] =
+{
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+const int MAX_EXACT_POWER = 22;
+
+} // namespace
+
+
+double ParseDouble( const char* aText, const char** aEnd )
+{
+    const char* p = aText;
+
+    while( isSpace( *p ) )
+        ++p;
+
+    bool negative = *p == '-';
+
+    if( *p == '-' || *p == '+' )
+        ++p;
+
+    // Hexadecimal numbers, infinities and NaNs are left to strtod()
+    if( !isDigit( *p ) && !( *p == '.' && isDigit( p[1] ) ) )
+        return strtodC( aText, aEnd );
+
+    if( p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' ) )
+        return strtodC( aText, aEnd );
+
+    // Read up to 19 significant digits, which always fit in a uint64_t
+    uint64_t mantissa = 0;
+    int      digits = 0;
+    int      exponent = 0;
+    bool     truncated = false;
+
+    for( ; isDigit( *p ); ++p )
+    {
+        if( digits < 19 )
+        {
+            mantissa = mantissa * 10 + ( *p - '0' );
+
+            if( mantissa )
+                digits++;
+        }
+        else
+        {
+            truncated |= *p != '0';
+            exponent++;
+        }
+    }
+
+    if( *p == '.' )
+    {
+        for( ++p; isDigit( *p ); ++p )
+        {
+            if( digits < 19 )
+            {
+                mantissa = mantissa * 10 + ( *p - '0' );
+                exponent--;
+
+                if( mantissa )
+                    digits++;
+            }
+            else
+            {
+                truncated |= *p != '0';
+            }
+        }
+    }
+
+    if( *p == 'e' || *p == 'E' )
+    {
+        const char* q = p + 1;
+        bool negativeExp = *q == '-';
+
+        if( *q == '-' || *q == '+' )
+            ++q;
+
+        if( isDigit( *q ) )
+        {
+            int exp = 0;
+
+            for( ; isDigit( *q ); ++q )
+            {
+                // beyond any double anyway
+                if( exp < 100000 )
+                    exp = exp * 10 + ( *q - '0' );
+            }
+
+            exponent += negativeExp ? -exp : exp;
+            p = q;
+        }
+    }
+
+    if( mantissa == 0 )
+    {
+        if( aEnd )
+            *aEnd = p;
+
+        return negative ? -0.0 : 0.0;
+    }
+
+#if defined( FLT_EVAL_METHOD ) && FLT_EVAL_METHOD == 0
+    // Both the mantissa and the power of ten are exact doubles, so the single multiplication
+    // or division is correctly rounded (Clinger's fast path).  This needs double arithmetic
+    // without extended precision intermediates, hence the FLT_EVAL_METHOD test.
+    if( !truncated && mantissa <= ( UINT64_C( 1 ) << 53 )
+            && exponent >= -MAX_EXACT_POWER && exponent <= MAX_EXACT_POWER )
+    {
+        double value = (double) mantissa;
+
+        if( exponent < 0 )
+            value /= exactPowersOf10[-exponent];
+        else
+            value *= exactPowersOf10[exponent];
+
+        if( aEnd )
+            *aEnd = p;
+
+        return negative ? -value : value;
+    }
+#endif
+
+    return strtodC( aText, aEnd );
+}
+
+
+long ParseLong( const char* aText, const char** aEnd, int aBase )
+{
+    const char* p = aText;
+
+    while( isSpace( *p ) )
+        ++p;
+
+    bool negative = *p == '-';
+
+    if( *p == '-' || *p == '+' )
+        ++p;
+
+    if( aBase == 16 && p[0] == '0' && ( p[1] == 'x' || p[1] == 'X' )
+            && digitValue( p[2] ) < 16 )
+        p += 2;
+
+    const unsigned long limit = negative ? (unsigned long) LONG_MAX + 1 : LONG_MAX;
+    const char*         start = p;
+    unsigned long       value = 0;
+    bool                overflow = false;
+
+    for( int digit = digitValue( *p ); digit < aBase; digit = digitValue( *++p ) )
+    {
+        if( value > ( limit - digit ) / aBase )
+            overflow = true;
+        else
+            value = value * aBase + digit;
+    }
+
+    if( p == start )
+    {
+        if( aEnd )
+            *aEnd = aText;
+
+        return 0;
+    }
+
+    if( aEnd )
+        *aEnd = p;
+
+    if( overflow )
+    {
+        errno = ERANGE;
+        return negative ? LONG_MIN : LONG_MAX;
+    }
+
+    if( negative )
+        return value == limit ? LONG_MIN : -(long) value;
+
+    return (long) value;
+}
+
+
+int VsnprintfC( char* aBuffer, size_t aSize, const char* aFormat, va_list aArgs )
+{
+#if defined( _WIN32 )
+    // _vsnprintf_l() returns -1 instead of the needed size when the buffer is too small
+    va_list tmp;
+    va_copy( tmp, aArgs );
+
+    int ret = _vsnprintf_l( aBuffer, aSize, aFormat, cLocale(), aArgs );
+
+    if( ret < 0 || (size_t) ret >= aSize )
+    {
+        ret = _vscprintf_l( aFormat, cLocale(), tmp );
+
+        if( aSize > 0 )
+            aBuffer[aSize - 1] = '\0';
+    }
+
+    va_end( tmp );
+
+    return ret;
+#else
+    THREAD_C_LOCALE scope;
+
+    return vsnprintf( aBuffer, aSize, aFormat, aArgs );
+#endif
+}
+
+
+int SnprintfC( char* aBuffer, size_t aSize, const char* aFormat, ... )
+{
+    va_list args;
+
+    va_start( args, aFormat );
+    int ret = VsnprintfC( aBuffer, aSize, aFormat, args );
+    va_end( args );
+
+    return ret;
+}
+
+
+std::string FormatDouble( double aValue )
+{
+    char buf[32];
+    int  len = 0;
+
+    for( int precision = 15; precision <= 17; ++precision )
+    {
+        len = SnprintfC( buf, sizeof( buf ), "%.*g", precision, aValue );
+
+        if( ParseDouble( buf ) == aValue )
+            break;
+    }
+
+    return std::string( buf, len );
+}
@@ -35,6 +35,7 @@
 #include <worksheet_shape_builder.h>
 #include <worksheet_dataitem.h>
 #include <page_layout_reader_lexer.h>
+#include <numeric_io.h>
 
 #include <wx/file.h>
 #include <wx/mstream.h>
@@ -751,7 +752,7 @@ double PAGE_LAYOUT_READER_PARSER::parseDouble()
     if( token != T_NUMBER )
         Expecting( T_NUMBER );
 
-    double val = strtod( CurText(), NULL );
+    double val = ParseDouble( CurText() );
 
     return val;
 }
@@ -23,10 +23,13 @@
  */
 
 
+#include <algorithm>
 #include <cstdarg>
+#include <cstring>
 #include <config.h> // HAVE_FGETC_NOLOCK
 
 #include <richio.h>
+#include <numeric_io.h>
 
 
 // Fall back to getc() when getc_unlocked() is not available on the target platform.
@@ -38,7 +41,8 @@
 static int vprint( std::string* result, const char* format, va_list ap )
 {
     char    msg[512];
-    // This function can call vsnprintf twice.
+    // This function can call VsnprintfC twice.  Numbers are always written with a point as
+    // decimal separator, whatever the locale.
     // But internally, vsnprintf retrieves arguments from the va_list identified by arg as if
     // va_arg was used on it, and thus the state of the va_list is likely to be altered by the call.
     // see: www.cplusplus.com/reference/cstdio/vsnprintf
@@ -46,7 +50,7 @@ static int vprint( std::string* result, const char* format, va_list ap )
     va_list tmp;
     va_copy( tmp, ap );
 
-    size_t  len = vsnprintf( msg, sizeof(msg), format, ap );
+    size_t  len = VsnprintfC( msg, sizeof(msg), format, ap );
 
     if( len < sizeof(msg) )     // the output fit into msg
     {
@@ -60,7 +64,7 @@ static int vprint( std::string* result, const char* format, va_list ap )
         std::vector<char>   buf;
         buf.reserve( len+1 );   // reserve(), not resize() which writes. +1 for trailing nul.
 
-        len = vsnprintf( &buf[0], len+1, format, tmp );
+        len = VsnprintfC( &buf[0], len+1, format, tmp );
 
         result->append( &buf[0], &buf[0] + len );
     }
@@ -225,6 +229,91 @@ char* FILE_LINE_READER::ReadLine()
 }
 
 
+MMAP_LINE_READER::MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber, unsigned aMaxLineLength ):
+    LINE_READER( aMaxLineLength ),
+    m_file( aFileName, true ),
+    m_data( m_file.Data() ), m_size( m_file.Size() ), m_ndx( 0 )
+{
+    m_source  = aFileName;
+    m_lineNum = aStartingLineNumber;
+}
+
+
+const char* MMAP_LINE_READER::nextLine()
+{
+    // m_lineNum is incremented even if there was no line read, because this
+    // leads to better error reporting when we hit an end of file.
+    ++m_lineNum;
+
+    if( m_ndx >= m_size )
+    {
+        m_length = 0;
+        return NULL;
+    }
+
+    const char* line = m_data + m_ndx;
+    size_t      left = m_size - m_ndx;
+    const char* eol  = (const char*) memchr( line, '\n', left );
+    size_t      len  = eol ? eol - line + 1 : left;
+
+    if( len > m_maxLineLength )
+        THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+    m_length = (unsigned) len;
+    m_ndx   += len;
+
+    return line;
+}
+
+
+char* MMAP_LINE_READER::ReadLine()
+{
+    const char* line = nextLine();
+    unsigned    len  = m_length;
+
+    // expandCapacity() keeps the first m_length bytes of the old buffer: there are none.
+    m_length = 0;
+
+    if( len + 1 > m_capacity )
+        expandCapacity( std::max( len + 1, m_capacity * 2 ) );
+
+    if( len )
+        memcpy( m_line, line, len );
+
+    m_line[len] = 0;
+    m_length    = len;
+
+    return len ? m_line : NULL;
+}
+
+
+const char* MMAP_LINE_READER::ReadLineView()
+{
+    return nextLine();
+}
+
+
+const char* MMAP_LINE_READER::ReadRemainingView( size_t* aLength )
+{
+    const char* text = m_data + m_ndx;
+
+    *aLength = m_size - m_ndx;
+    m_ndx    = m_size;
+
+    return text;
+}
+
+
+std::unique_ptr<LINE_READER> OpenFileLineReader( const wxString& aFileName, bool aMapped )
+{
+    if( aMapped )
+        return std::unique_ptr<LINE_READER>( new MMAP_LINE_READER( aFileName ) );
+
+    return std::unique_ptr<LINE_READER>( new FILE_LINE_READER( aFileName ) );
+}
+
+
 STRING_LINE_READER::STRING_LINE_READER( const std::string& aString, const wxString& aSource ):
     LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
     m_lines( aString ), m_ndx( 0 )
@@ -365,19 +454,20 @@ const char* OUTPUTFORMATTER::GetQuoteChar( const char* wrapee )
 
 int OUTPUTFORMATTER::vprint( const char* fmt,  va_list ap )
 {
-    // This function can call vsnprintf twice.
+    // This function can call VsnprintfC twice.  Numbers are always written with a point as
+    // decimal separator, whatever the locale.
     // But internally, vsnprintf retrieves arguments from the va_list identified by arg as if
     // va_arg was used on it, and thus the state of the va_list is likely to be altered by the call.
     // see: www.cplusplus.com/reference/cstdio/vsnprintf
     // we make a copy of va_list ap for the second call, if happens
     va_list tmp;
     va_copy( tmp, ap );
-    int ret = vsnprintf( &m_buffer[0], m_buffer.size(), fmt, ap );
+    int ret = VsnprintfC( &m_buffer[0], m_buffer.size(), fmt, ap );
 
     if( ret >= (int) m_buffer.size() )
     {
         m_buffer.resize( ret + 1000 );
-        ret = vsnprintf( &m_buffer[0], m_buffer.size(), fmt, tmp );
+        ret = VsnprintfC( &m_buffer[0], m_buffer.size(), fmt, tmp );
     }
 
     va_end( tmp );      // Release the temporary va_list, initialised from ap
@@ -0,0 +1,304 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <thread_pool.h>
+#include <widgets/progress_reporter.h>
+
+#include <algorithm>
+
+
+/// The pool running the current thread (if any) and the index of the thread in the pool
+static thread_local const THREAD_POOL* t_pool = nullptr;
+static thread_local size_t             t_worker = 0;
+
+
+THREAD_POOL::THREAD_POOL( size_t aThreadCount ) :
+    m_pending( 0 ),
+    m_stop( false ),
+    m_nextQueue( 0 )
+{
+    if( aThreadCount == 0 )
+        aThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 1 );
+
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers.emplace_back( new WORKER() );
+
+    // Start the threads once all the queues exist, as they steal from each other
+    for( size_t ii = 0; ii < aThreadCount; ++ii )
+        m_workers[ii]->m_thread = std::thread( &THREAD_POOL::run, this, ii );
+}
+
+
+THREAD_POOL::~THREAD_POOL()
+{
+    {
+        std::lock_guard<std::mutex> lock( m_sleepLock );
+        m_stop = true;
+    }
+
+    m_wakeUp.notify_all();
+
+    // Workers only exit once all the queued tasks are done
+    for( auto& worker : m_workers )
+        worker->m_thread.join();
+}
+
+
+THREAD_POOL& THREAD_POOL::GetPool()
+{
+    static THREAD_POOL pool;
+    return pool;
+}
+
+
+size_t THREAD_POOL::GetSlot() const
+{
+    return t_pool == this ? t_worker : m_workers.size();
+}
+
+
+void THREAD_POOL::push( TASK&& aTask )
+{
+    size_t queue;
+
+    if( t_pool == this )
+        queue = t_worker;
+    else
+        queue = m_nextQueue++ % m_workers.size();
+
+    {
+        // The count is updated in the same critical section as the queue, so a worker which
+        // pops the task cannot decrement it first
+        std::lock_guard<std::mutex> lock( m_sleepLock );
+
+        {
+            std::lock_guard<std::mutex> queueLock( m_workers[queue]->m_lock );
+            m_workers[queue]->m_tasks.push_back( std::move( aTask ) );
+        }
+
+        m_pending++;
+    }
+
+    m_wakeUp.notify_one();
+}
+
+
+bool THREAD_POOL::pop( size_t aWorker, TASK& aTask )
+{
+    bool found = false;
+
+    // Newest task of our own queue first: it is the most likely to be in cache
+    {
+        WORKER& own = *m_workers[aWorker];
+        std::lock_guard<std::mutex> lock( own.m_lock );
+
+        if( !own.m_tasks.empty() )
+        {
+            aTask = std::move( own.m_tasks.back() );
+            own.m_tasks.pop_back();
+            found = true;
+        }
+    }
+
+    // Then the oldest task of another worker
+    for( size_t ii = 1; !found && ii < m_workers.size(); ++ii )
+    {
+        WORKER& victim = *m_workers[( aWorker + ii ) % m_workers.size()];
+        std::lock_guard<std::mutex> lock( victim.m_lock );
+
+        if( !victim.m_tasks.empty() )
+        {
+            aTask = std::move( victim.m_tasks.front() );
+            victim.m_tasks.pop_front();
+            found = true;
+        }
+    }
+
+    if( found )
+    {
+        std::lock_guard<std::mutex> lock( m_sleepLock );
+        m_pending--;
+    }
+
+    return found;
+}
+
+
+void THREAD_POOL::run( size_t aWorker )
+{
+    t_pool = this;
+    t_worker = aWorker;
+
+    while( true )
+    {
+        TASK task;
+
+        if( pop( aWorker, task ) )
+        {
+            task();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock( m_sleepLock );
+
+        m_wakeUp.wait( lock, [this]()
+                             {
+                                 return m_stop || m_pending > 0;
+                             } );
+
+        if( m_stop && m_pending == 0 )
+            return;
+    }
+}
+
+
+namespace
+{
+
+/**
+ * The state of a ParallelFor() call, shared with its helper tasks.  Helpers which start
+ * after all the items were taken return immediately, so they may outlive the call.
+ */
+struct PARALLEL_JOB
+{
+    PARALLEL_JOB( size_t aCount, const std::function<void( size_t )>& aFunc ) :
+        m_func( aFunc ),
+        m_count( aCount ),
+        m_next( 0 ),
+        m_done( 0 ),
+        m_cancelled( false )
+    {}
+
+    /// Only called while the ParallelFor() call is waiting, so it can be a reference
+    const std::function<void( size_t )>& m_func;
+
+    const size_t            m_count;
+    std::atomic<size_t>     m_next;
+    std::atomic<size_t>     m_done;
+    std::atomic<bool>       m_cancelled;
+
+    std::mutex              m_lock;
+    std::condition_variable m_finished;
+    std::exception_ptr      m_error;            ///< protected by m_lock
+};
+
+
+void runItems( PARALLEL_JOB& aJob )
+{
+    for( size_t i = aJob.m_next++; i < aJob.m_count; i = aJob.m_next++ )
+    {
+        if( !aJob.m_cancelled )
+        {
+            try
+            {
+                aJob.m_func( i );
+            }
+            catch( ... )
+            {
+                std::lock_guard<std::mutex> lock( aJob.m_lock );
+
+                if( !aJob.m_error )
+                    aJob.m_error = std::current_exception();
+
+                aJob.m_cancelled = true;
+            }
+        }
+
+        if( ++aJob.m_done == aJob.m_count )
+        {
+            std::lock_guard<std::mutex> lock( aJob.m_lock );
+            aJob.m_finished.notify_all();
+        }
+    }
+}
+
+} // namespace
+
+
+bool THREAD_POOL::ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                               const WAIT_HOOK& aOnWait )
+{
+    if( aCount == 0 )
+        return true;
+
+    auto job = std::make_shared<PARALLEL_JOB>( aCount, aFunc );
+    bool hookCancelled = false;
+
+    // Without a hook the calling thread takes its share of the items
+    size_t helpers = std::min( m_workers.size(), aOnWait ? aCount : aCount - 1 );
+
+    for( size_t ii = 0; ii < helpers; ++ii )
+    {
+        push( [job]()
+              {
+                  runItems( *job );
+              } );
+    }
+
+    if( !aOnWait )
+        runItems( *job );
+
+    {
+        std::unique_lock<std::mutex> lock( job->m_lock );
+
+        while( job->m_done < aCount )
+        {
+            if( !aOnWait )
+            {
+                job->m_finished.wait( lock );
+            }
+            else if( job->m_finished.wait_for( lock,
+                             std::chrono::milliseconds( WAIT_HOOK_INTERVAL_MS ) )
+                     == std::cv_status::timeout )
+            {
+                lock.unlock();
+
+                if( !aOnWait() && !hookCancelled )
+                {
+                    hookCancelled = true;
+                    job->m_cancelled = true;
+                }
+
+                lock.lock();
+            }
+        }
+
+        if( job->m_error )
+            std::rethrow_exception( job->m_error );
+    }
+
+    return !hookCancelled;
+}
+
+
+THREAD_POOL::WAIT_HOOK THREAD_POOL::ReporterHook( PROGRESS_REPORTER* aReporter, bool aCanCancel )
+{
+    if( !aReporter )
+        return nullptr;
+
+    return [aReporter, aCanCancel]() -> bool
+           {
+               return aReporter->KeepRefreshing() || !aCanCancel;
+           };
+}
@@ -27,11 +27,13 @@
 #include <wx/mstream.h>
 #include <wx/filename.h>
 #include <wx/tokenzr.h>
+#include <advanced_config.h>
 #include <pgm_base.h>
 #include <draw_graphic_text.h>
 #include <kiway.h>
 #include <kicad_string.h>
 #include <richio.h>
+#include <numeric_io.h>
 #include <core/typeinfo.h>
 #include <properties.h>
 #include <trace_helpers.h>
@@ -151,12 +153,12 @@ static int parseInt( LINE_READER& aReader, const char* aLine, const char** aOutp
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
 
-    // Clear errno before calling strtol() in case some other crt call set it.
+    // Clear errno before calling ParseLong() in case some other crt call set it.
     errno = 0;
 
-    long retv = strtol( aLine, (char**) aOutput, 10 );
+    long retv = ParseLong( aLine, aOutput );
 
-    // Make sure no error occurred when calling strtol().
+    // Make sure no error occurred when calling ParseLong().
     if( errno == ERANGE )
         SCH_PARSE_ERROR( "invalid integer value", aReader, aLine );
 
@@ -240,12 +242,12 @@ static double parseDouble( LINE_READER& aReader, const char* aLine,
     if( !*aLine )
         SCH_PARSE_ERROR( _( "unexpected end of line" ), aReader, aLine );
 
-    // Clear errno before calling strtod() in case some other crt call set it.
+    // Clear errno before calling ParseDouble() in case some other crt call set it.
     errno = 0;
 
-    double retv = strtod( aLine, (char**) aOutput );
+    double retv = ParseDouble( aLine, aOutput );
 
-    // Make sure no error occurred when calling strtod().
+    // Make sure no error occurred when calling ParseDouble().
     if( errno == ERANGE )
         SCH_PARSE_ERROR( "invalid floating point number", aReader, aLine );
 
@@ -480,7 +482,7 @@ class SCH_LEGACY_PLUGIN_CACHE
     int             m_versionMinor;
     int             m_libType;      // Is this cache a component or symbol library.
 
-    void                  loadHeader( FILE_LINE_READER& aReader );
+    void                  loadHeader( LINE_READER& aReader );
     static void           loadAliases( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
     static void           loadField( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader );
     static void           loadDrawEntries( std::unique_ptr<LIB_PART>& aPart, LINE_READER& aReader,
@@ -731,7 +733,9 @@ void SCH_LEGACY_PLUGIN::loadHierarchy( SCH_SHEET* aSheet )
 
 void SCH_LEGACY_PLUGIN::loadFile( const wxString& aFileName, SCH_SCREEN* aScreen )
 {
-    FILE_LINE_READER reader( aFileName );
+    std::unique_ptr<LINE_READER> input = OpenFileLineReader( aFileName,
+            ADVANCED_CFG::GetCfg().m_useMmapLineReader );
+    LINE_READER& reader = *input;
 
     loadHeader( reader, aScreen );
 
@@ -2492,7 +2496,9 @@ void SCH_LEGACY_PLUGIN_CACHE::Load()
     wxLogTrace( traceSchLegacyPlugin, "Loading legacy symbol file \"%s\"",
                 m_libFileName.GetFullPath() );
 
-    FILE_LINE_READER reader( m_libFileName.GetFullPath() );
+    std::unique_ptr<LINE_READER> input = OpenFileLineReader( m_libFileName.GetFullPath(),
+            ADVANCED_CFG::GetCfg().m_useMmapLineReader );
+    LINE_READER& reader = *input;
 
     if( !reader.ReadLine() )
         THROW_IO_ERROR( _( "unexpected end of file" ) );
@@ -2623,7 +2629,9 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
         THROW_IO_ERROR( wxString::Format( _( "user does not have permission to read library "
                                              "document file \"%s\"" ), fn.GetFullPath() ) );
 
-    FILE_LINE_READER reader( fn.GetFullPath() );
+    std::unique_ptr<LINE_READER> input = OpenFileLineReader( fn.GetFullPath(),
+            ADVANCED_CFG::GetCfg().m_useMmapLineReader );
+    LINE_READER& reader = *input;
 
     line = reader.ReadLine();
 
@@ -2706,7 +2714,7 @@ void SCH_LEGACY_PLUGIN_CACHE::loadDocs()
 }
 
 
-void SCH_LEGACY_PLUGIN_CACHE::loadHeader( FILE_LINE_READER& aReader )
+void SCH_LEGACY_PLUGIN_CACHE::loadHeader( LINE_READER& aReader )
 {
     const char* line = aReader.Line();
 
@@ -73,7 +73,7 @@
 #include <excellon_image.h>
 #include <kicad_string.h>
 #include <X2_gerber_attributes.h>
-#include <view/view.h>
+#include <reporter.h>
 
 #include <cmath>
 
@@ -241,18 +241,10 @@ static EXCELLON_CMD excellon_G_CmdList[] =
 };
 
 
-bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
+bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName, bool aAddToHistory )
 {
     wxString msg;
-    int layerId = GetActiveLayer();      // current layer used in GerbView
-    GERBER_FILE_IMAGE_LIST* images = GetGerberLayout()->GetImagesList();
-    auto gerber_layer = images->GetGbrImage( layerId );
-
-    // OIf the active layer contains old gerber or nc drill data, remove it
-    if( gerber_layer )
-        Erase_Current_DrawLayer( false );
-
-    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( layerId );
+    EXCELLON_IMAGE* drill_layer = new EXCELLON_IMAGE( GetActiveLayer() );
 
     // Read the Excellon drill file:
     bool success = drill_layer->LoadFile( aFullFileName );
@@ -265,38 +257,18 @@ bool GERBVIEW_FRAME::Read_EXCELLON_File( const wxString& aFullFileName )
         return false;
     }
 
-    layerId = images->AddGbrImage( drill_layer, layerId );
+    WX_STRING_REPORTER reporter( &msg );
 
-    if( layerId < 0 )
-    {
-        delete drill_layer;
-        DisplayError( this, _( "No room to load file" ) );
-        return false;
-    }
+    success = registerImage( drill_layer, true, aAddToHistory, reporter );
 
     // Display errors list
-    if( drill_layer->GetMessages().size() > 0 )
+    if( !msg.IsEmpty() )
     {
         HTML_MESSAGE_BOX dlg( this, _( "Error reading EXCELLON drill file" ) );
-        dlg.ListSet( drill_layer->GetMessages() );
+        dlg.ListSet( msg );
         dlg.ShowModal();
     }
 
-    if( success )
-    {
-        EDA_DRAW_PANEL_GAL* canvas = GetGalCanvas();
-
-        if( canvas )
-        {
-            KIGFX::VIEW* view = canvas->GetView();
-
-            for( GERBER_DRAW_ITEM* item = drill_layer->GetItemsList(); item; item = item->Next() )
-            {
-                view->Add( (KIGFX::VIEW_ITEM*) item );
-            }
-        }
-    }
-
     return success;
 }
 
@@ -40,6 +40,8 @@
 #include <gerbview_layer_widget.h>
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
+#include <thread_pool.h>
+#include <view/view.h>
 
 // HTML Messages used more than one time:
 #define MSG_NO_MORE_LAYER\
@@ -272,11 +274,16 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
     wxString msg;
     WX_STRING_REPORTER reporter( &msg );
 
-    // Show progress dialog after 1 second of loading
-    static const long long progressShowDelay = 1000;
+    // The files to read, in the order of aFilenameList
+    struct FILE_TO_LOAD
+    {
+        wxString                           m_fullName;
+        bool                               m_isDrill;
+        bool                               m_loaded;
+        std::unique_ptr<GERBER_FILE_IMAGE> m_image;
+    };
 
-    auto startTime = wxGetUTCTimeMillis();
-    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    std::vector<FILE_TO_LOAD> files;
 
     for( unsigned ii = 0; ii < aFilenameList.GetCount(); ii++ )
     {
@@ -297,66 +304,117 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
             continue;
         }
 
+        FILE_TO_LOAD file;
+        file.m_fullName = filename.GetFullPath();
+        file.m_isDrill  = aFileType && (*aFileType)[ii] == 1;
+        file.m_loaded   = false;
+        files.push_back( std::move( file ) );
+    }
+
+    // Show progress dialog after 1 second of loading
+    static const long long progressShowDelay = 1000;
+
+    auto startTime = wxGetUTCTimeMillis();
+    std::unique_ptr<WX_PROGRESS_REPORTER> progress = nullptr;
+    std::atomic<int> parsedCount( 0 );
+    int reportedCount = 0;
+
+    // Each file is parsed in its own image, independently of the others, so all the files
+    // are read at the same time.  The images are added to the image list later, in order.
+    auto parseFile = [&]( size_t aIdx )
+    {
+        FILE_TO_LOAD& file = files[aIdx];
+
+        if( file.m_isDrill )
+        {
+            EXCELLON_IMAGE* drill_image = new EXCELLON_IMAGE( 0 );
+            file.m_image.reset( drill_image );
+            file.m_loaded = drill_image->LoadFile( file.m_fullName );
+        }
+        else
+        {
+            file.m_image.reset( new GERBER_FILE_IMAGE( 0 ) );
+            file.m_loaded = file.m_image->LoadGerberFile( file.m_fullName );
+        }
+
+        parsedCount++;
+    };
+
+    auto onWait = [&]() -> bool
+    {
         if( !progress && wxGetUTCTimeMillis() - startTime > progressShowDelay )
         {
-            progress = std::make_unique<WX_PROGRESS_REPORTER>( this,
-                            _( "Loading Gerber files..." ), 1, false );
-            progress->SetMaxProgress( aFilenameList.GetCount() - 1 );
+            progress.reset( new WX_PROGRESS_REPORTER( this, _( "Loading Gerber files..." ),
+                                                      1, false ) );
+            progress->SetMaxProgress( files.size() );
             progress->Report( _("Loading Gerber files..." ) );
         }
-        else if( progress )
+
+        if( progress )
         {
+            for( ; reportedCount < parsedCount; reportedCount++ )
+                progress->AdvanceProgress();
+
             progress->KeepRefreshing();
         }
 
-        m_lastFileName = filename.GetFullPath();
+        return true;
+    };
 
-        SetActiveLayer( layer, false );
+    // Each parser switches its own thread to the "C" locale
+    THREAD_POOL::GetPool().ParallelFor( files.size(), parseFile, onWait );
 
-        visibility[ layer ] = true;
+    for( unsigned ii = 0; ii < files.size(); ii++ )
+    {
+        FILE_TO_LOAD& file = files[ii];
 
-        if( aFileType && (*aFileType)[ii] == 1 )
+        if( !file.m_loaded )
         {
-            LoadExcellonFiles( filename.GetFullPath() );
-            layer = GetActiveLayer();   // Loading NC drill file changes the active layer
+            wxString txt = wxString::Format( _( "<b>File \"%s\" cannot be read</b>\n" ),
+                                             file.m_fullName );
+            reporter.Report( txt, REPORTER::RPT_ERROR );
+            success = false;
+            continue;
         }
-        else
+
+        if( layer == NO_AVAILABLE_LAYERS )
         {
-            if( Read_GERBER_File( filename.GetFullPath() ) )
+            success = false;
+            reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+
+            // Report the name of not loaded files:
+            while( ii < files.size() )
             {
-                UpdateFileHistory( m_lastFileName );
+                filename = files[ii++].m_fullName;
+                wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
+                reporter.Report( txt, REPORTER::RPT_ERROR );
+            }
+            break;
+        }
 
-                layer = getNextAvailableLayer( layer );
+        m_lastFileName = file.m_fullName;
 
-                if( layer == NO_AVAILABLE_LAYERS && ii < aFilenameList.GetCount()-1 )
-                {
-                    success = false;
-                    reporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
-
-                    // Report the name of not loaded files:
-                    ii += 1;
-                    while( ii < aFilenameList.GetCount() )
-                    {
-                        filename = aFilenameList[ii++];
-                        wxString txt = wxString::Format( MSG_NOT_LOADED, filename.GetFullName() );
-                        reporter.Report( txt, REPORTER::RPT_ERROR );
-                    }
-                    break;
-                }
+        SetActiveLayer( layer, false );
 
-                SetActiveLayer( layer, false );
-            }
+        if( !registerImage( file.m_image.release(), file.m_isDrill, true, reporter ) )
+        {
+            success = false;
+            continue;
         }
 
-        if( progress )
-            progress->AdvanceProgress();
+        visibility[ layer ] = true;
+
+        layer = getNextAvailableLayer( layer );
+
+        if( layer != NO_AVAILABLE_LAYERS )
+            SetActiveLayer( layer, false );
     }
 
-    if( !success )
+    if( !msg.IsEmpty() )
     {
         wxSafeYield();  // Allows slice of time to redraw the screen
                         // to refresh widgets, before displaying messages
-        HTML_MESSAGE_BOX mbox( this, _( "Errors" ) );
+        HTML_MESSAGE_BOX mbox( this, success ? _( "Messages" ) : _( "Errors" ) );
         mbox.ListSet( msg );
         mbox.ShowModal();
     }
@@ -384,6 +442,69 @@ bool GERBVIEW_FRAME::loadListOfGerberAndDrillFiles( const wxString& aPath,
 }
 
 
+bool GERBVIEW_FRAME::registerImage( GERBER_FILE_IMAGE* aImage, bool aIsDrill,
+                                    bool aAddToHistory, REPORTER& aReporter )
+{
+    int layer = GetActiveLayer();
+
+    // The image replaces the content of the active layer, if any
+    if( GetGbrImage( layer ) )
+        Erase_Current_DrawLayer( false );
+
+    aImage->m_GraphicLayer = layer;
+
+    if( GetImagesList()->AddGbrImage( aImage, layer ) < 0 )
+    {
+        delete aImage;
+        aReporter.Report( MSG_NO_MORE_LAYER, REPORTER::RPT_ERROR );
+        return false;
+    }
+
+    if( aAddToHistory )
+    {
+        if( aIsDrill )
+            UpdateFileHistory( aImage->m_FileName, &m_drillFileHistory );
+        else
+            UpdateFileHistory( aImage->m_FileName );
+    }
+
+    // Collect the errors of all files, to display them in one list
+    if( aImage->GetMessages().size() > 0 )
+    {
+        aReporter.Report( wxString::Format( "<b>%s</b>\n", aImage->m_FileName ),
+                          REPORTER::RPT_WARNING );
+
+        for( const wxString& message : aImage->GetMessages() )
+            aReporter.Report( message + "\n", REPORTER::RPT_WARNING );
+    }
+
+    /* if the gerber file is only a RS274D file
+     * (i.e. without any aperture information, but with items), warn the user:
+     */
+    if( !aIsDrill && !aImage->m_Has_DCode && aImage->GetItemsList() )
+    {
+        aReporter.Report( wxString::Format( _( "<b>%s</b>: this file has no D-Code "
+                                               "definition. It is perhaps an old RS274D "
+                                               "file, therefore the size of items is "
+                                               "undefined\n" ),
+                                            aImage->m_FileName ),
+                          REPORTER::RPT_WARNING );
+    }
+
+    EDA_DRAW_PANEL_GAL* canvas = GetGalCanvas();
+
+    if( canvas )
+    {
+        KIGFX::VIEW* view = canvas->GetView();
+
+        for( GERBER_DRAW_ITEM* item = aImage->GetItemsList(); item; item = item->Next() )
+            view->Add( (KIGFX::VIEW_ITEM*) item );
+    }
+
+    return true;
+}
+
+
 bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 {
     wxString   filetypes;
@@ -442,11 +563,8 @@ bool GERBVIEW_FRAME::LoadExcellonFiles( const wxString& aFullFileName )
 
         SetActiveLayer( layer, false );
 
-        if( Read_EXCELLON_File( filename.GetFullPath() ) )
+        if( Read_EXCELLON_File( filename.GetFullPath(), true ) )
         {
-            // Update the list of recent drill files.
-            UpdateFileHistory( filename.GetFullPath(), &m_drillFileHistory );
-
             layer = getNextAvailableLayer( layer );
 
             if( layer == NO_AVAILABLE_LAYERS && ii < filenamesList.GetCount()-1 )
@@ -0,0 +1,399 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_rasterizer.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <common.h>
+#include <macros.h>
+#include <trigo.h>
+#include <convert_basic_shapes_to_polygon.h>
+#include <geometry/geometry_utils.h>
+#include <geometry/shape_poly_set.h>
+
+#include <gerber_file_image.h>
+#include <gerber_draw_item.h>
+#include <dcode.h>
+#include <am_primitive.h>
+#include <gerber_rasterizer.h>
+
+
+// Height of the bands used to find the polygons of a row, in pixels
+static const int BUCKET_ROWS = 64;
+
+
+GERBER_RASTERIZER::GERBER_RASTERIZER( GERBER_FILE_IMAGE* aImage, double aPixelSize ) :
+    m_pixelSize( aPixelSize ),
+    m_maxError( std::max( 1, KiROUND( aPixelSize / 4 ) ) ),
+    m_hasNegativeItems( aImage->HasNegativeItems() ),
+    m_bucketHeight( std::max( 1, KiROUND( aPixelSize * BUCKET_ROWS ) ) )
+{
+    for( GERBER_DRAW_ITEM* item = aImage->GetItemsList(); item; item = item->Next() )
+        addItem( item, item->GetLayerPolarity() ^ aImage->m_ImageNegative );
+
+    // A negative image is dark where there are no items: paint its area first
+    if( aImage->m_ImageNegative && !m_polygons.empty() )
+    {
+        CONTOUR contour;
+        contour.m_firstPoint = m_points.size();
+        contour.m_pointCount = 4;
+
+        m_points.push_back( m_bbox.GetOrigin() );
+        m_points.push_back( VECTOR2I( m_bbox.GetRight(), m_bbox.GetY() ) );
+        m_points.push_back( m_bbox.GetEnd() );
+        m_points.push_back( VECTOR2I( m_bbox.GetX(), m_bbox.GetBottom() ) );
+
+        POLYGON background;
+        background.m_bbox = m_bbox;
+        background.m_firstContour = m_contours.size();
+        background.m_contourCount = 1;
+        background.m_clear = false;
+
+        m_contours.push_back( contour );
+        m_polygons.insert( m_polygons.begin(), background );
+    }
+
+    buildBuckets();
+}
+
+
+int GERBER_RASTERIZER::circleSegments( int aRadius ) const
+{
+    return std::max( 8, GetArcToSegmentCount( aRadius, m_maxError, 360.0 ) );
+}
+
+
+void GERBER_RASTERIZER::addItem( GERBER_DRAW_ITEM* aItem, bool aClear )
+{
+    // The shapes are the ones drawn by GERBVIEW_PAINTER::draw(), in filled mode
+    SHAPE_POLY_SET shape;
+    D_CODE*        code = aItem->GetDcodeDescr();
+    int            width = aItem->m_Size.x;
+
+    switch( aItem->m_Shape )
+    {
+    case GBR_POLYGON:
+        addShape( aItem->m_Polygon, aClear, aItem );
+        return;
+
+    case GBR_CIRCLE:
+    {
+        int radius = KiROUND( GetLineLength( aItem->m_Start, aItem->m_End ) );
+        TransformRingToPolygon( shape, aItem->GetABPosition( aItem->m_Start ), radius,
+                                circleSegments( radius + width / 2 ), width );
+        break;
+    }
+
+    case GBR_ARC:
+    {
+        wxPoint center = aItem->GetABPosition( aItem->m_ArcCentre );
+        wxPoint start = aItem->GetABPosition( aItem->m_Start );
+        wxPoint end = aItem->GetABPosition( aItem->m_End );
+        int     radius = KiROUND( GetLineLength( aItem->m_Start, aItem->m_ArcCentre ) );
+        int     segments = circleSegments( radius + width / 2 );
+
+        // 360-degree arcs are stored in the file with start equal to end
+        if( aItem->m_Start == aItem->m_End )
+        {
+            TransformRingToPolygon( shape, center, radius, segments, width );
+            break;
+        }
+
+        // The arc goes from the end to the start point, in the direction of increasing
+        // angles, which is the direction TransformArcToPolygon() turns to.
+        double arcAngle = ArcTangente( start.y - center.y, start.x - center.x )
+                          - ArcTangente( end.y - center.y, end.x - center.x );
+        NORMALIZE_ANGLE_POS( arcAngle );
+
+        TransformArcToPolygon( shape, center, end, arcAngle, segments, width );
+        break;
+    }
+
+    case GBR_SEGMENT:
+        // A segment drawn with a rectangular aperture
+        if( code && code->m_Shape == APT_RECT )
+        {
+            aItem->ConvertSegmentToPolygon();
+            addShape( aItem->m_Polygon, aClear, aItem );
+            return;
+        }
+
+        TransformRoundedEndsSegmentToPolygon( shape, aItem->GetABPosition( aItem->m_Start ),
+                                              aItem->GetABPosition( aItem->m_End ),
+                                              circleSegments( width / 2 ), width );
+        break;
+
+    case GBR_SPOT_CIRCLE:
+    case GBR_SPOT_RECT:
+    case GBR_SPOT_OVAL:
+    case GBR_SPOT_POLY:
+    {
+        if( !code )
+            return;
+
+        if( aItem->m_Shape == GBR_SPOT_CIRCLE && code->m_DrillShape == APT_DEF_NO_HOLE )
+        {
+            // Use the accuracy of the raster rather than the one of the D_CODE shape
+            int radius = code->m_Size.x / 2;
+            TransformCircleToPolygon( shape, aItem->GetABPosition( aItem->m_Start ), radius,
+                                      circleSegments( radius ) );
+            break;
+        }
+
+        if( code->m_Polygon.OutlineCount() == 0 )
+            code->ConvertShapeToPolygon();
+
+        SHAPE_POLY_SET flashed = code->m_Polygon;
+        flashed.Move( aItem->m_Start );
+        addShape( flashed, aClear, aItem );
+        return;
+    }
+
+    case GBR_SPOT_MACRO:
+    {
+        APERTURE_MACRO* macro = code ? code->GetMacro() : nullptr;
+
+        if( !macro )
+            return;
+
+        // The macro shape is already in image coordinates
+        addShape( *macro->GetApertureMacroShape( aItem, aItem->m_Start ), aClear );
+        return;
+    }
+
+    default:
+        wxASSERT_MSG( false, wxT( "GERBER_DRAW_ITEM shape is unknown!" ) );
+        return;
+    }
+
+    addShape( shape, aClear );
+}
+
+
+void GERBER_RASTERIZER::addShape( const SHAPE_POLY_SET& aShape, bool aClear,
+                                  const GERBER_DRAW_ITEM* aItem )
+{
+    for( int ii = 0; ii < aShape.OutlineCount(); ii++ )
+    {
+        POLYGON polygon;
+        polygon.m_firstContour = m_contours.size();
+        polygon.m_contourCount = 0;
+        polygon.m_clear = aClear;
+
+        VECTOR2I bbMin( std::numeric_limits<int>::max(), std::numeric_limits<int>::max() );
+        VECTOR2I bbMax( std::numeric_limits<int>::min(), std::numeric_limits<int>::min() );
+
+        for( int jj = -1; jj < aShape.HoleCount( ii ); jj++ )
+        {
+            const SHAPE_LINE_CHAIN& chain = jj < 0 ? aShape.COutline( ii ) : aShape.CHole( ii, jj );
+
+            if( chain.PointCount() < 2 )
+                continue;
+
+            CONTOUR contour;
+            contour.m_firstPoint = m_points.size();
+            contour.m_pointCount = chain.PointCount();
+
+            for( int kk = 0; kk < chain.PointCount(); kk++ )
+            {
+                VECTOR2I pt = chain.CPoint( kk );
+
+                if( aItem )
+                    pt = aItem->GetABPosition( wxPoint( pt.x, pt.y ) );
+
+                bbMin.x = std::min( bbMin.x, pt.x );
+                bbMin.y = std::min( bbMin.y, pt.y );
+                bbMax.x = std::max( bbMax.x, pt.x );
+                bbMax.y = std::max( bbMax.y, pt.y );
+
+                m_points.push_back( pt );
+            }
+
+            m_contours.push_back( contour );
+            polygon.m_contourCount++;
+        }
+
+        if( polygon.m_contourCount == 0 )
+            continue;
+
+        polygon.m_bbox = BOX2I( bbMin, bbMax - bbMin );
+
+        if( m_polygons.empty() )
+            m_bbox = polygon.m_bbox;
+        else
+            m_bbox.Merge( polygon.m_bbox );
+
+        m_polygons.push_back( polygon );
+    }
+}
+
+
+void GERBER_RASTERIZER::buildBuckets()
+{
+    if( m_polygons.empty() )
+        return;
+
+    m_buckets.resize( m_bbox.GetHeight() / m_bucketHeight + 1 );
+
+    for( int ii = 0; ii < (int) m_polygons.size(); ii++ )
+    {
+        const BOX2I& bbox = m_polygons[ii].m_bbox;
+        int          first = ( bbox.GetY() - m_bbox.GetY() ) / m_bucketHeight;
+        int          last = ( bbox.GetBottom() - m_bbox.GetY() ) / m_bucketHeight;
+
+        for( int bucket = first; bucket <= last; bucket++ )
+            m_buckets[bucket].push_back( ii );
+    }
+}
+
+
+void GERBER_RASTERIZER::RasterizeRows( const VECTOR2I& aOrigin, int aWidth, int aFirstRow,
+                                       int aRowCount, uint8_t* aPixels ) const
+{
+    memset( aPixels, 0, (size_t) aWidth * aRowCount );
+
+    if( m_polygons.empty() || aRowCount <= 0 || aWidth <= 0 )
+        return;
+
+    // Centres of the first and last rows, in internal units
+    double firstY = aOrigin.y + ( aFirstRow + 0.5 ) * m_pixelSize;
+    double lastY = aOrigin.y + ( aFirstRow + aRowCount - 0.5 ) * m_pixelSize;
+
+    if( lastY < m_bbox.GetY() || firstY > m_bbox.GetBottom() )
+        return;
+
+    // The polygons which can cover the rows, in the file order
+    int lastBucket = m_buckets.size() - 1;
+    int firstBucket = Clamp( 0, (int) ( ( firstY - m_bbox.GetY() ) / m_bucketHeight ), lastBucket );
+    int endBucket = Clamp( 0, (int) ( ( lastY - m_bbox.GetY() ) / m_bucketHeight ), lastBucket );
+
+    std::vector<int>        merged;
+    const std::vector<int>* candidates = &m_buckets[firstBucket];
+
+    if( endBucket != firstBucket )
+    {
+        for( int bucket = firstBucket; bucket <= endBucket; bucket++ )
+            merged.insert( merged.end(), m_buckets[bucket].begin(), m_buckets[bucket].end() );
+
+        std::sort( merged.begin(), merged.end() );
+        merged.erase( std::unique( merged.begin(), merged.end() ), merged.end() );
+        candidates = &merged;
+    }
+
+    // A non horizontal edge, with y0 < y1
+    struct EDGE
+    {
+        double m_y0;
+        double m_y1;
+        double m_x0;
+        double m_slope;     ///< dx / dy
+    };
+
+    std::vector<EDGE>   edges;
+    std::vector<double> crossings;
+
+    for( int idx : *candidates )
+    {
+        const POLYGON& polygon = m_polygons[idx];
+
+        if( polygon.m_bbox.GetBottom() < firstY || polygon.m_bbox.GetY() > lastY )
+            continue;
+
+        edges.clear();
+
+        for( int ii = 0; ii < polygon.m_contourCount; ii++ )
+        {
+            const CONTOUR&  contour = m_contours[polygon.m_firstContour + ii];
+            const VECTOR2I* pts = &m_points[contour.m_firstPoint];
+
+            for( int jj = 0; jj < contour.m_pointCount; jj++ )
+            {
+                const VECTOR2I& a = pts[jj];
+                const VECTOR2I& b = pts[( jj + 1 ) % contour.m_pointCount];
+
+                if( a.y == b.y )
+                    continue;
+
+                const VECTOR2I& top = a.y < b.y ? a : b;
+                const VECTOR2I& bottom = a.y < b.y ? b : a;
+
+                if( bottom.y < firstY || top.y > lastY )
+                    continue;
+
+                EDGE edge;
+                edge.m_y0 = top.y;
+                edge.m_y1 = bottom.y;
+                edge.m_x0 = top.x;
+                edge.m_slope = double( bottom.x - top.x ) / double( bottom.y - top.y );
+                edges.push_back( edge );
+            }
+        }
+
+        if( edges.empty() )
+            continue;
+
+        // Rows of the band whose centre is inside the polygon bounding box
+        int rowStart = std::max( 0, (int) std::ceil( ( polygon.m_bbox.GetY() - aOrigin.y )
+                                                     / m_pixelSize - 0.5 ) - aFirstRow );
+        int rowEnd = std::min( aRowCount - 1,
+                               (int) std::floor( ( polygon.m_bbox.GetBottom() - aOrigin.y )
+                                                 / m_pixelSize - 0.5 ) - aFirstRow );
+        uint8_t value = polygon.m_clear ? 0 : 1;
+
+        for( int row = rowStart; row <= rowEnd; row++ )
+        {
+            double y = aOrigin.y + ( aFirstRow + row + 0.5 ) * m_pixelSize;
+
+            // Edges are half open, so a vertex on the row is crossed once
+            crossings.clear();
+
+            for( const EDGE& edge : edges )
+            {
+                if( y >= edge.m_y0 && y < edge.m_y1 )
+                    crossings.push_back( edge.m_x0 + ( y - edge.m_y0 ) * edge.m_slope );
+            }
+
+            std::sort( crossings.begin(), crossings.end() );
+
+            uint8_t* line = aPixels + (size_t) row * aWidth;
+
+            // Even-odd rule: fill the pixels whose centre is between two crossings
+            for( size_t ii = 0; ii + 1 < crossings.size(); ii += 2 )
+            {
+                int first = std::max( 0, (int) std::ceil( ( crossings[ii] - aOrigin.x )
+                                                          / m_pixelSize - 0.5 ) );
+                int end = std::min( aWidth, (int) std::ceil( ( crossings[ii + 1] - aOrigin.x )
+                                                             / m_pixelSize - 0.5 ) );
+
+                if( end > first )
+                    memset( line + first, value, end - first );
+            }
+        }
+    }
+}
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file gerber_rasterizer.h
+ * converts the items of a Gerber or drill image to pixels, without any display
+ */
+
+#ifndef GERBER_RASTERIZER_H
+#define GERBER_RASTERIZER_H
+
+#include <cstdint>
+#include <vector>
+
+#include <math/box2.h>
+#include <math/vector2d.h>
+
+class GERBER_FILE_IMAGE;
+class GERBER_DRAW_ITEM;
+class SHAPE_POLY_SET;
+
+
+/**
+ * Class GERBER_RASTERIZER
+ * renders the items of a GERBER_FILE_IMAGE to a 1 bit per pixel raster, a few rows at a
+ * time, so a large image never needs its full bitmap in memory.
+ *
+ * The constructor converts each item (tracks, arcs, regions, flashed apertures and aperture
+ * macros) to polygons in image coordinates, as GerbView draws them.  Items are painted in
+ * the file order: clear items (negative layer polarity) erase the dark items drawn before
+ * them.  Once constructed, the rasterizer does not use the image anymore and RasterizeRows()
+ * can be called from several threads.
+ */
+class GERBER_RASTERIZER
+{
+public:
+    /**
+     * @param aImage is the image to render.  The D_CODE and aperture macro shapes of the
+     * image are built when needed, so an image must not be used by two threads while its
+     * rasterizer is constructed.
+     * @param aPixelSize is the size of a pixel, in internal units.
+     */
+    GERBER_RASTERIZER( GERBER_FILE_IMAGE* aImage, double aPixelSize );
+
+    /**
+     * @return the bounding box of the image in internal units, empty if the image has no
+     * items.
+     */
+    const BOX2I& GetBoundingBox() const { return m_bbox; }
+
+    /**
+     * @return true if some items are clear, so the image cannot be rendered in any order.
+     */
+    bool HasNegativeItems() const { return m_hasNegativeItems; }
+
+    /**
+     * Function RasterizeRows
+     * renders a band of rows of a raster.  A pixel is dark when its centre is inside the
+     * image.
+     *
+     * @param aOrigin is the top left corner of the raster, in internal units.
+     * @param aWidth is the width of the raster in pixels.
+     * @param aFirstRow is the first row to render.
+     * @param aRowCount is the number of rows to render.
+     * @param aPixels receives the rows: aWidth * aRowCount bytes, 1 for dark pixels and 0
+     * for the others.
+     */
+    void RasterizeRows( const VECTOR2I& aOrigin, int aWidth, int aFirstRow, int aRowCount,
+                        uint8_t* aPixels ) const;
+
+private:
+    /// A polygon (an outline and its holes) of an item
+    struct POLYGON
+    {
+        BOX2I   m_bbox;
+        int     m_firstContour;     ///< index in m_contours
+        int     m_contourCount;
+        bool    m_clear;
+    };
+
+    /// A closed contour, stored in m_points
+    struct CONTOUR
+    {
+        int     m_firstPoint;
+        int     m_pointCount;
+    };
+
+    void addItem( GERBER_DRAW_ITEM* aItem, bool aClear );
+
+    /// Adds the polygons of aShape, which are in XY coordinates if aItem is not NULL
+    void addShape( const SHAPE_POLY_SET& aShape, bool aClear,
+                   const GERBER_DRAW_ITEM* aItem = nullptr );
+
+    void buildBuckets();
+
+    /// @return the number of segments to approximate a circle of radius aRadius
+    int circleSegments( int aRadius ) const;
+
+    double                  m_pixelSize;
+    int                     m_maxError;         ///< of arcs approximation, in internal units
+    BOX2I                   m_bbox;
+    bool                    m_hasNegativeItems;
+
+    std::vector<POLYGON>    m_polygons;         ///< in the file order
+    std::vector<CONTOUR>    m_contours;
+    std::vector<VECTOR2I>   m_points;
+
+    /// m_polygons indices, in increasing order, for horizontal bands of m_bucketHeight
+    /// starting at the top of m_bbox
+    std::vector<std::vector<int>> m_buckets;
+    int                     m_bucketHeight;
+};
+
+#endif  // GERBER_RASTERIZER_H
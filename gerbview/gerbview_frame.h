@@ -193,6 +193,8 @@ private:
 
     /**
      * Loads a list of Gerber and NC drill files and updates the view based on them
+     * The files are parsed in parallel, then added to the image list in the list order,
+     * each one on the next available layer, starting at the active layer.
      * @param aPath is the base path for the filenames if they are relative
      * @param aFilenameList is a list of filenames to load
      * @param aFileType is a list of type of files to load (0 = Gerber, 1 = NC drill)
@@ -203,6 +205,18 @@ private:
                                         const wxArrayString& aFilenameList,
                                         const std::vector<int>* aFileType = nullptr );
 
+    /**
+     * Adds a parsed Gerber or NC drill image to the active layer, in place of the previous
+     * content of this layer, and adds its items to the view.
+     * @param aImage is the image, owned by the image list if it is added, deleted otherwise
+     * @param aIsDrill is true for a NC drill image
+     * @param aAddToHistory is true to add the file of the image to the recent files
+     * @param aReporter collects the messages of the parser and the warnings about the image
+     * @return true if the image was added
+     */
+    bool registerImage( GERBER_FILE_IMAGE* aImage, bool aIsDrill, bool aAddToHistory,
+                        REPORTER& aReporter );
+
 public:
     GERBVIEW_FRAME( KIWAY* aKiway, wxWindow* aParent );
     ~GERBVIEW_FRAME();
@@ -595,7 +609,7 @@ public:
      * @return true if file was opened successfully.
      */
     bool LoadExcellonFiles( const wxString& aFileName );
-    bool Read_EXCELLON_File( const wxString& aFullFileName );
+    bool Read_EXCELLON_File( const wxString& aFullFileName, bool aAddToHistory = false );
 
     /**
      * function LoadZipArchiveFileLoadZipArchiveFile
@@ -30,7 +30,7 @@
 #include <gerbview_frame.h>
 #include <gerber_file_image.h>
 #include <gerber_file_image_list.h>
-#include <view/view.h>
+#include <reporter.h>
 
 #include <html_messagebox.h>
 #include <macros.h>
@@ -41,16 +41,7 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 {
     wxString msg;
 
-    int layer = GetActiveLayer();
-    GERBER_FILE_IMAGE_LIST* images = GetImagesList();
-    GERBER_FILE_IMAGE* gerber = GetGbrImage( layer );
-
-    if( gerber != NULL )
-    {
-        Erase_Current_DrawLayer( false );
-    }
-
-    gerber = new GERBER_FILE_IMAGE( layer );
+    GERBER_FILE_IMAGE* gerber = new GERBER_FILE_IMAGE( GetActiveLayer() );
 
     // Read the gerber file. The image will be added only if it can be read
     // to avoid broken data.
@@ -64,46 +55,19 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
         return false;
     }
 
-    images->AddGbrImage( gerber, layer );
+    WX_STRING_REPORTER reporter( &msg );
+
+    success = registerImage( gerber, false, false, reporter );
 
     // Display errors list
-    if( gerber->GetMessages().size() > 0 )
+    if( !msg.IsEmpty() )
     {
-        HTML_MESSAGE_BOX dlg( this, _("Errors") );
-        dlg.ListSet(gerber->GetMessages());
+        HTML_MESSAGE_BOX dlg( this, success ? _( "Messages" ) : _( "Errors" ) );
+        dlg.ListSet( msg );
         dlg.ShowModal();
     }
 
-    /* if the gerber file is only a RS274D file
-     * (i.e. without any aperture information, but with items), warn the user:
-     */
-    if( !gerber->m_Has_DCode && gerber->GetItemsList() )
-    {
-        msg = _("Warning: this file has no D-Code definition\n"
-                "It is perhaps an old RS274D file\n"
-                "Therefore the size of items is undefined");
-        wxMessageBox( msg );
-    }
-
-    auto canvas = GetGalCanvas();
-
-    if( canvas )
-    {
-        auto view = canvas->GetView();
-
-        if( gerber->m_ImageNegative )
-        {
-            // TODO: find a way to handle negative images
-            // (maybe convert geometry into positives?)
-        }
-
-        for( auto item = gerber->GetItemsList(); item; item = item->Next() )
-        {
-            view->Add( (KIGFX::VIEW_ITEM*) item );
-        }
-    }
-
-    return true;
+    return success;
 }
 
 
@@ -111,8 +75,6 @@ bool GERBVIEW_FRAME::Read_GERBER_File( const wxString& GERBER_FullFileName )
 // size of a single line of text from a gerber file.
 // warning: some files can have *very long* lines, so the buffer must be large.
 #define GERBER_BUFZ 1000000
-// A large buffer to store one line
-static char lineBuffer[GERBER_BUFZ+1];
 
 bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
 {
@@ -120,6 +82,11 @@ bool GERBER_FILE_IMAGE::LoadGerberFile( const wxString& aFullFileName )
     int      D_commande = 0;       // command number for D commands like D02
     char*    text;
 
+    // A large buffer to store one line.  It is not static: several files can be read
+    // at the same time (see GERBVIEW_FRAME::loadListOfGerberAndDrillFiles())
+    std::vector<char> buffer( GERBER_BUFZ + 1 );
+    char*    lineBuffer = buffer.data();
+
     ClearMessageList( );
     ResetDefaultValues();
 
@@ -78,6 +78,46 @@ public:
      */
     bool m_realTimeConnectivity;
 
+    /**
+     * Cross-check incremental connectivity updates against a full rebuild
+     */
+    bool m_verifyIncrementalConnectivity;
+
+    /**
+     * Load files through MMAP_LINE_READER instead of FILE_LINE_READER
+     */
+    bool m_useMmapLineReader;
+
+    /**
+     * Parse the items of board files on the thread pool
+     */
+    bool m_parallelBoardParser;
+
+    /**
+     * Update the ratsnest triangulation of a net in place instead of rebuilding it
+     */
+    bool m_incrementalRatsnest;
+
+    /**
+     * Skip refilling zones whose fill inputs did not change since their last fill
+     */
+    bool m_zoneFillCache;
+
+    /**
+     * Split big zones in tiles filled in parallel
+     */
+    bool m_tiledZoneFill;
+
+    /**
+     * Record the events of the interactive router, to replay them
+     */
+    bool m_recordRouterEvents;
+
+    /**
+     * Run the alternative searches of the interactive router concurrently
+     */
+    bool m_concurrentRouterSearch;
+
     /**
      * Helper to determine if legacy canvas is allowed (according to platform
      * and config)
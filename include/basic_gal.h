@@ -25,6 +25,8 @@
 #ifndef BASIC_GAL_H
 #define BASIC_GAL_H
 
+#include <mutex>
+
 #include <eda_rect.h>
 
 #include <gal/stroke_font.h>
@@ -167,4 +169,10 @@ private:
 
 extern BASIC_GAL basic_gal;
 
+/**
+ * basic_gal keeps the attributes and the callback of the text being drawn: its users lock
+ * this mutex, for texts to be drawn or measured from several threads.
+ */
+extern std::mutex basic_gal_mutex;
+
 #endif      // define BASIC_GAL_H
@@ -173,20 +173,16 @@ extern KIGFX::COLOR4D  g_GhostColor;
  * The constructor sets a "C" language locale option, to read/print files with floating
  * point  numbers.  The destructor insures that the default locale is restored if an
  * exception is thrown or not.
+ *
+ * Only the locale of the calling thread is switched, so other threads (the GUI or other
+ * readers) keep their own.  New code should rather use the functions of numeric_io.h,
+ * which need no locale switching at all.
  */
 class LOCALE_IO
 {
 public:
     LOCALE_IO();
     ~LOCALE_IO();
-
-private:
-    // allow for nesting of LOCALE_IO instantiations
-    static std::atomic<unsigned int> m_c_count;
-
-    // The locale in use before switching to the "C" locale
-    // (the locale can be set by user, and is not always the system locale)
-    std::string m_user_locale;
 };
 
 /**
@@ -175,6 +175,13 @@ public:
     BOARD_ITEM* GetMainItem( BOARD* aBoard ) const;
     BOARD_ITEM* GetAuxiliaryItem( BOARD* aBoard ) const;
 
+    /**
+     * Access to A and B item references, without checking the items still exist.
+     * They can be compared to item pointers, but must not be dereferenced.
+     */
+    const void* GetMainItemWeakRef() const { return m_mainItemWeakRef; }
+    const void* GetAuxiliaryItemWeakRef() const { return m_auxItemWeakRef; }
+
     /**
      * Function ShowHtml
      * translates this object into a fragment of HTML suitable for the
@@ -107,6 +107,7 @@ protected:
 
     int                 curTok;                 ///< the current token obtained on last NextTok()
     std::string         curText;                ///< the text of the current token
+    std::string         curLine;                ///< nul terminated copy of an in place line
 
     const KEYWORD*      keywords;               ///< table sorted by CMake for bsearch()
     unsigned            keywordCount;           ///< count of keywords table
@@ -118,13 +119,15 @@ protected:
     {
         if( reader )
         {
-            reader->ReadLine();
+            // Readers holding the whole text in memory return the line in place, which
+            // is not nul terminated: never read past limit.
+            const char* line = reader->ReadLineView();
 
             unsigned len = reader->Length();
 
-            // start may have changed in ReadLine(), which can resize and
+            // else start may have changed in ReadLine(), which can resize and
             // relocate reader's line buffer.
-            start = reader->Line();
+            start = line ? line : reader->Line();
 
             next  = start;
             limit = next + len;
@@ -516,6 +519,13 @@ public:
      */
     const char* CurLine()
     {
+        // A line returned in place by ReadLineView() is not nul terminated.
+        if( start && start != reader->Line() )
+        {
+            curLine.assign( start, reader->Length() );
+            return curLine.c_str();
+        }
+
         return (const char*)(*reader);
     }
 
@@ -130,6 +130,14 @@ public:
         return m_num;
     }
 
+    /**
+     * @return true if the fields read from the footprint are available without reading it.
+     */
+    bool IsLoaded() const
+    {
+        return m_loaded;
+    }
+
     /**
      * Test if the #FOOTPRINT_INFO object was loaded from \a aLibrary.
      *
@@ -186,6 +194,7 @@ inline bool operator<( const FOOTPRINT_INFO& item1, const FOOTPRINT_INFO& item2
 class APIEXPORT FOOTPRINT_LIST
 {
     friend class FOOTPRINT_ASYNC_LOADER;
+    friend class FOOTPRINT_INFO_IMPL;
 
 protected:
     FP_LIB_TABLE* m_lib_table; ///< no ownership
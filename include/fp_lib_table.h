@@ -200,6 +200,8 @@ public:
      * a version of FootprintLoad() for use after FootprintEnumerate() for more efficient
      * cache management.  Return value is const to allow it to return a reference to a cached
      * item.
+     *
+     * @throw IO_ERROR if the footprint cannot be read.
      */
     const MODULE* GetEnumeratedFootprint( const wxString& aNickname,
                                           const wxString& aFootprintName );
@@ -32,6 +32,8 @@
 
 #include <algorithm>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #define ASSERT assert    // RTree uses ASSERT( condition )
 
@@ -48,7 +50,9 @@
 #define RTREE_SEARCH_QUAL       RTree<DATATYPE, ELEMTYPE, NUMDIMS, ELEMTYPEREAL, TMAXNODES, \
     TMINNODES, VISITOR>
 
-#define RTREE_DONT_USE_MEMPOOLS     // This version does not contain a fixed memory allocator, fill in lines with EXAMPLE to implement one.
+// Nodes are taken from a pool owned by the tree.  Define RTREE_DONT_USE_MEMPOOLS before
+// including this file to allocate each node with new/delete instead.
+// #define RTREE_DONT_USE_MEMPOOLS
 #define RTREE_USE_SPHERICAL_VOLUME  // Better split classification, may be slower on some systems
 
 // Fwd decl
@@ -67,7 +71,11 @@ class RTFileStream;    // File I/O helper class, look below for implementation a
 /// ELEMTYPEREAL Type of element that allows fractional and large values such as float or double, for use in volume calcs
 ///
 /// NOTES: Inserting and removing data requires the knowledge of its constant Minimal Bounding Rectangle.
-///        This version uses new/delete for nodes, I recommend using a fixed size allocator for efficiency.
+///        Nodes are allocated by growing blocks and recycled through a free list, all of them being
+///        released at once when the tree is emptied.
+///        A tree built from a known set of entries should use BulkLoad() (Sort-Tile-Recursive
+///        packing) rather than a sequence of Insert(): it is built faster, its nodes are full and
+///        overlap less, so it is smaller and faster to query.
 ///        Instead of using a callback function for returned results, I recommend and efficient pre-sized, grow-only memory
 ///        array similar to MFC CArray or STL Vector for returning search query result.
 ///
@@ -98,9 +106,31 @@ public:
 
 public:
 
+    /// An entry of a bulk loaded tree
+    struct Entry
+    {
+        ELEMTYPE    m_min[NUMDIMS];                 ///< Min of bounding rect
+        ELEMTYPE    m_max[NUMDIMS];                 ///< Max of bounding rect
+        DATATYPE    m_data;                         ///< Data Id or Ptr
+    };
+
     RTree();
+
+    /// Build a tree holding a_entries, see BulkLoad()
+    RTree( const std::vector<Entry>& a_entries );
+
     virtual ~RTree();
 
+    // The nodes belong to the tree, it cannot be copied
+    RTree( const RTree& ) = delete;
+    RTree& operator=( const RTree& ) = delete;
+
+    /// Replace the content of the tree by a_entries, using Sort-Tile-Recursive packing:
+    /// the entries are sorted into slabs along each axis in turn and packed into full nodes,
+    /// and the nodes of each level are packed the same way up to the root.
+    /// \param a_entries the entries, in any order
+    void BulkLoad( const std::vector<Entry>& a_entries );
+
     /// Insert entry
     /// \param a_min Min of bounding rect
     /// \param a_max Max of bounding rect
@@ -166,6 +196,9 @@ public:
     /// Count the data elements in this container.  This is slow as no internal counter is maintained.
     int     Count();
 
+    /// \return the memory allocated for the nodes of the tree, in bytes
+    size_t  MemoryUsage() const;
+
     /// Load tree contents from file
     bool    Load( const char* a_fileName );
 
@@ -507,6 +540,9 @@ protected:
         return true; // Continue searching
     }
 
+    void    PackLevel( Branch* a_branches, int a_count, int a_axis, int a_level,
+                       std::vector<Branch>& a_parents );
+
     void    RemoveAllRec( Node* a_node );
     void    Reset();
     void    CountRec( Node* a_node, int& a_count );
@@ -516,6 +552,17 @@ protected:
 
     Node*           m_root;                         ///< Root of tree
     ELEMTYPEREAL    m_unitSphereVolume;             ///< Unit sphere constant for required number of dimensions
+    size_t          m_nodeCount;                    ///< Allocated nodes
+
+#ifndef RTREE_DONT_USE_MEMPOOLS
+    /// Node blocks grow from MIN_NODE_BLOCK to MAX_NODE_BLOCK nodes, so small trees stay small
+    enum { MIN_NODE_BLOCK = 4, MAX_NODE_BLOCK = 1024 };
+
+    std::vector<std::unique_ptr<Node[]>> m_nodeBlocks;
+    int                                  m_lastBlockSize;
+    int                                  m_lastBlockUsed;   ///< Nodes taken from the last block
+    std::vector<Node*>                   m_freeNodes;       ///< Freed nodes, to be reused
+#endif    // RTREE_DONT_USE_MEMPOOLS
 };
 
 
@@ -622,18 +669,133 @@ RTREE_TEMPLATE RTREE_QUAL::RTree()
         0.082146f, 0.046622f, 0.025807f,    // Dimension  18,19,20
     };
 
+    m_nodeCount = 0;
+
+#ifndef RTREE_DONT_USE_MEMPOOLS
+    m_lastBlockSize = 0;
+    m_lastBlockUsed = 0;
+#endif    // RTREE_DONT_USE_MEMPOOLS
+
     m_root = AllocNode();
     m_root->m_level     = 0;
     m_unitSphereVolume  = (ELEMTYPEREAL) UNIT_SPHERE_VOLUMES[NUMDIMS];
 }
 
 
+RTREE_TEMPLATE
+RTREE_QUAL::RTree( const std::vector<Entry>& a_entries ) : RTree()
+{
+    BulkLoad( a_entries );
+}
+
+
 RTREE_TEMPLATE
 RTREE_QUAL::~RTree() {
     Reset(); // Free, or reset node memory
 }
 
 
+RTREE_TEMPLATE
+void RTREE_QUAL::BulkLoad( const std::vector<Entry>& a_entries )
+{
+    Reset();
+
+    std::vector<Branch> branches( a_entries.size() );
+
+    for( size_t index = 0; index < a_entries.size(); ++index )
+    {
+        for( int axis = 0; axis < NUMDIMS; ++axis )
+        {
+            ASSERT( a_entries[index].m_min[axis] <= a_entries[index].m_max[axis] );
+
+            branches[index].m_rect.m_min[axis] = a_entries[index].m_min[axis];
+            branches[index].m_rect.m_max[axis] = a_entries[index].m_max[axis];
+        }
+
+        branches[index].m_data = a_entries[index].m_data;
+    }
+
+    // Pack the entries into leaves, then each level into the nodes of the level above,
+    // until a single node is left
+    int level = 0;
+
+    do
+    {
+        std::vector<Branch> parents;
+
+        parents.reserve( branches.size() / MAXNODES + NUMDIMS * MAXNODES );
+        PackLevel( branches.data(), (int) branches.size(), 0, level, parents );
+        branches.swap( parents );
+        ++level;
+    } while( branches.size() > 1 );
+
+    if( branches.empty() )
+    {
+        m_root = AllocNode();
+        m_root->m_level = 0;
+    }
+    else
+    {
+        m_root = branches[0].m_child;
+    }
+}
+
+
+// Sort-Tile-Recursive packing of a_count branches into nodes of level a_level.
+// With k axes left, the branches are sorted along a_axis and cut into about P^(1/k) slabs
+// of P^(1-1/k) nodes, P being the number of nodes needed; each slab is then packed along
+// the next axis.  The branches are finally packed in runs along the last axis.
+RTREE_TEMPLATE
+void RTREE_QUAL::PackLevel( Branch* a_branches, int a_count, int a_axis, int a_level,
+                            std::vector<Branch>& a_parents )
+{
+    int nodeCount = ( a_count + MAXNODES - 1 ) / MAXNODES;
+
+    if( nodeCount > 1 )
+    {
+        std::sort( a_branches, a_branches + a_count,
+                   [a_axis]( const Branch& a, const Branch& b )
+                   {
+                       // Sum in ELEMTYPEREAL: centres of rects spanning the full ELEMTYPE range
+                       // would overflow
+                       return (ELEMTYPEREAL) a.m_rect.m_min[a_axis] + a.m_rect.m_max[a_axis]
+                              < (ELEMTYPEREAL) b.m_rect.m_min[a_axis] + b.m_rect.m_max[a_axis];
+                   } );
+    }
+
+    if( a_axis < NUMDIMS - 1 && nodeCount > 1 )
+    {
+        int slabCount = (int) ceil( pow( (double) nodeCount, 1.0 / ( NUMDIMS - a_axis ) ) );
+        int slabSize = ( ( nodeCount + slabCount - 1 ) / slabCount ) * MAXNODES;
+
+        for( int first = 0; first < a_count; first += slabSize )
+        {
+            PackLevel( a_branches + first, std::min( slabSize, a_count - first ), a_axis + 1,
+                       a_level, a_parents );
+        }
+
+        return;
+    }
+
+    // Spread the branches evenly: unless there are less than MAXNODES of them, no node is
+    // filled below MINNODES
+    for( int index = 0, first = 0; index < nodeCount; ++index )
+    {
+        Node* node = AllocNode();
+
+        node->m_level = a_level;
+        node->m_count = a_count / nodeCount + ( index < a_count % nodeCount ? 1 : 0 );
+        std::copy( a_branches + first, a_branches + first + node->m_count, node->m_branch );
+        first += node->m_count;
+
+        Branch parent;
+        parent.m_rect = NodeCover( node );
+        parent.m_child = node;
+        a_parents.push_back( parent );
+    }
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Insert( const ELEMTYPE     a_min[NUMDIMS],
                          const ELEMTYPE     a_max[NUMDIMS],
@@ -993,16 +1155,42 @@ void RTREE_QUAL::RemoveAll()
 }
 
 
+RTREE_TEMPLATE
+size_t RTREE_QUAL::MemoryUsage() const
+{
+#ifdef RTREE_DONT_USE_MEMPOOLS
+    return m_nodeCount * sizeof( Node );
+#else    // RTREE_DONT_USE_MEMPOOLS
+    size_t nodes = 0;
+
+    for( int size = MIN_NODE_BLOCK, index = 0; index < (int) m_nodeBlocks.size(); ++index )
+    {
+        nodes += size;
+        size = std::min( size * 2, (int) MAX_NODE_BLOCK );
+    }
+
+    return nodes * sizeof( Node ) + m_freeNodes.capacity() * sizeof( Node* );
+#endif    // RTREE_DONT_USE_MEMPOOLS
+}
+
+
 RTREE_TEMPLATE
 void RTREE_QUAL::Reset()
 {
 #ifdef RTREE_DONT_USE_MEMPOOLS
     // Delete all existing nodes
-    RemoveAllRec( m_root );
+    if( m_root )
+        RemoveAllRec( m_root );
 #else    // RTREE_DONT_USE_MEMPOOLS
     // Just reset memory pools.  We are not using complex types
-    // EXAMPLE
+    m_nodeBlocks.clear();
+    m_freeNodes.clear();
+    m_lastBlockSize = 0;
+    m_lastBlockUsed = 0;
+    m_nodeCount = 0;
 #endif    // RTREE_DONT_USE_MEMPOOLS
+
+    m_root = NULL;
 }
 
 
@@ -1032,8 +1220,25 @@ typename RTREE_QUAL::Node* RTREE_QUAL::AllocNode()
 #ifdef RTREE_DONT_USE_MEMPOOLS
     newNode = new Node;
 #else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
+    if( !m_freeNodes.empty() )
+    {
+        newNode = m_freeNodes.back();
+        m_freeNodes.pop_back();
+    }
+    else
+    {
+        if( m_lastBlockUsed == m_lastBlockSize )
+        {
+            m_lastBlockSize = m_nodeBlocks.empty() ? (int) MIN_NODE_BLOCK
+                                    : std::min( m_lastBlockSize * 2, (int) MAX_NODE_BLOCK );
+            m_lastBlockUsed = 0;
+            m_nodeBlocks.emplace_back( new Node[m_lastBlockSize] );
+        }
+
+        newNode = &m_nodeBlocks.back()[m_lastBlockUsed++];
+    }
 #endif      // RTREE_DONT_USE_MEMPOOLS
+    ++m_nodeCount;
     InitNode( newNode );
     return newNode;
 }
@@ -1047,8 +1252,9 @@ void RTREE_QUAL::FreeNode( Node* a_node )
 #ifdef RTREE_DONT_USE_MEMPOOLS
     delete a_node;
 #else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
+    m_freeNodes.push_back( a_node );
 #endif      // RTREE_DONT_USE_MEMPOOLS
+    --m_nodeCount;
 }
 
 
@@ -1057,22 +1263,15 @@ void RTREE_QUAL::FreeNode( Node* a_node )
 RTREE_TEMPLATE
 typename RTREE_QUAL::ListNode* RTREE_QUAL::AllocListNode()
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
+    // Only used while removing entries, the node pool is not worth it
     return new ListNode;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
 }
 
 
 RTREE_TEMPLATE
 void RTREE_QUAL::FreeListNode( ListNode* a_listNode )
 {
-#ifdef RTREE_DONT_USE_MEMPOOLS
     delete a_listNode;
-#else       // RTREE_DONT_USE_MEMPOOLS
-    // EXAMPLE
-#endif      // RTREE_DONT_USE_MEMPOOLS
 }
 
 
@@ -0,0 +1,84 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <vector>
+
+#include <wx/string.h>
+
+
+/**
+ * Class MAPPED_FILE
+ * gives read-only access to the whole content of a file.  The file is mapped into memory
+ * (mmap on POSIX, MapViewOfFile on Windows), or read in one go when it cannot be mapped,
+ * as for empty files and some special files.
+ *
+ * A mapped view is page aligned, and a read buffer is aligned for any fundamental type, so
+ * the content can be accessed in place as arrays of plain data.
+ */
+class MAPPED_FILE
+{
+public:
+    /**
+     * Constructor MAPPED_FILE
+     * opens and maps @a aFileName.  The file is closed again once mapped.
+     *
+     * @param aFileName is the name of the file to open.
+     * @param aSequential tells the system the content will be read from start to end.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or read.
+     */
+    MAPPED_FILE( const wxString& aFileName, bool aSequential = false );
+
+    ~MAPPED_FILE();
+
+    MAPPED_FILE( const MAPPED_FILE& ) = delete;
+    MAPPED_FILE& operator=( const MAPPED_FILE& ) = delete;
+
+    /**
+     * @return the file content, which is not nul terminated.
+     */
+    const char* Data() const { return m_data; }
+
+    /**
+     * @return the size of the file content in bytes.
+     */
+    size_t Size() const { return m_size; }
+
+    /**
+     * @return true if the file is mapped, false if it was read into a buffer.
+     */
+    bool IsMapped() const { return m_mapping != nullptr; }
+
+private:
+    const char*         m_data;
+    size_t              m_size;
+
+    void*               m_mapping;  ///< the mapped view, or NULL if m_buffer is used.
+    std::vector<double> m_buffer;   ///< file content when the file cannot be mapped.
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,99 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file numeric_io.h
+ * reads and writes numbers in files, with a point as decimal separator whatever the locale
+ *
+ * Unlike strtod() and printf() under a LOCALE_IO, these functions never change the locale,
+ * so they can be used by several threads at once while the user locale stays in effect for
+ * the rest of the program.
+ */
+
+#ifndef NUMERIC_IO_H
+#define NUMERIC_IO_H
+
+#include <cstdarg>
+#include <cstddef>
+#include <string>
+
+
+/**
+ * Function ParseDouble
+ * reads a floating point number as strtod() does in the "C" locale.
+ *
+ * The result is correctly rounded, so the text written by FormatDouble() (or by a "%.17g"
+ * format) reads back to the same value.  Plain decimal numbers of up to 15 significant
+ * digits, as found in board and library files, are converted without calling strtod().
+ *
+ * @param aText is the text to read.  Leading white space is skipped.
+ * @param aEnd receives the address of the first character after the number, or aText if
+ * there is no number.
+ * @return the number, or 0.0 if there is none.  errno is set to ERANGE if the number is
+ * out of the range of a double.
+ */
+double ParseDouble( const char* aText, const char** aEnd = nullptr );
+
+
+/**
+ * Function ParseLong
+ * reads an integer as strtol() does in the "C" locale.
+ *
+ * @param aText is the text to read.  Leading white space is skipped.
+ * @param aEnd receives the address of the first character after the number, or aText if
+ * there is no number.
+ * @param aBase is the base of the number, from 2 to 36.  A "0x" prefix is allowed in base 16.
+ * @return the number, or 0 if there is none.  errno is set to ERANGE (and the result clamped
+ * to LONG_MIN or LONG_MAX) if the number does not fit in a long.
+ */
+long ParseLong( const char* aText, const char** aEnd = nullptr, int aBase = 10 );
+
+
+/**
+ * Function VsnprintfC
+ * is vsnprintf() in the "C" locale.  Only the calling thread uses the "C" locale, and only
+ * during the call.
+ */
+int VsnprintfC( char* aBuffer, size_t aSize, const char* aFormat, va_list aArgs );
+
+
+/**
+ * Function SnprintfC
+ * is snprintf() in the "C" locale.
+ * @see VsnprintfC()
+ */
+int
+#if defined(__GNUG__)
+    __attribute__ ((format (printf, 3, 4)))
+#endif
+    SnprintfC( char* aBuffer, size_t aSize, const char* aFormat, ... );
+
+
+/**
+ * Function FormatDouble
+ * @return the shortest "%g" text of 15 to 17 significant digits which ParseDouble() reads
+ * back to exactly aValue.
+ */
+std::string FormatDouble( double aValue );
+
+#endif  // NUMERIC_IO_H
@@ -29,8 +29,10 @@
 // "richio" after its author, Richard Hollenbeck, aka Dick Hollenbeck.
 
 
+#include <memory>
 #include <vector>
 #include <utf8.h>
+#include <mapped_file.h>
 
 // I really did not want to be dependent on wxWidgets in richio
 // but the errorText needs to be wide char so wxString rules.
@@ -120,6 +122,35 @@ public:
      */
     virtual char* ReadLine() = 0;
 
+    /**
+     * Function ReadLineView
+     * reads a line of text like ReadLine(), but a reader which already holds the whole
+     * text in memory may return the line in place instead of copying it into the line
+     * buffer.  In that case the returned line is not nul terminated and Line() is not
+     * updated: use Length() to find its end.
+     * @return const char* - The beginning of the read line, or NULL if EOF.
+     * @throw IO_ERROR when a line is too long.
+     */
+    virtual const char* ReadLineView()
+    {
+        return ReadLine();
+    }
+
+    /**
+     * Function ReadRemainingView
+     * returns in place all the text following the last line read, for the readers which
+     * hold the whole text in memory, and moves to the end of the text.  The line number is
+     * not updated.
+     * @param aLength is set to the length of the returned text.
+     * @return const char* - The text, not nul terminated, or NULL if the reader does not
+     *                       hold its text in memory.
+     */
+    virtual const char* ReadRemainingView( size_t* aLength )
+    {
+        *aLength = 0;
+        return NULL;
+    }
+
     /**
      * Function GetSource
      * returns the name of the source of the lines in an abstract sense.
@@ -247,6 +278,72 @@ public:
 };
 
 
+/**
+ * Class MMAP_LINE_READER
+ * is a LINE_READER that maps a whole file into memory (or reads it in one go when the
+ * file cannot be mapped).  ReadLine() copies each line into the line buffer with a single
+ * memcpy(), and ReadLineView() returns the lines in place, without any copy.
+ */
+class MMAP_LINE_READER : public LINE_READER
+{
+protected:
+    MAPPED_FILE         m_file;
+    const char*         m_data;     ///< the whole file content, not nul terminated.
+    size_t              m_size;     ///< size of m_data in bytes.
+    size_t              m_ndx;      ///< offset of the next line in m_data.
+
+    /**
+     * Function nextLine
+     * finds the next line, sets m_length and increments the line number counter.
+     * @return const char* - The beginning of the line in m_data, or NULL if EOF.
+     */
+    const char* nextLine();
+
+public:
+
+    /**
+     * Constructor MMAP_LINE_READER
+     * opens and maps @a aFileName.  The file is closed again once mapped.
+     *
+     * @param aFileName is the name of the file to open and to use for error reporting purposes.
+     * @param aStartingLineNumber is the initial line number to report on error.
+     * @param aMaxLineLength is the maximum supported line length.
+     *
+     * @throw IO_ERROR if @a aFileName cannot be opened or read.
+     */
+    MMAP_LINE_READER( const wxString& aFileName,
+            unsigned aStartingLineNumber = 0,
+            unsigned aMaxLineLength = LINE_READER_LINE_DEFAULT_MAX );
+
+    char* ReadLine() override;
+
+    const char* ReadLineView() override;
+
+    const char* ReadRemainingView( size_t* aLength ) override;
+
+    /**
+     * Function Rewind
+     * restarts reading from the beginning of the file and resets the line number back
+     * to zero.  Line number will go to 1 on first ReadLine().
+     */
+    void Rewind()
+    {
+        m_ndx = 0;
+        m_lineNum = 0;
+    }
+};
+
+
+/**
+ * Function OpenFileLineReader
+ * opens @a aFileName for reading with a MMAP_LINE_READER if @a aMapped is true, else with a
+ * FILE_LINE_READER.
+ *
+ * @throw IO_ERROR if @a aFileName cannot be opened.
+ */
+std::unique_ptr<LINE_READER> OpenFileLineReader( const wxString& aFileName, bool aMapped );
+
+
 /**
  * Class STRING_LINE_READER
  * is a LINE_READER that reads from a multiline 8 bit wide std::string
@@ -385,7 +482,8 @@ public:
 
     /**
      * Function Print
-     * formats and writes text to the output stream.
+     * formats and writes text to the output stream.  Floating point numbers are always
+     * written with a point as decimal separator, whatever the locale.
      *
      * @param nestLevel The multiple of spaces to precede the output with.
      * @param fmt A printf() style format string.
@@ -0,0 +1,178 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class PROGRESS_REPORTER;
+
+
+/**
+ * A pool of worker threads shared by all the parallel computations of the process (zone
+ * filling, connectivity, ratsnest, 3D geometry...), so that computations which overlap do
+ * not oversubscribe the CPU.
+ *
+ * Each worker owns a task queue: tasks submitted from a worker go to its own queue, which
+ * it processes last-in first-out, and idle workers steal the oldest tasks of the others.
+ *
+ * Pool threads must never block on a future of a task which is still queued: use
+ * ParallelFor(), which only waits for items already running, for nested parallelism.
+ */
+class THREAD_POOL
+{
+public:
+    /**
+     * Called by the waiting thread about every WAIT_HOOK_INTERVAL_MS while ParallelFor()
+     * runs.  Returning false cancels the items which have not started yet.
+     */
+    using WAIT_HOOK = std::function<bool()>;
+
+    static constexpr int WAIT_HOOK_INTERVAL_MS = 100;
+
+    /**
+     * @param aThreadCount is the number of worker threads, hardware concurrency if 0.
+     */
+    explicit THREAD_POOL( size_t aThreadCount = 0 );
+
+    ~THREAD_POOL();
+
+    THREAD_POOL( const THREAD_POOL& ) = delete;
+    THREAD_POOL& operator=( const THREAD_POOL& ) = delete;
+
+    /**
+     * @return the process-wide pool.
+     */
+    static THREAD_POOL& GetPool();
+
+    size_t GetThreadCount() const { return m_workers.size(); }
+
+    /**
+     * @return the number of distinct values GetSlot() can return.
+     */
+    size_t GetSlotCount() const { return m_workers.size() + 1; }
+
+    /**
+     * @return a small index identifying the calling thread within a ParallelFor() call:
+     * the index of the worker for pool threads, GetThreadCount() for any other thread.
+     * It can be used to keep per-thread state in a vector of GetSlotCount() entries.
+     */
+    size_t GetSlot() const;
+
+    /**
+     * Queue \a aFunc for execution on a pool thread.
+     *
+     * @return the future result of the call.
+     */
+    template <typename FUNC>
+    auto Submit( FUNC&& aFunc ) -> std::future<decltype( aFunc() )>
+    {
+        using RESULT = decltype( aFunc() );
+
+        auto task = std::make_shared<std::packaged_task<RESULT()>>( std::forward<FUNC>( aFunc ) );
+        std::future<RESULT> result = task->get_future();
+
+        push( [task]()
+              {
+                  ( *task )();
+              } );
+
+        return result;
+    }
+
+    /**
+     * Wait for \a aFuture, calling \a aOnWait every WAIT_HOOK_INTERVAL_MS.  The result of
+     * \a aOnWait is ignored: a queued task cannot be cancelled.
+     */
+    template <typename T>
+    void Wait( const std::future<T>& aFuture, const WAIT_HOOK& aOnWait = nullptr )
+    {
+        if( !aOnWait )
+        {
+            aFuture.wait();
+            return;
+        }
+
+        while( aFuture.wait_for( std::chrono::milliseconds( WAIT_HOOK_INTERVAL_MS ) )
+                != std::future_status::ready )
+        {
+            aOnWait();
+        }
+    }
+
+    /**
+     * Call \a aFunc( i ) for each i in [0, aCount) on the pool threads, and wait until all
+     * calls returned.
+     *
+     * Without \a aOnWait, the calling thread processes items too.  With it, the calling
+     * thread only calls the hook (e.g. to refresh the UI), so it stays responsive.
+     *
+     * The first exception thrown by \a aFunc is rethrown once all running items finished;
+     * the items not started yet are skipped.
+     *
+     * @return false if \a aOnWait cancelled the remaining items.
+     */
+    bool ParallelFor( size_t aCount, const std::function<void( size_t )>& aFunc,
+                      const WAIT_HOOK& aOnWait = nullptr );
+
+    /**
+     * @return a wait hook refreshing \a aReporter (which must be called from the main
+     * thread), or nullptr if there is no reporter.  If \a aCanCancel is true, the
+     * computation is cancelled when the user cancels the reporter.
+     */
+    static WAIT_HOOK ReporterHook( PROGRESS_REPORTER* aReporter, bool aCanCancel = false );
+
+private:
+    using TASK = std::function<void()>;
+
+    struct WORKER
+    {
+        std::mutex       m_lock;
+        std::deque<TASK> m_tasks;
+        std::thread      m_thread;
+    };
+
+    void push( TASK&& aTask );
+    bool pop( size_t aWorker, TASK& aTask );
+    void run( size_t aWorker );
+
+    std::vector<std::unique_ptr<WORKER>> m_workers;
+
+    std::mutex              m_sleepLock;
+    std::condition_variable m_wakeUp;
+    size_t                  m_pending;          ///< queued tasks, protected by m_sleepLock
+    bool                    m_stop;             ///< protected by m_sleepLock
+    std::atomic<size_t>     m_nextQueue;        ///< round robin for external submissions
+};
+
+#endif // THREAD_POOL_H
@@ -220,6 +220,18 @@ public:
         return m_isLeadingEdge;
     }
 
+    /// Sets the position of a leading edge in the list of leading edges of the triangulation
+    inline void SetLeadingEdgePos( const std::list<EDGE_PTR>::iterator& aPos )
+    {
+        m_leadingEdgePos = aPos;
+    }
+
+    /// Returns the position of a leading edge in the list of leading edges
+    inline const std::list<EDGE_PTR>::iterator& GetLeadingEdgePos() const
+    {
+        return m_leadingEdgePos;
+    }
+
     /// Returns the twin edge
     inline EDGE_PTR GetTwinEdge() const
     {
@@ -270,6 +282,9 @@ protected:
     EDGE_WEAK_PTR   m_twinEdge;
     EDGE_PTR        m_nextEdgeInFace;
     bool            m_isLeadingEdge;
+
+    /// Valid only for leading edges, so they can be removed from the list in constant time
+    std::list<EDGE_PTR>::iterator m_leadingEdgePos;
 };
 
 class DART; // Forward declaration (class in this namespace)
@@ -290,6 +305,7 @@ protected:
     {
         aEdge->SetAsLeadingEdge();
         m_leadingEdges.push_front( aEdge );
+        aEdge->SetLeadingEdgePos( m_leadingEdges.begin() );
     }
 
     bool removeLeadingEdgeFromList( EDGE_PTR& aLeadingEdge );
@@ -365,6 +381,36 @@ public:
     EDGE_PTR InitTwoEnclosingTriangles( NODES_CONTAINER::iterator aFirst,
                                         NODES_CONTAINER::iterator aLast );
 
+    /**
+     * Creates a triangulation of a rectangle made of two triangles and no other nodes.
+     * Nodes inside the rectangle can then be added and removed one at a time with
+     * InsertNode() and RemoveNode(); the four corners are never removed.
+     *
+     * @return a CCW dart at the boundary.
+     */
+    EDGE_PTR InitRectangle( int aXmin, int aYmin, int aXmax, int aYmax );
+
+    /**
+     * Inserts a node and swaps edges so the triangulation stays Delaunay.
+     *
+     * @param aNode must lie strictly inside the boundary and must not coincide with an
+     * existing node.
+     * @param aDart is a CCW dart where the search for the enclosing triangle starts (it is
+     * faster when close to the node).  On return it is a CCW dart leaving the new node.
+     * @return false if no triangle containing the node was found.
+     */
+    bool InsertNode( const NODE_PTR& aNode, DART& aDart );
+
+    /**
+     * Removes a node previously added with InsertNode() and swaps edges so the
+     * triangulation stays Delaunay.
+     *
+     * @param aDart is a CCW dart where the search for the node starts.  On return it is an
+     * arbitrary valid CCW dart.
+     * @return false if the node was not found.
+     */
+    bool RemoveNode( const NODE_PTR& aNode, DART& aDart );
+
     // These two functions are required by TTL for Delaunay triangulation
 
     /// Swaps the edge associated with diagonal
@@ -410,7 +410,7 @@ template <class TRAITS_TYPE, class DART_TYPE>
 void TRIANGULATION_HELPER::RemoveNode( DART_TYPE& aDart )
 {
 
-    if( isBoundaryNode( aDart ) )
+    if( IsBoundaryNode( aDart ) )
         RemoveBoundaryNode<TRAITS_TYPE>( aDart );
     else
         RemoveInteriorNode<TRAITS_TYPE>( aDart );
@@ -1687,7 +1687,7 @@ void TRIANGULATION_HELPER::SwapEdgesAwayFromInteriorNode( DART_TYPE& aDart,
     // infinite loop with degree > 3.
     bool allowDegeneracy = true;
 
-    int degree = getDegreeOfNode( aDart );
+    int degree = GetDegreeOfNode( aDart );
     DART_TYPE d_iter;
 
     while( degree > 3 )
@@ -31,6 +31,7 @@
 #include <tools/pcb_tool.h>
 #include <tools/pcb_actions.h>
 #include <connectivity/connectivity_data.h>
+#include <drc.h>
 
 #include <functional>
 using namespace std::placeholders;
@@ -66,10 +67,14 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     auto              connectivity = board->GetConnectivity();
     std::set<EDA_ITEM*>      savedModules;
     std::vector<BOARD_ITEM*> itemsToDeselect;
+    DRC*                     drc = nullptr;
 
     if( Empty() )
         return;
 
+    if( !m_editModules && frame->IsType( FRAME_PCB ) )
+        drc = static_cast<PCB_EDIT_FRAME*>( frame )->GetDrcController();
+
     for( COMMIT_LINE& ent : m_changes )
     {
         int changeType = ent.m_type & CHT_TYPE;
@@ -108,6 +113,15 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
             }
         }
 
+        // Record the change for the incremental DRC
+        if( drc )
+        {
+            drc->MarkDirty( boardItem );
+
+            if( changeType == CHT_MODIFY && ent.m_copy )
+                drc->MarkDirty( static_cast<BOARD_ITEM*>( ent.m_copy )->GetBoundingBox() );
+        }
+
         switch( changeType )
         {
             case CHT_ADD:
@@ -275,6 +289,10 @@ void BOARD_COMMIT::Push( const wxString& aMessage, bool aCreateUndoEntry, bool a
     frame->UpdateMsgPanel();
 
     clear();
+
+    // Keep the markers shown by the DRC dialog up to date while editing
+    if( drc && drc->IsDRCDialogShown() )
+        drc->RunIncrementalTests();
 }
 
 
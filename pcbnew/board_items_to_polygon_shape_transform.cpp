@@ -53,13 +53,13 @@
 // A helper struct for the callback function
 // These variables are parameters used in addTextSegmToPoly.
 // But addTextSegmToPoly is a call-back function,
-// so we cannot send them as arguments.
+// so they are given to it in its aData argument.
+// Each conversion uses its own instance, so texts can be converted from several threads.
 struct TSEGM_2_POLY_PRMS {
     int m_textWidth;
     int m_textCircle2SegmentCount;
     SHAPE_POLY_SET* m_cornerBuffer;
 };
-TSEGM_2_POLY_PRMS prms;
 
 // The max error is the distance between the middle of a segment, and the circle
 // for circle/arc to segment approximation.
@@ -266,6 +266,7 @@ void MODULE::TransformGraphicShapesWithClearanceToPolygonSet(
     if( Value().GetLayer() == aLayer && Value().IsVisible() )
         texts.push_back( &Value() );
 
+    TSEGM_2_POLY_PRMS prms;
     prms.m_cornerBuffer = &aCornerBuffer;
 
     // To allow optimization of circles approximated by segments,
@@ -335,6 +336,7 @@ void MODULE::TransformGraphicTextWithClearanceToPolygonSet(
     if( Value().GetLayer() == aLayer && Value().IsVisible() )
         texts.push_back( &Value() );
 
+    TSEGM_2_POLY_PRMS prms;
     prms.m_cornerBuffer = &aCornerBuffer;
 
     // To allow optimization of circles approximated by segments,
@@ -465,6 +467,7 @@ void TEXTE_PCB::TransformShapeWithClearanceToPolygonSet(
     if( IsMirrored() )
         size.x = -size.x;
 
+    TSEGM_2_POLY_PRMS prms;
     prms.m_cornerBuffer = &aCornerBuffer;
     prms.m_textWidth  = GetThickness() + ( 2 * aClearanceValue );
     prms.m_textCircle2SegmentCount = aCircleToSegmentsCount;
@@ -42,6 +42,7 @@
 
 #include <pcb_netlist.h>
 #include <connectivity/connectivity_data.h>
+#include <advanced_config.h>
 #include <reporter.h>
 
 #include <board_netlist_updater.h>
@@ -732,7 +733,8 @@ bool BOARD_NETLIST_UPDATER::UpdateNetlist( NETLIST& aNetlist )
     if( !m_isDryRun )
     {
         m_commit.Push( _( "Update netlist" ) );
-        m_board->GetConnectivity()->Build( m_board );
+        m_board->GetConnectivity()->Sync( m_board,
+                ADVANCED_CFG::GetCfg().m_verifyIncrementalConnectivity );
         testConnectivity( aNetlist );
 
         // Now the connectivity data is rebuilt, we can delete single pads nets
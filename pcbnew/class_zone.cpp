@@ -99,6 +99,8 @@ ZONE_CONTAINER::ZONE_CONTAINER( const ZONE_CONTAINER& aZone ) :
     m_ThermalReliefGap = aZone.m_ThermalReliefGap;
     m_ThermalReliefCopperBridge = aZone.m_ThermalReliefCopperBridge;
     m_FilledPolysList.Append( aZone.m_FilledPolysList );
+    m_RawPolysList = aZone.m_RawPolysList;
+    m_fillInputsHash = aZone.m_fillInputsHash;
     m_FillSegmList = aZone.m_FillSegmList;      // vector <> copy
 
     m_isKeepout = aZone.m_isKeepout;
@@ -141,6 +143,8 @@ ZONE_CONTAINER& ZONE_CONTAINER::operator=( const ZONE_CONTAINER& aOther )
     m_HatchLines = aOther.m_HatchLines;     // copy vector <SEG>
     m_FilledPolysList.RemoveAllContours();
     m_FilledPolysList.Append( aOther.m_FilledPolysList );
+    m_RawPolysList = aOther.m_RawPolysList;
+    m_fillInputsHash = aOther.m_fillInputsHash;
     m_FillSegmList.clear();
     m_FillSegmList = aOther.m_FillSegmList;
 
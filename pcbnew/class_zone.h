@@ -721,6 +721,13 @@ public:
      */
     void BuildHashValue() { m_filledPolysHash = m_FilledPolysList.GetHash(); }
 
+    /** @return the hash of the inputs (outline, settings and knockout items) of the last
+     * fill, stored by the zone filler, or an invalid hash if the zone was not filled since
+     * it was loaded.  m_RawPolysList holds the result of that fill.
+     */
+    const MD5_HASH& GetFillInputsHash() const { return m_fillInputsHash; }
+    void SetFillInputsHash( const MD5_HASH& aHash ) { m_fillInputsHash = aHash; }
+
 
 
 #if defined(DEBUG)
@@ -825,6 +832,8 @@ private:
     SHAPE_POLY_SET        m_RawPolysList;
     MD5_HASH              m_filledPolysHash;    // A hash value used in zone filling calculations
                                                 // to see if the filled areas are up to date
+    MD5_HASH              m_fillInputsHash;     // Hash of the inputs of the fill which
+                                                // produced m_RawPolysList
 
     HATCH_STYLE           m_hatchStyle;     // hatch style, see enum above
     int                   m_hatchPitch;     // for DIAGONAL_EDGE, distance between 2 hatch lines
@@ -25,11 +25,11 @@
 #include <connectivity/connectivity_algo.h>
 #include <widgets/progress_reporter.h>
 #include <geometry/geometry_utils.h>
+#include <thread_pool.h>
 
-#include <thread>
 #include <mutex>
 #include <algorithm>
-#include <future>
+#include <map>
 
 #ifdef PROFILE
 #include <profile.h>
@@ -39,12 +39,14 @@
 bool CN_CONNECTIVITY_ALGO::Remove( BOARD_ITEM* aItem )
 {
     markItemNetAsDirty( aItem );
+    m_dirtyItems.erase( aItem );
 
     switch( aItem->Type() )
     {
     case PCB_MODULE_T:
         for( auto pad : static_cast<MODULE*>( aItem ) -> Pads() )
         {
+            m_dirtyItems.erase( pad );
             m_itemMap[ static_cast<BOARD_CONNECTED_ITEM*>( pad ) ].MarkItemsAsInvalid();
             m_itemMap.erase( static_cast<BOARD_CONNECTED_ITEM*>( pad ) );
         }
@@ -217,48 +219,16 @@ void CN_CONNECTIVITY_ALGO::searchConnections()
 
     if( m_itemList.IsDirty() )
     {
-        size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-                ( dirtyItems.size() + 7 ) / 8 );
-
-        std::atomic<size_t> nextItem( 0 );
-        std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-        auto conn_lambda = [&nextItem, &dirtyItems]
-                            ( CN_LIST* aItemList, PROGRESS_REPORTER* aReporter) -> size_t
-        {
-            for( size_t i = nextItem++; i < dirtyItems.size(); i = nextItem++ )
-            {
-                CN_VISITOR visitor( dirtyItems[i] );
-                aItemList->FindNearby( dirtyItems[i], visitor );
-
-                if( aReporter )
-                    aReporter->AdvanceProgress();
-            }
-
-            return 1;
-        };
-
-        if( parallelThreadCount <= 1 )
-            conn_lambda( &m_itemList, m_progressReporter );
-        else
-        {
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-                returns[ii] = std::async( std::launch::async, conn_lambda,
-                        &m_itemList, m_progressReporter );
-
-            for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            {
-                // Here we balance returns with a 100ms timeout to allow UI updating
-                std::future_status status;
-                do
+        THREAD_POOL::GetPool().ParallelFor( dirtyItems.size(),
+                [&]( size_t i )
                 {
-                    if( m_progressReporter )
-                        m_progressReporter->KeepRefreshing();
+                    CN_VISITOR visitor( dirtyItems[i] );
+                    m_itemList.FindNearby( dirtyItems[i], visitor );
 
-                    status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-                } while( status != std::future_status::ready );
-            }
-        }
+                    if( m_progressReporter )
+                        m_progressReporter->AdvanceProgress();
+                },
+                THREAD_POOL::ReporterHook( m_progressReporter ) );
 
         if( m_progressReporter )
             m_progressReporter->KeepRefreshing();
@@ -291,6 +261,29 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
 
 const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUSTER_SEARCH_MODE aMode,
         const KICAD_T aTypes[], int aSingleNet )
+{
+    return searchClusters( aMode, aTypes,
+            [aSingleNet]( int aNet )
+            {
+                return aSingleNet < 0 || aNet == aSingleNet;
+            } );
+}
+
+
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchDirtyClusters()
+{
+    constexpr KICAD_T types[] = { PCB_TRACE_T, PCB_PAD_T, PCB_VIA_T, PCB_ZONE_AREA_T, PCB_MODULE_T, EOT };
+
+    return searchClusters( CSM_RATSNEST, types,
+            [this]( int aNet )
+            {
+                return IsNetDirty( aNet );
+            } );
+}
+
+
+const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::searchClusters( CLUSTER_SEARCH_MODE aMode,
+        const KICAD_T aTypes[], const std::function<bool( int )>& aNetFilter )
 {
     bool withinAnyNet = ( aMode != CSM_PROPAGATE );
 
@@ -301,7 +294,7 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
     if( m_itemList.IsDirty() )
         searchConnections();
 
-    auto addToSearchList = [&head, withinAnyNet, aSingleNet, aTypes] ( CN_ITEM *aItem )
+    auto addToSearchList = [&head, withinAnyNet, &aNetFilter, aTypes] ( CN_ITEM *aItem )
     {
         if( withinAnyNet && aItem->Net() <= 0 )
             return;
@@ -309,7 +302,7 @@ const CN_CONNECTIVITY_ALGO::CLUSTERS CN_CONNECTIVITY_ALGO::SearchClusters( CLUST
         if( !aItem->Valid() )
             return;
 
-        if( aSingleNet >=0 && aItem->Net() != aSingleNet )
+        if( !aNetFilter( aItem->Net() ) )
             return;
 
         bool found = false;
@@ -444,6 +437,95 @@ void CN_CONNECTIVITY_ALGO::Build( const std::vector<BOARD_ITEM*>& aItems )
 }
 
 
+void CN_CONNECTIVITY_ALGO::MarkItemDirty( BOARD_ITEM* aItem )
+{
+    // The net the item is on now: if it changes net, it must be marked before the change
+    markItemNetAsDirty( aItem );
+    m_dirtyItems.insert( aItem );
+}
+
+
+int CN_CONNECTIVITY_ALGO::Sync()
+{
+    int changes = 0;
+
+    // Remove() updates m_dirtyItems
+    std::unordered_set<BOARD_ITEM*> dirtyItems;
+    dirtyItems.swap( m_dirtyItems );
+
+    for( BOARD_ITEM* item : dirtyItems )
+    {
+        Remove( item );
+        Add( item );
+        changes++;
+    }
+
+    wxLogTrace( "CN", "Sync: %d items changed\n", changes );
+
+    return changes;
+}
+
+
+bool CN_CONNECTIVITY_ALGO::IsEquivalent( CN_CONNECTIVITY_ALGO& aOther )
+{
+    using KEY = std::pair<const BOARD_CONNECTED_ITEM*, int>;
+
+    auto makeKey = []( CN_ITEM* aItem )
+    {
+        int subpoly = -1;
+
+        if( aItem->Parent()->Type() == PCB_ZONE_AREA_T )
+            subpoly = static_cast<CN_ZONE*>( aItem )->SubpolyIndex();
+
+        return KEY( aItem->Parent(), subpoly );
+    };
+
+    auto buildGraph = [&makeKey]( CN_CONNECTIVITY_ALGO& aAlgo )
+    {
+        std::map<KEY, std::vector<KEY>> graph;
+
+        aAlgo.searchConnections();
+
+        for( auto item : aAlgo.m_itemList )
+        {
+            if( !item->Valid() )
+                continue;
+
+            auto& links = graph[ makeKey( item ) ];
+
+            for( auto connected : item->ConnectedItems() )
+            {
+                if( connected->Valid() )
+                    links.push_back( makeKey( connected ) );
+            }
+
+            std::sort( links.begin(), links.end() );
+        }
+
+        return graph;
+    };
+
+    auto graph = buildGraph( *this );
+    auto otherGraph = buildGraph( aOther );
+
+    if( graph == otherGraph )
+        return true;
+
+    for( const auto& node : graph )
+    {
+        auto it = otherGraph.find( node.first );
+
+        if( it == otherGraph.end() || it->second != node.second )
+        {
+            wxLogTrace( "CN", "Connections of item %p (subpoly %d) differ\n",
+                    node.first.first, node.first.second );
+        }
+    }
+
+    return false;
+}
+
+
 void CN_CONNECTIVITY_ALGO::propagateConnections()
 {
     for( const auto& cluster : m_connClusters )
@@ -712,6 +794,7 @@ void CN_CONNECTIVITY_ALGO::Clear()
     m_connClusters.clear();
     m_itemMap.clear();
     m_itemList.Clear();
+    m_dirtyItems.clear();
 
 }
 
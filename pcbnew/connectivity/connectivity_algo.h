@@ -41,6 +41,7 @@
 #include <functional>
 #include <vector>
 #include <deque>
+#include <unordered_set>
 #include <intrusive_list.h>
 
 #include <connectivity/connectivity_rtree.h>
@@ -147,6 +148,9 @@ private:
 
     std::unordered_map<const BOARD_CONNECTED_ITEM*, ITEM_MAP_ENTRY> m_itemMap;
 
+    ///> Items modified in place since the last Sync(), see MarkItemDirty()
+    std::unordered_set<BOARD_ITEM*> m_dirtyItems;
+
     CLUSTERS m_connClusters;
     CLUSTERS m_ratsnestClusters;
     std::vector<bool> m_dirtyNets;
@@ -167,6 +171,9 @@ private:
 
     void markItemNetAsDirty( const BOARD_ITEM* aItem );
 
+    const CLUSTERS searchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[],
+            const std::function<bool( int )>& aNetFilter );
+
 public:
 
     CN_CONNECTIVITY_ALGO() {}
@@ -184,7 +191,7 @@ public:
 
     bool IsNetDirty( int aNet ) const
     {
-        if( aNet < 0 )
+        if( aNet < 0 || aNet >= (int) m_dirtyNets.size() )
             return false;
 
         return m_dirtyNets[ aNet ];
@@ -196,17 +203,6 @@ public:
             *i = false;
     }
 
-    void GetDirtyClusters( CLUSTERS& aClusters )
-    {
-        for( auto cl : m_ratsnestClusters )
-        {
-            int net = cl->OriginNet();
-
-            if( net >= 0 && m_dirtyNets[net] )
-                aClusters.push_back( cl );
-        }
-    }
-
     int NetCount() const
     {
         return m_dirtyNets.size();
@@ -220,9 +216,40 @@ public:
     bool    Remove( BOARD_ITEM* aItem );
     bool    Add( BOARD_ITEM* aItem );
 
+    /**
+     * Records that \a aItem (or the pads of a module) is modified in place, without a
+     * Remove()/Add() pair.  It is updated by the next Sync().  Call it before changing the
+     * net of the item, so that its previous net is updated too.  Removing the item clears
+     * the mark, so a marked item may be deleted once it is removed.
+     */
+    void    MarkItemDirty( BOARD_ITEM* aItem );
+
+    /**
+     * Updates the items marked by MarkItemDirty() since the last call, without looking at
+     * the rest of the board.  Added and removed items are already up to date, as Add() and
+     * Remove() are incremental.  Only the touched items are searched for connections again.
+     *
+     * @return the number of items updated.
+     */
+    int     Sync();
+
+    /**
+     * Checks that this database connects the same items as \a aOther.  Used to verify
+     * the incremental update against a full rebuild.
+     *
+     * @return true if both connection graphs are identical.
+     */
+    bool    IsEquivalent( CN_CONNECTIVITY_ALGO& aOther );
+
     const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode, const KICAD_T aTypes[], int aSingleNet );
     const CLUSTERS  SearchClusters( CLUSTER_SEARCH_MODE aMode );
 
+    /**
+     * Searches the ratsnest clusters of the dirty nets only.  Clusters never span several
+     * nets in this mode, so the result is the same as the dirty part of GetClusters().
+     */
+    const CLUSTERS  SearchDirtyClusters();
+
     void    PropagateNets();
     void    FindIsolatedCopperIslands( ZONE_CONTAINER* aZone, std::vector<int>& aIslands );
 
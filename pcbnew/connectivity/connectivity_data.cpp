@@ -27,13 +27,12 @@
 #include <profile.h>
 #endif
 
-#include <thread>
 #include <algorithm>
-#include <future>
 
 #include <connectivity/connectivity_data.h>
 #include <connectivity/connectivity_algo.h>
 #include <ratsnest_data.h>
+#include <thread_pool.h>
 
 CONNECTIVITY_DATA::CONNECTIVITY_DATA()
 {
@@ -77,6 +76,12 @@ bool CONNECTIVITY_DATA::Update( BOARD_ITEM* aItem )
 }
 
 
+void CONNECTIVITY_DATA::MarkItemDirty( BOARD_ITEM* aItem )
+{
+    m_connAlgo->MarkItemDirty( aItem );
+}
+
+
 void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
@@ -85,6 +90,30 @@ void CONNECTIVITY_DATA::Build( BOARD* aBoard )
 }
 
 
+bool CONNECTIVITY_DATA::Sync( BOARD* aBoard, bool aVerify )
+{
+    m_connAlgo->Sync();
+
+    if( aVerify )
+    {
+        CN_CONNECTIVITY_ALGO reference;
+        reference.Build( aBoard );
+
+        if( !m_connAlgo->IsEquivalent( reference ) )
+        {
+            wxLogTrace( "CN", "Incremental connectivity differs from a full rebuild\n" );
+
+            Clear();
+            Build( aBoard );
+            return false;
+        }
+    }
+
+    RecalculateRatsnest();
+    return true;
+}
+
+
 void CONNECTIVITY_DATA::Build( const std::vector<BOARD_ITEM*>& aItems )
 {
     m_connAlgo.reset( new CN_CONNECTIVITY_ALGO );
@@ -106,32 +135,11 @@ void CONNECTIVITY_DATA::updateRatsnest()
     std::copy_if( m_nets.begin() + 1, m_nets.end(), std::back_inserter( dirty_nets ),
             [] ( RN_NET* aNet ) { return aNet->IsDirty() && aNet->GetNodeCount() > 0; } );
 
-    // We don't want to spin up a new thread for fewer than 8 nets (overhead costs)
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(),
-            ( dirty_nets.size() + 7 ) / 8 );
-
-    std::atomic<size_t> nextNet( 0 );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
-
-    auto update_lambda = [&nextNet, &dirty_nets]() -> size_t
-    {
-        for( size_t i = nextNet++; i < dirty_nets.size(); i = nextNet++ )
-            dirty_nets[i]->Update();
-
-        return 1;
-    };
-
-    if( parallelThreadCount == 1 )
-        update_lambda();
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, update_lambda );
-
-        // Finalize the ratsnest threads
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii].wait();
-    }
+    THREAD_POOL::GetPool().ParallelFor( dirty_nets.size(),
+            [&dirty_nets]( size_t i )
+            {
+                dirty_nets[i]->Update();
+            } );
 
     #ifdef PROFILE
     rnUpdate.Show();
@@ -162,7 +170,7 @@ void CONNECTIVITY_DATA::RecalculateRatsnest()
             m_nets[i] = new RN_NET;
     }
 
-    auto clusters = m_connAlgo->GetClusters();
+    auto clusters = m_connAlgo->SearchDirtyClusters();
 
     int dirtyNets = 0;
 
@@ -95,6 +95,18 @@ public:
      */
     void Build( const std::vector<BOARD_ITEM*>& aItems );
 
+    /**
+     * Function Sync()
+     * Updates the items marked with MarkItemDirty() and recalculates the ratsnest of the
+     * dirty nets.  Unlike Build(), the rest of the board is not looked at: items added,
+     * removed or modified without Add(), Remove(), Update() or MarkItemDirty() are missed.
+     * @param aBoard is the board, only read for the verification.
+     * @param aVerify when true, the result is cross-checked against a full rebuild of
+     * aBoard, which replaces it if they differ.
+     * @return false if the verification failed.
+     */
+    bool Sync( BOARD* aBoard, bool aVerify = false );
+
     /**
      * Function Add()
      * Adds an item to the connectivity data.
@@ -119,6 +131,14 @@ public:
      */
     bool Update( BOARD_ITEM* aItem );
 
+    /**
+     * Function MarkItemDirty()
+     * Defers the update of an item modified in place to the next Sync(), so that editing
+     * many items only searches their connections once.
+     * @param aItem is an item about to be modified, or a module whose pads are.
+     */
+    void MarkItemDirty( BOARD_ITEM* aItem );
+
     /**
      * Function Clear()
      * Erases the connectivity database.
@@ -50,6 +50,8 @@
 #include <tools/pcb_actions.h>
 
 #include <kiface_i.h>
+#include <advanced_config.h>
+#include <thread_pool.h>
 #include <pcbnew.h>
 #include <drc.h>
 #include <pcb_netlist.h>
@@ -57,10 +59,35 @@
 #include <dialog_drc.h>
 #include <wx/progdlg.h>
 #include <board_commit.h>
+#include <zone_filler.h>
 #include <geometry/shape_segment.h>
 #include <geometry/shape_arc.h>
 
 #include <drc/courtyard_overlap.h>
+#include <drc/drc_rtree.h>
+#include <drc/drc_sweep_index.h>
+
+#include <algorithm>
+#include <atomic>
+
+
+/**
+ * Tracks and pads of the board, indexed once per run and shared by its tests.
+ *
+ * Ids are the positions of the items in the lists of all tracks and pads, in board order, so
+ * candidates come in the order a plain loop over the board would visit them.  For an
+ * incremental run, only the items which can come close to a tested item are indexed.
+ */
+struct DRC::ITEM_INDEX
+{
+    std::vector<TRACK*> m_tracks;           ///< all tracks and vias, in board order
+    std::vector<D_PAD*> m_pads;             ///< all pads, in board order
+    std::vector<int>    m_padIds;           ///< ids of the indexed pads
+    DRC_RTREE           m_trackIndex;
+    DRC_RTREE           m_padIndex;         ///< pad shapes, and their holes on all copper layers
+    int                 m_maxClearance = 0; ///< biggest clearance of the board and its items
+};
+
 
 void DRC::ShowDRCDialog( wxWindow* aParent )
 {
@@ -103,6 +130,8 @@ void DRC::ShowDRCDialog( wxWindow* aParent )
 
 void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
 {
+    m_markerCount++;
+
     // In legacy routing mode, do not add markers to the board.
     // only shows the drc error message
     if( m_drcInLegacyRoutingMode )
@@ -111,6 +140,10 @@ void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
         delete aMarker;
         m_currentMarker = nullptr;
     }
+    else if( m_markerHandler )
+    {
+        m_markerHandler( aMarker );
+    }
     else
     {
         BOARD_COMMIT commit( m_pcbEditorFrame );
@@ -120,6 +153,35 @@ void DRC::addMarkerToPcb( MARKER_PCB* aMarker )
 }
 
 
+void DRC::addMarkersToPcb( const std::vector<MARKER_PCB*>& aMarkers )
+{
+    if( aMarkers.empty() )
+        return;
+
+    if( m_drcInLegacyRoutingMode || m_markerHandler )
+    {
+        for( MARKER_PCB* marker : aMarkers )
+            addMarkerToPcb( marker );
+    }
+    else
+    {
+        BOARD_COMMIT commit( m_pcbEditorFrame );
+
+        for( MARKER_PCB* marker : aMarkers )
+            commit.Add( marker );
+
+        commit.Push( wxEmptyString, false, false );
+        m_markerCount += aMarkers.size();
+    }
+}
+
+
+EDA_UNITS_T DRC::userUnits() const
+{
+    return m_pcbEditorFrame ? m_pcbEditorFrame->GetUserUnits() : m_units;
+}
+
+
 void DRC::DestroyDRCDialog( int aReason )
 {
     if( m_drcDialog )
@@ -137,6 +199,10 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
     m_pcbEditorFrame = aPcbWindow;
     m_pcb = aPcbWindow->GetBoard();
     m_drcDialog  = NULL;
+    m_units = aPcbWindow->GetUserUnits();
+    m_markerCount = 0;
+    m_clearanceMargin = 0;
+    m_fullRunInProgress = false;
 
     // establish initial values for everything:
     m_drcInLegacyRoutingMode = false;
@@ -168,6 +234,71 @@ DRC::DRC( PCB_EDIT_FRAME* aPcbWindow )
 }
 
 
+DRC::DRC( BOARD* aBoard, EDA_UNITS_T aUnits, MARKER_HANDLER aHandler ) :
+    m_doPad2PadTest( true ),
+    m_doUnconnectedTest( true ),
+    m_doZonesTest( false ),
+    m_doKeepoutTest( true ),
+    m_doCreateRptFile( false ),
+    m_refillZones( false ),
+    m_reportAllTrackErrors( false ),
+    m_testFootprints( false ),
+    m_currentMarker( nullptr ),
+    m_drcInLegacyRoutingMode( false ),
+    m_segmAngle( 0 ),
+    m_segmLength( 0 ),
+    m_xcliplo( 0 ),
+    m_ycliplo( 0 ),
+    m_xcliphi( 0 ),
+    m_ycliphi( 0 ),
+    m_pcbEditorFrame( nullptr ),
+    m_pcb( aBoard ),
+    m_drcDialog( nullptr ),
+    m_drcRun( false ),
+    m_footprintsTested( false ),
+    m_markerHandler( aHandler ),
+    m_units( aUnits ),
+    m_markerCount( 0 ),
+    m_clearanceMargin( 0 ),
+    m_fullRunInProgress( false )
+{
+    m_markerFactory.SetUnits( aUnits );
+}
+
+
+DRC::DRC( const DRC& aMaster, MARKER_HANDLER aHandler ) :
+    m_doPad2PadTest( aMaster.m_doPad2PadTest ),
+    m_doUnconnectedTest( aMaster.m_doUnconnectedTest ),
+    m_doZonesTest( aMaster.m_doZonesTest ),
+    m_doKeepoutTest( aMaster.m_doKeepoutTest ),
+    m_doCreateRptFile( false ),
+    m_refillZones( false ),
+    m_reportAllTrackErrors( aMaster.m_reportAllTrackErrors ),
+    m_testFootprints( false ),
+    m_currentMarker( nullptr ),
+    m_drcInLegacyRoutingMode( false ),
+    m_segmAngle( 0 ),
+    m_segmLength( 0 ),
+    m_xcliplo( 0 ),
+    m_ycliplo( 0 ),
+    m_xcliphi( 0 ),
+    m_ycliphi( 0 ),
+    m_pcbEditorFrame( aMaster.m_pcbEditorFrame ),
+    m_pcb( aMaster.m_pcb ),
+    m_board_outlines( aMaster.m_board_outlines ),
+    m_drcDialog( nullptr ),
+    m_markerFactory( aMaster.m_markerFactory ),
+    m_drcRun( false ),
+    m_footprintsTested( false ),
+    m_markerHandler( aHandler ),
+    m_units( aMaster.m_units ),
+    m_markerCount( 0 ),
+    m_clearanceMargin( 0 ),
+    m_fullRunInProgress( false )
+{
+}
+
+
 DRC::~DRC()
 {
     for( DRC_ITEM* unconnectedItem : m_unconnected )
@@ -225,8 +356,8 @@ int DRC::DrcOnCreatingTrack( TRACK* aRefSegm, TRACK* aList )
 
 int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
-    BOARD_COMMIT commit( m_pcbEditorFrame );
+    BOARD* board = m_pcbEditorFrame ? m_pcbEditorFrame->GetBoard() : m_pcb;
+    std::vector<MARKER_PCB*> markers;
     int nerrors = 0;
 
     std::vector<SHAPE_POLY_SET> smoothed_polys;
@@ -296,7 +427,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 if( smoothed_polys[ia2].Contains( currentVertex ) )
                 {
                     if( aCreateMarkers )
-                        commit.Add( m_markerFactory.NewMarker(
+                        markers.push_back( m_markerFactory.NewMarker(
                                 pt, zoneRef, zoneToTest, DRCE_ZONES_INTERSECT ) );
 
                     nerrors++;
@@ -312,7 +443,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
                 if( smoothed_polys[ia].Contains( currentVertex ) )
                 {
                     if( aCreateMarkers )
-                        commit.Add( m_markerFactory.NewMarker(
+                        markers.push_back( m_markerFactory.NewMarker(
                                 pt, zoneToTest, zoneRef, DRCE_ZONES_INTERSECT ) );
 
                     nerrors++;
@@ -361,7 +492,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
             for( wxPoint pt : conflictPoints )
             {
                 if( aCreateMarkers )
-                    commit.Add( m_markerFactory.NewMarker(
+                    markers.push_back( m_markerFactory.NewMarker(
                             pt, zoneRef, zoneToTest, DRCE_ZONES_TOO_CLOSE ) );
 
                 nerrors++;
@@ -370,7 +501,7 @@ int DRC::TestZoneToZoneOutline( ZONE_CONTAINER* aZone, bool aCreateMarkers )
     }
 
     if( aCreateMarkers )
-        commit.Push( wxEmptyString, false, false );
+        addMarkersToPcb( markers );
 
     return nerrors;
 }
@@ -403,11 +534,37 @@ int DRC::DrcOnCreatingZone( ZONE_CONTAINER* aArea, int aCornerIndex )
 }
 
 
+void DRC::runPass( const std::string& aName, size_t aItemCount,
+                   const std::function<void()>& aPass )
+{
+    size_t markerCount = m_markerCount;
+    auto   start = std::chrono::steady_clock::now();
+
+    aPass();
+
+    auto   duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - start );
+
+    m_passStats.push_back( { aName, duration, aItemCount, m_markerCount - markerCount } );
+}
+
+
 void DRC::RunTests( wxTextCtrl* aMessages )
 {
     // be sure m_pcb is the current board, not a old one
     // ( the board can be reloaded )
-    m_pcb = m_pcbEditorFrame->GetBoard();
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
+
+    m_passStats.clear();
+    m_dirtyRegion.Clear();
+
+    // The zone refill commits its changes, which must not trigger incremental runs
+    m_fullRunInProgress = true;
+
+    size_t padCount = m_pcb->GetPadCount();
+    size_t trackCount = m_pcb->m_Track.GetCount();
+    size_t zoneCount = m_pcb->GetAreaCount();
 
     if( aMessages )
     {
@@ -415,10 +572,15 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testOutline();
+    runPass( "outline", m_pcb->m_Drawings.GetCount(), [&]() { testOutline(); } );
 
     // someone should have cleared the two lists before calling this.
-    if( !testNetClasses() )
+    bool netclassesOk = true;
+
+    runPass( "netclasses", m_pcb->GetDesignSettings().m_NetClasses.GetCount() + 1,
+             [&]() { netclassesOk = testNetClasses(); } );
+
+    if( !netclassesOk )
     {
         // testing the netclasses is a special case because if the netclasses
         // do not pass the BOARD_DESIGN_SETTINGS checks, then every member of a net
@@ -427,12 +589,17 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         if( aMessages )
             aMessages->AppendText( _( "Aborting\n" ) );
 
+        m_fullRunInProgress = false;
+
         // update the m_drcDialog listboxes
         updatePointers();
 
         return;
     }
 
+    // Shared by the pad, track and keepout tests.  Refilling the zones does not move them.
+    buildItemIndex();
+
     // test pad to pad clearances, nothing to do with tracks, vias or zones.
     if( m_doPad2PadTest )
     {
@@ -442,7 +609,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             wxSafeYield();
         }
 
-        testPad2Pad();
+        runPass( "pad2pad", padCount, [&]() { testPad2Pad(); } );
     }
 
     // test clearances between drilled holes
@@ -452,24 +619,36 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testDrilledHoles();
-
-    // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
-    wxWindow* caller = aMessages ? aMessages->GetParent() : m_pcbEditorFrame;
+    runPass( "drilled_holes", padCount + trackCount, [&]() { testDrilledHoles(); } );
 
     if( m_refillZones )
     {
         if( aMessages )
             aMessages->AppendText( _( "Refilling all zones...\n" ) );
 
-        m_pcbEditorFrame->Fill_All_Zones();
+        runPass( "zone_fill", zoneCount, [&]()
+                {
+                    if( m_pcbEditorFrame )
+                    {
+                        m_pcbEditorFrame->Fill_All_Zones();
+                    }
+                    else
+                    {
+                        ZONE_FILLER filler( m_pcb );
+                        filler.Fill( m_pcb->Zones() );
+                    }
+                } );
     }
-    else
+    else if( m_pcbEditorFrame )
     {
+        // caller (a wxTopLevelFrame) is the wxDialog or the Pcb Editor frame that call DRC:
+        wxWindow* caller = aMessages ? aMessages->GetParent() : m_pcbEditorFrame;
+
         if( aMessages )
             aMessages->AppendText( _( "Checking zone fills...\n" ) );
 
-        m_pcbEditorFrame->Check_All_Zones( caller );
+        runPass( "zone_fill_check", zoneCount,
+                 [&]() { m_pcbEditorFrame->Check_All_Zones( caller ); } );
     }
 
     // test track and via clearances to other tracks, pads, and vias
@@ -479,7 +658,13 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, true );
+    runPass( "tracks", trackCount, [&]()
+            {
+                if( m_pcbEditorFrame )
+                    testTracks( aMessages ? aMessages->GetParent() : m_pcbEditorFrame, true );
+                else
+                    testTracks( nullptr, false );
+            } );
 
     // test zone clearances to other zones
     if( aMessages )
@@ -488,7 +673,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testZones();
+    runPass( "zones", zoneCount, [&]() { testZones(); } );
 
     // find and gather unconnected pads.
     if( m_doUnconnectedTest )
@@ -499,7 +684,10 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
-        testUnconnected();
+        runPass( "unconnected", padCount + trackCount + zoneCount, [&]() { testUnconnected(); } );
+
+        // unconnected items are not markers: report them as the pass result
+        m_passStats.back().m_MarkerCount = m_unconnected.size();
     }
 
     // find and gather vias, tracks, pads inside keepout areas.
@@ -511,7 +699,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
-        testKeepoutAreas();
+        runPass( "keepouts", zoneCount, [&]() { testKeepoutAreas(); } );
     }
 
     // find and gather vias, tracks, pads inside text boxes.
@@ -521,7 +709,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         wxSafeYield();
     }
 
-    testCopperTextAndGraphics();
+    runPass( "copper_text_graphics", m_pcb->m_Drawings.GetCount() + m_pcb->m_Modules.GetCount(),
+             [&]() { testCopperTextAndGraphics(); } );
 
     // find overlapping courtyard ares.
     if( m_pcb->GetDesignSettings().m_ProhibitOverlappingCourtyards
@@ -533,7 +722,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
             aMessages->Refresh();
         }
 
-        doFootprintOverlappingDrc();
+        runPass( "courtyards", m_pcb->m_Modules.GetCount(),
+                 [&]() { doFootprintOverlappingDrc(); } );
     }
 
     for( DRC_ITEM* footprintItem : m_footprints )
@@ -542,7 +732,7 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     m_footprints.clear();
     m_footprintsTested = false;
 
-    if( m_testFootprints && !Kiface().IsSingle() )
+    if( m_testFootprints && m_pcbEditorFrame && !Kiface().IsSingle() )
     {
         if( aMessages )
         {
@@ -561,7 +751,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
     }
 
     // Check if there are items on disabled layers
-    testDisabledLayers();
+    runPass( "disabled_layers", padCount + trackCount + zoneCount,
+             [&]() { testDisabledLayers(); } );
 
     if( aMessages )
     {
@@ -569,6 +760,8 @@ void DRC::RunTests( wxTextCtrl* aMessages )
         aMessages->Refresh();
     }
 
+    m_itemIndex.reset();
+    m_fullRunInProgress = false;
     m_drcRun = true;
 
     // update the m_drcDialog listboxes
@@ -583,10 +776,240 @@ void DRC::RunTests( wxTextCtrl* aMessages )
 }
 
 
+void DRC::MarkDirty( const BOARD_ITEM* aItem )
+{
+    if( !m_drcRun || m_fullRunInProgress )
+        return;
+
+    m_dirtyRegion.Add( aItem );
+
+    // Keep the margin of the incremental tests up to date without scanning the board
+    switch( aItem->Type() )
+    {
+    case PCB_TRACE_T:
+    case PCB_VIA_T:
+    case PCB_PAD_T:
+        m_clearanceMargin = std::max( m_clearanceMargin,
+                static_cast<const BOARD_CONNECTED_ITEM*>( aItem )->GetClearance() );
+        break;
+
+    case PCB_MODULE_T:
+        for( const D_PAD* pad = static_cast<const MODULE*>( aItem )->PadsList().GetFirst(); pad;
+                pad = pad->Next() )
+        {
+            m_clearanceMargin = std::max( m_clearanceMargin, pad->GetClearance() );
+        }
+
+        break;
+
+    default:
+        break;
+    }
+}
+
+
+void DRC::MarkDirty( const EDA_RECT& aArea )
+{
+    if( m_drcRun && !m_fullRunInProgress )
+        m_dirtyRegion.Add( aArea );
+}
+
+
+void DRC::RunIncrementalTests()
+{
+    if( !m_drcRun || m_fullRunInProgress || m_drcInLegacyRoutingMode
+            || m_dirtyRegion.IsEmpty() )
+    {
+        return;
+    }
+
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
+
+    m_passStats.clear();
+
+    // Any item closer than this to a changed area can have new (or lost) clearance errors.
+    // The item clearances are those of the last full run, raised by the changed items since.
+    m_clearanceMargin = std::max( m_clearanceMargin,
+                                  m_pcb->GetDesignSettings().GetBiggestClearanceValue() );
+
+    int margin = m_clearanceMargin;
+
+    auto isAffected = [&]( const BOARD_ITEM* aItem )
+    {
+        return m_dirtyRegion.Contains( aItem )
+               || m_dirtyRegion.Intersects( aItem->GetBoundingBox(), margin );
+    };
+
+    std::set<const BOARD_ITEM*> refTracks;
+    std::set<const BOARD_ITEM*> refPads;
+    std::set<const BOARD_ITEM*> refFootprints;
+
+    for( TRACK* track : m_pcb->Tracks() )
+    {
+        if( isAffected( track ) )
+            refTracks.insert( track );
+    }
+
+    for( MODULE* module : m_pcb->Modules() )
+    {
+        if( isAffected( module ) )
+            refFootprints.insert( module );
+
+        for( D_PAD* pad : module->Pads() )
+        {
+            if( isAffected( pad ) )
+                refPads.insert( pad );
+        }
+    }
+
+    // Find the markers which will be created again, or which are about items since removed
+    auto isStale = [&]( const DRC_ITEM& aItem, const std::set<const BOARD_ITEM*>& aRefItems )
+    {
+        for( const void* ref : { aItem.GetMainItemWeakRef(), aItem.GetAuxiliaryItemWeakRef() } )
+        {
+            // Removed items are only compared, never dereferenced
+            const BOARD_ITEM* item = static_cast<const BOARD_ITEM*>( ref );
+
+            if( item && ( aRefItems.count( item ) || m_dirtyRegion.Contains( item ) ) )
+                return true;
+        }
+
+        return false;
+    };
+
+    std::vector<MARKER_PCB*> staleMarkers;
+
+    for( int ii = 0; ii < m_pcb->GetMARKERCount(); ++ii )
+    {
+        MARKER_PCB*     marker = m_pcb->GetMARKER( ii );
+        const DRC_ITEM& item = marker->GetReporter();
+        bool            stale = false;
+
+        switch( item.GetErrorCode() )
+        {
+        case DRCE_PAD_NEAR_PAD1:
+        case DRCE_HOLE_NEAR_PAD:
+            stale = m_doPad2PadTest && isStale( item, refPads );
+            break;
+
+        case DRCE_VIA_INSIDE_KEEPOUT:
+        case DRCE_TRACK_INSIDE_KEEPOUT:
+            stale = m_doKeepoutTest && isStale( item, refTracks );
+            break;
+
+        case DRCE_PAD_INSIDE_KEEPOUT:
+            stale = m_doKeepoutTest && isStale( item, refPads );
+            break;
+
+        case DRCE_OVERLAPPING_FOOTPRINTS:
+        case DRCE_MISSING_COURTYARD_IN_FOOTPRINT:
+        case DRCE_MALFORMED_COURTYARD_IN_FOOTPRINT:
+            stale = isStale( item, refFootprints );
+            break;
+
+        case DRCE_TRACK_NEAR_THROUGH_HOLE:
+        case DRCE_TRACK_NEAR_PAD:
+        case DRCE_TRACK_NEAR_VIA:
+        case DRCE_VIA_NEAR_VIA:
+        case DRCE_VIA_NEAR_TRACK:
+        case DRCE_TRACK_ENDS1:
+        case DRCE_TRACK_ENDS2:
+        case DRCE_TRACK_ENDS3:
+        case DRCE_TRACK_ENDS4:
+        case DRCE_TRACK_SEGMENTS_TOO_CLOSE:
+        case DRCE_TRACKS_CROSSING:
+        case DRCE_ENDS_PROBLEM1:
+        case DRCE_ENDS_PROBLEM2:
+        case DRCE_ENDS_PROBLEM3:
+        case DRCE_ENDS_PROBLEM4:
+        case DRCE_ENDS_PROBLEM5:
+        case DRCE_VIA_HOLE_BIGGER:
+        case DRCE_MICRO_VIA_INCORRECT_LAYER_PAIR:
+        case DRCE_TOO_SMALL_TRACK_WIDTH:
+        case DRCE_TOO_SMALL_VIA:
+        case DRCE_TOO_SMALL_MICROVIA:
+        case DRCE_TOO_SMALL_VIA_DRILL:
+        case DRCE_TOO_SMALL_MICROVIA_DRILL:
+        case DRCE_TRACK_NEAR_ZONE:
+        case DRCE_MICRO_VIA_NOT_ALLOWED:
+        case DRCE_BURIED_VIA_NOT_ALLOWED:
+        case DRCE_TRACK_NEAR_EDGE:
+            stale = isStale( item, refTracks );
+            break;
+
+        default:
+            break;
+        }
+
+        if( stale )
+            staleMarkers.push_back( marker );
+    }
+
+    // Collect the new markers, so the board is updated in a single commit
+    std::vector<MARKER_PCB*> newMarkers;
+    MARKER_HANDLER           handler = m_markerHandler;
+
+    m_markerHandler = [&]( MARKER_PCB* aMarker ) { newMarkers.push_back( aMarker ); };
+
+    std::set<const BOARD_ITEM*> refItems( refTracks );
+    refItems.insert( refPads.begin(), refPads.end() );
+
+    buildItemIndex( &refItems );
+
+    if( m_doPad2PadTest )
+        runPass( "pad2pad", refPads.size(), [&]() { testPad2Pad( &refPads ); } );
+
+    runPass( "tracks", refTracks.size(), [&]() { testTracks( nullptr, false, &refTracks ); } );
+
+    if( m_doKeepoutTest )
+        runPass( "keepouts", refItems.size(), [&]() { testKeepoutAreas( &refItems ); } );
+
+    if( m_pcb->GetDesignSettings().m_ProhibitOverlappingCourtyards
+        || m_pcb->GetDesignSettings().m_RequireCourtyards )
+    {
+        runPass( "courtyards", refFootprints.size(),
+                 [&]() { doFootprintOverlappingDrc( &refFootprints ); } );
+    }
+
+    m_markerHandler = handler;
+    m_itemIndex.reset();
+
+    // Cleared before committing the markers: the commit reports its changes to this DRC
+    m_dirtyRegion.Clear();
+
+    if( m_markerHandler )
+    {
+        for( MARKER_PCB* marker : newMarkers )
+            m_markerHandler( marker );
+    }
+    else if( !staleMarkers.empty() || !newMarkers.empty() )
+    {
+        BOARD_COMMIT commit( m_pcbEditorFrame );
+
+        for( MARKER_PCB* marker : staleMarkers )
+            commit.Remove( marker );
+
+        for( MARKER_PCB* marker : newMarkers )
+            commit.Add( marker );
+
+        commit.Push( wxEmptyString, false, false );
+
+        // Without undo entry, nobody owns the removed markers
+        for( MARKER_PCB* marker : staleMarkers )
+            delete marker;
+    }
+
+    // update the m_drcDialog listboxes
+    updatePointers();
+}
+
+
 void DRC::updatePointers()
 {
     // update my pointers, m_pcbEditorFrame is the only unchangeable one
-    m_pcb = m_pcbEditorFrame->GetBoard();
+    if( m_pcbEditorFrame )
+        m_pcb = m_pcbEditorFrame->GetBoard();
 
     if( m_drcDialog )  // Use diag list boxes only in DRC dialog
     {
@@ -608,7 +1031,7 @@ bool DRC::doNetClass( const NETCLASSPTR& nc, wxString& msg )
 
     const BOARD_DESIGN_SETTINGS& g = m_pcb->GetDesignSettings();
 
-#define FmtVal( x ) GetChars( StringFromValue( m_pcbEditorFrame->GetUserUnits(), x ) )
+#define FmtVal( x ) GetChars( StringFromValue( userUnits(), x ) )
 
 #if 0   // set to 1 when (if...) BOARD_DESIGN_SETTINGS has a m_MinClearance value
     if( nc->GetClearance() < g.m_MinClearance )
@@ -710,47 +1133,244 @@ bool DRC::testNetClasses()
 }
 
 
-void DRC::testPad2Pad()
+void DRC::testInStrips( const std::vector<size_t>& aStrips,
+                        const std::function<void( DRC& aWorker, size_t aIndex )>& aTest )
 {
-    std::vector<D_PAD*> sortedPads;
+    if( aStrips.size() < 2 )
+        return;
 
-    m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
+    // Markers found for each item, merged in item order once all threads are done
+    std::vector<std::vector<MARKER_PCB*>> itemMarkers( aStrips.back() );
 
-    if( sortedPads.size() == 0 )
-        return;
+    // Each thread has its own worker DRC, created on its first strip
+    THREAD_POOL&                      pool = THREAD_POOL::GetPool();
+    std::vector<std::unique_ptr<DRC>> workers( pool.GetSlotCount() );
+    std::vector<size_t>               current( pool.GetSlotCount(), 0 );
+
+    pool.ParallelFor( aStrips.size() - 1,
+            [&]( size_t strip )
+            {
+                size_t slot = pool.GetSlot();
+
+                if( !workers[slot] )
+                {
+                    auto handler = [&itemMarkers, &current, slot]( MARKER_PCB* aMarker )
+                                   {
+                                       itemMarkers[current[slot]].push_back( aMarker );
+                                   };
+
+                    workers[slot].reset( new DRC( *this, handler ) );
+                }
+
+                for( current[slot] = aStrips[strip]; current[slot] < aStrips[strip + 1];
+                        ++current[slot] )
+                {
+                    aTest( *workers[slot], current[slot] );
+                }
+            } );
 
-    // find the max size of the pads (used to stop the test)
-    int max_size = 0;
+    std::vector<MARKER_PCB*> markers;
+
+    for( auto& list : itemMarkers )
+        markers.insert( markers.end(), list.begin(), list.end() );
+
+    addMarkersToPcb( markers );
+}
+
+
+/**
+ * @return the bounding box of the copper of \a aPad and of its hole.
+ */
+static EDA_RECT padExtent( const D_PAD* aPad )
+{
+    EDA_RECT bbox( aPad->ShapePos(), wxSize( 0, 0 ) );
+    bbox.Inflate( aPad->GetBoundingRadius() );
 
-    for( unsigned i = 0; i < sortedPads.size(); ++i )
+    if( aPad->GetDrillSize().x )
     {
-        D_PAD* pad = sortedPads[i];
+        int      holeRadius = std::max( aPad->GetDrillSize().x, aPad->GetDrillSize().y ) / 2;
+        EDA_RECT holeBox( aPad->GetPosition(), wxSize( 0, 0 ) );
+        holeBox.Inflate( holeRadius );
+        bbox.Merge( holeBox );
+    }
+
+    return bbox;
+}
+
+
+void DRC::buildItemIndex( const std::set<const BOARD_ITEM*>* aRefItems )
+{
+    m_itemIndex.reset( new ITEM_INDEX );
+
+    ITEM_INDEX& index = *m_itemIndex;
+
+    for( TRACK* segm : m_pcb->Tracks() )
+        index.m_tracks.push_back( segm );
+
+    index.m_pads = m_pcb->GetPads();
+
+    // For an incremental run, the area around the tested items.  It is an index too, as
+    // these items can be anywhere on the board.  Layers do not matter: use a single one.
+    DRC_RTREE        area;
+    const LSET       areaLayer( 1, F_Cu );
+    std::vector<int> ids;
+
+    if( aRefItems )
+    {
+        // The clearances are known from the last run, see MarkDirty()
+        index.m_maxClearance = m_clearanceMargin;
+
+        int id = 0;
+
+        for( const BOARD_ITEM* item : *aRefItems )
+        {
+            EDA_RECT bbox = item->Type() == PCB_PAD_T
+                                    ? padExtent( static_cast<const D_PAD*>( item ) )
+                                    : item->GetBoundingBox();
+
+            // Tests use rotated integer coordinates: allow a few nm for rounding
+            bbox.Inflate( m_clearanceMargin + 10 );
+            area.Insert( id++, bbox, areaLayer );
+        }
+    }
+    else
+    {
+        index.m_maxClearance = m_pcb->GetDesignSettings().GetBiggestClearanceValue();
+    }
+
+    auto isIndexed = [&]( const EDA_RECT& aBBox )
+    {
+        if( !aRefItems )
+            return true;
+
+        area.Query( aBBox, areaLayer, ids );
+        return !ids.empty();
+    };
+
+    for( size_t ii = 0; ii < index.m_tracks.size(); ++ii )
+    {
+        TRACK*   segm = index.m_tracks[ii];
+        EDA_RECT bbox = segm->GetBoundingBox();
+
+        if( !isIndexed( bbox ) )
+            continue;
+
+        index.m_trackIndex.Insert( ii, bbox, segm->GetLayerSet() );
+
+        if( !aRefItems )
+            index.m_maxClearance = std::max( index.m_maxClearance, segm->GetClearance() );
+    }
 
-        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
-        int radius = pad->GetBoundingRadius();
+    for( size_t ii = 0; ii < index.m_pads.size(); ++ii )
+    {
+        D_PAD* pad = index.m_pads[ii];
+
+        // GetBoundingRadius() is cached on first use: compute it here, before the threads
+        // start reading it
+        EDA_RECT bbox = padExtent( pad );
+
+        if( !isIndexed( bbox ) )
+            continue;
+
+        LSET layers = pad->GetLayerSet();
+
+        // A hole is tested against tracks on every copper layer
+        if( pad->GetDrillSize().x )
+            layers |= LSET::AllCuMask();
 
-        if( radius > max_size )
-            max_size = radius;
+        index.m_padIndex.Insert( ii, bbox, layers );
+        index.m_padIds.push_back( ii );
+
+        if( !aRefItems )
+            index.m_maxClearance = std::max( index.m_maxClearance, pad->GetClearance() );
     }
 
+    if( !aRefItems )
+        m_clearanceMargin = index.m_maxClearance;
+}
+
+
+/// Number of strips per thread: small enough strips let the threads finish together
+static const size_t STRIPS_PER_THREAD = 8;
+
+
+void DRC::testPad2Pad( const std::set<const BOARD_ITEM*>* aRefPads )
+{
+    const ITEM_INDEX& items = *m_itemIndex;
+    DRC_SWEEP_INDEX   index;
+
+    if( items.m_padIds.empty() )
+        return;
+
+    // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
+    for( int id : items.m_padIds )
+        index.Add( id, items.m_pads[id]->GetPosition(), items.m_pads[id]->GetBoundingRadius() );
+
+    index.Build();
+
+    int                 max_clearance = items.m_maxClearance;
+    std::vector<D_PAD*> sortedPads;
+
+    for( size_t ii = 0; ii < index.Size(); ++ii )
+        sortedPads.push_back( items.m_pads[index.GetItem( ii ).m_Id] );
+
     // Upper limit of pad list (limit not included)
     D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
 
     // Test the pads
-    for( unsigned i = 0; i< sortedPads.size(); ++i )
+    auto testPad = [&]( DRC& aWorker, size_t i )
     {
         D_PAD* pad = sortedPads[i];
 
-        int    x_limit = max_size + pad->GetClearance() +
-                         pad->GetBoundingRadius() + pad->GetPosition().x;
+        int    x_limit = index.GetLimitX( i, pad->GetClearance() );
+        bool   ok;
 
-        if( !doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+        if( !aRefPads )
         {
-            wxASSERT( m_currentMarker );
-            addMarkerToPcb ( m_currentMarker );
-            m_currentMarker = nullptr;
+            ok = aWorker.doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit );
         }
-    }
+        else if( aRefPads->count( pad ) )
+        {
+            // Test against earlier pads too, unless they are tested themselves
+            int x_start = pad->GetPosition().x - index.GetMaxReach() - max_clearance
+                          - pad->GetBoundingRadius();
+
+            auto first = std::lower_bound( sortedPads.begin(), sortedPads.end(), x_start,
+                    []( const D_PAD* aPad, int aX )
+                    {
+                        return aPad->GetPosition().x < aX;
+                    } );
+
+            std::vector<D_PAD*> candidates;
+
+            for( auto it = first; it != sortedPads.end(); ++it )
+            {
+                if( (*it)->GetPosition().x > x_limit )
+                    break;
+
+                if( it >= sortedPads.begin() + i || !aRefPads->count( *it ) )
+                    candidates.push_back( *it );
+            }
+
+            ok = candidates.empty()
+                 || aWorker.doPadToPadsDrc( pad, &candidates[0],
+                                            &candidates[0] + candidates.size(), x_limit );
+        }
+        else
+        {
+            return;
+        }
+
+        if( !ok )
+        {
+            wxASSERT( aWorker.m_currentMarker );
+            aWorker.addMarkerToPcb( aWorker.m_currentMarker );
+            aWorker.m_currentMarker = nullptr;
+        }
+    };
+
+    testInStrips( index.GetStrips( THREAD_POOL::GetPool().GetThreadCount() * STRIPS_PER_THREAD ),
+                  testPad );
 }
 
 
@@ -802,13 +1422,26 @@ void DRC::testDrilledHoles()
         }
     }
 
+    DRC_SWEEP_INDEX index;
+
     for( size_t ii = 0; ii < holes.size(); ++ii )
+        index.Add( ii, holes[ii].m_location, holes[ii].m_drillRadius );
+
+    index.Build();
+
+    auto testHole = [&]( DRC& aWorker, size_t aIndex )
     {
-        const DRILLED_HOLE& refHole = holes[ ii ];
+        std::vector<size_t> candidates;
+
+        index.QueryForward( aIndex, holeToHoleMin, candidates );
 
-        for( size_t jj = ii + 1; jj < holes.size(); ++jj )
+        for( size_t candidate : candidates )
         {
-            const DRILLED_HOLE& checkHole = holes[ jj ];
+            // Report each pair as the full scan of the hole list would: from the first hole
+            int                 ii = index.GetItem( aIndex ).m_Id;
+            int                 jj = index.GetItem( candidate ).m_Id;
+            const DRILLED_HOLE& refHole = holes[ std::min( ii, jj ) ];
+            const DRILLED_HOLE& checkHole = holes[ std::max( ii, jj ) ];
 
             // Holes with identical locations are allowable
             if( checkHole.m_location == refHole.m_location )
@@ -817,27 +1450,51 @@ void DRC::testDrilledHoles()
             if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
                     <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
             {
-                addMarkerToPcb( new MARKER_PCB( m_pcbEditorFrame->GetUserUnits(),
+                aWorker.addMarkerToPcb( new MARKER_PCB( userUnits(),
                                                 DRCE_DRILLED_HOLES_TOO_CLOSE, refHole.m_location,
                                                 refHole.m_owner, refHole.m_location,
                                                 checkHole.m_owner, checkHole.m_location ) );
             }
         }
-    }
+    };
+
+    testInStrips( index.GetStrips( THREAD_POOL::GetPool().GetThreadCount() * STRIPS_PER_THREAD ),
+                  testHole );
 }
 
 
-void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
+void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar,
+                      const std::set<const BOARD_ITEM*>* aRefTracks )
 {
     wxProgressDialog * progressDialog = NULL;
     const int delta = 500;  // This is the number of tests between 2 calls to the
                             // progress bar
-    int count = 0;
 
-    for( TRACK* segm = m_pcb->m_Track; segm && segm->Next(); segm = segm->Next() )
-        count++;
+    // Tracks, vias and pads are indexed by their position in the board lists, so candidates
+    // found by the index are tested in the same order as the full scan would test them.
+    const std::vector<TRACK*>& tracks = m_itemIndex->m_tracks;
+    const std::vector<D_PAD*>& pads = m_itemIndex->m_pads;
+    const DRC_RTREE&           trackIndex = m_itemIndex->m_trackIndex;
+    const DRC_RTREE&           padIndex = m_itemIndex->m_padIndex;
+
+    // Tests use rotated integer coordinates: allow a few nm for rounding
+    const int searchMargin = m_itemIndex->m_maxClearance + 10;
+
+    // The segments to test, in track order
+    std::vector<size_t> refTracks;
+
+    for( size_t ii = 0; ii < tracks.size(); ++ii )
+    {
+        if( !aRefTracks || aRefTracks->count( tracks[ii] ) )
+            refTracks.push_back( ii );
+    }
+
+    auto isRefTrack = [&]( const TRACK* aTrack )
+    {
+        return !aRefTracks || aRefTracks->count( aTrack );
+    };
 
-    int deltamax = count/delta;
+    int deltamax = refTracks.size() / delta;
 
     if( aShowProgressBar && deltamax > 3 )
     {
@@ -849,38 +1506,96 @@ void DRC::testTracks( wxWindow *aActiveWindow, bool aShowProgressBar )
         progressDialog->Update( 0, wxEmptyString );
     }
 
-    int ii = 0;
-    count = 0;
+    // Markers found for each reference segment, merged in track order once all threads are done
+    std::vector<std::vector<MARKER_PCB*>> segmMarkers( tracks.size() );
 
-    for( TRACK* segm = m_pcb->m_Track; segm; segm = segm->Next() )
+    // State of each thread: its worker DRC and some scratch lists
+    struct TRACK_WORKER
     {
-        if( ii++ > delta )
+        std::unique_ptr<DRC> m_drc;
+        size_t               m_current = 0;
+        std::vector<int>     m_ids;
+        std::vector<D_PAD*>  m_candidatePads;
+        std::vector<TRACK*>  m_candidateTracks;
+    };
+
+    THREAD_POOL&              pool = THREAD_POOL::GetPool();
+    std::vector<TRACK_WORKER> workers( pool.GetSlotCount() );
+    std::atomic<size_t>       doneCount( 0 );
+    bool                      cancelled = false;
+
+    auto testTrack = [&]( size_t ref )
+    {
+        TRACK_WORKER& worker = workers[pool.GetSlot()];
+
+        if( !worker.m_drc )
         {
-            ii = 0;
-            count++;
+            auto handler = [&segmMarkers, &worker]( MARKER_PCB* aMarker )
+                           {
+                               segmMarkers[worker.m_current].push_back( aMarker );
+                           };
 
-            if( progressDialog )
-            {
-                if( !progressDialog->Update( count, wxEmptyString ) )
-                    break;  // Aborted by user
-#ifdef __WXMAC__
-                // Work around a dialog z-order issue on OS X
-                if( count == deltamax )
-                    aActiveWindow->Raise();
-#endif
-            }
+            worker.m_drc.reset( new DRC( *this, handler ) );
         }
 
-        // Test new segment against tracks and pads, optionally against copper zones
-        if( !doTrackDrc( segm, segm->Next(), true, m_doZonesTest ) )
+        size_t   i = refTracks[ref];
+        TRACK*   segm = tracks[i];
+        EDA_RECT searchBox = segm->GetBoundingBox();
+        searchBox.Inflate( searchMargin );
+
+        worker.m_current = i;
+
+        worker.m_candidatePads.clear();
+        padIndex.Query( searchBox, segm->GetLayerSet(), worker.m_ids );
+
+        for( int id : worker.m_ids )
+            worker.m_candidatePads.push_back( pads[id] );
+
+        // Only later segments: earlier ones have already been tested against this one,
+        // unless they are not tested at all
+        worker.m_candidateTracks.clear();
+        trackIndex.Query( searchBox, segm->GetLayerSet(), worker.m_ids );
+
+        for( int id : worker.m_ids )
         {
-            if( m_currentMarker )
-            {
-                addMarkerToPcb ( m_currentMarker );
-                m_currentMarker = nullptr;
-            }
+            if( id > (int) i || !isRefTrack( tracks[id] ) )
+                worker.m_candidateTracks.push_back( tracks[id] );
         }
-    }
+
+        // Test new segment against tracks and pads, optionally against copper zones
+        worker.m_drc->doTrackDrc( segm, worker.m_candidatePads, worker.m_candidateTracks,
+                                  m_doZonesTest );
+
+        doneCount++;
+    };
+
+    auto updateProgress = [&]() -> bool
+    {
+        if( cancelled )
+            return false;
+
+        int count = doneCount / delta;
+
+        if( !progressDialog->Update( std::min( count, deltamax ), wxEmptyString ) )
+            cancelled = true;   // Aborted by user
+#ifdef __WXMAC__
+        // Work around a dialog z-order issue on OS X
+        if( count == deltamax )
+            aActiveWindow->Raise();
+#endif
+
+        return !cancelled;
+    };
+
+    pool.ParallelFor( refTracks.size(), testTrack,
+                      progressDialog ? THREAD_POOL::WAIT_HOOK( updateProgress ) : nullptr );
+
+    std::vector<MARKER_PCB*> markers;
+
+    for( auto& segmList : segmMarkers )
+        markers.insert( markers.end(), segmList.begin(), segmList.end() );
+
+    addMarkersToPcb( markers );
 
     if( progressDialog )
         progressDialog->Destroy();
@@ -896,9 +1611,9 @@ void DRC::testUnconnected()
 
     auto connectivity = m_pcb->GetConnectivity();
 
-    connectivity->Clear();
-    connectivity->Build( m_pcb ); // just in case. This really needs to be reliable.
-    connectivity->RecalculateRatsnest();
+    // Catch up with the items marked dirty; this only processes the items which changed
+    // rather than rebuilding everything.
+    connectivity->Sync( m_pcb, ADVANCED_CFG::GetCfg().m_verifyIncrementalConnectivity );
 
     std::vector<CN_EDGE> edges;
     connectivity->GetUnconnectedEdges( edges );
@@ -908,7 +1623,7 @@ void DRC::testUnconnected()
         auto src = edge.GetSourcePos();
         auto dst = edge.GetTargetPos();
 
-        m_unconnected.emplace_back( new DRC_ITEM( m_pcbEditorFrame->GetUserUnits(),
+        m_unconnected.emplace_back( new DRC_ITEM( userUnits(),
                                                   DRCE_UNCONNECTED_ITEMS,
                                                   edge.GetSourceNode()->Parent(),
                                                   wxPoint( src.x, src.y ),
@@ -955,8 +1670,22 @@ void DRC::testZones()
 }
 
 
-void DRC::testKeepoutAreas()
+void DRC::testKeepoutAreas( const std::set<const BOARD_ITEM*>* aRefItems )
 {
+    bool hasKeepouts = false;
+
+    for( int ii = 0; ii < m_pcb->GetAreaCount() && !hasKeepouts; ii++ )
+        hasKeepouts = m_pcb->GetArea( ii )->GetIsKeepout();
+
+    if( !hasKeepouts )
+        return;
+
+    // Each keepout area is only compared to the items inside its bounding box: tracks in
+    // board order, then pads
+    const ITEM_INDEX&                  index = *m_itemIndex;
+    std::vector<BOARD_CONNECTED_ITEM*> items;
+    std::vector<int>                   ids;
+
     // Test keepout areas for vias, tracks and pads inside keepout areas
     for( int ii = 0; ii < m_pcb->GetAreaCount(); ii++ )
     {
@@ -967,10 +1696,33 @@ void DRC::testKeepoutAreas()
             continue;
         }
 
-        for( TRACK* segm = m_pcb->m_Track; segm != NULL; segm = segm->Next() )
+        if( !area->GetDoNotAllowTracks() && !area->GetDoNotAllowVias() )
+            continue;
+
+        items.clear();
+        index.m_trackIndex.Query( area->GetBoundingBox(), area->GetLayerSet(), ids );
+
+        for( int id : ids )
+        {
+            if( !aRefItems || aRefItems->count( index.m_tracks[id] ) )
+                items.push_back( index.m_tracks[id] );
+        }
+
+        index.m_padIndex.Query( area->GetBoundingBox(), area->GetLayerSet(), ids );
+
+        for( int id : ids )
+        {
+            if( !aRefItems || aRefItems->count( index.m_pads[id] ) )
+                items.push_back( index.m_pads[id] );
+        }
+
+        for( BOARD_CONNECTED_ITEM* item : items )
         {
-            if( segm->Type() == PCB_TRACE_T )
+
+            if( item->Type() == PCB_TRACE_T )
             {
+                TRACK* segm = static_cast<TRACK*>( item );
+
                 if( !area->GetDoNotAllowTracks()  )
                     continue;
 
@@ -984,8 +1736,10 @@ void DRC::testKeepoutAreas()
                     addMarkerToPcb(
                             m_markerFactory.NewMarker( segm, area, DRCE_TRACK_INSIDE_KEEPOUT ) );
             }
-            else if( segm->Type() == PCB_VIA_T )
+            else if( item->Type() == PCB_VIA_T )
             {
+                TRACK* segm = static_cast<TRACK*>( item );
+
                 if( ! area->GetDoNotAllowVias()  )
                     continue;
 
@@ -998,12 +1752,57 @@ void DRC::testKeepoutAreas()
                     addMarkerToPcb(
                             m_markerFactory.NewMarker( segm, area, DRCE_VIA_INSIDE_KEEPOUT ) );
             }
+            else if( item->Type() == PCB_PAD_T )
+            {
+                D_PAD* pad = static_cast<D_PAD*>( item );
+
+                if( doPadInKeepoutDrc( pad, area ) )
+                    addMarkerToPcb(
+                            m_markerFactory.NewMarker( pad, area, DRCE_PAD_INSIDE_KEEPOUT ) );
+            }
         }
-        // Test pads: TODO
     }
 }
 
 
+bool DRC::doPadInKeepoutDrc( D_PAD* aPad, ZONE_CONTAINER* aArea )
+{
+    // The copper of a pad is not allowed where tracks are not, and a plated hole is not
+    // allowed where vias are not
+    bool forbidden = aArea->GetDoNotAllowTracks();
+
+    if( aArea->GetDoNotAllowVias() && aPad->GetDrillSize().x
+            && aPad->GetAttribute() != PAD_ATTRIB_HOLE_NOT_PLATED )
+    {
+        forbidden = true;
+    }
+
+    if( !forbidden || !aArea->CommonLayerExists( aPad->GetLayerSet() & LSET::AllCuMask() ) )
+        return false;
+
+    SHAPE_POLY_SET* outline = aArea->Outline();
+
+    if( outline->Contains( aPad->ShapePos() ) )
+        return true;
+
+    const int      segmentCount = ARC_APPROX_SEGMENTS_COUNT_HIGH_DEF;
+    double         correctionFactor = GetCircletoPolyCorrectionFactor( segmentCount );
+    SHAPE_POLY_SET padOutline;
+
+    aPad->TransformShapeWithClearanceToPolygon( padOutline, 0, segmentCount, correctionFactor );
+
+    // Pad outline crossing the area outline
+    for( auto it = padOutline.IterateSegmentsWithHoles(); it; it++ )
+    {
+        if( outline->Distance( *it, 0 ) == 0 )
+            return true;
+    }
+
+    // Or area entirely inside the pad
+    return outline->TotalVertices() > 0 && padOutline.Contains( outline->CVertex( 0 ) );
+}
+
+
 void DRC::testCopperTextAndGraphics()
 {
     // Test copper items for clearance violations with vias, tracks and pads
@@ -1257,7 +2056,7 @@ void DRC::testOutline()
 
 void DRC::testDisabledLayers()
 {
-    BOARD* board = m_pcbEditorFrame->GetBoard();
+    BOARD* board = m_pcb;
     wxCHECK( board, /*void*/ );
     LSET disabledLayers = board->GetEnabledLayers().flip();
 
@@ -1473,11 +2272,19 @@ bool DRC::doPadToPadsDrc( D_PAD* aRefPad, D_PAD** aStart, D_PAD** aEnd, int x_li
 }
 
 
-void DRC::doFootprintOverlappingDrc()
+void DRC::doFootprintOverlappingDrc( const std::set<const BOARD_ITEM*>* aRefFootprints )
 {
     DRC_COURTYARD_OVERLAP drc_overlap(
             m_markerFactory, [&]( MARKER_PCB* aMarker ) { addMarkerToPcb( aMarker ); } );
 
+    if( aRefFootprints )
+    {
+        drc_overlap.SetFootprintFilter( [&]( const MODULE* aFootprint )
+                                        {
+                                            return aRefFootprints->count( aFootprint ) > 0;
+                                        } );
+    }
+
     drc_overlap.RunDRC( *m_pcb );
 }
 
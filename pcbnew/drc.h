@@ -31,9 +31,14 @@
 
 #include <vector>
 #include <memory>
+#include <set>
+#include <functional>
+#include <chrono>
+#include <string>
 #include <geometry/seg.h>
 #include <geometry/shape_poly_set.h>
 
+#include <drc/drc_dirty_region.h>
 #include <drc/drc_marker_factory.h>
 
 #define OK_DRC  0
@@ -130,6 +135,11 @@ class wxWindow;
 class wxString;
 class wxTextCtrl;
 
+namespace KI_TEST
+{
+class DRC_REFERENCE_SCANS;
+}
+
 
 /**
  * Provide an abstract interface of a DRC_ITEM* list manager.  The details
@@ -177,6 +187,18 @@ public:
 typedef std::vector<DRC_ITEM*> DRC_LIST;
 
 
+/**
+ * Statistics about a single pass of DRC::RunTests().
+ */
+struct DRC_PASS_STATS
+{
+    std::string               m_Name;         ///< short name of the pass
+    std::chrono::microseconds m_Duration;     ///< wall-clock time taken by the pass
+    size_t                    m_ItemCount;    ///< number of board items tested by the pass
+    size_t                    m_MarkerCount;  ///< number of violations found by the pass
+};
+
+
 /**
  * Design Rule Checker object that performs all the DRC tests.  The output of
  * the checking goes to the BOARD file in the form of two MARKER lists.  Those
@@ -188,6 +210,13 @@ typedef std::vector<DRC_ITEM*> DRC_LIST;
 class DRC
 {
     friend class DIALOG_DRC_CONTROL;
+    friend class KI_TEST::DRC_REFERENCE_SCANS;     // The QA reference of the pad tests
+
+public:
+    /**
+     * A callable that receives the markers created by the DRC instead of the board.
+     */
+    using MARKER_HANDLER = std::function<void( MARKER_PCB* )>;
 
 private:
 
@@ -247,6 +276,29 @@ private:
     bool                m_drcRun;
     bool                m_footprintsTested;
 
+    MARKER_HANDLER      m_markerHandler;    ///< if set, markers go here instead of the board
+    EDA_UNITS_T         m_units;            ///< units used for messages when there is no frame
+    size_t              m_markerCount;      ///< number of markers created since construction
+
+    std::vector<DRC_PASS_STATS> m_passStats;    ///< statistics of the last RunTests()
+
+    DRC_DIRTY_REGION    m_dirtyRegion;      ///< changes since the last run, see MarkDirty()
+    int                 m_clearanceMargin;  ///< biggest item clearance, kept between runs
+    bool                m_fullRunInProgress;    ///< true while RunTests() runs
+
+    struct ITEM_INDEX;
+
+    std::unique_ptr<ITEM_INDEX> m_itemIndex;    ///< tracks and pads of the current run
+
+    /**
+     * Create a worker instance sharing the board, settings and board outlines of \a aMaster.
+     *
+     * The segment geometry members above are scratch state for a single test, so each thread
+     * of a multi-threaded test needs its own instance.  A worker never touches the board or
+     * the editor frame: its markers are passed to \a aHandler.
+     */
+    DRC( const DRC& aMaster, MARKER_HANDLER aHandler );
+
 
     /**
      * Update needed pointers from the one pointer which is known not to change.
@@ -258,6 +310,26 @@ private:
      */
     void addMarkerToPcb( MARKER_PCB* aMarker );
 
+    /**
+     * Adds a list of DRC markers to the PCB in a single commit, preserving their order.
+     */
+    void addMarkersToPcb( const std::vector<MARKER_PCB*>& aMarkers );
+
+    /**
+     * @return the units used in messages: those of the editor frame, if any.
+     */
+    EDA_UNITS_T userUnits() const;
+
+    /**
+     * Run a single pass of RunTests() and record its statistics in m_passStats.
+     *
+     * @param aName is the name of the pass reported in the statistics
+     * @param aItemCount is the number of items the pass will test
+     * @param aPass is the test itself
+     */
+    void runPass( const std::string& aName, size_t aItemCount,
+                  const std::function<void()>& aPass );
+
     //-----<categorical group tests>-----------------------------------------
 
     /**
@@ -271,25 +343,69 @@ private:
      */
     bool testNetClasses();
 
+    /**
+     * Index the tracks and pads of the board for the tests of a run, see ITEM_INDEX.
+     *
+     * @param aRefItems = if not null, only index the items which can come close to these
+     * ones (an incremental run)
+     */
+    void buildItemIndex( const std::set<const BOARD_ITEM*>* aRefItems = nullptr );
+
     /**
      * Perform the DRC on all tracks.
      *
+     * Each segment is only compared with the pads and later segments found near it in a
+     * per-layer R-tree, and the segments are shared out between worker threads.  Markers are
+     * added to the board in track list order, so the result is the same as comparing every
+     * segment with every later one.
+     *
      * This test can take a while, a progress bar can be displayed
      * @param aActiveWindow = the active window ued as parent for the progress bar
      * @param aShowProgressBar = true to show a progress bar
      * (Note: it is shown only if there are many tracks)
+     * @param aRefTracks = if not null, only test these segments (against all others)
      */
-    void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar );
+    void testTracks( wxWindow * aActiveWindow, bool aShowProgressBar,
+                     const std::set<const BOARD_ITEM*>* aRefTracks = nullptr );
 
-    void testPad2Pad();
+    /**
+     * Perform the DRC between pads.
+     *
+     * Pads are sorted along X in a DRC_SWEEP_INDEX, and each pad is compared with the next
+     * ones up to the X limit its size and clearance allow.  The sorted list is shared out
+     * between worker threads in strips.
+     * @param aRefPads = if not null, only test these pads (against all others)
+     */
+    void testPad2Pad( const std::set<const BOARD_ITEM*>* aRefPads = nullptr );
 
+    /**
+     * Test the distance between drilled holes, using the same sweep line as testPad2Pad().
+     */
     void testDrilledHoles();
 
+    /**
+     * Run \a aTest on the items of each strip of a DRC_SWEEP_INDEX, on several threads.
+     *
+     * Each thread uses its own worker instance, and the markers it creates are added to the
+     * board in item order once all threads are done, as a single thread would.
+     * @param aStrips = the strips, as returned by DRC_SWEEP_INDEX::GetStrips()
+     * @param aTest = the test of the item at a given index, using the given worker
+     */
+    void testInStrips( const std::vector<size_t>& aStrips,
+                       const std::function<void( DRC& aWorker, size_t aIndex )>& aTest );
+
     void testUnconnected();
 
     void testZones();
 
-    void testKeepoutAreas();
+    /**
+     * Test vias, tracks and pads inside keepout areas.
+     *
+     * Items are indexed in a DRC_RTREE, so each area is only tested against the items in
+     * its bounding box.
+     * @param aRefItems = if not null, only test these tracks, vias and pads
+     */
+    void testKeepoutAreas( const std::set<const BOARD_ITEM*>* aRefItems = nullptr );
 
     // aTextItem is type BOARD_ITEM* to accept either TEXTE_PCB or TEXTE_MODULE
     void testCopperTextItem( BOARD_ITEM* aTextItem );
@@ -337,6 +453,18 @@ private:
     bool doTrackDrc( TRACK* aRefSeg, TRACK* aStart,
                      bool aTestPads, bool aTestZones );
 
+    /**
+     * Test the current segment against the given candidates.
+     *
+     * @param aRefSeg The segment to test
+     * @param aPads the pads to test against, in board order
+     * @param aTracks the tracks and vias to test against, in track list order
+     * @param aTestZones true if should do copper zones test. This can be very time consumming
+     * @return bool - true if no problems, else false.
+     */
+    bool doTrackDrc( TRACK* aRefSeg, const std::vector<D_PAD*>& aPads,
+                     const std::vector<TRACK*>& aTracks, bool aTestZones );
+
     /**
      * Test the current segment or via.
      *
@@ -358,10 +486,22 @@ private:
      */
     bool doEdgeZoneDrc( ZONE_CONTAINER* aArea, int aCornerIndex );
 
+    /**
+     * Test a pad against a keepout area.  Pads are not allowed in areas where tracks are not,
+     * and plated holes are not allowed in areas where vias are not.
+     *
+     * @param aPad The pad to test
+     * @param aArea The keepout area
+     * @return bool - true if the pad is (even partly) inside a forbidding area
+     */
+    bool doPadInKeepoutDrc( D_PAD* aPad, ZONE_CONTAINER* aArea );
+
     /**
      * Test for footprint courtyard overlaps.
+     * @param aRefFootprints = if not null, only test these footprints (against all others)
      */
-    void doFootprintOverlappingDrc();
+    void doFootprintOverlappingDrc(
+            const std::set<const BOARD_ITEM*>* aRefFootprints = nullptr );
 
     //-----<single tests>----------------------------------------------
 
@@ -420,8 +560,39 @@ private:
 public:
     DRC( PCB_EDIT_FRAME* aPcbWindow );
 
+    /**
+     * Create a DRC tester without any editor frame or window, e.g. for batch processing.
+     *
+     * Zones are refilled only if requested by SetRefillZones() (the fill is never checked),
+     * and footprints are never tested against the schematic.
+     *
+     * @param aBoard is the board to test
+     * @param aUnits are the units used in marker messages
+     * @param aHandler receives (and takes ownership of) every marker created
+     */
+    DRC( BOARD* aBoard, EDA_UNITS_T aUnits, MARKER_HANDLER aHandler );
+
     ~DRC();
 
+    /// Enable the (slow) track to copper zone clearance tests
+    void SetZonesTest( bool aEnable ) { m_doZonesTest = aEnable; }
+
+    /// Refill all zones before testing
+    void SetRefillZones( bool aEnable ) { m_refillZones = aEnable; }
+
+    /// Report all errors of a track, not only the first one
+    void SetReportAllTrackErrors( bool aEnable ) { m_reportAllTrackErrors = aEnable; }
+
+    /**
+     * @return the timing and size statistics of each pass of the last RunTests()
+     */
+    const std::vector<DRC_PASS_STATS>& GetPassStats() const { return m_passStats; }
+
+    /**
+     * @return the unconnected items found by the last RunTests()
+     */
+    const DRC_LIST& GetUnconnectedItems() const { return m_unconnected; }
+
     /**
      * Function Drc
      * tests the current segment and returns the result and displays the error
@@ -498,6 +669,39 @@ public:
      */
     void RunTests( wxTextCtrl* aMessages = NULL );
 
+    /**
+     * Record a change of \a aItem (added, modified or removed) since the last run.
+     *
+     * Changes are only recorded once RunTests() has been run, as there is nothing to update
+     * before, and not while it runs (e.g. when it refills the zones), as its markers already
+     * take them into account.
+     */
+    void MarkDirty( const BOARD_ITEM* aItem );
+
+    /**
+     * Record a changed area of the board, e.g. the former place of a modified item.
+     */
+    void MarkDirty( const EDA_RECT& aArea );
+
+    /**
+     * Re-run the clearance, keepout and courtyard tests on the items affected by the changes
+     * recorded with MarkDirty() since the last run, and update the markers accordingly.
+     *
+     * An item is tested again if it is a changed item, or if its bounding box comes closer
+     * than the biggest clearance to a changed area.  Markers of these tests involving such
+     * an item are removed from the board, the others are kept.  Does nothing before a first
+     * RunTests(), or while it runs.
+     *
+     * Markers can only be removed when they are on the board: with a marker handler, the
+     * new markers are passed to the handler and the caller has to discard old ones.
+     */
+    void RunIncrementalTests();
+
+    /**
+     * @return true if the DRC dialog is currently shown.
+     */
+    bool IsDRCDialogShown() const { return m_drcDialog != nullptr; }
+
     /**
      * @return a pointer to the current marker (last created marker
      */
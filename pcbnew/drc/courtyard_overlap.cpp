@@ -70,6 +70,9 @@ bool DRC_COURTYARD_OVERLAP::RunDRC( BOARD& aBoard ) const
         wxPoint pos = footprint->GetPosition();
         bool    is_ok = footprint->BuildPolyCourtyard();
 
+        if( !isTested( footprint ) )
+            continue;
+
         if( !is_ok && aBoard.GetDesignSettings().m_ProhibitOverlappingCourtyards )
         {
             auto marker = std::unique_ptr<MARKER_PCB>( marker_factory.NewMarker(
@@ -109,6 +112,9 @@ bool DRC_COURTYARD_OVERLAP::RunDRC( BOARD& aBoard ) const
             if( candidate->GetPolyCourtyardFront().OutlineCount() == 0 )
                 continue; // No courtyard defined
 
+            if( !isTested( footprint ) && !isTested( candidate ) )
+                continue;
+
             courtyard.RemoveAllContours();
             courtyard.Append( footprint->GetPolyCourtyardFront() );
 
@@ -142,6 +148,9 @@ bool DRC_COURTYARD_OVERLAP::RunDRC( BOARD& aBoard ) const
             if( candidate->GetPolyCourtyardBack().OutlineCount() == 0 )
                 continue; // No courtyard defined
 
+            if( !isTested( footprint ) && !isTested( candidate ) )
+                continue;
+
             courtyard.RemoveAllContours();
             courtyard.Append( footprint->GetPolyCourtyardBack() );
 
@@ -35,10 +35,30 @@
 class DRC_COURTYARD_OVERLAP : public DRC_PROVIDER
 {
 public:
+    /**
+     * A callable selecting the footprints to test
+     */
+    using FOOTPRINT_FILTER = std::function<bool( const MODULE* )>;
+
     DRC_COURTYARD_OVERLAP(
             const DRC_MARKER_FACTORY& aMarkerFactory, MARKER_HANDLER aMarkerHandler );
 
+    /**
+     * Restrict the checks to the footprints accepted by \a aFilter: only their own courtyard
+     * is checked, and only overlaps involving at least one of them are reported.
+     * By default, all footprints are tested.
+     */
+    void SetFootprintFilter( FOOTPRINT_FILTER aFilter ) { m_filter = aFilter; }
+
     bool RunDRC( BOARD& aBoard ) const override;
+
+private:
+    bool isTested( const MODULE* aFootprint ) const
+    {
+        return !m_filter || m_filter( aFootprint );
+    }
+
+    FOOTPRINT_FILTER m_filter;
 };
 
 #endif // DRC_COURTYARD_OVERLAP__H
\ No newline at end of file
@@ -0,0 +1,108 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_dirty_region.h>
+
+#include <class_board_item.h>
+
+
+DRC_DIRTY_REGION::DRC_DIRTY_REGION() :
+    m_areas( new TREE() ),
+    m_areaCount( 0 )
+{
+}
+
+
+DRC_DIRTY_REGION::~DRC_DIRTY_REGION()
+{
+}
+
+
+void DRC_DIRTY_REGION::Add( const BOARD_ITEM* aItem )
+{
+    if( !aItem || aItem->Type() == PCB_MARKER_T )
+        return;
+
+    m_items.insert( aItem );
+    Add( aItem->GetBoundingBox() );
+}
+
+
+void DRC_DIRTY_REGION::Add( const EDA_RECT& aArea )
+{
+    EDA_RECT  area = aArea;
+    area.Normalize();
+
+    const int mmin[2] = { area.GetX(), area.GetY() };
+    const int mmax[2] = { area.GetRight(), area.GetBottom() };
+
+    m_areas->Insert( mmin, mmax, m_areaCount );
+
+    if( m_areaCount++ == 0 )
+        m_bbox = area;
+    else
+        m_bbox.Merge( area );
+}
+
+
+void DRC_DIRTY_REGION::Clear()
+{
+    m_areas->RemoveAll();
+    m_areaCount = 0;
+    m_items.clear();
+    m_bbox = EDA_RECT();
+}
+
+
+bool DRC_DIRTY_REGION::Contains( const BOARD_ITEM* aItem ) const
+{
+    return m_items.count( aItem ) > 0;
+}
+
+
+bool DRC_DIRTY_REGION::Intersects( const EDA_RECT& aBox, int aMargin ) const
+{
+    if( m_areaCount == 0 )
+        return false;
+
+    EDA_RECT box = aBox;
+    box.Normalize();
+    box.Inflate( aMargin );
+
+    if( !m_bbox.Intersects( box ) )
+        return false;
+
+    const int mmin[2] = { box.GetX(), box.GetY() };
+    const int mmax[2] = { box.GetRight(), box.GetBottom() };
+    bool      found = false;
+
+    auto visitor = [&found]( const int& aId ) -> bool
+    {
+        found = true;
+        return false;       // one area is enough
+    };
+
+    m_areas->Search( mmin, mmax, visitor );
+
+    return found;
+}
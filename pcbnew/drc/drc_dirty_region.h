@@ -0,0 +1,95 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_DIRTY_REGION__H
+#define DRC_DIRTY_REGION__H
+
+#include <memory>
+#include <set>
+
+#include <eda_rect.h>
+#include <geometry/rtree.h>
+
+class BOARD_ITEM;
+
+
+/**
+ * The part of a board changed since the last DRC run.
+ *
+ * The region is made of the bounding boxes of every item added, modified or removed (both
+ * before and after a modification), and of the set of items themselves.  It is filled by
+ * BOARD_COMMIT::Push() and by undo/redo, and read by DRC::RunIncrementalTests() to decide
+ * which items have to be tested again.
+ *
+ * Items are only used as keys: they are never dereferenced after being added, so removed
+ * (and possibly deleted) items can be recorded safely.
+ */
+class DRC_DIRTY_REGION
+{
+public:
+    DRC_DIRTY_REGION();
+
+    ~DRC_DIRTY_REGION();
+
+    /**
+     * Record an item and its current bounding box.
+     *
+     * Markers are ignored: they are the result of the DRC, not an input.
+     */
+    void Add( const BOARD_ITEM* aItem );
+
+    /**
+     * Record an area of the board without any item (e.g. the former place of an item).
+     */
+    void Add( const EDA_RECT& aArea );
+
+    void Clear();
+
+    bool IsEmpty() const { return m_items.empty() && m_areaCount == 0; }
+
+    /**
+     * @return true if \a aItem has been recorded.  \a aItem is not dereferenced, so it can be
+     * a removed item.  The pads of a recorded footprint are covered by its bounding box.
+     */
+    bool Contains( const BOARD_ITEM* aItem ) const;
+
+    /**
+     * @return true if \a aBox, inflated by \a aMargin, intersects a recorded area.
+     */
+    bool Intersects( const EDA_RECT& aBox, int aMargin = 0 ) const;
+
+    /**
+     * @return the bounding box of all recorded areas.
+     */
+    const EDA_RECT& GetBoundingBox() const { return m_bbox; }
+
+private:
+    typedef RTree<int, int, 2, double> TREE;
+
+    std::unique_ptr<TREE>       m_areas;
+    int                         m_areaCount;
+    std::set<const BOARD_ITEM*> m_items;
+    EDA_RECT                    m_bbox;
+};
+
+#endif // DRC_DIRTY_REGION__H
@@ -0,0 +1,103 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_rtree.h>
+
+#include <algorithm>
+
+
+DRC_RTREE::DRC_RTREE() :
+    m_count( 0 )
+{
+    for( int layer = 0; layer < MAX_CU_LAYERS; ++layer )
+        m_trees.emplace_back( new TREE() );
+}
+
+
+DRC_RTREE::~DRC_RTREE()
+{
+}
+
+
+void DRC_RTREE::Insert( int aId, const EDA_RECT& aBBox, LSET aLayers )
+{
+    EDA_RECT  box = aBBox;
+    box.Normalize();
+
+    const int mmin[2] = { box.GetX(), box.GetY() };
+    const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+    for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+        m_trees[layer]->Insert( mmin, mmax, aId );
+
+    m_count++;
+}
+
+
+void DRC_RTREE::Remove( int aId, const EDA_RECT& aBBox, LSET aLayers )
+{
+    EDA_RECT  box = aBBox;
+    box.Normalize();
+
+    const int mmin[2] = { box.GetX(), box.GetY() };
+    const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+    for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+        m_trees[layer]->Remove( mmin, mmax, aId );
+
+    if( m_count )
+        m_count--;
+}
+
+
+void DRC_RTREE::Clear()
+{
+    for( auto& tree : m_trees )
+        tree->RemoveAll();
+
+    m_count = 0;
+}
+
+
+void DRC_RTREE::Query( const EDA_RECT& aBBox, LSET aLayers, std::vector<int>& aIds ) const
+{
+    EDA_RECT  box = aBBox;
+    box.Normalize();
+
+    const int mmin[2] = { box.GetX(), box.GetY() };
+    const int mmax[2] = { box.GetRight(), box.GetBottom() };
+
+    aIds.clear();
+
+    auto visitor = [&aIds]( const int& aId ) -> bool
+    {
+        aIds.push_back( aId );
+        return true;
+    };
+
+    for( PCB_LAYER_ID layer : ( aLayers & LSET::AllCuMask() ).Seq() )
+        m_trees[layer]->Search( mmin, mmax, visitor );
+
+    std::sort( aIds.begin(), aIds.end() );
+    aIds.erase( std::unique( aIds.begin(), aIds.end() ), aIds.end() );
+}
@@ -0,0 +1,91 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_RTREE__H
+#define DRC_RTREE__H
+
+#include <memory>
+#include <vector>
+
+#include <eda_rect.h>
+#include <layers_id_colors_and_visibility.h>
+#include <geometry/rtree.h>
+
+
+/**
+ * A per-copper-layer R-tree used to find DRC candidates.
+ *
+ * The index does not store the board items themselves, but integer ids chosen by the caller
+ * (usually the position of the item in a vector).  Query results are returned sorted by id,
+ * so a caller which numbers its items in board order visits candidates in the same order as
+ * a plain loop over the board would, and therefore reports the same markers.
+ *
+ * The index is read-only once built: Query() may be called concurrently from several threads.
+ */
+class DRC_RTREE
+{
+public:
+    DRC_RTREE();
+
+    ~DRC_RTREE();
+
+    /**
+     * Add an item to the index on all copper layers of \a aLayers.
+     *
+     * @param aId is the id returned by Query() for this item.
+     * @param aBBox is the bounding box of the item (including any width).
+     * @param aLayers is the layer set of the item.  Non-copper layers are ignored.
+     */
+    void Insert( int aId, const EDA_RECT& aBBox, LSET aLayers );
+
+    /**
+     * Remove an item previously added with the same bounding box and layer set.
+     */
+    void Remove( int aId, const EDA_RECT& aBBox, LSET aLayers );
+
+    /**
+     * Remove all items from the index.
+     */
+    void Clear();
+
+    /**
+     * Collect the ids of all items on any copper layer of \a aLayers whose bounding box
+     * intersects \a aBBox.
+     *
+     * @param aIds receives the ids, sorted and without duplicates.  It is cleared first.
+     */
+    void Query( const EDA_RECT& aBBox, LSET aLayers, std::vector<int>& aIds ) const;
+
+    /**
+     * @return the number of items inserted (items on several layers are counted once).
+     */
+    size_t Size() const { return m_count; }
+
+private:
+    typedef RTree<int, int, 2, double> TREE;
+
+    std::vector<std::unique_ptr<TREE>> m_trees;     ///< one tree per copper layer
+    size_t                             m_count;
+};
+
+#endif // DRC_RTREE__H
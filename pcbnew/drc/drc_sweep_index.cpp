@@ -0,0 +1,105 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <drc/drc_sweep_index.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+
+DRC_SWEEP_INDEX::DRC_SWEEP_INDEX() :
+    m_maxReach( 0 )
+{
+}
+
+
+void DRC_SWEEP_INDEX::Add( int aId, const wxPoint& aPos, int aReach )
+{
+    m_items.push_back( { aId, aPos, aReach } );
+    m_maxReach = std::max( m_maxReach, aReach );
+}
+
+
+void DRC_SWEEP_INDEX::Build()
+{
+    std::sort( m_items.begin(), m_items.end(),
+            []( const ITEM& aA, const ITEM& aB )
+            {
+                if( aA.m_Pos.x != aB.m_Pos.x )
+                    return aA.m_Pos.x < aB.m_Pos.x;
+
+                if( aA.m_Pos.y != aB.m_Pos.y )
+                    return aA.m_Pos.y < aB.m_Pos.y;
+
+                return aA.m_Id < aB.m_Id;
+            } );
+}
+
+
+void DRC_SWEEP_INDEX::Clear()
+{
+    m_items.clear();
+    m_maxReach = 0;
+}
+
+
+void DRC_SWEEP_INDEX::QueryForward( size_t aIndex, int aMargin,
+                                    std::vector<size_t>& aResult ) const
+{
+    const ITEM& ref = m_items[aIndex];
+    const int   x_limit = GetLimitX( aIndex, aMargin );
+
+    aResult.clear();
+
+    for( size_t ii = aIndex + 1; ii < m_items.size(); ++ii )
+    {
+        const ITEM& item = m_items[ii];
+
+        // The list is sorted by X: no other item can be close enough
+        if( item.m_Pos.x > x_limit )
+            break;
+
+        int dist_max = ref.m_Reach + item.m_Reach + aMargin;
+
+        if( item.m_Pos.x - ref.m_Pos.x <= dist_max
+                && std::abs( item.m_Pos.y - ref.m_Pos.y ) <= dist_max )
+        {
+            aResult.push_back( ii );
+        }
+    }
+}
+
+
+std::vector<size_t> DRC_SWEEP_INDEX::GetStrips( size_t aCount ) const
+{
+    std::vector<size_t> strips;
+
+    aCount = std::max<size_t>( 1, std::min( aCount, m_items.size() ) );
+
+    for( size_t ii = 0; ii < aCount; ++ii )
+        strips.push_back( ii * m_items.size() / aCount );
+
+    strips.push_back( m_items.size() );
+
+    return strips;
+}
@@ -0,0 +1,110 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#ifndef DRC_SWEEP_INDEX__H
+#define DRC_SWEEP_INDEX__H
+
+#include <vector>
+
+#include <wx/gdicmn.h>
+
+
+/**
+ * Items sorted along the X axis, to find the items close to each other with a sweep line.
+ *
+ * Each item is known by its position and its reach: the radius of a circle around the
+ * position which contains the item.  Two items can only come within a given distance if
+ * their X distance is below the sum of their reaches plus that distance, so the items close
+ * to an item are found by scanning the sorted list forward, up to GetLimitX().  Each pair
+ * of items is seen once, from the item first in the list.
+ *
+ * The sorted list can be split in strips of consecutive items (i.e. vertical bands of the
+ * board holding the same number of items), so the scans can be shared out between threads:
+ * once built, the index is only read.
+ */
+class DRC_SWEEP_INDEX
+{
+public:
+    struct ITEM
+    {
+        int     m_Id;       ///< id given by the caller (usually an index in its own list)
+        wxPoint m_Pos;      ///< position of the item
+        int     m_Reach;    ///< radius of the circle around m_Pos containing the item
+    };
+
+    DRC_SWEEP_INDEX();
+
+    void Add( int aId, const wxPoint& aPos, int aReach );
+
+    /**
+     * Sort the items by X, then Y, then id.  Must be called after the last Add().
+     */
+    void Build();
+
+    void Clear();
+
+    size_t Size() const { return m_items.size(); }
+
+    /**
+     * @return the item at \a aIndex in the sorted list
+     */
+    const ITEM& GetItem( size_t aIndex ) const { return m_items[aIndex]; }
+
+    /**
+     * @return the greatest reach of all items
+     */
+    int GetMaxReach() const { return m_maxReach; }
+
+    /**
+     * @return the greatest X position of an item which can come within \a aMargin of the item
+     * at \a aIndex.
+     */
+    int GetLimitX( size_t aIndex, int aMargin ) const
+    {
+        return m_items[aIndex].m_Pos.x + m_items[aIndex].m_Reach + m_maxReach + aMargin;
+    }
+
+    /**
+     * Collect the items after \a aIndex in the sorted list whose bounding box, inflated by
+     * \a aMargin, intersects the one of the item at \a aIndex.
+     *
+     * @param aResult receives the indices of the items in the sorted list, in list order.
+     * It is cleared first.
+     */
+    void QueryForward( size_t aIndex, int aMargin, std::vector<size_t>& aResult ) const;
+
+    /**
+     * Split the sorted list in strips of consecutive items.
+     *
+     * @param aCount is the number of strips wanted.  Less strips are returned if there are
+     * less items.
+     * @return the index of the first item of each strip, followed by Size().
+     */
+    std::vector<size_t> GetStrips( size_t aCount ) const;
+
+private:
+    std::vector<ITEM> m_items;
+    int               m_maxReach;
+};
+
+#endif // DRC_SWEEP_INDEX__H
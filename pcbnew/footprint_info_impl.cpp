@@ -38,6 +38,7 @@
 #include <wildcards_and_files_ext.h>
 #include <widgets/progress_reporter.h>
 
+#include <algorithm>
 #include <thread>
 #include <mutex>
 
@@ -48,7 +49,17 @@ void FOOTPRINT_INFO_IMPL::load()
 
     wxASSERT( fptable );
 
-    const MODULE* footprint = fptable->GetEnumeratedFootprint( m_nickname, m_fpname );
+    const MODULE* footprint = NULL;
+
+    try
+    {
+        footprint = fptable->GetEnumeratedFootprint( m_nickname, m_fpname );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        // Reported with the errors of the libraries
+        m_owner->m_errors.move_push( std::make_unique<IO_ERROR>( ioe ) );
+    }
 
     if( footprint == NULL ) // Should happen only with malformed/broken libraries
     {
@@ -239,14 +250,10 @@ bool FOOTPRINT_LIST_IMPL::JoinWorkers()
 
     size_t total_count = m_queue_out.size();
 
-    LOCALE_IO toggle_locale;
-
-    // Parse the footprints in parallel. WARNING! This requires changing the locale, which is
-    // GLOBAL. It is only threadsafe to construct the LOCALE_IO before the threads are created,
-    // destroy it after they finish, and block the main (GUI) thread while they work. Any deviation
-    // from this will cause nasal demons.
-    //
-    // TODO: blast LOCALE_IO into the sun
+    // Read the footprint infos in parallel: the .pretty libraries only list their files
+    // when enumerated, and each footprint is parsed here by its FOOTPRINT_INFO_IMPL.  The
+    // plugins read numbers with the functions of numeric_io.h, or switch the locale of
+    // their own thread only, so the user locale of the other threads is left alone.
 
     SYNC_QUEUE<std::unique_ptr<FOOTPRINT_INFO>> queue_parsed;
     std::vector<std::thread>                    threads;
@@ -351,10 +358,22 @@ void FOOTPRINT_LIST_IMPL::WriteCacheToFile( wxTextFile* aCacheFile )
         aCacheFile->Create();
     }
 
-    aCacheFile->AddLine( wxString::Format( "%lld", m_list_timestamp ) );
+    // Only the infos already read are written: reading the others here would parse their
+    // footprints one at a time.  The cache is then incomplete, and must not match the
+    // libraries next time.
+    bool complete = std::all_of( m_list.begin(), m_list.end(),
+                                 []( const std::unique_ptr<FOOTPRINT_INFO>& aInfo )
+                                 {
+                                     return aInfo->IsLoaded();
+                                 } );
+
+    aCacheFile->AddLine( wxString::Format( "%lld", complete ? m_list_timestamp : 0 ) );
 
     for( auto& fpinfo : m_list )
     {
+        if( !fpinfo->IsLoaded() )
+            continue;
+
         aCacheFile->AddLine( fpinfo->GetLibNickname() );
         aCacheFile->AddLine( fpinfo->GetName() );
         aCacheFile->AddLine( EscapeString( fpinfo->GetDescription(), CTX_DELIMITED_STR ) );
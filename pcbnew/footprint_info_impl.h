@@ -43,6 +43,8 @@ public:
         m_pad_count = 0;
         m_unique_pad_count = 0;
 
+        // Read here, on the JoinWorkers() threads, rather than later on the thread which
+        // first needs a description
         m_owner = aOwner;
         m_loaded = false;
         load();
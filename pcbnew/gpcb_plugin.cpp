@@ -871,7 +871,6 @@ void GPCB_PLUGIN::FootprintEnumerate( wxArrayString&    aFootprintNames,
                                       const wxString&   aLibraryPath,
                                       const PROPERTIES* aProperties )
 {
-    LOCALE_IO     toggle;     // toggles on, then off, the C locale.
     wxDir         dir( aLibraryPath );
 
     if( !dir.IsOpened() )
@@ -912,8 +911,6 @@ const MODULE* GPCB_PLUGIN::getFootprint( const wxString& aLibraryPath,
                                          const PROPERTIES* aProperties,
                                          bool checkModified )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     validateCache( aLibraryPath, checkModified );
@@ -415,6 +415,8 @@ public:
      * Function GetEnumeratedFootprint
      * a version of FootprintLoad() for use after FootprintEnumerate() for more efficient
      * cache management.
+     *
+     * @throw   IO_ERROR if the footprint cannot be read.
      */
     virtual const MODULE* GetEnumeratedFootprint( const wxString& aLibraryPath,
                                                   const wxString& aFootprintName,
@@ -30,6 +30,7 @@
 #include <wildcards_and_files_ext.h>
 #include <base_units.h>
 #include <trace_helpers.h>
+#include <advanced_config.h>
 
 #include <class_board.h>
 #include <class_module.h>
@@ -84,19 +85,46 @@ void filterNetClass( const BOARD& aBoard, NETCLASS& aNetClass )
 class FP_CACHE_ITEM
 {
     WX_FILENAME             m_filename;
-    std::unique_ptr<MODULE> m_module;
+    std::unique_ptr<MODULE> m_module;       // NULL until the file is read.
+    wxString                m_error;        // Why the file could not be read, if it could not.
+    long long               m_timestamp;    // Of the file when m_module was read or written.
 
 public:
     FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName );
 
     const WX_FILENAME& GetFileName() const { return m_filename; }
     const MODULE*      GetModule()   const { return m_module.get(); }
+
+    void SetModule( MODULE* aModule ) { m_module.reset( aModule ); }
+
+    const wxString& GetError() const { return m_error; }
+    void            SetError( const wxString& aError ) { m_error = aError; }
+
+    /**
+     * Function UpdateTimestamp
+     * records the current timestamp of the file, before reading it or after writing it.
+     */
+    long long UpdateTimestamp()
+    {
+        m_timestamp = m_filename.GetTimestamp();
+        return m_timestamp;
+    }
+
+    /**
+     * Function IsModified
+     * @return true if the footprint was read, or failed to be, and its file changed since.
+     */
+    bool IsModified()
+    {
+        return ( m_module || !m_error.IsEmpty() ) && m_filename.GetTimestamp() != m_timestamp;
+    }
 };
 
 
 FP_CACHE_ITEM::FP_CACHE_ITEM( MODULE* aModule, const WX_FILENAME& aFileName ) :
     m_filename( aFileName ),
-    m_module( aModule )
+    m_module( aModule ),
+    m_timestamp( 0 )
 { }
 
 
@@ -110,7 +138,8 @@ class FP_CACHE
     PCB_IO*         m_owner;            // Plugin object that owns the cache.
     wxFileName      m_lib_path;         // The path of the library.
     wxString        m_lib_raw_path;     // For quick comparisons.
-    MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.
+    MODULE_MAP      m_modules;          // Map of footprint file name per MODULE*.  The
+                                        // footprints are only read on demand.
 
     bool            m_cache_dirty;      // Stored separately because it's expensive to check
                                         // m_cache_timestamp against all the files.
@@ -137,8 +166,23 @@ public:
      */
     void Save( MODULE* aModule = NULL );
 
+    /**
+     * Function Load
+     * lists the footprint files of the library, without reading them.
+     *
+     * When called again, the footprints already read are kept, unless their file changed.
+     */
     void Load();
 
+    /**
+     * Function GetModule
+     * reads the footprint file if it was not read yet.
+     *
+     * @return the footprint, or NULL if the library has no footprint \a aFootprintName.
+     * @throw IO_ERROR if the footprint file cannot be read.
+     */
+    const MODULE* GetModule( const wxString& aFootprintName );
+
     void Remove( const wxString& aFootprintName );
 
     /**
@@ -199,6 +243,10 @@ void FP_CACHE::Save( MODULE* aModule )
 
     for( MODULE_ITER it = m_modules.begin();  it != m_modules.end();  ++it )
     {
+        // Footprints which were never read are unchanged on disk
+        if( !it->second->GetModule() )
+            continue;
+
         if( aModule && aModule != it->second->GetModule() )
             continue;
 
@@ -239,7 +287,7 @@ void FP_CACHE::Save( MODULE* aModule )
             THROW_IO_ERROR( msg );
         }
 #endif
-        m_cache_timestamp += fn.GetTimestamp();
+        m_cache_timestamp += it->second->UpdateTimestamp();
     }
 
     m_cache_timestamp += m_lib_path.GetModificationTime().GetValue().GetValue();
@@ -253,7 +301,9 @@ void FP_CACHE::Save( MODULE* aModule )
 void FP_CACHE::Load()
 {
     m_cache_dirty = false;
-    m_cache_timestamp = 0;
+
+    // Taken before listing the files, so a file added meanwhile is seen by IsModified()
+    m_cache_timestamp = GetTimestamp( m_lib_raw_path );
 
     wxDir dir( m_lib_raw_path );
 
@@ -264,8 +314,9 @@ void FP_CACHE::Load()
         THROW_IO_ERROR( msg );
     }
 
-    wxString fullName;
-    wxString fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
+    wxString   fullName;
+    wxString   fileSpec = wxT( "*." ) + KiCadFootprintFileExtension;
+    MODULE_MAP modules;
 
     // wxFileName construction is egregiously slow.  Construct it once and just swap out
     // the filename thereafter.
@@ -273,39 +324,73 @@ void FP_CACHE::Load()
 
     if( dir.GetFirst( &fullName, fileSpec ) )
     {
-        wxString cacheError;
-
         do
         {
             fn.SetFullName( fullName );
 
-            // Queue I/O errors so only files that fail to parse don't get loaded.
-            try
+            wxString    fpName = fn.GetName();
+            MODULE_ITER it = m_modules.find( fpName );
+
+            if( it == m_modules.end() )
             {
-                FILE_LINE_READER    reader( fn.GetFullPath() );
+                modules.insert( fpName, new FP_CACHE_ITEM( nullptr, fn ) );
+                continue;
+            }
 
-                m_owner->m_parser->SetLineReader( &reader );
+            // Keep the footprint already read, unless its file changed since
+            if( it->second->IsModified() )
+            {
+                it->second->SetModule( nullptr );
+                it->second->SetError( wxEmptyString );
+            }
 
-                MODULE*     footprint = (MODULE*) m_owner->m_parser->Parse();
-                wxString    fpName = fn.GetName();
+            modules.transfer( it, m_modules );
+        } while( dir.GetNext( &fullName ) );
+    }
 
-                footprint->SetFPID( LIB_ID( wxEmptyString, fpName ) );
-                m_modules.insert( fpName, new FP_CACHE_ITEM( footprint, fn ) );
+    // The footprints of the files which are gone are dropped with the old map
+    m_modules.swap( modules );
+}
 
-                m_cache_timestamp += fn.GetTimestamp();
-            }
-            catch( const IO_ERROR& ioe )
-            {
-                if( !cacheError.IsEmpty() )
-                    cacheError += "\n\n";
 
-                cacheError += ioe.What();
-            }
-        } while( dir.GetNext( &fullName ) );
+const MODULE* FP_CACHE::GetModule( const wxString& aFootprintName )
+{
+    MODULE_ITER it = m_modules.find( aFootprintName );
 
-        if( !cacheError.IsEmpty() )
-            THROW_IO_ERROR( cacheError );
+    if( it == m_modules.end() )
+        return NULL;
+
+    FP_CACHE_ITEM* item = it->second;
+
+    if( !item->GetModule() )
+    {
+        // A broken file is not parsed again until it changes
+        if( !item->GetError().IsEmpty() )
+            THROW_IO_ERROR( item->GetError() );
+
+        item->UpdateTimestamp();
+
+        try
+        {
+            std::unique_ptr<LINE_READER> reader = OpenFileLineReader(
+                    item->GetFileName().GetFullPath(),
+                    ADVANCED_CFG::GetCfg().m_useMmapLineReader );
+
+            m_owner->m_parser->SetLineReader( reader.get() );
+
+            MODULE* footprint = (MODULE*) m_owner->m_parser->Parse();
+
+            footprint->SetFPID( LIB_ID( wxEmptyString, aFootprintName ) );
+            item->SetModule( footprint );
+        }
+        catch( const IO_ERROR& ioe )
+        {
+            item->SetError( ioe.What() );
+            throw;
+        }
     }
+
+    return item->GetModule();
 }
 
 
@@ -1925,12 +2010,14 @@ PCB_IO::~PCB_IO()
 
 BOARD* PCB_IO::Load( const wxString& aFileName, BOARD* aAppendToMe, const PROPERTIES* aProperties )
 {
-    FILE_LINE_READER    reader( aFileName );
+    std::unique_ptr<LINE_READER> reader = OpenFileLineReader( aFileName,
+            ADVANCED_CFG::GetCfg().m_useMmapLineReader );
 
     init( aProperties );
 
-    m_parser->SetLineReader( &reader );
+    m_parser->SetLineReader( reader.get() );
     m_parser->SetBoard( aAppendToMe );
+    m_parser->SetParallel( ADVANCED_CFG::GetCfg().m_parallelBoardParser );
 
     BOARD* board;
 
@@ -1978,13 +2065,18 @@ void PCB_IO::init( const PROPERTIES* aProperties )
 
 void PCB_IO::validateCache( const wxString& aLibraryPath, bool checkModified )
 {
-    if( !m_cache || !m_cache->IsPath( aLibraryPath ) || ( checkModified && m_cache->IsModified() ) )
+    if( !m_cache || !m_cache->IsPath( aLibraryPath ) )
     {
         // a spectacular episode in memory management:
         delete m_cache;
         m_cache = new FP_CACHE( this, aLibraryPath );
         m_cache->Load();
     }
+    else if( checkModified && m_cache->IsModified() )
+    {
+        // Only the footprints whose file changed are read again
+        m_cache->Load();
+    }
 }
 
 
@@ -1992,7 +2084,6 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
                                  const wxString&   aLibraryPath,
                                  const PROPERTIES* aProperties )
 {
-    LOCALE_IO     toggle;     // toggles on, then off, the C locale.
     wxDir         dir( aLibraryPath );
 
     init( aProperties );
@@ -2008,8 +2099,8 @@ void PCB_IO::FootprintEnumerate( wxArrayString&    aFootprintNames,
         errorMsg = ioe.What();
     }
 
-    // Some of the files may have been parsed correctly so we want to add the valid files to
-    // the library.
+    // The footprint files are listed but not parsed: their errors are reported when they
+    // are loaded.
 
     const MODULE_MAP& mods = m_cache->GetModules();
 
@@ -2028,8 +2119,6 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
                                     const PROPERTIES* aProperties,
                                     bool checkModified )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     try
@@ -2041,16 +2130,7 @@ const MODULE* PCB_IO::getFootprint( const wxString& aLibraryPath,
         // do nothing with the error
     }
 
-    const MODULE_MAP& mods = m_cache->GetModules();
-
-    MODULE_CITER it = mods.find( aFootprintName );
-
-    if( it == mods.end() )
-    {
-        return NULL;
-    }
-
-    return it->second->GetModule();
+    return m_cache->GetModule( aFootprintName );
 }
 
 
@@ -87,6 +87,7 @@
 #include <trigo.h>
 #include <build_version.h>
 #include <confirm.h>
+#include <numeric_io.h>
 
 typedef LEGACY_PLUGIN::BIU      BIU;
 
@@ -363,8 +364,7 @@ LSET LEGACY_PLUGIN::leg_mask2new( int cu_count, unsigned aMask )
  */
 static inline int intParse( const char* next, const char** out = NULL )
 {
-    // please just compile this and be quiet, hide casting ugliness:
-    return (int) strtol( next, (char**) out, 10 );
+    return (int) ParseLong( next, out );
 }
 
 /**
@@ -385,16 +385,35 @@ static inline LAYER_NUM layerParse( const char* next, const char** out = NULL )
  */
 static inline long hexParse( const char* next, const char** out = NULL )
 {
-    // please just compile this and be quiet, hide casting ugliness:
-    return strtol( next, (char**) out, 16 );
+    return ParseLong( next, out, 16 );
+}
+
+/**
+ * Function tripletParse
+ * parses three floating point numbers as sscanf( next, "%lf %lf %lf" ) does: the
+ * numbers after the first missing one are left unchanged.
+ */
+static void tripletParse( const char* next, double* aX, double* aY, double* aZ )
+{
+    double* values[] = { aX, aY, aZ };
+
+    for( double* value : values )
+    {
+        const char* end;
+        double      tmp = ParseDouble( next, &end );
+
+        if( end == next )
+            break;
+
+        *value = tmp;
+        next = end;
+    }
 }
 
 
 BOARD* LEGACY_PLUGIN::Load( const wxString& aFileName, BOARD* aAppendToMe,
         const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     m_board = aAppendToMe ? aAppendToMe : new BOARD();
@@ -1095,7 +1114,7 @@ void LEGACY_PLUGIN::loadSETUP()
 
         else if( TESTLINE( "Pad2PasteClearanceRatio" ) )
         {
-            double ratio = atof( line + SZ( "Pad2PasteClearanceRatio" ) );
+            double ratio = ParseDouble( line + SZ( "Pad2PasteClearanceRatio" ) );
             bds.m_SolderPasteMarginRatio = ratio;
         }
 
@@ -1323,7 +1342,7 @@ void LEGACY_PLUGIN::loadMODULE( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = ParseDouble( line + SZ( ".SolderPasteRatio" ) );
             // Due to a bug in dialog editor in Modedit, fixed in BZR version 3565
             // this parameter can be broken.
             // It should be >= -50% (no solder paste) and <= 0% (full area of the pad)
@@ -1572,7 +1591,7 @@ void LEGACY_PLUGIN::loadPAD( MODULE* aModule )
 
         else if( TESTLINE( ".SolderPasteRatio" ) )
         {
-            double tmp = atof( line + SZ( ".SolderPasteRatio" ) );
+            double tmp = ParseDouble( line + SZ( ".SolderPasteRatio" ) );
             pad->SetLocalSolderPasteMarginRatio( tmp );
         }
 
@@ -1892,26 +1911,26 @@ void LEGACY_PLUGIN::load3D( MODULE* aModule )
 
         else if( TESTLINE( "Sc" ) )     // Scale
         {
-            sscanf( line + SZ( "Sc" ), "%lf %lf %lf\n",
-                    &t3D.m_Scale.x,
-                    &t3D.m_Scale.y,
-                    &t3D.m_Scale.z );
+            tripletParse( line + SZ( "Sc" ),
+                          &t3D.m_Scale.x,
+                          &t3D.m_Scale.y,
+                          &t3D.m_Scale.z );
         }
 
         else if( TESTLINE( "Of" ) )     // Offset
         {
-            sscanf( line + SZ( "Of" ), "%lf %lf %lf\n",
-                    &t3D.m_Offset.x,
-                    &t3D.m_Offset.y,
-                    &t3D.m_Offset.z );
+            tripletParse( line + SZ( "Of" ),
+                          &t3D.m_Offset.x,
+                          &t3D.m_Offset.y,
+                          &t3D.m_Offset.z );
         }
 
         else if( TESTLINE( "Ro" ) )     // Rotation
         {
-            sscanf( line + SZ( "Ro" ), "%lf %lf %lf\n",
-                    &t3D.m_Rotation.x,
-                    &t3D.m_Rotation.y,
-                    &t3D.m_Rotation.z );
+            tripletParse( line + SZ( "Ro" ),
+                          &t3D.m_Rotation.x,
+                          &t3D.m_Rotation.y,
+                          &t3D.m_Rotation.z );
         }
 
         else if( TESTLINE( "$EndSHAPE3D" ) )
@@ -3022,11 +3041,11 @@ void LEGACY_PLUGIN::loadPCB_TARGET()
 
 BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 {
-    char*   nptr;
+    const char* nptr;
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = ParseDouble( aValue, &nptr );
 
     if( errno )
     {
@@ -3059,11 +3078,11 @@ BIU LEGACY_PLUGIN::biuParse( const char* aValue, const char** nptrptr )
 
 double LEGACY_PLUGIN::degParse( const char* aValue, const char** nptrptr )
 {
-    char*   nptr;
+    const char* nptr;
 
     errno = 0;
 
-    double fval = strtod( aValue, &nptr );
+    double fval = ParseDouble( aValue, &nptr );
 
     if( errno )
     {
@@ -3444,8 +3463,6 @@ void LEGACY_PLUGIN::FootprintEnumerate( wxArrayString&    aFootprintNames,
                                         const wxString&   aLibraryPath,
                                         const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     cacheLib( aLibraryPath );
@@ -3462,8 +3479,6 @@ void LEGACY_PLUGIN::FootprintEnumerate( wxArrayString&    aFootprintNames,
 MODULE* LEGACY_PLUGIN::FootprintLoad( const wxString& aLibraryPath,
         const wxString& aFootprintName, const PROPERTIES* aProperties )
 {
-    LOCALE_IO   toggle;     // toggles on, then off, the C locale.
-
     init( aProperties );
 
     cacheLib( aLibraryPath );
@@ -3518,8 +3533,6 @@ bool LEGACY_PLUGIN::IsFootprintLibWritable( const wxString& aLibraryPath )
 #if 0   // no support for 32 Cu layers in legacy format
     return false;
 #else
-    LOCALE_IO   toggle;
-
     init( NULL );
 
     cacheLib( aLibraryPath );
@@ -38,11 +38,12 @@
 #include <class_marker_pcb.h>
 #include <pcb_base_frame.h>
 #include <confirm.h>
+#include <thread_pool.h>
 
 #include <gal/graphics_abstraction_layer.h>
 
 #include <functional>
-#include <thread>
+#include <future>
 using namespace std::placeholders;
 
 const LAYER_NUM GAL_LAYER_ORDER[] =
@@ -144,23 +145,16 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
 
     m_view->Clear();
 
+    // Triangulate the zones in the background while the other items are loaded
     auto zones = aBoard->Zones();
-    std::atomic<size_t> next( 0 );
-    std::atomic<size_t> count_done( 0 );
-    size_t parallelThreadCount = std::max<size_t>( std::thread::hardware_concurrency(), 2 );
-
-    for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-    {
-        std::thread t = std::thread( [ &count_done, &next, &zones ]( )
-        {
-            for( size_t i = next.fetch_add( 1 ); i < zones.size(); i = next.fetch_add( 1 ) )
-                zones[i]->CacheTriangulation();
-
-            count_done++;
-        } );
-
-        t.detach();
-    }
+    std::future<bool> triangulation = THREAD_POOL::GetPool().Submit( [&zones]()
+            {
+                return THREAD_POOL::GetPool().ParallelFor( zones.size(),
+                        [&zones]( size_t i )
+                        {
+                            zones[i]->CacheTriangulation();
+                        } );
+            } );
 
     if( m_worksheet )
         m_worksheet->SetFileName( TO_UTF8( aBoard->GetFileName() ) );
@@ -183,9 +177,8 @@ void PCB_DRAW_PANEL_GAL::DisplayBoard( BOARD* aBoard )
         m_view->Add( aBoard->GetMARKER( marker_idx ) );
     }
 
-    // Finalize the triangulation threads
-    while( count_done < parallelThreadCount )
-        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    // Finalize the triangulation
+    triangulation.wait();
 
     // Load zones
     for( auto zone : aBoard->Zones() )
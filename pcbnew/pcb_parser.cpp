@@ -50,6 +50,11 @@
 #include <zones.h>
 #include <pcb_parser.h>
 #include <convert_basic_shapes_to_polygon.h>    // for RECT_CHAMFER_POSITIONS definition
+#include <thread_pool.h>
+#include <numeric_io.h>
+
+#include <algorithm>
+#include <exception>
 
 using namespace PCB_KEYS_T;
 
@@ -57,6 +62,8 @@ using namespace PCB_KEYS_T;
 void PCB_PARSER::init()
 {
     m_showLegacyZoneWarning = true;
+    m_legacyZoneFill = false;
+    m_zoneNetsToResolve.clear();
     m_tooRecent = false;
     m_requiredVersion = 0;
     m_layerIndices.clear();
@@ -125,11 +132,11 @@ void PCB_PARSER::pushValueIntoMap( int aIndex, int aValue )
 
 double PCB_PARSER::parseDouble()
 {
-    char* tmp;
+    const char* tmp;
 
     errno = 0;
 
-    double fval = strtod( CurText(), &tmp );
+    double fval = ParseDouble( CurText(), &tmp );
 
     if( errno )
     {
@@ -445,7 +452,6 @@ BOARD_ITEM* PCB_PARSER::Parse()
 {
     T               token;
     BOARD_ITEM*     item;
-    LOCALE_IO       toggle;
 
     // MODULEs can be prefixed with an initial block of single line comments and these
     // are kept for Format() so they round trip in s-expression form.  BOARDs might
@@ -498,89 +504,12 @@ BOARD* PCB_PARSER::parseBOARD()
 
 BOARD* PCB_PARSER::parseBOARD_unchecked()
 {
-    T token;
-
     parseHeader();
 
-    for( token = NextTok();  token != T_RIGHT;  token = NextTok() )
-    {
-        if( token != T_LEFT )
-            Expecting( T_LEFT );
-
-        token = NextTok();
-
-        switch( token )
-        {
-        case T_general:
-            parseGeneralSection();
-            break;
-
-        case T_page:
-            parsePAGE_INFO();
-            break;
-
-        case T_title_block:
-            parseTITLE_BLOCK();
-            break;
-
-        case T_layers:
-            parseLayers();
-            break;
-
-        case T_setup:
-            parseSetup();
-            break;
-
-        case T_net:
-            parseNETINFO_ITEM();
-            break;
-
-        case T_net_class:
-            parseNETCLASS();
-            break;
-
-        case T_gr_arc:
-        case T_gr_circle:
-        case T_gr_curve:
-        case T_gr_line:
-        case T_gr_poly:
-            m_board->Add( parseDRAWSEGMENT(), ADD_APPEND );
-            break;
-
-        case T_gr_text:
-            m_board->Add( parseTEXTE_PCB(), ADD_APPEND );
-            break;
-
-        case T_dimension:
-            m_board->Add( parseDIMENSION(), ADD_APPEND );
-            break;
-
-        case T_module:
-            m_board->Add( parseMODULE(), ADD_APPEND );
-            break;
-
-        case T_segment:
-            m_board->Add( parseTRACK(), ADD_INSERT );
-            break;
-
-        case T_via:
-            m_board->Add( parseVIA(), ADD_INSERT );
-            break;
-
-        case T_zone:
-            m_board->Add( parseZONE_CONTAINER(), ADD_APPEND );
-            break;
-
-        case T_target:
-            m_board->Add( parsePCB_TARGET(), ADD_APPEND );
-            break;
-
-        default:
-            wxString err;
-            err.Printf( _( "Unknown token \"%s\"" ), GetChars( FromUTF8() ) );
-            THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
-        }
-    }
+    if( m_parallel )
+        parseBoardContentParallel();
+    else
+        parseBoardContent();
 
     if( m_undefinedLayers.size() > 0 )
     {
@@ -665,6 +594,515 @@ BOARD* PCB_PARSER::parseBOARD_unchecked()
 }
 
 
+void PCB_PARSER::parseBoardContent()
+{
+    for( T token = NextTok();  token != T_RIGHT;  token = NextTok() )
+    {
+        if( token != T_LEFT )
+            Expecting( T_LEFT );
+
+        BOARD_ITEM* item = parseBoardSection( NextTok() );
+
+        if( item )
+            addBoardItem( item );
+    }
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseBoardSection( T aToken )
+{
+    switch( aToken )
+    {
+    case T_general:
+        parseGeneralSection();
+        return NULL;
+
+    case T_page:
+        parsePAGE_INFO();
+        return NULL;
+
+    case T_title_block:
+        parseTITLE_BLOCK();
+        return NULL;
+
+    case T_layers:
+        parseLayers();
+        return NULL;
+
+    case T_setup:
+        parseSetup();
+        return NULL;
+
+    case T_net:
+        parseNETINFO_ITEM();
+        return NULL;
+
+    case T_net_class:
+        parseNETCLASS();
+        return NULL;
+
+    case T_gr_arc:
+    case T_gr_circle:
+    case T_gr_curve:
+    case T_gr_line:
+    case T_gr_poly:
+        return parseDRAWSEGMENT();
+
+    case T_gr_text:
+        return parseTEXTE_PCB();
+
+    case T_dimension:
+        return parseDIMENSION();
+
+    case T_module:
+        return parseMODULE();
+
+    case T_segment:
+        return parseTRACK();
+
+    case T_via:
+        return parseVIA();
+
+    case T_zone:
+        return parseZONE_CONTAINER();
+
+    case T_target:
+        return parsePCB_TARGET();
+
+    default:
+        wxString err;
+        err.Printf( _( "Unknown token \"%s\"" ), GetChars( FromUTF8() ) );
+        THROW_PARSE_ERROR( err, CurSource(), CurLine(), CurLineNumber(), CurOffset() );
+    }
+}
+
+
+BOARD_ITEM* PCB_PARSER::parseBoardSection( LINE_READER* aReader )
+{
+    SetLineReader( aReader );
+
+    if( NextTok() != T_LEFT )
+        Expecting( T_LEFT );
+
+    return parseBoardSection( NextTok() );
+}
+
+
+void PCB_PARSER::addBoardItem( BOARD_ITEM* aItem )
+{
+    // Tracks are inserted in net code order, everything else in file order.
+    if( aItem->Type() == PCB_TRACE_T || aItem->Type() == PCB_VIA_T )
+        m_board->Add( aItem, ADD_INSERT );
+    else
+        m_board->Add( aItem, ADD_APPEND );
+}
+
+
+/**
+ * A LINE_READER returning the lines of a part of a text held in memory, in place.
+ */
+class SECTION_LINE_READER : public LINE_READER
+{
+    const char* m_next;
+    const char* m_end;
+
+public:
+    SECTION_LINE_READER( const wxString& aSource ) :
+        LINE_READER( LINE_READER_LINE_DEFAULT_MAX ),
+        m_next( NULL ),
+        m_end( NULL )
+    {
+        m_source = aSource;
+    }
+
+    /**
+     * Read the text in [@a aBegin, @a aEnd), which starts on line @a aLineNumber.
+     */
+    void SetText( const char* aBegin, const char* aEnd, unsigned aLineNumber )
+    {
+        m_next    = aBegin;
+        m_end     = aEnd;
+        m_lineNum = aLineNumber - 1;
+    }
+
+    char* ReadLine() override
+    {
+        const char* line = ReadLineView();
+        unsigned    len  = m_length;
+
+        // expandCapacity() keeps the first m_length bytes of the old buffer: there are none.
+        m_length = 0;
+
+        if( len + 1 > m_capacity )
+            expandCapacity( len + 1 );
+
+        if( len )
+            memcpy( m_line, line, len );
+
+        m_line[len] = 0;
+        m_length    = len;
+
+        return len ? m_line : NULL;
+    }
+
+    const char* ReadLineView() override
+    {
+        ++m_lineNum;
+
+        if( m_next >= m_end )
+        {
+            m_length = 0;
+            return NULL;
+        }
+
+        const char* line = m_next;
+        const char* eol  = (const char*) memchr( line, '\n', m_end - line );
+
+        m_next = eol ? eol + 1 : m_end;
+
+        if( unsigned( m_next - line ) > m_maxLineLength )
+            THROW_IO_ERROR( _( "Maximum line length exceeded" ) );
+
+        m_length = m_next - line;
+
+        return line;
+    }
+};
+
+
+/**
+ * A top level section of a board, e.g. "(segment ...)".
+ */
+struct BOARD_SECTION
+{
+    const char* m_begin;
+    const char* m_end;
+    unsigned    m_line;     ///< line number of m_begin
+};
+
+
+/**
+ * Split the content of a board following its header into its top level sections.
+ *
+ * This is a bracket scanner which only knows about the quoted strings and the comment
+ * lines of the lexer.  It gives up as soon as the text does not look like a well formed
+ * board, to let the regular parser report the error.
+ *
+ * @return true if the text was split up to the closing parenthesis of the board.
+ */
+static bool splitBoardSections( const char* aBegin, const char* aEnd, unsigned aLine,
+                                std::vector<BOARD_SECTION>& aSections )
+{
+    const char* section     = NULL;
+    unsigned    sectionLine = 0;
+    int         depth       = 0;
+    const char* lineBegin   = aBegin;
+    bool        lineStart   = true;     // only blanks since the beginning of the line
+
+    for( const char* p = aBegin; p < aEnd; ++p )
+    {
+        switch( *p )
+        {
+        case '\n':
+            ++aLine;
+            lineBegin = p + 1;
+            lineStart = true;
+            continue;
+
+        case ' ':
+        case '\r':
+        case '\t':
+        case '\0':
+            continue;
+
+        case '#':
+            if( lineStart )
+            {
+                // A comment line, as for DSNLEXER::NextTok().
+                p = (const char*) memchr( p, '\n', aEnd - p );
+
+                if( !p )
+                    return false;
+
+                --p;
+                continue;
+            }
+
+            break;
+
+        case '"':
+            // As for the lexer, a quoted string starts a token and ends on the same line
+            if( p > aBegin && !strchr( " \r\n\t()", p[-1] ) )
+                break;
+
+            for( ++p; p < aEnd && *p != '"'; ++p )
+            {
+                if( *p == '\\' )
+                    ++p;
+
+                if( p >= aEnd || *p == '\n' )
+                    return false;
+            }
+
+            if( p >= aEnd )
+                return false;
+
+            lineStart = false;
+            continue;
+
+        case '(':
+            if( depth++ == 0 )
+            {
+                // Keep the indentation, for the same error offsets as the serial parser.
+                section     = lineStart ? lineBegin : p;
+                sectionLine = aLine;
+            }
+
+            lineStart = false;
+            continue;
+
+        case ')':
+            // The closing parenthesis of the board: the parser ignores what follows.
+            if( depth == 0 )
+                return true;
+
+            if( --depth == 0 )
+                aSections.push_back( { section, p + 1, sectionLine } );
+
+            lineStart = false;
+            continue;
+        }
+
+        // Any other token must be in a section.
+        if( depth == 0 )
+            return false;
+
+        lineStart = false;
+    }
+
+    return false;
+}
+
+
+void PCB_PARSER::parseBoardContentParallel()
+{
+    // Sections are split in chunks of this many consecutive items for the pool threads.
+    static const size_t ITEMS_PER_CHUNK = 64;
+
+    // The whole board, starting with what follows the header on its line.  A reader holding
+    // the file in memory returns it in place, right after the current line; the text of the
+    // other ones is copied.
+    unsigned    firstLine = CurLineNumber();
+    size_t      restLength;
+    const char* rest = reader->ReadRemainingView( &restLength );
+    const char* textBegin = next;
+    const char* textEnd;
+    std::string text;
+
+    if( rest && rest == limit )
+    {
+        textEnd = rest + restLength;
+    }
+    else
+    {
+        text.assign( next, limit );
+
+        if( rest )
+        {
+            text.append( rest, restLength );
+        }
+        else
+        {
+            const char* line;
+
+            while( ( line = reader->ReadLineView() ) != NULL )
+                text.append( line, reader->Length() );
+        }
+
+        textBegin = text.data();
+        textEnd   = text.data() + text.size();
+    }
+
+    SECTION_LINE_READER sectionReader( CurSource() );
+    LINE_READER*        fileReader = SetLineReader( &sectionReader );
+
+    // All the items, in file order, and the sections of the ones left to parse in parallel.
+    std::vector<BOARD_ITEM*>          items;
+    std::vector<const BOARD_SECTION*> itemSections;
+
+    try
+    {
+        std::vector<BOARD_SECTION> sections;
+
+        if( !splitBoardSections( textBegin, textEnd, firstLine, sections ) )
+        {
+            sectionReader.SetText( textBegin, textEnd, firstLine );
+            SetLineReader( &sectionReader );
+            parseBoardContent();
+            SetLineReader( fileReader );
+            return;
+        }
+
+        // Phase 1: set up the board from the non item sections, in file order, and collect
+        // the items.  Sections with an unexpected syntax are parsed here too.
+        for( const BOARD_SECTION& section : sections )
+        {
+            const char* name = std::find( section.m_begin, section.m_end, '(' ) + 1;
+            const char* nameEnd = name;
+
+            while( nameEnd < section.m_end && ( isalnum( *nameEnd ) || *nameEnd == '_' ) )
+                ++nameEnd;
+
+            switch( findToken( std::string( name, nameEnd ) ) )
+            {
+            case T_gr_arc:
+            case T_gr_circle:
+            case T_gr_curve:
+            case T_gr_line:
+            case T_gr_poly:
+            case T_gr_text:
+            case T_dimension:
+            case T_module:
+            case T_segment:
+            case T_via:
+            case T_zone:
+            case T_target:
+                items.push_back( NULL );
+                itemSections.push_back( &section );
+                break;
+
+            default:
+                sectionReader.SetText( section.m_begin, section.m_end, section.m_line );
+
+                // Items not recognized above, e.g. "( module", are simply parsed here.
+                if( BOARD_ITEM* item = parseBoardSection( &sectionReader ) )
+                {
+                    items.push_back( item );
+                    itemSections.push_back( NULL );
+                }
+
+                break;
+            }
+        }
+
+        // Phase 2: parse the items on the pool threads, each with its own parser.
+        struct WORKER
+        {
+            WORKER( const wxString& aSource ) :
+                m_reader( aSource )
+            {}
+
+            PCB_PARSER          m_parser;
+            SECTION_LINE_READER m_reader;
+        };
+
+        THREAD_POOL&                         pool = THREAD_POOL::GetPool();
+        std::vector<std::unique_ptr<WORKER>> workers( pool.GetSlotCount() );
+        const wxString                       source = CurSource();
+        size_t                               chunkCount;
+
+        chunkCount = ( items.size() + ITEMS_PER_CHUNK - 1 ) / ITEMS_PER_CHUNK;
+
+        std::vector<std::exception_ptr> errors( chunkCount );
+
+        pool.ParallelFor( chunkCount,
+                [&]( size_t aChunk )
+                {
+                    std::unique_ptr<WORKER>& worker = workers[ pool.GetSlot() ];
+
+                    if( !worker )
+                    {
+                        worker.reset( new WORKER( source ) );
+
+                        PCB_PARSER& parser = worker->m_parser;
+
+                        parser.m_board           = m_board;
+                        parser.m_layerIndices    = m_layerIndices;
+                        parser.m_layerMasks      = m_layerMasks;
+                        parser.m_netCodes        = m_netCodes;
+                        parser.m_tooRecent       = m_tooRecent;
+                        parser.m_requiredVersion = m_requiredVersion;
+                        parser.m_worker          = true;
+                    }
+
+                    size_t last = std::min( ( aChunk + 1 ) * ITEMS_PER_CHUNK, items.size() );
+
+                    try
+                    {
+                        for( size_t i = aChunk * ITEMS_PER_CHUNK; i < last; ++i )
+                        {
+                            const BOARD_SECTION* section = itemSections[i];
+
+                            if( !section )
+                                continue;
+
+                            worker->m_reader.SetText( section->m_begin, section->m_end,
+                                                      section->m_line );
+                            items[i] = worker->m_parser.parseBoardSection( &worker->m_reader );
+                        }
+                    }
+                    catch( ... )
+                    {
+                        errors[aChunk] = std::current_exception();
+                    }
+                } );
+
+        for( std::unique_ptr<WORKER>& worker : workers )
+        {
+            if( !worker )
+                continue;
+
+            PCB_PARSER& parser = worker->m_parser;
+
+            m_undefinedLayers.insert( parser.m_undefinedLayers.begin(),
+                                      parser.m_undefinedLayers.end() );
+            m_zoneNetsToResolve.insert( parser.m_zoneNetsToResolve.begin(),
+                                        parser.m_zoneNetsToResolve.end() );
+            m_requiredVersion = std::max( m_requiredVersion, parser.m_requiredVersion );
+            m_tooRecent = m_tooRecent || parser.m_tooRecent;
+            m_legacyZoneFill = m_legacyZoneFill || parser.m_legacyZoneFill;
+        }
+
+        // Report the first error in file order, as the serial parser would.
+        for( std::exception_ptr& error : errors )
+        {
+            if( error )
+                std::rethrow_exception( error );
+        }
+
+        if( m_legacyZoneFill )
+            confirmLegacyZoneFill();
+    }
+    catch( ... )
+    {
+        for( BOARD_ITEM* item : items )
+            delete item;
+
+        m_zoneNetsToResolve.clear();
+        SetLineReader( fileReader );
+        throw;
+    }
+
+    SetLineReader( fileReader );
+
+    for( BOARD_ITEM* item : items )
+    {
+        if( item->Type() == PCB_ZONE_AREA_T )
+        {
+            ZONE_CONTAINER* zone = static_cast<ZONE_CONTAINER*>( item );
+            auto            it = m_zoneNetsToResolve.find( zone );
+
+            if( it != m_zoneNetsToResolve.end() )
+                resolveZoneNet( zone, it->second );
+        }
+
+        addBoardItem( item );
+    }
+
+    m_zoneNetsToResolve.clear();
+}
+
+
 void PCB_PARSER::parseHeader()
 {
     wxCHECK_RET( CurTok() == T_kicad_pcb,
@@ -3190,24 +3628,13 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
                     if( token == T_segment )    // deprecated
                     {
                         // SEGMENT fill mode no longer supported.  Make sure user is OK with converting them.
-                        if( m_showLegacyZoneWarning )
-                        {
-                            KIDIALOG dlg( nullptr,
-                                          _( "The legacy segment fill mode is no longer supported.\n"
-                                             "Convert zones to polygon fills?"),
-                                          _( "Legacy Zone Warning" ),
-                                          wxYES_NO | wxICON_WARNING );
-
-                            dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
-
-                            if( dlg.ShowModal() == wxID_NO )
-                                THROW_IO_ERROR( wxT( "CANCEL" ) );
-
-                            m_showLegacyZoneWarning = false;
-                        }
+                        // Workers leave the question to the main parser.
+                        if( m_worker )
+                            m_legacyZoneFill = true;
+                        else
+                            confirmLegacyZoneFill();
 
                         zone->SetFillMode( ZFM_POLYGONS );
-                        m_board->SetModified();
                     }
                     else if( token == T_hatch )
                         zone->SetFillMode( ZFM_HATCH_PATTERN );
@@ -3433,36 +3860,13 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
         zone->SetNetCode( NETINFO_LIST::UNCONNECTED );
 
     // Ensure the zone net name is valid, and matches the net code, for copper zones
+    // Workers cannot add nets: the main parser does it when it adds the zone to the board.
     if( zone_has_net && ( zone->GetNet()->GetNetname() != netnameFromfile ) )
     {
-        // Can happens which old boards, with nonexistent nets ...
-        // or after being edited by hand
-        // We try to fix the mismatch.
-        NETINFO_ITEM* net = m_board->FindNet( netnameFromfile );
-
-        if( net )   // An existing net has the same net name. use it for the zone
-            zone->SetNetCode( net->GetNet() );
-        else    // Not existing net: add a new net to keep trace of the zone netname
-        {
-            int newnetcode = m_board->GetNetCount();
-            net = new NETINFO_ITEM( m_board, netnameFromfile, newnetcode );
-            m_board->Add( net );
-
-            // Store the new code mapping
-            pushValueIntoMap( newnetcode, net->GetNet() );
-            // and update the zone netcode
-            zone->SetNetCode( net->GetNet() );
-
-            // FIXME: a call to any GUI item is not allowed in io plugins:
-            // Change this code to generate a warning message outside this plugin
-            // Prompt the user
-            wxString msg;
-            msg.Printf( _( "There is a zone that belongs to a not existing net\n"
-                           "\"%s\"\n"
-                           "you should verify and edit it (run DRC test)." ),
-                           GetChars( netnameFromfile ) );
-            DisplayError( NULL, msg );
-        }
+        if( m_worker )
+            m_zoneNetsToResolve[ zone.get() ] = netnameFromfile;
+        else
+            resolveZoneNet( zone.get(), netnameFromfile );
     }
 
     // Clear flags used in zone edition:
@@ -3472,6 +3876,61 @@ ZONE_CONTAINER* PCB_PARSER::parseZONE_CONTAINER()
 }
 
 
+void PCB_PARSER::confirmLegacyZoneFill()
+{
+    if( m_showLegacyZoneWarning )
+    {
+        KIDIALOG dlg( nullptr,
+                      _( "The legacy segment fill mode is no longer supported.\n"
+                         "Convert zones to polygon fills?"),
+                      _( "Legacy Zone Warning" ),
+                      wxYES_NO | wxICON_WARNING );
+
+        dlg.DoNotShowCheckbox( __FILE__, __LINE__ );
+
+        if( dlg.ShowModal() == wxID_NO )
+            THROW_IO_ERROR( wxT( "CANCEL" ) );
+
+        m_showLegacyZoneWarning = false;
+    }
+
+    m_board->SetModified();
+}
+
+
+void PCB_PARSER::resolveZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetName )
+{
+    // Can happens which old boards, with nonexistent nets ...
+    // or after being edited by hand
+    // We try to fix the mismatch.
+    NETINFO_ITEM* net = m_board->FindNet( aNetName );
+
+    if( net )   // An existing net has the same net name. use it for the zone
+        aZone->SetNetCode( net->GetNet() );
+    else    // Not existing net: add a new net to keep trace of the zone netname
+    {
+        int newnetcode = m_board->GetNetCount();
+        net = new NETINFO_ITEM( m_board, aNetName, newnetcode );
+        m_board->Add( net );
+
+        // Store the new code mapping
+        pushValueIntoMap( newnetcode, net->GetNet() );
+        // and update the zone netcode
+        aZone->SetNetCode( net->GetNet() );
+
+        // FIXME: a call to any GUI item is not allowed in io plugins:
+        // Change this code to generate a warning message outside this plugin
+        // Prompt the user
+        wxString msg;
+        msg.Printf( _( "There is a zone that belongs to a not existing net\n"
+                       "\"%s\"\n"
+                       "you should verify and edit it (run DRC test)." ),
+                       GetChars( aNetName ) );
+        DisplayError( NULL, msg );
+    }
+}
+
+
 PCB_TARGET* PCB_PARSER::parsePCB_TARGET()
 {
     wxCHECK_MSG( CurTok() == T_target, NULL,
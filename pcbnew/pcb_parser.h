@@ -35,7 +35,9 @@
 #include <layers_id_colors_and_visibility.h>    // PCB_LAYER_ID
 #include <common.h>                             // KiROUND
 #include <convert_to_biu.h>                     // IU_PER_MM
+#include <numeric_io.h>                         // ParseLong
 
+#include <map>
 #include <unordered_map>
 
 
@@ -77,6 +79,14 @@ class PCB_PARSER : public PCB_LEXER
 
     bool                m_showLegacyZoneWarning;
 
+    bool                m_parallel;         ///< parse the board items on the thread pool
+    bool                m_worker;           ///< parsing items for another parser, on a pool
+                                            ///< thread: no dialogs, no changes to the board
+    bool                m_legacyZoneFill;   ///< a worker found a legacy segment zone fill
+
+    ///> zones whose net must be resolved by name once they are merged, with this name
+    std::map<ZONE_CONTAINER*, wxString> m_zoneNetsToResolve;
+
     ///> Converts net code using the mapping table if available,
     ///> otherwise returns unchanged net code if < 0 or if is is out of range
     inline int getNetCode( int aNetCode )
@@ -148,6 +158,57 @@ class PCB_PARSER : public PCB_LEXER
     PCB_TARGET*     parsePCB_TARGET();
     BOARD*          parseBOARD();
 
+    /**
+     * Function parseBoardContent
+     * parses the sections and items of a board following its header, up to its closing
+     * parenthesis.
+     */
+    void            parseBoardContent();
+
+    /**
+     * Function parseBoardContentParallel
+     * does the same as parseBoardContent(), but first splits the board into its top level
+     * sections with a bracket scanner, parses the setup sections in order and then the
+     * board items on the thread pool.  The items are added to the board in file order.
+     */
+    void            parseBoardContentParallel();
+
+    /**
+     * Function parseBoardSection
+     * parses a top level board section starting with @a aToken.
+     *
+     * @return the parsed item, or NULL for sections (layers, nets ...) which set up the
+     *  board rather than add an item to it.
+     */
+    BOARD_ITEM*     parseBoardSection( PCB_KEYS_T::T aToken );
+
+    /**
+     * Function parseBoardSection
+     * parses the single top level board section held by @a aReader.
+     */
+    BOARD_ITEM*     parseBoardSection( LINE_READER* aReader );
+
+    /**
+     * Function addBoardItem
+     * adds a parsed top level item to the board, keeping the tracks sorted by net.
+     */
+    void            addBoardItem( BOARD_ITEM* aItem );
+
+    /**
+     * Function confirmLegacyZoneFill
+     * asks the user (once) to convert zones using the legacy segment fill mode.
+     *
+     * @throw IO_ERROR if the user cancels the load.
+     */
+    void            confirmLegacyZoneFill();
+
+    /**
+     * Function resolveZoneNet
+     * fixes the net of @a aZone when its net code does not match its net name
+     * @a aNetName, by name, adding a new net if needed.
+     */
+    void            resolveZoneNet( ZONE_CONTAINER* aZone, const wxString& aNetName );
+
     /**
      * Function parseBOARD_unchecked
      * Parse a module, but do not replace PARSE_ERROR with FUTURE_FORMAT_ERROR automatically.
@@ -275,7 +336,7 @@ class PCB_PARSER : public PCB_LEXER
 
     inline int parseInt()
     {
-        return (int)strtol( CurText(), NULL, 10 );
+        return (int) ParseLong( CurText() );
     }
 
     inline int parseInt( const char* aExpected )
@@ -287,7 +348,7 @@ class PCB_PARSER : public PCB_LEXER
     inline long parseHex()
     {
         NextTok();
-        return strtol( CurText(), NULL, 16 );
+        return ParseLong( CurText(), nullptr, 16 );
     }
 
     bool parseBool();
@@ -302,7 +363,9 @@ public:
 
     PCB_PARSER( LINE_READER* aReader = NULL ) :
         PCB_LEXER( aReader ),
-        m_board( 0 )
+        m_board( 0 ),
+        m_parallel( false ),
+        m_worker( false )
     {
         init();
     }
@@ -328,6 +391,16 @@ public:
         m_board = aBoard;
     }
 
+    /**
+     * Function SetParallel
+     * enables parsing the items of boards on the thread pool.  Footprints are always
+     * parsed serially.
+     */
+    void SetParallel( bool aParallel )
+    {
+        m_parallel = aParallel;
+    }
+
     BOARD_ITEM* Parse();
     /**
      * Function parseMODULE
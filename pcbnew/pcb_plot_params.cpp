@@ -28,6 +28,7 @@
 #include <macros.h>
 #include <convert_to_biu.h>
 #include <board_design_settings.h>
+#include <numeric_io.h>
 
 
 #define PLOT_LINEWIDTH_MIN        ( 0.02 * IU_PER_MM )  // min value for default line thickness
@@ -571,7 +572,7 @@ double PCB_PLOT_PARAMS_PARSER::parseDouble()
     if( token != T_NUMBER )
         Expecting( T_NUMBER );
 
-    double val = strtod( CurText(), NULL );
+    double val = ParseDouble( CurText() );
 
     return val;
 }
@@ -33,6 +33,7 @@
 #endif
 
 #include <ratsnest_data.h>
+#include <advanced_config.h>
 #include <functional>
 using namespace std::placeholders;
 
@@ -49,13 +50,56 @@ static uint64_t getDistance( const CN_ANCHOR_PTR& aNode1, const CN_ANCHOR_PTR& a
 }
 
 
-static bool sortWeight( const CN_EDGE& aEdge1, const CN_EDGE& aEdge2 )
+/**
+ * Disjoint-set forest used by kruskalMST() to detect cycles
+ */
+class DISJOINT_SET
 {
-    return aEdge1.GetWeight() < aEdge2.GetWeight();
-}
+public:
+    DISJOINT_SET( size_t aSize ) :
+        m_parent( aSize )
+    {
+        for( size_t i = 0; i < aSize; i++ )
+            m_parent[i] = i;
+    }
+
+    int Find( int aVal )
+    {
+        int root = aVal;
+
+        while( m_parent[root] != root )
+            root = m_parent[root];
+
+        // Compress the path
+        while( m_parent[aVal] != root )
+        {
+            int next = m_parent[aVal];
+            m_parent[aVal] = root;
+            aVal = next;
+        }
+
+        return root;
+    }
+
+    ///> Joins the sets of two elements, @return false if they were in the same set already
+    bool Unite( int aVal0, int aVal1 )
+    {
+        int root0 = Find( aVal0 );
+        int root1 = Find( aVal1 );
 
+        if( root0 == root1 )
+            return false;
+
+        m_parent[root1] = root0;
+        return true;
+    }
 
-static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
+private:
+    std::vector<int> m_parent;
+};
+
+
+static const std::vector<CN_EDGE> kruskalMST( const std::vector<CN_EDGE>& aEdges,
         std::vector<CN_ANCHOR_PTR>& aNodes )
 {
     unsigned int    nodeNumber = aNodes.size();
@@ -66,85 +110,79 @@ static const std::vector<CN_EDGE> kruskalMST( std::list<CN_EDGE>& aEdges,
     // The output
     std::vector<CN_EDGE> mst;
 
-    // Set tags for marking cycles
-    std::unordered_map<CN_ANCHOR_PTR, int> tags;
-    unsigned int tag = 0;
+    // Nodes are referred to by their index while looking for the tree
+    for( unsigned int i = 0; i < nodeNumber; i++ )
+        aNodes[i]->SetTag( i );
 
-    for( auto& node : aNodes )
-    {
-        node->SetTag( tag );
-        tags[node] = tag++;
-    }
+    // Kruskal algorithm requires edges to be sorted by their weight.  Sort references rather
+    // than the edges themselves; ties keep their order, as they did with std::list::sort().
+    std::vector<const CN_EDGE*> sorted;
+    sorted.reserve( aEdges.size() );
 
-    // Lists of nodes connected together (subtrees) to detect cycles in the graph
-    std::vector<std::list<int> > cycles( nodeNumber );
+    for( const CN_EDGE& edge : aEdges )
+        sorted.push_back( &edge );
 
-    for( unsigned int i = 0; i < nodeNumber; ++i )
-        cycles[i].push_back( i );
+    std::stable_sort( sorted.begin(), sorted.end(),
+            []( const CN_EDGE* aEdge1, const CN_EDGE* aEdge2 )
+            {
+                return aEdge1->GetWeight() < aEdge2->GetWeight();
+            } );
+
+    std::vector<std::pair<int, int>> ends;
+    ends.reserve( sorted.size() );
+
+    for( const CN_EDGE* edge : sorted )
+        ends.emplace_back( edge->GetSourceNode()->GetTag(), edge->GetTargetNode()->GetTag() );
 
-    // Kruskal algorithm requires edges to be sorted by their weight
-    aEdges.sort( sortWeight );
+    DISJOINT_SET subtrees( nodeNumber );
 
-    while( mstSize < mstExpectedSize && !aEdges.empty() )
+    // Once the connections which exist on the board are known, tag the nodes by the subtree
+    // they belong to
+    auto tagConnected = [&]()
     {
-        //printf("mstSize %d %d\n", mstSize, mstExpectedSize);
-        auto& dt = aEdges.front();
+        for( unsigned int i = 0; i < nodeNumber; i++ )
+            aNodes[i]->SetTag( subtrees.Find( i ) );
+    };
 
-        int srcTag  = tags[dt.GetSourceNode()];
-        int trgTag  = tags[dt.GetTargetNode()];
+    for( size_t i = 0; i < sorted.size() && mstSize < mstExpectedSize; i++ )
+    {
+        const CN_EDGE& dt = *sorted[i];
 
-        // Check if by adding this edge we are going to join two different forests
-        if( srcTag != trgTag )
+        // Because edges are sorted by their weight, first we always process connected
+        // items (weight == 0). Once we stumble upon an edge with non-zero weight,
+        // it means that the rest of the lines are ratsnest.
+        if( !ratsnestLines && dt.GetWeight() != 0 )
         {
-            // Because edges are sorted by their weight, first we always process connected
-            // items (weight == 0). Once we stumble upon an edge with non-zero weight,
-            // it means that the rest of the lines are ratsnest.
-            if( !ratsnestLines && dt.GetWeight() != 0 )
-                ratsnestLines = true;
-
-            // Update tags
-            if( ratsnestLines )
-            {
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                }
-
-                // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
-                // RN_EDGE_MST saves both source and target node and does not require any other
-                // edges to exist for getting source/target nodes
-                CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
+            ratsnestLines = true;
+            tagConnected();
+        }
 
-                assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
-                assert( newEdge.GetWeight() > 0 );
+        // Check if by adding this edge we are going to join two different forests
+        if( !subtrees.Unite( ends[i].first, ends[i].second ) )
+            continue;
 
-                mst.push_back( newEdge );
-                ++mstSize;
-            }
-            else
-            {
-                // for( it = cycles[trgTag].begin(), itEnd = cycles[trgTag].end(); it != itEnd; ++it )
-                // for( auto it : cycles[trgTag] )
-                for( auto it = cycles[trgTag].begin(); it != cycles[trgTag].end(); ++it )
-                {
-                    tags[aNodes[*it]] = srcTag;
-                    aNodes[*it]->SetTag( srcTag );
-                }
+        if( ratsnestLines )
+        {
+            // Do a copy of edge, but make it RN_EDGE_MST. In contrary to RN_EDGE,
+            // RN_EDGE_MST saves both source and target node and does not require any other
+            // edges to exist for getting source/target nodes
+            CN_EDGE newEdge ( dt.GetSourceNode(), dt.GetTargetNode(), dt.GetWeight() );
 
-                // Processing a connection, decrease the expected size of the ratsnest MST
-                --mstExpectedSize;
-            }
+            assert( newEdge.GetSourceNode()->GetTag() != newEdge.GetTargetNode()->GetTag() );
+            assert( newEdge.GetWeight() > 0 );
 
-            // Move nodes that were marked with old tag to the list marked with the new tag
-            cycles[srcTag].splice( cycles[srcTag].end(), cycles[trgTag] );
+            mst.push_back( newEdge );
+            ++mstSize;
+        }
+        else
+        {
+            // Processing a connection, decrease the expected size of the ratsnest MST
+            --mstExpectedSize;
         }
-
-        // Remove the edge that was just processed
-        aEdges.erase( aEdges.begin() );
     }
 
-    // Probably we have discarded some of edges, so reduce the size
-    mst.resize( mstSize );
+    if( !ratsnestLines )
+        tagConnected();
 
     return mst;
 }
@@ -155,16 +193,28 @@ class RN_NET::TRIANGULATOR_STATE
 private:
     std::vector<CN_ANCHOR_PTR>  m_allNodes;
 
-    std::list<hed::EDGE_PTR> hedTriangulation( std::vector<hed::NODE_PTR>& aNodes )
-    {
-        hed::TRIANGULATION triangulator;
-        triangulator.CreateDelaunay( aNodes.begin(), aNodes.end() );
-        std::list<hed::EDGE_PTR> edges;
-        triangulator.GetEdges( edges );
+    ///> Delaunay triangulation of the anchor positions at the previous update.  It is kept
+    ///> inside an enclosing rectangle, whose corners are never removed, so that nodes can be
+    ///> added and removed in place when only a few anchors have moved.
+    std::unique_ptr<hed::TRIANGULATION> m_triangulation;
+
+    ///> Nodes of m_triangulation (except the rectangle corners), by position
+    std::unordered_map<uint64_t, hed::NODE_PTR> m_triNodes;
+
+    ///> Nodes can be inserted in this area without rebuilding the triangulation
+    VECTOR2I m_safeMin;
+    VECTOR2I m_safeMax;
 
-        return edges;
+    static uint64_t posKey( int aX, int aY )
+    {
+        return ( (uint64_t) (uint32_t) aX << 32 ) | (uint32_t) aY;
     }
 
+    static int clampCoord( int64_t aVal )
+    {
+        return (int) std::max<int64_t>( std::numeric_limits<int>::min(),
+                                        std::min<int64_t>( aVal, std::numeric_limits<int>::max() ) );
+    }
 
     // Checks if all nodes in aNodes lie on a single line. Requires the nodes to
     // have unique coordinates!
@@ -189,6 +239,121 @@ private:
         return true;
     }
 
+    /**
+     * Triangulates aNodes from scratch.
+     *
+     * The rectangle corners are placed far enough from the nodes that they do not hide any
+     * edge of the minimum spanning tree: an edge of the tree is always an edge of the
+     * Gabriel graph, whose diametral circle is empty and cannot reach the corners.
+     */
+    void rebuild( const std::vector<hed::NODE_PTR>& aNodes, const VECTOR2I& aMin,
+            const VECTOR2I& aMax )
+    {
+        // Leave some room for the nodes to move before the next rebuild
+        int64_t size  = std::max<int64_t>( (int64_t) aMax.x - aMin.x, (int64_t) aMax.y - aMin.y );
+        int64_t slack = size / 4 + 1;
+
+        m_safeMin = VECTOR2I( clampCoord( aMin.x - slack ), clampCoord( aMin.y - slack ) );
+        m_safeMax = VECTOR2I( clampCoord( aMax.x + slack ), clampCoord( aMax.y + slack ) );
+
+        int64_t margin = size + 2 * slack + 1;
+
+        m_triangulation.reset( new hed::TRIANGULATION );
+        m_triangulation->InitRectangle( clampCoord( m_safeMin.x - margin ),
+                                        clampCoord( m_safeMin.y - margin ),
+                                        clampCoord( m_safeMax.x + margin ),
+                                        clampCoord( m_safeMax.y + margin ) );
+
+        // Mark the corners, so their edges are skipped
+        for( hed::EDGE_PTR edge : m_triangulation->GetLeadingEdges() )
+        {
+            for( int i = 0; i < 3; ++i )
+            {
+                edge->GetSourceNode()->SetId( -1 );
+                edge = edge->GetNextEdgeInFace();
+            }
+        }
+
+        // The nodes are sorted, so each one is close to the previous one
+        hed::DART dart = m_triangulation->CreateDart();
+
+        for( const hed::NODE_PTR& node : aNodes )
+            m_triangulation->InsertNode( node, dart );
+    }
+
+    /**
+     * Brings m_triangulation up to date with aNodes.  If only a few of them have changed,
+     * the triangulation is modified in place, otherwise it is rebuilt.
+     *
+     * @param aNodes are the unique anchor positions, with the index of their first anchor
+     * as id.  Nodes already in the triangulation are replaced by the existing ones.
+     */
+    void updateTriangulation( std::vector<hed::NODE_PTR>& aNodes )
+    {
+        VECTOR2I bboxMin( std::numeric_limits<int>::max(), std::numeric_limits<int>::max() );
+        VECTOR2I bboxMax( std::numeric_limits<int>::min(), std::numeric_limits<int>::min() );
+
+        std::unordered_map<uint64_t, hed::NODE_PTR> triNodes;
+        std::vector<hed::NODE_PTR>                  added;
+
+        triNodes.reserve( aNodes.size() );
+
+        for( hed::NODE_PTR& node : aNodes )
+        {
+            bboxMin.x = std::min( bboxMin.x, node->GetX() );
+            bboxMin.y = std::min( bboxMin.y, node->GetY() );
+            bboxMax.x = std::max( bboxMax.x, node->GetX() );
+            bboxMax.y = std::max( bboxMax.y, node->GetY() );
+
+            uint64_t key = posKey( node->GetX(), node->GetY() );
+            auto     it = m_triNodes.find( key );
+
+            if( it != m_triNodes.end() )
+            {
+                it->second->SetId( node->Id() );
+                node = it->second;
+                m_triNodes.erase( it );
+            }
+            else
+            {
+                added.push_back( node );
+            }
+
+            triNodes[key] = node;
+        }
+
+        // What is left in m_triNodes are the nodes which have gone
+        size_t changes = added.size() + m_triNodes.size();
+
+        bool incremental = m_triangulation && changes * 4 <= aNodes.size()
+                           && bboxMin.x >= m_safeMin.x && bboxMin.y >= m_safeMin.y
+                           && bboxMax.x <= m_safeMax.x && bboxMax.y <= m_safeMax.y;
+
+        if( incremental )
+        {
+            hed::DART dart = m_triangulation->CreateDart();
+
+            for( const auto& gone : m_triNodes )
+            {
+                if( !m_triangulation->RemoveNode( gone.second, dart ) )
+                {
+                    incremental = false;
+                    break;
+                }
+            }
+
+            for( size_t i = 0; incremental && i < added.size(); i++ )
+                incremental = m_triangulation->InsertNode( added[i], dart );
+        }
+
+        // A failure above should not happen, but leaves the triangulation in an unknown
+        // state; start over in that case
+        if( !incremental )
+            rebuild( aNodes, bboxMin, bboxMax );
+
+        m_triNodes = std::move( triNodes );
+    }
+
 public:
 
     void Clear()
@@ -201,9 +366,16 @@ public:
         m_allNodes.push_back( aNode );
     }
 
-    const std::list<CN_EDGE> Triangulate()
+    ///> Discards the triangulation kept from the previous update
+    void Reset()
     {
-        std::list<CN_EDGE> mstEdges;
+        m_triangulation.reset();
+        m_triNodes.clear();
+    }
+
+    const std::vector<CN_EDGE> Triangulate()
+    {
+        std::vector<CN_EDGE> mstEdges;
         std::list<hed::EDGE_PTR> triangEdges;
         std::vector<hed::NODE_PTR> triNodes;
 
@@ -280,14 +452,21 @@ public:
         }
         else
         {
-            hed::TRIANGULATION triangulator;
-            triangulator.CreateDelaunay( triNodes.begin(), triNodes.end() );
-            triangulator.GetEdges( triangEdges );
+            updateTriangulation( triNodes );
+            m_triangulation->GetEdges( triangEdges );
+            mstEdges.reserve( triangEdges.size() + m_allNodes.size() );
 
             for( auto e : triangEdges )
             {
-                auto    src = m_allNodes[ e->GetSourceNode()->Id() ];
-                auto    dst = m_allNodes[ e->GetTargetNode()->Id() ];
+                int srcId = e->GetSourceNode()->Id();
+                int dstId = e->GetTargetNode()->Id();
+
+                // Edges of the enclosing rectangle
+                if( srcId < 0 || dstId < 0 )
+                    continue;
+
+                auto    src = m_allNodes[ srcId ];
+                auto    dst = m_allNodes[ dstId ];
 
                 mstEdges.emplace_back( src, dst, getDistance( src, dst ) );
             }
@@ -319,7 +498,9 @@ public:
 };
 
 
-RN_NET::RN_NET() : m_dirty( true )
+RN_NET::RN_NET() :
+    m_dirty( true ),
+    m_incremental( ADVANCED_CFG::GetCfg().m_incrementalRatsnest )
 {
     m_triangulator.reset( new TRIANGULATOR_STATE );
 }
@@ -363,6 +544,9 @@ void RN_NET::compute()
         m_triangulator->AddNode( n );
     }
 
+    if( !m_incremental )
+        m_triangulator->Reset();
+
     #ifdef PROFILE
     PROF_COUNTER cnt("triangulate");
     #endif
@@ -371,8 +555,7 @@ void RN_NET::compute()
     cnt.Show();
     #endif
 
-    for( const auto& e : m_boardEdges )
-        triangEdges.push_back( e );
+    triangEdges.insert( triangEdges.end(), m_boardEdges.begin(), m_boardEdges.end() );
 
 // Get the minimal spanning tree
 #ifdef PROFILE
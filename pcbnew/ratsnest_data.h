@@ -107,6 +107,16 @@ public:
     void Update();
     void Clear();
 
+    /**
+     * Function SetIncremental()
+     * Chooses between updating the triangulation of the net in place, when only some of its
+     * nodes have moved, and building it from scratch at every update.
+     */
+    void SetIncremental( bool aEnabled )
+    {
+        m_incremental = aEnabled;
+    }
+
     void AddCluster( std::shared_ptr<CN_CLUSTER> aCluster );
 
     unsigned int GetNodeCount() const
@@ -160,6 +170,9 @@ protected:
     ///> Flag indicating necessity of recalculation of ratsnest for a net.
     bool m_dirty;
 
+    ///> Keep the triangulation between updates and only move the nodes which changed
+    bool m_incremental;
+
     class TRIANGULATOR_STATE;
 
     std::shared_ptr<TRIANGULATOR_STATE> m_triangulator;
@@ -126,6 +126,8 @@ bool DRAGGER::startDragVia( const VECTOR2D& aP, VIA* aVia )
 
 bool DRAGGER::Start( const VECTOR2I& aP, ITEM* aStartItem )
 {
+    ALGO_TIMER timer( Router(), PA_DRAGGER );
+
     m_shove = new SHOVE( m_world, Router() );
     m_lastNode = NULL;
     m_draggedItems.Clear();
@@ -337,6 +339,8 @@ bool DRAGGER::FixRoute()
 
 bool DRAGGER::Drag( const VECTOR2I& aP )
 {
+    ALGO_TIMER timer( Router(), PA_DRAGGER );
+
     if( m_freeAngleMode )
         return dragMarkObstacles( aP );
 
@@ -432,6 +432,9 @@ public:
 
     void AddLine( const SHAPE_LINE_CHAIN& aLine, int aType, int aWidth ) override
     {
+        if( !m_view )
+            return;
+
         ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( NULL, m_view );
 
         pitem->Line( aLine, aWidth, aType );
@@ -468,8 +471,10 @@ PNS_KICAD_IFACE::PNS_KICAD_IFACE()
     m_view = nullptr;
     m_previewItems = nullptr;
     m_router = nullptr;
-    m_debugDecorator = nullptr;
     m_dispOptions = nullptr;
+
+    // Replaced by one drawing in the view by SetView()
+    m_debugDecorator = new PNS_PCBNEW_DEBUG_DECORATOR();
 }
 
 
@@ -1076,6 +1081,9 @@ void PNS_KICAD_IFACE::SyncWorld( PNS::NODE *aWorld )
 
 void PNS_KICAD_IFACE::EraseView()
 {
+    if( !m_view )
+        return;
+
     for( auto item : m_hiddenItems )
         m_view->SetVisible( item, true );
 
@@ -1096,6 +1104,9 @@ void PNS_KICAD_IFACE::DisplayItem( const PNS::ITEM* aItem, int aColor, int aClea
 {
     wxLogTrace( "PNS", "DisplayItem %p", aItem );
 
+    if( !m_view )
+        return;
+
     ROUTER_PREVIEW_ITEM* pitem = new ROUTER_PREVIEW_ITEM( aItem, m_view );
 
     if( aColor >= 0 )
@@ -1142,7 +1153,7 @@ void PNS_KICAD_IFACE::HideItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* parent = aItem->Parent();
 
-    if( parent )
+    if( parent && m_view )
     {
         if( m_view->IsVisible( parent ) )
             m_hiddenItems.insert( parent );
@@ -1157,7 +1168,7 @@ void PNS_KICAD_IFACE::RemoveItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* parent = aItem->Parent();
 
-    if( parent )
+    if( parent && m_commit )
     {
         m_commit->Remove( parent );
     }
@@ -1168,6 +1179,10 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 {
     BOARD_CONNECTED_ITEM* newBI = NULL;
 
+    // Without a host tool, the routed items are kept in the router world only
+    if( !m_commit )
+        return;
+
     switch( aItem->Kind() )
     {
     case PNS::ITEM::SEGMENT_T:
@@ -1216,6 +1231,10 @@ void PNS_KICAD_IFACE::AddItem( PNS::ITEM* aItem )
 void PNS_KICAD_IFACE::Commit()
 {
     EraseView();
+
+    if( !m_commit )
+        return;
+
     m_commit->Push( _( "Added a track" ) );
     m_commit.reset( new BOARD_COMMIT( m_tool ) );
 }
@@ -39,6 +39,12 @@ namespace KIGFX
     class VIEW;
 }
 
+/**
+ * Class PNS_KICAD_IFACE
+ * connects the router to a BOARD.  Without a view, nothing is displayed, and without a host
+ * tool the routed items are not committed to the board: the router world is the only one
+ * updated, which allows running the router headless.
+ */
 class PNS_KICAD_IFACE : public PNS::ROUTER_IFACE {
 public:
     PNS_KICAD_IFACE();
@@ -19,6 +19,9 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <atomic>
+#include <future>
+
 #include <core/optional.h>
 
 #include "pns_node.h"
@@ -31,6 +34,7 @@
 #include "pns_debug_decorator.h"
 
 #include <class_board_item.h>
+#include <thread_pool.h>
 
 namespace PNS {
 
@@ -620,10 +624,38 @@ bool LINE_PLACER::rhShoveOnly( const VECTOR2I& aP, LINE& aNewHead )
         return false;
     }
 
+    std::atomic<bool> shoveDone( false );
+    std::future<void> walkFallback;
+    LINE walkFull;
+
+    if( Settings().ConcurrentSearch() )
+    {
+        // Compute the walkaround used if the shove fails on a pool thread, during the shove.
+        // It reads the node the shove branches from, which the shove leaves as is.
+        walkaround.SetWorld( m_shove->ShoveBase( l ) );
+        walkaround.SetSolidsOnly( false );
+        walkaround.SetIterationLimit( 10 );
+        walkaround.SetApproachCursor( true, aP );
+        walkaround.SetCancelFlag( &shoveDone );
+
+        walkFallback = THREAD_POOL::GetPool().Submit( [&]()
+                                                      {
+                                                          walkaround.Route( initTrack, walkFull );
+                                                      } );
+    }
+
     SHOVE::SHOVE_STATUS status = m_shove->ShoveLines( l );
 
     m_currentNode = m_shove->CurrentNode();
 
+    if( walkFallback.valid() )
+    {
+        if( status == SHOVE::SH_OK || status == SHOVE::SH_HEAD_MODIFIED )
+            shoveDone = true;
+
+        walkFallback.wait();
+    }
+
     if( status == SHOVE::SH_OK  || status == SHOVE::SH_HEAD_MODIFIED )
     {
         if( status == SHOVE::SH_HEAD_MODIFIED )
@@ -642,11 +674,19 @@ bool LINE_PLACER::rhShoveOnly( const VECTOR2I& aP, LINE& aNewHead )
     }
     else
     {
-        walkaround.SetWorld( m_currentNode );
-        walkaround.SetSolidsOnly( false );
-        walkaround.SetIterationLimit( 10 );
-        walkaround.SetApproachCursor( true, aP );
-        walkaround.Route( initTrack, l2 );
+        if( walkFallback.valid() )
+        {
+            l2 = walkFull;
+        }
+        else
+        {
+            walkaround.SetWorld( m_currentNode );
+            walkaround.SetSolidsOnly( false );
+            walkaround.SetIterationLimit( 10 );
+            walkaround.SetApproachCursor( true, aP );
+            walkaround.Route( initTrack, l2 );
+        }
+
         aNewHead = l2.ClipToNearestObstacle( m_shove->CurrentNode() );
 
         return false;
@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <fstream>
+
 #include "pns_logger.h"
 #include "pns_item.h"
 #include "pns_via.h"
@@ -37,6 +39,7 @@ namespace PNS {
 LOGGER::LOGGER( )
 {
     m_groupOpened = false;
+    m_eventCount = 0;
 }
 
 
@@ -49,6 +52,55 @@ void LOGGER::Clear()
 {
     m_theLog.str( std::string() );
     m_groupOpened = false;
+    m_eventCount = 0;
+}
+
+
+void LOGGER::LogEvent( const EVENT_ENTRY& aEvent )
+{
+    m_theLog << "event " << aEvent.m_type << " " << aEvent.m_p.x << " " << aEvent.m_p.y << " "
+             << aEvent.m_param << " " << aEvent.m_routerMode << " " << aEvent.m_routingMode << " "
+             << aEvent.m_trackWidth << " " << aEvent.m_viaDiameter << " " << aEvent.m_viaDrill
+             << " " << aEvent.m_itemKind << " " << aEvent.m_itemNet << " "
+             << aEvent.m_itemLayerStart << " " << aEvent.m_itemLayerEnd << std::endl;
+
+    m_eventCount++;
+}
+
+
+bool LOGGER::LoadEvents( const std::string& aFilename, std::vector<EVENT_ENTRY>& aEvents )
+{
+    std::ifstream file( aFilename );
+
+    if( !file )
+        return false;
+
+    std::string line;
+
+    while( std::getline( file, line ) )
+    {
+        std::istringstream fields( line );
+        std::string        tag;
+        int                type;
+        EVENT_ENTRY        evt;
+
+        fields >> tag;
+
+        if( tag != "event" )
+            continue;
+
+        fields >> type >> evt.m_p.x >> evt.m_p.y >> evt.m_param >> evt.m_routerMode
+               >> evt.m_routingMode >> evt.m_trackWidth >> evt.m_viaDiameter >> evt.m_viaDrill
+               >> evt.m_itemKind >> evt.m_itemNet >> evt.m_itemLayerStart >> evt.m_itemLayerEnd;
+
+        if( !fields || type < EVT_START_ROUTE || type > EVT_STOP )
+            return false;
+
+        evt.m_type = (EVENT_TYPE) type;
+        aEvents.push_back( evt );
+    }
+
+    return true;
 }
 
 
@@ -39,12 +39,54 @@ class ITEM;
 class LOGGER
 {
 public:
+    ///> Interactive routing events, see ROUTER::SetEventLogger()
+    enum EVENT_TYPE
+    {
+        EVT_START_ROUTE = 0,
+        EVT_START_DRAG,
+        EVT_MOVE,
+        EVT_FIX,
+        EVT_STOP
+    };
+
+    ///> A routing event, with what is needed to replay it on the same board
+    struct EVENT_ENTRY
+    {
+        EVENT_TYPE  m_type;
+        VECTOR2I    m_p;
+        int         m_param;        ///< layer of a route start, drag mode of a drag start,
+                                    ///< force finish flag of a fix
+        int         m_routerMode;   ///< ROUTER_MODE
+        int         m_routingMode;  ///< PNS_MODE (shove, walkaround...)
+        int         m_trackWidth;
+        int         m_viaDiameter;
+        int         m_viaDrill;
+
+        ///> The item passed to the router (start item or end item), 0 kind if none
+        int         m_itemKind;
+        int         m_itemNet;
+        int         m_itemLayerStart;
+        int         m_itemLayerEnd;
+    };
+
     LOGGER();
     ~LOGGER();
 
     void Save( const std::string& aFilename );
     void Clear();
 
+    void LogEvent( const EVENT_ENTRY& aEvent );
+
+    ///> Returns the number of events logged since the last Clear()
+    int EventCount() const { return m_eventCount; }
+
+    /**
+     * Function LoadEvents
+     * reads the events of a log written by Save(), ignoring the other lines.
+     * @return false if the file cannot be read.
+     */
+    static bool LoadEvents( const std::string& aFilename, std::vector<EVENT_ENTRY>& aEvents );
+
     void NewGroup( const std::string& aName, int aIter = 0 );
     void EndGroup();
 
@@ -57,6 +99,7 @@ private:
     void dumpShape( const SHAPE* aSh );
 
     bool m_groupOpened;
+    int m_eventCount;
     std::stringstream m_theLog;
 };
 
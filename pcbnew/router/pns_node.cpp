@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <cassert>
+#include <mutex>
 
 #include <math/vector2d.h>
 
@@ -43,6 +44,16 @@ namespace PNS {
 
 #ifdef DEBUG
 static std::unordered_set<NODE*> allocNodes;
+
+// The walkaround of the concurrent search queries the nodes from the thread pool, while the
+// shove creates and deletes branches on the main thread.
+static std::mutex allocNodesLock;
+
+static bool isAllocNode( NODE* aNode )
+{
+    std::lock_guard<std::mutex> lock( allocNodesLock );
+    return allocNodes.find( aNode ) != allocNodes.end();
+}
 #endif
 
 NODE::NODE()
@@ -56,7 +67,10 @@ NODE::NODE()
     m_index = new INDEX;
 
 #ifdef DEBUG
-    allocNodes.insert( this );
+    {
+        std::lock_guard<std::mutex> lock( allocNodesLock );
+        allocNodes.insert( this );
+    }
 #endif
 }
 
@@ -72,13 +86,15 @@ NODE::~NODE()
     }
 
 #ifdef DEBUG
-    if( allocNodes.find( this ) == allocNodes.end() )
     {
-        wxLogTrace( "PNS", "attempting to free an already-free'd node." );
-        assert( false );
-    }
+        std::lock_guard<std::mutex> lock( allocNodesLock );
 
-    allocNodes.erase( this );
+        if( allocNodes.erase( this ) == 0 )
+        {
+            wxLogTrace( "PNS", "attempting to free an already-free'd node." );
+            assert( false );
+        }
+    }
 #endif
 
     m_joints.clear();
@@ -280,7 +296,7 @@ int NODE::QueryColliding( const ITEM* aItem,
     DEFAULT_OBSTACLE_VISITOR visitor( aObstacles, aItem, aKindMask, aDifferentNetsOnly );
 
 #ifdef DEBUG
-    assert( allocNodes.find( this ) != allocNodes.end() );
+    assert( isAllocNode( this ) );
 #endif
 
     visitor.SetCountLimit( aLimitCount );
@@ -553,6 +553,8 @@ bool OPTIMIZER::mergeFull( LINE* aLine )
 
 bool OPTIMIZER::Optimize( LINE* aLine, LINE* aResult )
 {
+    ALGO_TIMER timer( ROUTER::GetInstance(), PA_OPTIMIZER );
+
     if( !aResult )
         aResult = aLine;
     else
@@ -1226,6 +1228,8 @@ bool OPTIMIZER::mergeDpSegments( DIFF_PAIR* aPair )
 
 bool OPTIMIZER::Optimize( DIFF_PAIR* aPair )
 {
+    ALGO_TIMER timer( ROUTER::GetInstance(), PA_OPTIMIZER );
+
     return mergeDpSegments( aPair );
 }
 
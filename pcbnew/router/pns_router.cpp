@@ -72,6 +72,10 @@ ROUTER::ROUTER()
     m_snapshotIter = 0;
     m_violation = false;
     m_iface = nullptr;
+    m_eventLogger = nullptr;
+    m_profiling = false;
+
+    ResetAlgoTimes();
 }
 
 
@@ -126,6 +130,7 @@ const ITEM_SET ROUTER::QueryHoverItems( const VECTOR2I& aP )
 
 bool ROUTER::StartDragging( const VECTOR2I& aP, ITEM* aStartItem, int aDragMode )
 {
+    logEvent( LOGGER::EVT_START_DRAG, aP, aStartItem, aDragMode );
 
     if( aDragMode & DM_FREE_ANGLE )
         m_forceMarkObstaclesMode = true;
@@ -175,6 +180,7 @@ bool ROUTER::isStartingPointRoutable( const VECTOR2I& aWhere, int aLayer )
 
 bool ROUTER::StartRouting( const VECTOR2I& aP, ITEM* aStartItem, int aLayer )
 {
+    logEvent( LOGGER::EVT_START_ROUTE, aP, aStartItem, aLayer );
 
     if( ! isStartingPointRoutable( aP, aLayer ) )
     {
@@ -230,6 +236,8 @@ void ROUTER::DisplayItems( const ITEM_SET& aItems )
 
 void ROUTER::Move( const VECTOR2I& aP, ITEM* endItem )
 {
+    logEvent( LOGGER::EVT_MOVE, aP, endItem, 0 );
+
     m_currentEnd = aP;
 
     switch( m_state )
@@ -373,6 +381,8 @@ void ROUTER::CommitRouting( NODE* aNode )
 
 bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 {
+    logEvent( LOGGER::EVT_FIX, aP, aEndItem, aForceFinish ? 1 : 0 );
+
     bool rv = false;
 
     switch( m_state )
@@ -398,6 +408,9 @@ bool ROUTER::FixRoute( const VECTOR2I& aP, ITEM* aEndItem, bool aForceFinish )
 
 void ROUTER::StopRouting()
 {
+    if( RoutingInProgress() )
+        logEvent( LOGGER::EVT_STOP, m_currentEnd, nullptr, 0 );
+
     // Update the ratsnest with new changes
 
     if( m_placer )
@@ -505,6 +518,38 @@ bool ROUTER::IsPlacingVia() const
 }
 
 
+void ROUTER::ResetAlgoTimes()
+{
+    for( auto& time : m_algoTime )
+        time = 0;
+}
+
+
+void ROUTER::logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                       int aParam )
+{
+    if( !m_eventLogger )
+        return;
+
+    LOGGER::EVENT_ENTRY evt;
+
+    evt.m_type = aType;
+    evt.m_p = aP;
+    evt.m_param = aParam;
+    evt.m_routerMode = m_mode;
+    evt.m_routingMode = m_settings.Mode();
+    evt.m_trackWidth = m_sizes.TrackWidth();
+    evt.m_viaDiameter = m_sizes.ViaDiameter();
+    evt.m_viaDrill = m_sizes.ViaDrill();
+    evt.m_itemKind = aItem ? aItem->Kind() : 0;
+    evt.m_itemNet = aItem ? aItem->Net() : 0;
+    evt.m_itemLayerStart = aItem ? aItem->Layers().Start() : 0;
+    evt.m_itemLayerEnd = aItem ? aItem->Layers().End() : 0;
+
+    m_eventLogger->LogEvent( evt );
+}
+
+
 void ROUTER::SetOrthoMode( bool aEnable )
 {
     if( !m_placer )
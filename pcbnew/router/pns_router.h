@@ -22,6 +22,9 @@
 #ifndef __PNS_ROUTER_H
 #define __PNS_ROUTER_H
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <list>
 
 #include <memory>
@@ -35,6 +38,7 @@
 #include "pns_item.h"
 #include "pns_itemset.h"
 #include "pns_node.h"
+#include "pns_logger.h"
 
 namespace KIGFX
 {
@@ -77,6 +81,17 @@ enum DRAG_MODE
     DM_FREE_ANGLE = 0x8,
     DM_ANY = 0x7
 };
+
+///> The algorithms whose time the router can measure, see ROUTER::SetProfiling()
+enum PROFILED_ALGO
+{
+    PA_SHOVE = 0,
+    PA_WALKAROUND,
+    PA_DRAGGER,
+    PA_OPTIMIZER,
+    PA_COUNT
+};
+
 /**
  * Class ROUTER
  *
@@ -220,7 +235,35 @@ public:
         return m_iface;
     }
 
+    /**
+     * Function SetEventLogger
+     * records the routing and dragging events (start, move, fix and stop) in aLogger, so
+     * they can be replayed on the same board.  NULL stops recording.
+     */
+    void SetEventLogger( LOGGER* aLogger ) { m_eventLogger = aLogger; }
+
+    /**
+     * Function SetProfiling
+     * enables measuring the time spent in the SHOVE, WALKAROUND, DRAGGER and OPTIMIZER
+     * algorithms.  The time of an algorithm includes the time of the algorithms it calls.
+     */
+    void SetProfiling( bool aEnable ) { m_profiling = aEnable; }
+    bool IsProfiling() const { return m_profiling; }
+
+    ///> Returns the time spent in aAlgo since the last ResetAlgoTimes(), in microseconds
+    int64_t AlgoTime( PROFILED_ALGO aAlgo ) const { return m_algoTime[aAlgo]; }
+
+    void AddAlgoTime( PROFILED_ALGO aAlgo, int64_t aMicroseconds )
+    {
+        m_algoTime[aAlgo] += aMicroseconds;
+    }
+
+    void ResetAlgoTimes();
+
 private:
+    void logEvent( LOGGER::EVENT_TYPE aType, const VECTOR2I& aP, const ITEM* aItem,
+                   int aParam );
+
     void movePlacing( const VECTOR2I& aP, ITEM* aItem );
     void moveDragging( const VECTOR2I& aP, ITEM* aItem );
 
@@ -271,6 +314,44 @@ private:
 
     wxString m_toolStatusbarName;
     wxString m_failureReason;
+
+    LOGGER* m_eventLogger;
+
+    bool m_profiling;
+    std::atomic<int64_t> m_algoTime[PA_COUNT];
+};
+
+
+/**
+ * Class ALGO_TIMER
+ * adds the time spent in its scope to the time of an algorithm, if the router measures
+ * its algorithms.
+ */
+class ALGO_TIMER
+{
+public:
+    ALGO_TIMER( ROUTER* aRouter, PROFILED_ALGO aAlgo ) :
+        m_router( aRouter && aRouter->IsProfiling() ? aRouter : nullptr ),
+        m_algo( aAlgo )
+    {
+        if( m_router )
+            m_start = std::chrono::steady_clock::now();
+    }
+
+    ~ALGO_TIMER()
+    {
+        if( m_router )
+        {
+            auto elapsed = std::chrono::steady_clock::now() - m_start;
+            m_router->AddAlgoTime( m_algo,
+                    std::chrono::duration_cast<std::chrono::microseconds>( elapsed ).count() );
+        }
+    }
+
+private:
+    ROUTER*                               m_router;
+    PROFILED_ALGO                         m_algo;
+    std::chrono::steady_clock::time_point m_start;
 };
 
 }
@@ -47,6 +47,7 @@ ROUTING_SETTINGS::ROUTING_SETTINGS()
     m_inlineDragEnabled = false;
     m_snapToTracks = false;
     m_snapToPads = false;
+    m_concurrentSearch = false;
 }
 
 
@@ -142,6 +142,13 @@ public:
     bool GetSnapToTracks() const { return m_snapToTracks; }
     bool GetSnapToPads() const { return m_snapToPads; }
 
+    ///> Returns true if the alternative searches of the router (the two walkaround directions,
+    ///> the shove and the walkaround replacing it) run concurrently.  Not saved.
+    bool ConcurrentSearch() const { return m_concurrentSearch; }
+
+    ///> Enables/disables concurrent searches.
+    void SetConcurrentSearch( bool aEnable ) { m_concurrentSearch = aEnable; }
+
 private:
     bool m_shoveVias;
     bool m_startDiagonal;
@@ -156,6 +163,7 @@ private:
     bool m_inlineDragEnabled;
     bool m_snapToTracks;
     bool m_snapToPads;
+    bool m_concurrentSearch;
 
     PNS_MODE m_routingMode;
     PNS_OPTIMIZATION_EFFORT m_optimizerEffort;
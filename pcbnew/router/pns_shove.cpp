@@ -1086,6 +1086,7 @@ OPT_BOX2I SHOVE::totalAffectedArea() const
 
 SHOVE::SHOVE_STATUS SHOVE::ShoveLines( const LINE& aCurrentHead )
 {
+    ALGO_TIMER timer( Router(), PA_SHOVE );
     SHOVE_STATUS st = SH_OK;
 
     m_multiLineMode = false;
@@ -1187,6 +1188,7 @@ SHOVE::SHOVE_STATUS SHOVE::ShoveLines( const LINE& aCurrentHead )
 
 SHOVE::SHOVE_STATUS SHOVE::ShoveMultiLines( const ITEM_SET& aHeadSet )
 {
+    ALGO_TIMER timer( Router(), PA_SHOVE );
     SHOVE_STATUS st = SH_OK;
 
     m_multiLineMode = true;
@@ -1271,6 +1273,7 @@ SHOVE::SHOVE_STATUS SHOVE::ShoveMultiLines( const ITEM_SET& aHeadSet )
 SHOVE::SHOVE_STATUS SHOVE::ShoveDraggingVia( VIA* aVia, const VECTOR2I& aWhere,
                                                      VIA** aNewVia )
 {
+    ALGO_TIMER timer( Router(), PA_SHOVE );
     SHOVE_STATUS st = SH_OK;
 
     m_lineStack.clear();
@@ -1405,6 +1408,20 @@ NODE* SHOVE::CurrentNode()
 }
 
 
+NODE* SHOVE::ShoveBase( const LINE& aHead )
+{
+    if( aHead.SegmentCount() || aHead.EndsWithVia() )
+    {
+        ITEM_SET headSet;
+        headSet.Add( aHead );
+
+        reduceSpringback( headSet );
+    }
+
+    return CurrentNode();
+}
+
+
 const LINE SHOVE::NewHead() const
 {
     assert( m_newHead );
@@ -81,6 +81,15 @@ public:
 
     NODE* CurrentNode();
 
+    /**
+     * Function ShoveBase()
+     *
+     * Drops the springback nodes aHead does not collide with, as ShoveLines( aHead ) does
+     * first.  ShoveLines( aHead ) then branches the returned node without changing it (and
+     * returns to it if the shove fails), so other threads may read it meanwhile.
+     */
+    NODE* ShoveBase( const LINE& aHead );
+
     const LINE NewHead() const;
 
     void SetInitialLine( LINE& aInitial );
@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <wx/datetime.h>
+#include <wx/filename.h>
 #include <wx/numdlg.h>
 
 #include <functional>
@@ -30,6 +32,7 @@ using namespace std::placeholders;
 #include <pcb_edit_frame.h>
 #include <id.h>
 #include <macros.h>
+#include <advanced_config.h>
 #include <pcbnew_id.h>
 #include <view/view_controls.h>
 #include <pcb_painter.h>
@@ -80,6 +83,8 @@ TOOL_BASE::TOOL_BASE( const std::string& aToolName ) :
 
 TOOL_BASE::~TOOL_BASE()
 {
+    saveEventLog();
+
     delete m_gridHelper;
     delete m_iface;
     delete m_router;
@@ -89,6 +94,8 @@ TOOL_BASE::~TOOL_BASE()
 
 void TOOL_BASE::Reset( RESET_REASON aReason )
 {
+    saveEventLog();
+
     delete m_gridHelper;
     delete m_iface;
     delete m_router;
@@ -103,13 +110,38 @@ void TOOL_BASE::Reset( RESET_REASON aReason )
     m_router->SetInterface( m_iface );
     m_router->ClearWorld();
     m_router->SyncWorld();
+    m_savedSettings.SetConcurrentSearch( ADVANCED_CFG::GetCfg().m_concurrentRouterSearch );
     m_router->LoadSettings( m_savedSettings );
     m_router->UpdateSizes( m_savedSizes );
 
+    if( ADVANCED_CFG::GetCfg().m_recordRouterEvents )
+    {
+        m_eventLog.reset( new LOGGER );
+        m_router->SetEventLogger( m_eventLog.get() );
+    }
+
     m_gridHelper = new GRID_HELPER( frame() );
 }
 
 
+void TOOL_BASE::saveEventLog()
+{
+    if( !m_eventLog || m_eventLog->EventCount() == 0 )
+        return;
+
+    wxString   name = wxString::Format( "pns_events_%s_%s.log",
+                                        wxDateTime::Now().Format( "%Y%m%d_%H%M%S" ),
+                                        GetName() );
+    wxFileName fn( wxFileName::GetTempDir(), name );
+
+    wxLogTrace( "PNS", "Saving %d routing events to '%s'", m_eventLog->EventCount(),
+                fn.GetFullPath() );
+
+    m_eventLog->Save( fn.GetFullPath().ToStdString() );
+    m_eventLog.reset();
+}
+
+
 ITEM* TOOL_BASE::pickSingleItem( const VECTOR2I& aWhere, int aNet, int aLayer, bool aIgnorePads,
 								 const std::vector<ITEM*> aAvoidItems)
 {
@@ -61,6 +61,9 @@ protected:
     virtual void updateEndItem( const TOOL_EVENT& aEvent );
     void deleteTraces( ITEM* aStartItem, bool aWholeTrack );
 
+    ///> Writes the recorded routing events, if any, see ADVANCED_CFG::m_recordRouterEvents
+    void saveEventLog();
+
     MSG_PANEL_ITEMS m_panelItems;
 
     ROUTING_SETTINGS m_savedSettings;     ///< Stores routing settings between router invocations
@@ -76,6 +79,7 @@ protected:
     GRID_HELPER* m_gridHelper;
     PNS_KICAD_IFACE* m_iface;
     ROUTER* m_router;
+    std::unique_ptr<LOGGER> m_eventLog;
 };
 
 }
@@ -19,6 +19,8 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <climits>
+
 #include <core/optional.h>
 
 #include <geometry/shape_line_chain.h>
@@ -28,6 +30,8 @@
 #include "pns_utils.h"
 #include "pns_router.h"
 
+#include <thread_pool.h>
+
 namespace PNS {
 
 void WALKAROUND::start( const LINE& aInitialPath )
@@ -52,7 +56,8 @@ NODE::OPT_OBSTACLE WALKAROUND::nearestObstacle( const LINE& aPath )
 
 
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
-                                                              bool aWindingDirection )
+                                                              bool aWindingDirection,
+                                                              int& aBlockageCount )
 {
     OPT<OBSTACLE>& current_obs =
         aWindingDirection ? m_currentObstacle[0] : m_currentObstacle[1];
@@ -68,9 +73,9 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 
     if( ( current_obs->m_hull ).PointInside( last ) || ( current_obs->m_hull ).PointOnEdge( last ) )
     {
-        m_recursiveBlockageCount++;
+        aBlockageCount++;
 
-        if( m_recursiveBlockageCount < 3 )
+        if( aBlockageCount < 3 )
             aPath.Line().Append( current_obs->m_hull.NearestPoint( last ) );
         else
         {
@@ -88,12 +93,16 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
         return STUCK;
 
 #ifdef DEBUG
-    m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
-    m_logger.Log( &path_walk[0], 0, "path-walk" );
-    m_logger.Log( &path_pre[0], 1, "path-pre" );
-    m_logger.Log( &path_post[0], 4, "path-post" );
-    m_logger.Log( &current_obs->m_hull, 2, "hull" );
-    m_logger.Log( current_obs->m_item, 3, "item" );
+    // the logger is shared by both directions
+    if( !m_concurrent )
+    {
+        m_logger.NewGroup( aWindingDirection ? "walk-cw" : "walk-ccw", m_iteration );
+        m_logger.Log( &path_walk[0], 0, "path-walk" );
+        m_logger.Log( &path_pre[0], 1, "path-pre" );
+        m_logger.Log( &path_post[0], 4, "path-post" );
+        m_logger.Log( &current_obs->m_hull, 2, "hull" );
+        m_logger.Log( current_obs->m_item, 3, "item" );
+    }
 #endif
 
     int len_pre = path_walk[0].Length();
@@ -144,12 +153,56 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::singleStep( LINE& aPath,
 }
 
 
+void WALKAROUND::walkConcurrently( LINE& aPathCw, LINE& aPathCcw, DIRECTION_RESULT aResult[2] )
+{
+    LINE* paths[2] = { &aPathCw, &aPathCcw };
+
+    // Route() takes the path of the first direction done (unless it wants the longer one), so
+    // the other direction can stop after the iteration at which a path was found.  Both
+    // directions only read m_world.
+    std::atomic<int> doneIteration( INT_MAX );
+
+    THREAD_POOL::GetPool().ParallelFor( 2,
+            [&]( size_t aDir )
+            {
+                WALKAROUND_STATUS st = IN_PROGRESS;
+                int blockageCount = 0;
+                int iteration;
+
+                for( iteration = 0; iteration < m_iterationLimit; iteration++ )
+                {
+                    if( iteration > doneIteration || cancelled() )
+                        break;
+
+                    st = singleStep( *paths[aDir], aDir == 0, blockageCount );
+
+                    if( st != IN_PROGRESS )
+                        break;
+                }
+
+                if( st == DONE && !m_forceLongerPath )
+                {
+                    int prev = doneIteration;
+
+                    while( iteration < prev
+                            && !doneIteration.compare_exchange_weak( prev, iteration ) )
+                        ;
+                }
+
+                aResult[aDir].m_status = st;
+                aResult[aDir].m_lastIteration = iteration;
+            } );
+}
+
+
 WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         LINE& aWalkPath, bool aOptimize )
 {
+    ALGO_TIMER timer( Router(), PA_WALKAROUND );
     LINE path_cw( aInitialPath ), path_ccw( aInitialPath );
     WALKAROUND_STATUS s_cw = IN_PROGRESS, s_ccw = IN_PROGRESS;
     SHAPE_LINE_CHAIN best_path;
+    DIRECTION_RESULT result[2];
 
     // special case for via-in-the-middle-of-track placement
     if( aInitialPath.PointCount() <= 1 )
@@ -177,13 +230,35 @@ WALKAROUND::WALKAROUND_STATUS WALKAROUND::Route( const LINE& aInitialPath,
         m_forceSingleDirection = false;
     }
 
+    m_concurrent = !m_forceWinding && Settings().ConcurrentSearch();
+
+    if( m_concurrent )
+    {
+        walkConcurrently( path_cw, path_ccw, result );
+
+        if( cancelled() )
+            return STUCK;
+    }
+
     while( m_iteration < m_iterationLimit )
     {
-        if( s_cw != STUCK )
-            s_cw = singleStep( path_cw, true );
+        if( cancelled() )
+            return STUCK;
 
-        if( s_ccw != STUCK )
-            s_ccw = singleStep( path_ccw, false );
+        if( m_concurrent )
+        {
+            // replay the states the directions had at this iteration, with both steps made
+            s_cw = m_iteration < result[0].m_lastIteration ? IN_PROGRESS : result[0].m_status;
+            s_ccw = m_iteration < result[1].m_lastIteration ? IN_PROGRESS : result[1].m_status;
+        }
+        else
+        {
+            if( s_cw != STUCK )
+                s_cw = singleStep( path_cw, true, m_recursiveBlockageCount );
+
+            if( s_ccw != STUCK )
+                s_ccw = singleStep( path_ccw, false, m_recursiveBlockageCount );
+        }
 
         if( ( s_cw == DONE && s_ccw == DONE ) || ( s_cw == STUCK && s_ccw == STUCK ) )
         {
@@ -22,6 +22,7 @@
 #ifndef __PNS_WALKAROUND_H
 #define __PNS_WALKAROUND_H
 
+#include <atomic>
 #include <set>
 
 #include "pns_line.h"
@@ -53,6 +54,8 @@ public:
         m_recursiveCollision[0] = m_recursiveCollision[1] = false;
         m_iteration = 0;
         m_forceCw = false;
+        m_concurrent = false;
+        m_cancelled = nullptr;
     }
 
     ~WALKAROUND() {};
@@ -118,6 +121,12 @@ public:
             m_restrictedSet.clear();
     }
 
+    ///> Makes Route() give up, returning STUCK, once *aCancelled is set by another thread.
+    void SetCancelFlag( const std::atomic<bool>* aCancelled )
+    {
+        m_cancelled = aCancelled;
+    }
+
     WALKAROUND_STATUS Route( const LINE& aInitialPath, LINE& aWalkPath,
             bool aOptimize = true );
 
@@ -127,11 +136,27 @@ public:
     }
 
 private:
+    ///> Outcome of the search in one winding direction, run by walkConcurrently()
+    struct DIRECTION_RESULT
+    {
+        WALKAROUND_STATUS m_status;
+        int m_lastIteration;        ///> iteration at which the search ended
+    };
+
     void start( const LINE& aInitialPath );
 
-    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection );
+    bool cancelled() const
+    {
+        return m_cancelled && *m_cancelled;
+    }
+
+    WALKAROUND_STATUS singleStep( LINE& aPath, bool aWindingDirection, int& aBlockageCount );
     NODE::OPT_OBSTACLE nearestObstacle( const LINE& aPath );
 
+    ///> Runs the searches in both directions on the thread pool, each until it ends or until
+    ///> the other one found a path at an earlier iteration.
+    void walkConcurrently( LINE& aPathCw, LINE& aPathCcw, DIRECTION_RESULT aResult[2] );
+
     NODE* m_world;
 
     int m_recursiveBlockageCount;
@@ -142,6 +167,8 @@ private:
     bool m_cursorApproachMode;
     bool m_forceWinding;
     bool m_forceCw;
+    bool m_concurrent;
+    const std::atomic<bool>* m_cancelled;
     VECTOR2I m_cursorPos;
     NODE::OPT_OBSTACLE m_currentObstacle[2];
     bool m_recursiveCollision[2];
@@ -57,6 +57,7 @@
 
 #include "specctra.h"
 #include <macros.h>
+#include <numeric_io.h>
 
 
 namespace DSN {
@@ -581,7 +582,7 @@ void SPECCTRA_DB::doSPECCTRA_LAYER_PAIR( SPECCTRA_LAYER_PAIR* growth )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->layer_weight = strtod( CurText(), 0 );
+    growth->layer_weight = ParseDouble( CurText() );
 
     NeedRIGHT();
 }
@@ -1021,7 +1022,7 @@ void SPECCTRA_DB::doPATH( PATH* growth )
     if( NextTok() != T_NUMBER )
         Expecting( "aperture_width" );
 
-    growth->aperture_width = strtod( CurText(), NULL );
+    growth->aperture_width = ParseDouble( CurText() );
 
     POINT   ptTemp;
 
@@ -1031,11 +1032,11 @@ void SPECCTRA_DB::doPATH( PATH* growth )
     {
         if( tok != T_NUMBER )
             Expecting( T_NUMBER );
-        ptTemp.x = strtod( CurText(), NULL );
+        ptTemp.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        ptTemp.y = strtod( CurText(), NULL );
+        ptTemp.y = ParseDouble( CurText() );
 
         growth->points.push_back( ptTemp );
 
@@ -1064,19 +1065,19 @@ void SPECCTRA_DB::doRECTANGLE( RECTANGLE* growth )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point0.x = strtod( CurText(), NULL );
+    growth->point0.x = ParseDouble( CurText() );
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point0.y = strtod( CurText(), NULL );
+    growth->point0.y = ParseDouble( CurText() );
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point1.x = strtod( CurText(), NULL );
+    growth->point1.x = ParseDouble( CurText() );
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->point1.y = strtod( CurText(), NULL );
+    growth->point1.y = ParseDouble( CurText() );
 
     NeedRIGHT();
 }
@@ -1091,16 +1092,16 @@ void SPECCTRA_DB::doCIRCLE( CIRCLE* growth )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->diameter = strtod( CurText(), 0 );
+    growth->diameter = ParseDouble( CurText() );
 
     tok = NextTok();
     if( tok == T_NUMBER )
     {
-        growth->vertex.x = strtod( CurText(), 0 );
+        growth->vertex.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->vertex.y = strtod( CurText(), 0 );
+        growth->vertex.y = ParseDouble( CurText() );
 
         tok = NextTok();
     }
@@ -1117,17 +1118,17 @@ void SPECCTRA_DB::doQARC( QARC* growth )
 
     if( NextTok() != T_NUMBER )
         Expecting( T_NUMBER );
-    growth->aperture_width = strtod( CurText(), 0 );
+    growth->aperture_width = ParseDouble( CurText() );
 
     for( int i=0;  i<3;  ++i )
     {
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->vertex[i].x = strtod( CurText(), 0 );
+        growth->vertex[i].x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->vertex[i].y = strtod( CurText(), 0 );
+        growth->vertex[i].y = ParseDouble( CurText() );
     }
 
     NeedRIGHT();
@@ -1659,7 +1660,7 @@ void SPECCTRA_DB::doGRID( GRID* growth )
         growth->grid_type = tok;
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        growth->dimension = strtod( CurText(), 0 );
+        growth->dimension = ParseDouble( CurText() );
         tok = NextTok();
         if( tok == T_LEFT )
         {
@@ -1684,7 +1685,7 @@ void SPECCTRA_DB::doGRID( GRID* growth )
                     if( NextTok() != T_NUMBER )
                         Expecting( T_NUMBER );
 
-                    growth->offset = strtod( CurText(), 0 );
+                    growth->offset = ParseDouble( CurText() );
 
                     if( NextTok() != T_RIGHT )
                         Expecting(T_RIGHT);
@@ -1749,11 +1750,11 @@ void SPECCTRA_DB::doPLACE( PLACE* growth )
     {
         POINT   point;
 
-        point.x = strtod( CurText(), 0 );
+        point.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( T_NUMBER );
-        point.y = strtod( CurText(), 0 );
+        point.y = ParseDouble( CurText() );
 
         growth->SetVertex( point );
 
@@ -1764,7 +1765,7 @@ void SPECCTRA_DB::doPLACE( PLACE* growth )
 
         if( NextTok() != T_NUMBER )
             Expecting( "rotation" );
-        growth->SetRotation( strtod( CurText(), 0)  );
+        growth->SetRotation( ParseDouble( CurText() )  );
     }
 
     while( (tok = NextTok()) != T_RIGHT )
@@ -2241,7 +2242,7 @@ void SPECCTRA_DB::doPIN( PIN* growth )
 
             if( NextTok() != T_NUMBER )
                 Expecting( T_NUMBER );
-            growth->SetRotation( strtod( CurText(), 0 ) );
+            growth->SetRotation( ParseDouble( CurText() ) );
             NeedRIGHT();
         }
         else
@@ -2253,11 +2254,11 @@ void SPECCTRA_DB::doPIN( PIN* growth )
 
             if( NextTok() != T_NUMBER )
                 Expecting( T_NUMBER );
-            growth->vertex.x = strtod( CurText(), 0 );
+            growth->vertex.x = ParseDouble( CurText() );
 
             if( NextTok() != T_NUMBER )
                 Expecting( T_NUMBER );
-            growth->vertex.y = strtod( CurText(), 0 );
+            growth->vertex.y = ParseDouble( CurText() );
         }
     }
 }
@@ -2902,12 +2903,12 @@ void SPECCTRA_DB::doWIRE_VIA( WIRE_VIA* growth )
 
     while( (tok = NextTok()) == T_NUMBER )
     {
-        point.x = strtod( CurText(), 0 );
+        point.x = ParseDouble( CurText() );
 
         if( NextTok() != T_NUMBER )
             Expecting( "vertex.y" );
 
-        point.y = strtod( CurText(), 0 );
+        point.y = ParseDouble( CurText() );
 
         growth->vertexes.push_back( point );
     }
@@ -45,6 +45,7 @@
 #include <class_zone.h>
 #include <class_drawsegment.h>
 #include <connectivity/connectivity_data.h>
+#include <advanced_config.h>
 #include <view/view.h>
 
 #include "specctra.h"
@@ -127,8 +128,9 @@ bool PCB_EDIT_FRAME::ImportSpecctraSession( const wxString& fullFileName )
     OnModify();
     GetBoard()->m_Status_Pcb = 0;
 
-    GetBoard()->GetConnectivity()->Clear();
-    GetBoard()->GetConnectivity()->Build( GetBoard() );
+    // Update the moved footprints
+    GetBoard()->GetConnectivity()->Sync( GetBoard(),
+            ADVANCED_CFG::GetCfg().m_verifyIncrementalConnectivity );
 
     if( GetGalCanvas() )    // Update view:
     {
@@ -390,6 +392,9 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
         THROW_IO_ERROR( _("Session file is missing the \"library_out\" section") );
 
     // delete all the old tracks and vias
+    for( TRACK* track = aBoard->m_Track; track; track = track->Next() )
+        aBoard->GetConnectivity()->Remove( track );
+
     aBoard->m_Track.DeleteAll();
 
     aBoard->DeleteMARKERs();
@@ -423,6 +428,8 @@ void SPECCTRA_DB::FromSESSION( BOARD* aBoard )
                 UNIT_RES* resolution = place->GetUnits();
                 wxASSERT( resolution );
 
+                aBoard->GetConnectivity()->MarkItemDirty( module );
+
                 wxPoint newPos = mapPt( place->vertex, resolution );
                 module->SetPosition( newPos );
 
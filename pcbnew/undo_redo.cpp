@@ -47,6 +47,7 @@ using namespace std::placeholders;
 #include <origin_viewitem.h>
 
 #include <connectivity/connectivity_data.h>
+#include <drc.h>
 
 #include <tools/selection_tool.h>
 #include <tools/pcbnew_control.h>
@@ -410,6 +411,8 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
 
     auto view = GetGalCanvas()->GetView();
     auto connectivity = GetBoard()->GetConnectivity();
+    DRC* drc = IsType( FRAME_PCB ) ? static_cast<PCB_EDIT_FRAME*>( this )->GetDrcController()
+                                   : nullptr;
 
     // Undo in the reverse order of list creation: (this can allow stacked changes
     // like the same item can be changes and deleted in the same complex command
@@ -481,6 +484,12 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         // It is possible that we are going to replace the selected item, so clear it
         SetCurItem( NULL );
 
+        // Record the old and new place of the item for the incremental DRC
+        bool testDrc = drc && status != UR_DRILLORIGIN && status != UR_GRIDORIGIN;
+
+        if( testDrc )
+            drc->MarkDirty( item );
+
         switch( aList->GetPickedItemStatus( ii ) )
         {
         case UR_CHANGED:    /* Exchange old and new data for each item */
@@ -569,6 +578,9 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
         }
         break;
         }
+
+        if( testDrc )
+            drc->MarkDirty( item );
     }
 
     if( not_found )
@@ -582,6 +594,9 @@ void PCB_BASE_EDIT_FRAME::PutDataInPreviousState( PICKED_ITEMS_LIST* aList, bool
     }
 
     GetBoard()->SanitizeNetcodes();
+
+    if( drc && drc->IsDRCDialogShown() )
+        drc->RunIncrementalTests();
 }
 
 
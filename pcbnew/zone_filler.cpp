@@ -24,10 +24,10 @@
  */
 
 #include <cstdint>
-#include <thread>
+#include <cmath>
 #include <mutex>
 #include <algorithm>
-#include <future>
+#include <numeric>
 
 #include <class_board.h>
 #include <class_zone.h>
@@ -38,8 +38,10 @@
 #include <class_pcb_text.h>
 #include <class_pcb_target.h>
 
+#include <advanced_config.h>
 #include <connectivity/connectivity_data.h>
 #include <board_commit.h>
+#include <drc/drc_rtree.h>
 
 #include <widgets/progress_reporter.h>
 
@@ -48,6 +50,7 @@
 #include <geometry/convex_hull.h>
 #include <geometry/geometry_utils.h>
 #include <confirm.h>
+#include <thread_pool.h>
 
 #include "zone_filler.h"
 
@@ -82,9 +85,64 @@ extern void CreateThermalReliefPadPolygon( SHAPE_POLY_SET& aCornerBuffer,
 static double s_thermalRot = 450;   // angle of stubs in thermal reliefs for round pads
 static const bool s_DumpZonesWhenFilling = false;
 
+// A zone is split into tiles only if it has this many knockouts per tile
+static const int s_minHolesPerTile = 1000;
+
+// Number of tiles per pool thread, so that the threads stay busy when some tiles are empty
+static const int s_tilesPerThread = 4;
+
+
+static SHAPE_POLY_SET rectangleToPolygon( const BOX2I& aRect )
+{
+    SHAPE_POLY_SET poly;
+
+    poly.NewOutline();
+    poly.Append( aRect.GetX(), aRect.GetY() );
+    poly.Append( aRect.GetRight(), aRect.GetY() );
+    poly.Append( aRect.GetRight(), aRect.GetBottom() );
+    poly.Append( aRect.GetX(), aRect.GetBottom() );
+
+    return poly;
+}
+
+
+struct ZONE_FILLER::ITEM_INDEX
+{
+    std::vector<D_PAD*>      m_pads;        ///< all lists are in board order
+    std::vector<TRACK*>      m_tracks;
+    std::vector<BOARD_ITEM*> m_graphics;
+
+    DRC_RTREE m_padTree;        ///< pads with a hole are on all layers
+    DRC_RTREE m_trackTree;
+    DRC_RTREE m_graphicTree;    ///< items on Edge_Cuts are on all copper layers
+
+    ///> Largest clearance or thermal gap of a pad
+    int m_maxPadMargin = 0;
+
+    /**
+     * Collect the ids of the items of \a aTree which may intersect \a aArea on \a aLayer,
+     * in board order.  All the items are returned for a zone on a non copper layer.
+     */
+    static void Query( const DRC_RTREE& aTree, size_t aCount, const EDA_RECT& aArea,
+            PCB_LAYER_ID aLayer, std::vector<int>& aIds )
+    {
+        if( IsCopperLayer( aLayer ) )
+        {
+            aTree.Query( aArea, LSET( aLayer ), aIds );
+        }
+        else
+        {
+            aIds.resize( aCount );
+            std::iota( aIds.begin(), aIds.end(), 0 );
+        }
+    }
+};
+
 
 ZONE_FILLER::ZONE_FILLER(  BOARD* aBoard, COMMIT* aCommit ) :
-    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr )
+    m_board( aBoard ), m_commit( aCommit ), m_progressReporter( nullptr ),
+    m_pool( &THREAD_POOL::GetPool() ),
+    m_tiledFill( ADVANCED_CFG::GetCfg().m_tiledZoneFill )
 {
 }
 
@@ -137,52 +195,34 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
         zone->UnFill();
     }
 
-    std::atomic<size_t> nextItem( 0 );
-    size_t parallelThreadCount = std::min<size_t>( std::thread::hardware_concurrency(), toFill.size() );
-    std::vector<std::future<size_t>> returns( parallelThreadCount );
+    buildItemIndex();
 
-    auto fill_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
+    auto fillZone = [&]( size_t i )
     {
-        size_t num = 0;
+        ZONE_CONTAINER* zone = toFill[i].m_zone;
+        SHAPE_POLY_SET rawPolys, finalPolys;
+        fillSingleZone( zone, rawPolys, finalPolys );
 
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            ZONE_CONTAINER* zone = toFill[i].m_zone;
-            SHAPE_POLY_SET rawPolys, finalPolys;
-            fillSingleZone( zone, rawPolys, finalPolys );
+        zone->SetRawPolysList( rawPolys );
+        zone->SetFilledPolysList( finalPolys );
+        zone->SetIsFilled( true );
 
-            zone->SetRawPolysList( rawPolys );
-            zone->SetFilledPolysList( finalPolys );
-            zone->SetIsFilled( true );
-
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
+        if( m_progressReporter )
+            m_progressReporter->AdvanceProgress();
+    };
 
-            num++;
-        }
+    bool filled = m_pool->ParallelFor( toFill.size(), fillZone,
+            THREAD_POOL::ReporterHook( m_progressReporter, true ) );
 
-        return num;
-    };
+    m_itemIndex.reset();
 
-    if( parallelThreadCount <= 1 )
-        fill_lambda( m_progressReporter );
-    else
+    if( !filled )
     {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, fill_lambda, m_progressReporter );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
-            {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+        // Cancelled by the user: some zones are not filled
+        if( m_commit )
+            m_commit->Revert();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
+        return false;
     }
 
     // Now update the connectivity to check for copper islands
@@ -259,44 +299,15 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
     }
 
 
-    nextItem = 0;
-
-    auto tri_lambda = [&] ( PROGRESS_REPORTER* aReporter ) -> size_t
-    {
-        size_t num = 0;
-
-        for( size_t i = nextItem++; i < toFill.size(); i = nextItem++ )
-        {
-            toFill[i].m_zone->CacheTriangulation();
-            num++;
-
-            if( m_progressReporter )
-                m_progressReporter->AdvanceProgress();
-        }
-
-        return num;
-    };
-
-    if( parallelThreadCount <= 1 )
-        tri_lambda( m_progressReporter );
-    else
-    {
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-            returns[ii] = std::async( std::launch::async, tri_lambda, m_progressReporter );
-
-        for( size_t ii = 0; ii < parallelThreadCount; ++ii )
-        {
-            // Here we balance returns with a 100ms timeout to allow UI updating
-            std::future_status status;
-            do
+    m_pool->ParallelFor( toFill.size(),
+            [&]( size_t i )
             {
-                if( m_progressReporter )
-                    m_progressReporter->KeepRefreshing();
+                toFill[i].m_zone->CacheTriangulation();
 
-                status = returns[ii].wait_for( std::chrono::milliseconds( 100 ) );
-            } while( status != std::future_status::ready );
-        }
-    }
+                if( m_progressReporter )
+                    m_progressReporter->AdvanceProgress();
+            },
+            THREAD_POOL::ReporterHook( m_progressReporter ) );
 
     if( m_progressReporter )
     {
@@ -323,6 +334,69 @@ bool ZONE_FILLER::Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck
 }
 
 
+void ZONE_FILLER::buildItemIndex()
+{
+    m_itemIndex.reset( new ITEM_INDEX );
+    ITEM_INDEX& index = *m_itemIndex;
+
+    // The dummy pads used for holes get the default clearance
+    index.m_maxPadMargin = m_board->GetDesignSettings().GetBiggestClearanceValue();
+
+    for( auto module : m_board->Modules() )
+    {
+        for( auto pad : module->Pads() )
+        {
+            EDA_RECT bbox = pad->GetBoundingBox();
+            LSET     layers = pad->GetLayerSet();
+
+            // Holes are knocked out of zones on all layers
+            if( pad->GetDrillSize().x != 0 || pad->GetDrillSize().y != 0 )
+            {
+                int radius = ( std::max( pad->GetDrillSize().x, pad->GetDrillSize().y ) + 1 ) / 2;
+
+                bbox.Merge( EDA_RECT( pad->GetPosition() - wxPoint( radius, radius ),
+                                      wxSize( 2 * radius, 2 * radius ) ) );
+                bbox.Inflate( 1 );
+                layers = LSET::AllCuMask();
+            }
+
+            index.m_maxPadMargin = std::max( { index.m_maxPadMargin, pad->GetClearance(),
+                                               pad->GetThermalGap() } );
+
+            index.m_padTree.Insert( index.m_pads.size(), bbox, layers );
+            index.m_pads.push_back( pad );
+        }
+    }
+
+    for( auto track : m_board->Tracks() )
+    {
+        index.m_trackTree.Insert( index.m_tracks.size(), track->GetBoundingBox(),
+                                  track->GetLayerSet() );
+        index.m_tracks.push_back( track );
+    }
+
+    auto addGraphicItem = [&]( BOARD_ITEM* aItem )
+    {
+        LSET layers = aItem->IsOnLayer( Edge_Cuts ) ? LSET::AllCuMask() : aItem->GetLayerSet();
+
+        index.m_graphicTree.Insert( index.m_graphics.size(), aItem->GetBoundingBox(), layers );
+        index.m_graphics.push_back( aItem );
+    };
+
+    for( auto module : m_board->Modules() )
+    {
+        addGraphicItem( &module->Reference() );
+        addGraphicItem( &module->Value() );
+
+        for( auto item : module->GraphicalItems() )
+            addGraphicItem( item );
+    }
+
+    for( auto item : m_board->Drawings() )
+        addGraphicItem( item );
+}
+
+
 void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
         SHAPE_POLY_SET& aFeatures ) const
 {
@@ -380,108 +454,67 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     MODULE  dummymodule( m_board );   // Creates a dummy parent
     D_PAD   dummypad( &dummymodule );
 
-    for( MODULE* module = m_board->m_Modules; module; module = module->Next() )
-    {
-        D_PAD* nextpad;
+    const ITEM_INDEX&  index = *m_itemIndex;
+    const PCB_LAYER_ID layer = aZone->GetLayer();
+    std::vector<int>   candidates;
 
-        for( D_PAD* pad = module->PadsList(); pad != NULL; pad = nextpad )
-        {
-            nextpad = pad->Next();      // pad pointer can be modified by next code, so
-                                        // calculate the next pad here
+    // Pads are tested with their own clearance or thermal gap, which can be larger
+    EDA_RECT pad_area = zone_boundingbox;
+    pad_area.Inflate( std::max( { index.m_maxPadMargin, zone_clearance,
+                                  aZone->GetThermalReliefGap( nullptr ) } )
+                      + outline_half_thickness );
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-            {
-                /* Test for pads that are on top or bottom only and have a hole.
-                 * There are curious pads but they can be used for some components that are
-                 * inside the board (in fact inside the hole. Some photo diodes and Leds are
-                 * like this)
-                 */
-                if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
-                    continue;
-
-                // Use a dummy pad to calculate a hole shape that have the same dimension as
-                // the pad hole
-                dummypad.SetSize( pad->GetDrillSize() );
-                dummypad.SetOrientation( pad->GetOrientation() );
-                dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
-                        PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
-                dummypad.SetPosition( pad->GetPosition() );
-
-                pad = &dummypad;
-            }
+    ITEM_INDEX::Query( index.m_padTree, index.m_pads.size(), pad_area, layer, candidates );
 
-            // Note: netcode <=0 means not connected item
-            if( ( pad->GetNetCode() != aZone->GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
-            {
-                int item_clearance = pad->GetClearance() + outline_half_thickness;
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( item_clearance );
+    for( int id : candidates )
+    {
+        D_PAD* pad = index.m_pads[id];  // pad pointer can be modified by next code
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
-                {
-                    int clearance = std::max( zone_clearance, item_clearance );
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+        {
+            /* Test for pads that are on top or bottom only and have a hole.
+             * There are curious pads but they can be used for some components that are
+             * inside the board (in fact inside the hole. Some photo diodes and Leds are
+             * like this)
+             */
+            if( pad->GetDrillSize().x == 0 && pad->GetDrillSize().y == 0 )
+                continue;
 
-                    // PAD_SHAPE_CUSTOM can have a specific keepout, to avoid to break the shape
-                    if( pad->GetShape() == PAD_SHAPE_CUSTOM
-                        && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
-                    {
-                        // the pad shape in zone can be its convex hull or
-                        // the shape itself
-                        SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
-                        outline.Inflate( KiROUND( clearance * correctionFactor ), segsPerCircle );
-                        pad->CustomShapeAsPolygonToBoardPosition( &outline,
-                                pad->GetPosition(), pad->GetOrientation() );
-
-                        if( pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
-                        {
-                            std::vector<wxPoint> convex_hull;
-                            BuildConvexHull( convex_hull, outline );
-
-                            aFeatures.NewOutline();
-
-                            for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
-                                aFeatures.Append( convex_hull[ii] );
-                        }
-                        else
-                            aFeatures.Append( outline );
-                    }
-                    else
-                        pad->TransformShapeWithClearanceToPolygon( aFeatures,
-                                clearance,
-                                segsPerCircle,
-                                correctionFactor );
-                }
+            // Use a dummy pad to calculate a hole shape that have the same dimension as
+            // the pad hole
+            dummypad.SetSize( pad->GetDrillSize() );
+            dummypad.SetOrientation( pad->GetOrientation() );
+            dummypad.SetShape( pad->GetDrillShape() == PAD_DRILL_SHAPE_OBLONG ?
+                    PAD_SHAPE_OVAL : PAD_SHAPE_CIRCLE );
+            dummypad.SetPosition( pad->GetPosition() );
 
-                continue;
-            }
+            pad = &dummypad;
+        }
 
-            // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
-            // or if they have a custom shape and not PAD_ZONE_CONN_FULL,
-            // because a thermal relief will break
-            // the shape
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE
-                || ( pad->GetShape() == PAD_SHAPE_CUSTOM && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_FULL ) )
+        // Note: netcode <=0 means not connected item
+        if( ( pad->GetNetCode() != aZone->GetNetCode() ) || ( pad->GetNetCode() <= 0 ) )
+        {
+            int item_clearance = pad->GetClearance() + outline_half_thickness;
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( item_clearance );
+
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
             {
-                int gap = zone_clearance;
-                int thermalGap = aZone->GetThermalReliefGap( pad );
-                gap = std::max( gap, thermalGap );
-                item_boundingbox = pad->GetBoundingBox();
-                item_boundingbox.Inflate( gap );
+                int clearance = std::max( zone_clearance, item_clearance );
 
-                if( item_boundingbox.Intersects( zone_boundingbox ) )
+                // PAD_SHAPE_CUSTOM can have a specific keepout, to avoid to break the shape
+                if( pad->GetShape() == PAD_SHAPE_CUSTOM
+                    && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                 {
-                    // PAD_SHAPE_CUSTOM has a specific keepout, to avoid to break the shape
-                    // the pad shape in zone can be its convex hull or the shape itself
-                    if( pad->GetShape() == PAD_SHAPE_CUSTOM
-                        && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
+                    // the pad shape in zone can be its convex hull or
+                    // the shape itself
+                    SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
+                    outline.Inflate( KiROUND( clearance * correctionFactor ), segsPerCircle );
+                    pad->CustomShapeAsPolygonToBoardPosition( &outline,
+                            pad->GetPosition(), pad->GetOrientation() );
+
+                    if( pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
                     {
-                        // the pad shape in zone can be its convex hull or
-                        // the shape itself
-                        SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
-                        outline.Inflate( KiROUND( gap * correctionFactor ), segsPerCircle );
-                        pad->CustomShapeAsPolygonToBoardPosition( &outline,
-                                pad->GetPosition(), pad->GetOrientation() );
-
                         std::vector<wxPoint> convex_hull;
                         BuildConvexHull( convex_hull, outline );
 
@@ -491,9 +524,56 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
                             aFeatures.Append( convex_hull[ii] );
                     }
                     else
-                        pad->TransformShapeWithClearanceToPolygon( aFeatures,
-                                gap, segsPerCircle, correctionFactor );
+                        aFeatures.Append( outline );
+                }
+                else
+                    pad->TransformShapeWithClearanceToPolygon( aFeatures,
+                            clearance,
+                            segsPerCircle,
+                            correctionFactor );
+            }
+
+            continue;
+        }
+
+        // Pads are removed from zone if the setup is PAD_ZONE_CONN_NONE
+        // or if they have a custom shape and not PAD_ZONE_CONN_FULL,
+        // because a thermal relief will break
+        // the shape
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_NONE
+            || ( pad->GetShape() == PAD_SHAPE_CUSTOM && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_FULL ) )
+        {
+            int gap = zone_clearance;
+            int thermalGap = aZone->GetThermalReliefGap( pad );
+            gap = std::max( gap, thermalGap );
+            item_boundingbox = pad->GetBoundingBox();
+            item_boundingbox.Inflate( gap );
+
+            if( item_boundingbox.Intersects( zone_boundingbox ) )
+            {
+                // PAD_SHAPE_CUSTOM has a specific keepout, to avoid to break the shape
+                // the pad shape in zone can be its convex hull or the shape itself
+                if( pad->GetShape() == PAD_SHAPE_CUSTOM
+                    && pad->GetCustomShapeInZoneOpt() == CUST_PAD_SHAPE_IN_ZONE_CONVEXHULL )
+                {
+                    // the pad shape in zone can be its convex hull or
+                    // the shape itself
+                    SHAPE_POLY_SET outline( pad->GetCustomShapeAsPolygon() );
+                    outline.Inflate( KiROUND( gap * correctionFactor ), segsPerCircle );
+                    pad->CustomShapeAsPolygonToBoardPosition( &outline,
+                            pad->GetPosition(), pad->GetOrientation() );
+
+                    std::vector<wxPoint> convex_hull;
+                    BuildConvexHull( convex_hull, outline );
+
+                    aFeatures.NewOutline();
+
+                    for( unsigned ii = 0; ii < convex_hull.size(); ++ii )
+                        aFeatures.Append( convex_hull[ii] );
                 }
+                else
+                    pad->TransformShapeWithClearanceToPolygon( aFeatures,
+                            gap, segsPerCircle, correctionFactor );
             }
         }
     }
@@ -501,8 +581,13 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
     /* Add holes (i.e. tracks and vias areas as polygons outlines)
      * in cornerBufferPolysToSubstract
      */
-    for( auto track : m_board->Tracks() )
+    ITEM_INDEX::Query( index.m_trackTree, index.m_tracks.size(), zone_boundingbox, layer,
+                       candidates );
+
+    for( int id : candidates )
     {
+        TRACK* track = index.m_tracks[id];
+
         if( !track->IsOnLayer( aZone->GetLayer() ) )
             continue;
 
@@ -575,17 +660,11 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
         }
     };
 
-    for( auto module : m_board->Modules() )
-    {
-        doGraphicItem( &module->Reference() );
-        doGraphicItem( &module->Value() );
+    ITEM_INDEX::Query( index.m_graphicTree, index.m_graphics.size(), zone_boundingbox, layer,
+                       candidates );
 
-        for( auto item : module->GraphicalItems() )
-            doGraphicItem( item );
-    }
-
-    for( auto item : m_board->Drawings() )
-        doGraphicItem( item );
+    for( int id : candidates )
+        doGraphicItem( index.m_graphics[id] );
 
     /* Add zones outlines having an higher priority and keepout
      */
@@ -639,41 +718,42 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
 
     /* Remove thermal symbols
      */
-    for( auto module : m_board->Modules() )
+    ITEM_INDEX::Query( index.m_padTree, index.m_pads.size(), pad_area, layer, candidates );
+
+    for( int id : candidates )
     {
-        for( auto pad : module->Pads() )
-        {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-                && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+        D_PAD* pad = index.m_pads[id];
 
-            if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-                && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+            && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+        if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+            && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
 
-            if( pad->GetNetCode() != aZone->GetNetCode() )
-                continue;
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
 
-            if( pad->GetNetCode() <= 0 )
-                continue;
+        if( pad->GetNetCode() != aZone->GetNetCode() )
+            continue;
 
-            item_boundingbox = pad->GetBoundingBox();
-            int thermalGap = aZone->GetThermalReliefGap( pad );
-            item_boundingbox.Inflate( thermalGap, thermalGap );
+        if( pad->GetNetCode() <= 0 )
+            continue;
 
-            if( item_boundingbox.Intersects( zone_boundingbox ) )
-            {
-                CreateThermalReliefPadPolygon( aFeatures,
-                        *pad, thermalGap,
-                        aZone->GetThermalReliefCopperBridge( pad ),
-                        aZone->GetMinThickness(),
-                        segsPerCircle,
-                        correctionFactor, s_thermalRot );
-            }
+        item_boundingbox = pad->GetBoundingBox();
+        int thermalGap = aZone->GetThermalReliefGap( pad );
+        item_boundingbox.Inflate( thermalGap, thermalGap );
+
+        if( item_boundingbox.Intersects( zone_boundingbox ) )
+        {
+            CreateThermalReliefPadPolygon( aFeatures,
+                    *pad, thermalGap,
+                    aZone->GetThermalReliefCopperBridge( pad ),
+                    aZone->GetMinThickness(),
+                    segsPerCircle,
+                    correctionFactor, s_thermalRot );
         }
     }
 }
@@ -709,6 +789,7 @@ void ZONE_FILLER::buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
  */
 void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
         const SHAPE_POLY_SET& aSmoothedOutline,
+        SHAPE_POLY_SET& aHoles,
         SHAPE_POLY_SET& aRawPolys,
         SHAPE_POLY_SET& aFinalPolys ) const
 {
@@ -732,26 +813,38 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
     solidAreas.Inflate( -outline_half_thickness, segsPerCircle );
     solidAreas.Simplify( SHAPE_POLY_SET::PM_FAST );
 
-    SHAPE_POLY_SET holes;
-
     if( s_DumpZonesWhenFilling )
+    {
         dumper->Write( &solidAreas, "solid-areas" );
+        dumper->Write( &aHoles, "feature-holes" );
+    }
 
-    buildZoneFeatureHoleList( aZone, holes );
+    // Big zones are split in tiles filled in parallel (hatched zones are always filled
+    // in one piece)
+    if( m_tiledFill && aZone->GetFillMode() == ZFM_POLYGONS
+            && computeTiledFilledAreas( aZone, solidAreas, aHoles, correctionFactor,
+                                        aFinalPolys ) )
+    {
+        if( s_DumpZonesWhenFilling )
+        {
+            dumper->Write( &aFinalPolys, "tiled-areas_fractured" );
+            dumper->EndGroup();
+        }
 
-    if( s_DumpZonesWhenFilling )
-        dumper->Write( &holes, "feature-holes" );
+        aRawPolys = aFinalPolys;
+        return;
+    }
 
-    holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+    aHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
 
     if( s_DumpZonesWhenFilling )
-        dumper->Write( &holes, "feature-holes-postsimplify" );
+        dumper->Write( &aHoles, "feature-holes-postsimplify" );
 
     // Generate the filled areas (currently, without thermal shapes, which will
     // be created later).
     // Use SHAPE_POLY_SET::PM_STRICTLY_SIMPLE to generate strictly simple polygons
     // needed by Gerber files and Fracture()
-    solidAreas.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+    solidAreas.BooleanSubtract( aHoles, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
 
     // Now remove the non filled areas due to the hatch pattern
     if( aZone->GetFillMode() == ZFM_HATCH_PATTERN )
@@ -789,7 +882,7 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
     if( aZone->GetNetCode() > 0 )
     {
         buildUnconnectedThermalStubsPolygonList( thermalHoles, aZone, solidAreas,
-                correctionFactor, s_thermalRot );
+                thermalPadArea( aZone, solidAreas.BBox() ), correctionFactor, s_thermalRot );
 
     }
 
@@ -831,6 +924,277 @@ void ZONE_FILLER::computeRawFilledAreas( const ZONE_CONTAINER* aZone,
         dumper->EndGroup();
 }
 
+MD5_HASH ZONE_FILLER::fillInputsHash( const ZONE_CONTAINER* aZone,
+        const SHAPE_POLY_SET& aSmoothedOutline, const SHAPE_POLY_SET& aHoles ) const
+{
+    MD5_HASH hash;
+
+    auto hashPoly = [&hash]( const SHAPE_POLY_SET& aPoly )
+    {
+        MD5_HASH polyHash = aPoly.GetHash();
+        std::string digest = polyHash.Format();
+        hash.Hash( (uint8_t*) digest.data(), digest.size() );
+    };
+
+    auto hashDouble = [&hash]( double aValue )
+    {
+        hash.Hash( (uint8_t*) &aValue, sizeof( aValue ) );
+    };
+
+    // The thermal relief shapes in the hole list also describe the pads which are
+    // looked at when removing unconnected thermal stubs
+    hashPoly( aSmoothedOutline );
+    hashPoly( aHoles );
+
+    hash.Hash( aZone->GetLayer() );
+    hash.Hash( aZone->GetNetCode() );
+    hash.Hash( aZone->GetMinThickness() );
+    hash.Hash( aZone->GetArcSegmentCount() );
+    hash.Hash( aZone->GetFillMode() );
+    hash.Hash( aZone->GetHatchFillTypeThickness() );
+    hash.Hash( aZone->GetHatchFillTypeGap() );
+    hashDouble( aZone->GetHatchFillTypeOrientation() );
+    hash.Hash( aZone->GetHatchFillTypeSmoothingLevel() );
+    hashDouble( aZone->GetHatchFillTypeSmoothingValue() );
+    hash.Hash( aZone->GetZoneClearance() );
+    hash.Hash( m_board->GetDesignSettings().GetBiggestClearanceValue() );
+    hash.Hash( m_tiledFill );
+
+    hash.Finalize();
+    return hash;
+}
+
+
+bool ZONE_FILLER::computeTiledFilledAreas( const ZONE_CONTAINER* aZone,
+        const SHAPE_POLY_SET& aSolidAreas,
+        const SHAPE_POLY_SET& aHoles,
+        double aCorrectionFactor,
+        SHAPE_POLY_SET& aFinalPolys ) const
+{
+    const int holeCount = aHoles.OutlineCount();
+    const int tileCount = std::min<int>( holeCount / s_minHolesPerTile,
+                                         m_pool->GetSlotCount() * s_tilesPerThread );
+
+    if( tileCount < 2 )
+        return false;
+
+    const BOX2I bbox = aSolidAreas.BBox();
+
+    if( bbox.GetWidth() <= 0 || bbox.GetHeight() <= 0 )
+        return false;
+
+    // Roughly square tiles
+    double aspect = (double) bbox.GetWidth() / bbox.GetHeight();
+    int    columns = Clamp( 1, KiROUND( std::sqrt( tileCount * aspect ) ), tileCount );
+    int    rows = ( tileCount + columns - 1 ) / columns;
+    int    tileWidth = ( bbox.GetWidth() + columns - 1 ) / columns;
+    int    tileHeight = ( bbox.GetHeight() + rows - 1 ) / rows;
+
+    // Thermal stubs are removed when the copper around their pad is missing.  A tile is
+    // filled with enough margin to see the copper around all the pads whose stubs can reach
+    // it, so it makes the same decision as a fill in one piece.
+    const bool checkStubs = aZone->GetNetCode() > 0;
+    const int  pen_radius = aZone->GetMinThickness() / 2;
+    int        margin = 0;
+
+    if( checkStubs )
+    {
+        int padReach = 0;
+
+        for( D_PAD* pad : m_itemIndex->m_pads )
+        {
+            if( !pad->IsOnLayer( aZone->GetLayer() ) )
+                continue;
+
+            const EDA_RECT padBB = pad->GetBoundingBox();
+            int reach = std::max( padBB.GetWidth(), padBB.GetHeight() )
+                        + 2 * aZone->GetThermalReliefGap( pad );
+
+            padReach = std::max( padReach, KiROUND( reach * aCorrectionFactor ) );
+        }
+
+        margin = 2 * ( padReach + pen_radius ) + KiROUND( IU_PER_MM );
+    }
+
+    std::vector<BOX2I> holeBBoxes( holeCount );
+
+    for( int ii = 0; ii < holeCount; ++ii )
+        holeBBoxes[ii] = aHoles.COutline( ii ).BBox();
+
+    struct TILE
+    {
+        BOX2I          m_core;      ///< the part of the zone this tile fills
+        BOX2I          m_extended;  ///< the core with the margin for thermal stubs
+        SHAPE_POLY_SET m_area;      ///< the fill of m_extended
+        SHAPE_POLY_SET m_result;    ///< the fill of m_core
+    };
+
+    std::vector<TILE> tiles( columns * rows );
+
+    for( int row = 0; row < rows; ++row )
+    {
+        for( int col = 0; col < columns; ++col )
+        {
+            TILE& tile = tiles[row * columns + col];
+
+            tile.m_core = BOX2I( VECTOR2I( bbox.GetX() + col * tileWidth,
+                                           bbox.GetY() + row * tileHeight ),
+                                 VECTOR2I( tileWidth, tileHeight ) );
+            tile.m_extended = tile.m_core;
+            tile.m_extended.Inflate( margin );
+        }
+    }
+
+    // Knockouts are only subtracted from the tiles they overlap, which is where the time
+    // goes for a zone in one piece
+    m_pool->ParallelFor( tiles.size(),
+            [&]( size_t i )
+            {
+                TILE&          tile = tiles[i];
+                SHAPE_POLY_SET holes;
+
+                for( int ii = 0; ii < holeCount; ++ii )
+                {
+                    if( !holeBBoxes[ii].Intersects( tile.m_extended ) )
+                        continue;
+
+                    const SHAPE_POLY_SET::POLYGON& poly = aHoles.Polygon( ii );
+
+                    holes.AddOutline( poly[0] );
+
+                    for( size_t jj = 1; jj < poly.size(); ++jj )
+                        holes.AddHole( poly[jj] );
+                }
+
+                tile.m_area = aSolidAreas;
+                tile.m_area.BooleanIntersection( rectangleToPolygon( tile.m_extended ),
+                                                 SHAPE_POLY_SET::PM_FAST );
+                holes.Simplify( SHAPE_POLY_SET::PM_FAST );
+                tile.m_area.BooleanSubtract( holes, SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+
+                tile.m_result = tile.m_area;
+                tile.m_result.BooleanIntersection( rectangleToPolygon( tile.m_core ),
+                                                   SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+            } );
+
+    if( checkStubs )
+    {
+        // The pads looked at are the ones of a fill in one piece, so the filled area of
+        // all the tiles is needed first
+        BOX2I filledBBox;
+        bool  empty = true;
+
+        for( const TILE& tile : tiles )
+        {
+            if( tile.m_result.OutlineCount() == 0 )
+                continue;
+
+            if( empty )
+                filledBBox = tile.m_result.BBox();
+            else
+                filledBBox.Merge( tile.m_result.BBox() );
+
+            empty = false;
+        }
+
+        BOX2I zonePadArea = thermalPadArea( aZone, filledBBox );
+
+        m_pool->ParallelFor( tiles.size(),
+                [&]( size_t i )
+                {
+                    TILE& tile = tiles[i];
+                    BOX2I stubArea = tile.m_core;
+
+                    // Pads whose stubs can touch the core
+                    stubArea.Inflate( pen_radius + KiROUND( IU_PER_MM * 0.1 ) );
+
+                    if( empty || tile.m_result.OutlineCount() == 0
+                            || !stubArea.Intersects( zonePadArea ) )
+                        return;
+
+                    SHAPE_POLY_SET thermalHoles;
+                    buildUnconnectedThermalStubsPolygonList( thermalHoles, aZone, tile.m_area,
+                            stubArea.Intersect( zonePadArea ), aCorrectionFactor,
+                            s_thermalRot );
+
+                    if( thermalHoles.IsEmpty() )
+                        return;
+
+                    thermalHoles.Simplify( SHAPE_POLY_SET::PM_FAST );
+                    tile.m_result.BooleanSubtract( thermalHoles,
+                                                   SHAPE_POLY_SET::PM_STRICTLY_SIMPLE );
+                } );
+    }
+
+    // Stitch the tiles back together.  Only the pieces touching a tile edge need merging,
+    // and merging their outlines alone is much faster than merging them with their holes
+    // (Clipper is especially slow with strictly simple output along the shared tile edges).
+    // The holes are put back afterwards into the merged outline containing them.
+    SHAPE_POLY_SET seamOutlines;
+    std::vector<const SHAPE_POLY_SET::POLYGON*> seamPieces;
+
+    aFinalPolys.RemoveAllContours();
+
+    for( const TILE& tile : tiles )
+    {
+        BOX2I inside = tile.m_core;
+        inside.Inflate( -1 );
+
+        for( int ii = 0; ii < tile.m_result.OutlineCount(); ++ii )
+        {
+            const SHAPE_POLY_SET::POLYGON& poly = tile.m_result.CPolygon( ii );
+
+            if( inside.Contains( poly[0].BBox() ) )
+            {
+                aFinalPolys.AddOutline( poly[0] );
+
+                for( size_t jj = 1; jj < poly.size(); ++jj )
+                    aFinalPolys.AddHole( poly[jj] );
+            }
+            else
+            {
+                seamOutlines.AddOutline( poly[0] );
+
+                if( poly.size() > 1 )
+                    seamPieces.push_back( &poly );
+            }
+        }
+    }
+
+    seamOutlines.Simplify( SHAPE_POLY_SET::PM_FAST );
+
+    std::vector<BOX2I> seamBBoxes( seamOutlines.OutlineCount() );
+
+    for( int ii = 0; ii < seamOutlines.OutlineCount(); ++ii )
+        seamBBoxes[ii] = seamOutlines.COutline( ii ).BBox();
+
+    for( const SHAPE_POLY_SET::POLYGON* piece : seamPieces )
+    {
+        const VECTOR2I& holePt = ( *piece )[1].CPoint( 0 );
+        int owner = -1;
+
+        for( int ii = 0; ii < seamOutlines.OutlineCount() && owner < 0; ++ii )
+        {
+            if( seamBBoxes[ii].Contains( holePt )
+                    && seamOutlines.COutline( ii ).PointInside( holePt ) )
+                owner = ii;
+        }
+
+        // Should not happen, but the fill in one piece is always right
+        if( owner < 0 )
+            return false;
+
+        for( size_t jj = 1; jj < piece->size(); ++jj )
+            seamOutlines.AddHole( ( *piece )[jj], owner );
+    }
+
+    aFinalPolys.Append( seamOutlines );
+    aFinalPolys.Fracture( SHAPE_POLY_SET::PM_FAST );
+
+    return true;
+}
+
+
 /* Build the filled solid areas data from real outlines (stored in m_Poly)
  * The solid areas can be more than one on copper layers, and do not have holes
  * ( holes are linked by overlapping segments to the main outline)
@@ -849,7 +1213,24 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
 
     if( aZone->IsOnCopperLayer() )
     {
-        computeRawFilledAreas( aZone, smoothedPoly, aRawPolys, aFinalPolys );
+        SHAPE_POLY_SET holes;
+        buildZoneFeatureHoleList( aZone, holes );
+
+        MD5_HASH inputsHash = fillInputsHash( aZone, smoothedPoly, holes );
+
+        if( ADVANCED_CFG::GetCfg().m_zoneFillCache && aZone->GetFillInputsHash().IsValid()
+                && aZone->GetFillInputsHash() == inputsHash )
+        {
+            // Nothing the fill depends on changed: the raw polygons of the previous fill
+            // (before the removal of insulated islands) are still valid
+            aRawPolys = aZone->RawPolysList();
+            aFinalPolys = aRawPolys;
+        }
+        else
+        {
+            computeRawFilledAreas( aZone, smoothedPoly, holes, aRawPolys, aFinalPolys );
+            aZone->SetFillInputsHash( inputsHash );
+        }
     }
     else
     {
@@ -875,6 +1256,7 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
  * which are not connected to a zone (dangling bridges)
  * @param aCornerBuffer = a SHAPE_POLY_SET where to store polygons
  * @param aZone = a pointer to the ZONE_CONTAINER  to examine.
+ * @param aPadArea = only the pads whose thermal relief intersects this area are examined
  * @param aArcCorrection = arc correction factor.
  * @param aRoundPadThermalRotation = the rotation in 1.0 degree for thermal stubs in round pads
  */
@@ -882,168 +1264,183 @@ bool ZONE_FILLER::fillSingleZone( ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPol
 void ZONE_FILLER::buildUnconnectedThermalStubsPolygonList( SHAPE_POLY_SET& aCornerBuffer,
                                               const ZONE_CONTAINER*       aZone,
                                               const SHAPE_POLY_SET&       aRawFilledArea,
+                                              const BOX2I&          aPadArea,
                                               double                aArcCorrection,
                                               double                aRoundPadThermalRotation ) const
 {
     SHAPE_LINE_CHAIN spokes;
     BOX2I itemBB;
     VECTOR2I ptTest[4];
-    auto zoneBB = aRawFilledArea.BBox();
+    BOX2I zoneBB = aPadArea;
 
+    // half size of the pen used to draw/plot zones outlines
+    int pen_radius = aZone->GetMinThickness() / 2;
 
-    int      zone_clearance = aZone->GetZoneClearance();
+    const ITEM_INDEX& index = *m_itemIndex;
+    std::vector<int>  candidates;
 
-    int      biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
-    biggest_clearance = std::max( biggest_clearance, zone_clearance );
-    zoneBB.Inflate( biggest_clearance );
+    EDA_RECT pad_area( wxPoint( zoneBB.GetX(), zoneBB.GetY() ),
+                       wxSize( zoneBB.GetWidth(), zoneBB.GetHeight() ) );
+    pad_area.Inflate( std::max( index.m_maxPadMargin, aZone->GetThermalReliefGap( nullptr ) ) );
 
-    // half size of the pen used to draw/plot zones outlines
-    int pen_radius = aZone->GetMinThickness() / 2;
+    ITEM_INDEX::Query( index.m_padTree, index.m_pads.size(), pad_area, aZone->GetLayer(),
+                       candidates );
 
-    for( auto module : m_board->Modules() )
+    for( int id : candidates )
     {
-        for( auto pad : module->Pads() )
-        {
-            // Rejects non-standard pads with tht-only thermal reliefs
-            if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
-             && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
-                continue;
+        D_PAD* pad = index.m_pads[id];
 
-            if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
-             && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
-                continue;
+        // Rejects non-standard pads with tht-only thermal reliefs
+        if( aZone->GetPadConnection( pad ) == PAD_ZONE_CONN_THT_THERMAL
+         && pad->GetAttribute() != PAD_ATTRIB_STANDARD )
+            continue;
 
-            if( !pad->IsOnLayer( aZone->GetLayer() ) )
-                continue;
+        if( aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THERMAL
+         && aZone->GetPadConnection( pad ) != PAD_ZONE_CONN_THT_THERMAL )
+            continue;
 
-            if( pad->GetNetCode() != aZone->GetNetCode() )
-                continue;
+        if( !pad->IsOnLayer( aZone->GetLayer() ) )
+            continue;
 
-            // Calculate thermal bridge half width
-            int thermalBridgeWidth = aZone->GetThermalReliefCopperBridge( pad )
-                                     - aZone->GetMinThickness();
-            if( thermalBridgeWidth <= 0 )
-                continue;
+        if( pad->GetNetCode() != aZone->GetNetCode() )
+            continue;
 
-            // we need the thermal bridge half width
-            // with a small extra size to be sure we create a stub
-            // slightly larger than the actual stub
-            thermalBridgeWidth = ( thermalBridgeWidth + 4 ) / 2;
+        // Calculate thermal bridge half width
+        int thermalBridgeWidth = aZone->GetThermalReliefCopperBridge( pad )
+                                 - aZone->GetMinThickness();
+        if( thermalBridgeWidth <= 0 )
+            continue;
 
-            int thermalReliefGap = aZone->GetThermalReliefGap( pad );
+        // we need the thermal bridge half width
+        // with a small extra size to be sure we create a stub
+        // slightly larger than the actual stub
+        thermalBridgeWidth = ( thermalBridgeWidth + 4 ) / 2;
 
-            itemBB = pad->GetBoundingBox();
-            itemBB.Inflate( thermalReliefGap );
-            if( !( itemBB.Intersects( zoneBB ) ) )
-                continue;
+        int thermalReliefGap = aZone->GetThermalReliefGap( pad );
 
-            // Thermal bridges are like a segment from a starting point inside the pad
-            // to an ending point outside the pad
+        itemBB = pad->GetBoundingBox();
+        itemBB.Inflate( thermalReliefGap );
+        if( !( itemBB.Intersects( zoneBB ) ) )
+            continue;
 
-            // calculate the ending point of the thermal pad, outside the pad
-            VECTOR2I endpoint;
-            endpoint.x = ( pad->GetSize().x / 2 ) + thermalReliefGap;
-            endpoint.y = ( pad->GetSize().y / 2 ) + thermalReliefGap;
+        // Thermal bridges are like a segment from a starting point inside the pad
+        // to an ending point outside the pad
 
-            // Calculate the starting point of the thermal stub
-            // inside the pad
-            VECTOR2I startpoint;
-            int copperThickness = aZone->GetThermalReliefCopperBridge( pad )
-                                  - aZone->GetMinThickness();
+        // calculate the ending point of the thermal pad, outside the pad
+        VECTOR2I endpoint;
+        endpoint.x = ( pad->GetSize().x / 2 ) + thermalReliefGap;
+        endpoint.y = ( pad->GetSize().y / 2 ) + thermalReliefGap;
 
-            if( copperThickness < 0 )
-                copperThickness = 0;
+        // Calculate the starting point of the thermal stub
+        // inside the pad
+        VECTOR2I startpoint;
+        int copperThickness = aZone->GetThermalReliefCopperBridge( pad )
+                              - aZone->GetMinThickness();
 
-            // Leave a small extra size to the copper area inside to pad
-            copperThickness += KiROUND( IU_PER_MM * 0.04 );
+        if( copperThickness < 0 )
+            copperThickness = 0;
 
-            startpoint.x = std::min( pad->GetSize().x, copperThickness );
-            startpoint.y = std::min( pad->GetSize().y, copperThickness );
+        // Leave a small extra size to the copper area inside to pad
+        copperThickness += KiROUND( IU_PER_MM * 0.04 );
 
-            startpoint.x /= 2;
-            startpoint.y /= 2;
+        startpoint.x = std::min( pad->GetSize().x, copperThickness );
+        startpoint.y = std::min( pad->GetSize().y, copperThickness );
 
-            // This is a CIRCLE pad tweak
-            // for circle pads, the thermal stubs orientation is 45 deg
-            double fAngle = pad->GetOrientation();
-            if( pad->GetShape() == PAD_SHAPE_CIRCLE )
-            {
-                endpoint.x     = KiROUND( endpoint.x * aArcCorrection );
-                endpoint.y     = endpoint.x;
-                fAngle = aRoundPadThermalRotation;
-            }
+        startpoint.x /= 2;
+        startpoint.y /= 2;
 
-            // contour line width has to be taken into calculation to avoid "thermal stub bleed"
-            endpoint.x += pen_radius;
-            endpoint.y += pen_radius;
-            // compute north, south, west and east points for zone connection.
-            ptTest[0] = VECTOR2I( 0, endpoint.y );       // lower point
-            ptTest[1] = VECTOR2I( 0, -endpoint.y );      // upper point
-            ptTest[2] = VECTOR2I( endpoint.x, 0 );       // right point
-            ptTest[3] = VECTOR2I( -endpoint.x, 0 );      // left point
-
-            // Test all sides
-            for( int i = 0; i < 4; i++ )
-            {
-                // rotate point
-                RotatePoint( ptTest[i], fAngle );
+        // This is a CIRCLE pad tweak
+        // for circle pads, the thermal stubs orientation is 45 deg
+        double fAngle = pad->GetOrientation();
+        if( pad->GetShape() == PAD_SHAPE_CIRCLE )
+        {
+            endpoint.x     = KiROUND( endpoint.x * aArcCorrection );
+            endpoint.y     = endpoint.x;
+            fAngle = aRoundPadThermalRotation;
+        }
 
-                // translate point
-                ptTest[i] += pad->ShapePos();
+        // contour line width has to be taken into calculation to avoid "thermal stub bleed"
+        endpoint.x += pen_radius;
+        endpoint.y += pen_radius;
+        // compute north, south, west and east points for zone connection.
+        ptTest[0] = VECTOR2I( 0, endpoint.y );       // lower point
+        ptTest[1] = VECTOR2I( 0, -endpoint.y );      // upper point
+        ptTest[2] = VECTOR2I( endpoint.x, 0 );       // right point
+        ptTest[3] = VECTOR2I( -endpoint.x, 0 );      // left point
+
+        // Test all sides
+        for( int i = 0; i < 4; i++ )
+        {
+            // rotate point
+            RotatePoint( ptTest[i], fAngle );
 
-                if( aRawFilledArea.Contains( ptTest[i] ) )
-                    continue;
+            // translate point
+            ptTest[i] += pad->ShapePos();
 
-                spokes.Clear();
+            if( aRawFilledArea.Contains( ptTest[i] ) )
+                continue;
 
-                // polygons are rectangles with width of copper bridge value
-                switch( i )
-                {
-                case 0:       // lower stub
-                    spokes.Append( -thermalBridgeWidth, endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, startpoint.y );
-                    spokes.Append( -thermalBridgeWidth, startpoint.y );
-                    break;
-
-                case 1:       // upper stub
-                    spokes.Append( -thermalBridgeWidth, -endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, -endpoint.y );
-                    spokes.Append( +thermalBridgeWidth, -startpoint.y );
-                    spokes.Append( -thermalBridgeWidth, -startpoint.y );
-                    break;
-
-                case 2:       // right stub
-                    spokes.Append( endpoint.x, -thermalBridgeWidth );
-                    spokes.Append( endpoint.x, thermalBridgeWidth );
-                    spokes.Append( +startpoint.x, thermalBridgeWidth );
-                    spokes.Append( +startpoint.x, -thermalBridgeWidth );
-                    break;
-
-                case 3:       // left stub
-                    spokes.Append( -endpoint.x, -thermalBridgeWidth );
-                    spokes.Append( -endpoint.x, thermalBridgeWidth );
-                    spokes.Append( -startpoint.x, thermalBridgeWidth );
-                    spokes.Append( -startpoint.x, -thermalBridgeWidth );
-                    break;
-                }
+            spokes.Clear();
 
-                aCornerBuffer.NewOutline();
+            // polygons are rectangles with width of copper bridge value
+            switch( i )
+            {
+            case 0:       // lower stub
+                spokes.Append( -thermalBridgeWidth, endpoint.y );
+                spokes.Append( +thermalBridgeWidth, endpoint.y );
+                spokes.Append( +thermalBridgeWidth, startpoint.y );
+                spokes.Append( -thermalBridgeWidth, startpoint.y );
+                break;
 
-                // add computed polygon to list
-                for( int ic = 0; ic < spokes.PointCount(); ic++ )
-                {
-                    auto cpos = spokes.CPoint( ic );
-                    RotatePoint( cpos, fAngle );                               // Rotate according to module orientation
-                    cpos += pad->ShapePos();                              // Shift origin to position
-                    aCornerBuffer.Append( cpos );
-                }
+            case 1:       // upper stub
+                spokes.Append( -thermalBridgeWidth, -endpoint.y );
+                spokes.Append( +thermalBridgeWidth, -endpoint.y );
+                spokes.Append( +thermalBridgeWidth, -startpoint.y );
+                spokes.Append( -thermalBridgeWidth, -startpoint.y );
+                break;
+
+            case 2:       // right stub
+                spokes.Append( endpoint.x, -thermalBridgeWidth );
+                spokes.Append( endpoint.x, thermalBridgeWidth );
+                spokes.Append( +startpoint.x, thermalBridgeWidth );
+                spokes.Append( +startpoint.x, -thermalBridgeWidth );
+                break;
+
+            case 3:       // left stub
+                spokes.Append( -endpoint.x, -thermalBridgeWidth );
+                spokes.Append( -endpoint.x, thermalBridgeWidth );
+                spokes.Append( -startpoint.x, thermalBridgeWidth );
+                spokes.Append( -startpoint.x, -thermalBridgeWidth );
+                break;
+            }
+
+            aCornerBuffer.NewOutline();
+
+            // add computed polygon to list
+            for( int ic = 0; ic < spokes.PointCount(); ic++ )
+            {
+                auto cpos = spokes.CPoint( ic );
+                RotatePoint( cpos, fAngle );                               // Rotate according to module orientation
+                cpos += pad->ShapePos();                              // Shift origin to position
+                aCornerBuffer.Append( cpos );
             }
         }
     }
 }
 
 
+BOX2I ZONE_FILLER::thermalPadArea( const ZONE_CONTAINER* aZone,
+        const BOX2I& aFilledAreaBBox ) const
+{
+    BOX2I area = aFilledAreaBBox;
+
+    int biggest_clearance = m_board->GetDesignSettings().GetBiggestClearanceValue();
+    area.Inflate( std::max( biggest_clearance, aZone->GetZoneClearance() ) );
+
+    return area;
+}
+
+
 void ZONE_FILLER::addHatchFillTypeOnZone( const ZONE_CONTAINER* aZone, SHAPE_POLY_SET& aRawPolys ) const
 {
     // Build grid:
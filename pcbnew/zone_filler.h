@@ -26,10 +26,12 @@
 #ifndef __ZONE_FILLER_H
 #define __ZONE_FILLER_H
 
+#include <memory>
 #include <vector>
 #include <class_zone.h>
 
 class WX_PROGRESS_REPORTER;
+class THREAD_POOL;
 class BOARD;
 class COMMIT;
 class SHAPE_POLY_SET;
@@ -42,10 +44,30 @@ public:
     ~ZONE_FILLER();
 
     void SetProgressReporter( WX_PROGRESS_REPORTER* aReporter );
+
+    /**
+     * Run the fill on \a aPool instead of the process-wide pool (used by benchmarks).
+     */
+    void SetThreadPool( THREAD_POOL& aPool ) { m_pool = &aPool; }
+
+    /**
+     * Split the zones with many knockouts in tiles filled in parallel.  The default comes
+     * from the TiledZoneFill advanced option.
+     */
+    void SetTiledFill( bool aTiled ) { m_tiledFill = aTiled; }
+
     bool Fill( const std::vector<ZONE_CONTAINER*>& aZones, bool aCheck = false );
 
 private:
 
+    /**
+     * Board items which can knock out zones (pads, tracks and graphic items), indexed
+     * by copper layer.  Built once by each Fill() call and shared by the fill threads.
+     */
+    struct ITEM_INDEX;
+
+    void buildItemIndex();
+
     void buildZoneFeatureHoleList( const ZONE_CONTAINER* aZone,
             SHAPE_POLY_SET& aFeatures ) const;
 
@@ -59,13 +81,41 @@ private:
      * BuildFilledSolidAreasPolygons() call this function just after creating the
      *  filled copper area polygon (without clearance areas
      * @param aPcb: the current board
+     * @param aHoles: the areas built by buildZoneFeatureHoleList(), simplified in place
      * _NG version uses SHAPE_POLY_SET instead of Boost.Polygon
      */
     void computeRawFilledAreas( const ZONE_CONTAINER* aZone,
             const SHAPE_POLY_SET& aSmoothedOutline,
+            SHAPE_POLY_SET& aHoles,
             SHAPE_POLY_SET& aRawPolys,
             SHAPE_POLY_SET& aFinalPolys ) const;
 
+    /**
+     * Compute the raw filled area of a big solid zone in tiles: each tile subtracts only
+     * the knockouts and thermal stubs overlapping it, on its own thread, and the tiles are
+     * merged back into \a aFinalPolys.  The result is the same area as the one of
+     * computeRawFilledAreas(), with different vertices along the tile edges.
+     * @param aSolidAreas is the zone outline, shrunk by half the min thickness.
+     * @param aHoles is the list built by buildZoneFeatureHoleList().
+     * @return false (and do nothing) if the zone is too small to be split.
+     */
+    bool computeTiledFilledAreas( const ZONE_CONTAINER* aZone,
+            const SHAPE_POLY_SET& aSolidAreas,
+            const SHAPE_POLY_SET& aHoles,
+            double aCorrectionFactor,
+            SHAPE_POLY_SET& aFinalPolys ) const;
+
+    /**
+     * Hash everything the raw fill of a copper zone depends on: its smoothed outline, its
+     * fill settings and the shapes knocked out of it.  When the hash matches the one stored
+     * by the previous fill, the zone's raw polygons are reused instead of being computed
+     * again.
+     * @param aSmoothedOutline is the outline of the zone, after corner smoothing.
+     * @param aHoles is the list built by buildZoneFeatureHoleList().
+     */
+    MD5_HASH fillInputsHash( const ZONE_CONTAINER* aZone,
+            const SHAPE_POLY_SET& aSmoothedOutline, const SHAPE_POLY_SET& aHoles ) const;
+
     /**
      * Function buildUnconnectedThermalStubsPolygonList
      * Creates a set of polygons corresponding to stubs created by thermal shapes on pads
@@ -73,15 +123,23 @@ private:
      * @param aCornerBuffer = a SHAPE_POLY_SET where to store polygons
      * @param aPcb = the board.
      * @param aZone = a pointer to the ZONE_CONTAINER  to examine.
+     * @param aPadArea = the area where pads are examined (see thermalPadArea())
      * @param aArcCorrection = a pointer to the ZONE_CONTAINER  to examine.
      * @param aRoundPadThermalRotation = the rotation in 1.0 degree for thermal stubs in round pads
      */
     void buildUnconnectedThermalStubsPolygonList( SHAPE_POLY_SET& aCornerBuffer,
             const ZONE_CONTAINER* aZone,
             const SHAPE_POLY_SET&       aRawFilledArea,
+            const BOX2I& aPadArea,
             double aArcCorrection,
             double aRoundPadThermalRotation ) const;
 
+    /**
+     * @return the area where the pads of \a aZone can get thermal stubs: the bounding box of
+     * its filled area, inflated by the biggest clearance.
+     */
+    BOX2I thermalPadArea( const ZONE_CONTAINER* aZone, const BOX2I& aFilledAreaBBox ) const;
+
     /**
      * Build the filled solid areas polygons from zone outlines (stored in m_Poly)
      * The solid areas can be more than one on copper layers, and do not have holes
@@ -111,6 +169,10 @@ private:
     BOARD* m_board;
     COMMIT* m_commit;
     WX_PROGRESS_REPORTER* m_progressReporter;
+    THREAD_POOL* m_pool;
+    bool m_tiledFill;
+
+    std::unique_ptr<ITEM_INDEX> m_itemIndex;
 };
 
 #endif
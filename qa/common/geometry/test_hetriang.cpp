@@ -0,0 +1,158 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <ttl/halfedge/hetriang.h>
+#include <ttl/halfedge/hetraits.h>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+
+
+using EDGE_ENDS = std::tuple<int, int, int, int>;
+
+
+/**
+ * Edges of a triangulation between nodes with a non-negative id, as sorted coordinates
+ */
+static std::vector<EDGE_ENDS> getEdges( const hed::TRIANGULATION& aTriangulation )
+{
+    std::list<hed::EDGE_PTR> edges;
+    std::vector<EDGE_ENDS>   ends;
+
+    aTriangulation.GetEdges( edges );
+
+    for( const auto& edge : edges )
+    {
+        VECTOR2I a = edge->GetSourceNode()->GetPos();
+        VECTOR2I b = edge->GetTargetNode()->GetPos();
+
+        if( edge->GetSourceNode()->Id() < 0 || edge->GetTargetNode()->Id() < 0 )
+            continue;
+
+        if( std::make_pair( b.x, b.y ) < std::make_pair( a.x, a.y ) )
+            std::swap( a, b );
+
+        ends.emplace_back( a.x, a.y, b.x, b.y );
+    }
+
+    std::sort( ends.begin(), ends.end() );
+    return ends;
+}
+
+
+static void initRectangle( hed::TRIANGULATION& aTriangulation )
+{
+    aTriangulation.InitRectangle( -100000, -100000, 200000, 200000 );
+
+    for( hed::EDGE_PTR edge : aTriangulation.GetLeadingEdges() )
+    {
+        for( int i = 0; i < 3; ++i )
+        {
+            edge->GetSourceNode()->SetId( -1 );
+            edge = edge->GetNextEdgeInFace();
+        }
+    }
+}
+
+
+static hed::NODE_PTR makeNode( int aX, int aY )
+{
+    hed::NODE_PTR node = std::make_shared<hed::NODE>( aX, aY );
+    node->SetId( 0 );
+    return node;
+}
+
+
+BOOST_AUTO_TEST_SUITE( HeTriangulation )
+
+
+/**
+ * Moving nodes in place gives the same triangulation as building it again
+ */
+BOOST_AUTO_TEST_CASE( InsertRemove )
+{
+    std::mt19937                       rng( 42 );
+    std::uniform_int_distribution<int> coord( 0, 100000 );
+
+    std::vector<hed::NODE_PTR> nodes;
+
+    for( int i = 0; i < 500; i++ )
+        nodes.push_back( makeNode( coord( rng ), coord( rng ) ) );
+
+    hed::TRIANGULATION triangulation;
+    initRectangle( triangulation );
+
+    hed::DART dart = triangulation.CreateDart();
+
+    for( const auto& node : nodes )
+        BOOST_REQUIRE( triangulation.InsertNode( node, dart ) );
+
+    for( int step = 0; step < 10; step++ )
+    {
+        // Move a group of nodes
+        for( int i = 0; i < 20; i++ )
+        {
+            hed::NODE_PTR& node = nodes[step * 20 + i];
+
+            BOOST_REQUIRE( triangulation.RemoveNode( node, dart ) );
+            node = makeNode( coord( rng ), coord( rng ) );
+            BOOST_REQUIRE( triangulation.InsertNode( node, dart ) );
+        }
+
+        BOOST_CHECK( triangulation.CheckDelaunay() );
+
+        hed::TRIANGULATION reference;
+        initRectangle( reference );
+
+        hed::DART refDart = reference.CreateDart();
+
+        for( const auto& node : nodes )
+            reference.InsertNode( node, refDart );
+
+        const auto edges = getEdges( triangulation );
+        const auto refEdges = getEdges( reference );
+
+        BOOST_CHECK_EQUAL( edges.size(), refEdges.size() );
+        BOOST_CHECK( edges == refEdges );
+    }
+}
+
+
+/**
+ * Nodes which are not in the triangulation cannot be removed
+ */
+BOOST_AUTO_TEST_CASE( RemoveMissing )
+{
+    hed::TRIANGULATION triangulation;
+    initRectangle( triangulation );
+
+    hed::DART dart = triangulation.CreateDart();
+
+    BOOST_REQUIRE( triangulation.InsertNode( makeNode( 10, 10 ), dart ) );
+    BOOST_CHECK( !triangulation.RemoveNode( makeNode( 20, 20 ), dart ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,166 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <geometry/rtree.h>
+
+#include <climits>
+#include <random>
+#include <set>
+
+
+BOOST_AUTO_TEST_SUITE( RTreeBulkLoad )
+
+
+using TEST_TREE = RTree<long, int, 2, double>;
+
+
+static std::vector<TEST_TREE::Entry> randomEntries( int aCount, std::mt19937& aRng )
+{
+    std::uniform_int_distribution<int> pos( -100000, 100000 );
+    std::uniform_int_distribution<int> size( 0, 5000 );
+
+    std::vector<TEST_TREE::Entry> entries( aCount );
+
+    for( int i = 0; i < aCount; ++i )
+    {
+        entries[i].m_min[0] = pos( aRng );
+        entries[i].m_min[1] = pos( aRng );
+        entries[i].m_max[0] = entries[i].m_min[0] + size( aRng );
+        entries[i].m_max[1] = entries[i].m_min[1] + size( aRng );
+        entries[i].m_data = i;
+    }
+
+    return entries;
+}
+
+
+static std::set<long> search( const TEST_TREE& aTree, const TEST_TREE::Entry& aWindow )
+{
+    std::set<long> found;
+
+    aTree.Search( aWindow.m_min, aWindow.m_max,
+                  [&]( const long& aData )
+                  {
+                      found.insert( aData );
+                      return true;
+                  } );
+
+    return found;
+}
+
+
+static std::set<long> bruteForce( const std::vector<TEST_TREE::Entry>& aEntries,
+                                  const TEST_TREE::Entry& aWindow )
+{
+    std::set<long> found;
+
+    for( const TEST_TREE::Entry& entry : aEntries )
+    {
+        if( entry.m_min[0] <= aWindow.m_max[0] && entry.m_max[0] >= aWindow.m_min[0]
+                && entry.m_min[1] <= aWindow.m_max[1] && entry.m_max[1] >= aWindow.m_min[1] )
+        {
+            found.insert( entry.m_data );
+        }
+    }
+
+    return found;
+}
+
+
+/**
+ * A bulk loaded tree finds the same entries as a linear search, for trees of one node
+ * and of several levels
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadSearch )
+{
+    std::mt19937 rng( 42 );
+
+    for( int count : { 0, 1, 8, 9, 100, 5000 } )
+    {
+        BOOST_TEST_CONTEXT( count << " entries" )
+        {
+            std::vector<TEST_TREE::Entry> entries = randomEntries( count, rng );
+            TEST_TREE                     tree( entries );
+
+            BOOST_CHECK_EQUAL( tree.Count(), count );
+
+            for( const TEST_TREE::Entry& window : randomEntries( 50, rng ) )
+            {
+                TEST_TREE::Entry large = window;
+                large.m_max[0] += 20000;
+                large.m_max[1] += 20000;
+
+                BOOST_CHECK( search( tree, large ) == bruteForce( entries, large ) );
+            }
+        }
+    }
+}
+
+
+/**
+ * A bulk loaded tree can be modified as any other tree
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadRemoveInsert )
+{
+    std::mt19937                  rng( 7 );
+    std::vector<TEST_TREE::Entry> entries = randomEntries( 2000, rng );
+    TEST_TREE                     tree( entries );
+
+    for( size_t i = 0; i < entries.size(); i += 2 )
+        BOOST_CHECK( !tree.Remove( entries[i].m_min, entries[i].m_max, entries[i].m_data ) );
+
+    BOOST_CHECK_EQUAL( tree.Count(), 1000 );
+
+    for( size_t i = 0; i < entries.size(); i += 2 )
+        tree.Insert( entries[i].m_min, entries[i].m_max, entries[i].m_data );
+
+    TEST_TREE::Entry all = { { INT_MIN, INT_MIN }, { INT_MAX, INT_MAX }, 0 };
+
+    BOOST_CHECK( search( tree, all ) == bruteForce( entries, all ) );
+
+    tree.RemoveAll();
+    BOOST_CHECK_EQUAL( tree.Count(), 0 );
+}
+
+
+/**
+ * A bulk loaded tree is smaller than a tree built by inserting the same entries
+ */
+BOOST_AUTO_TEST_CASE( BulkLoadMemory )
+{
+    std::mt19937                  rng( 3 );
+    std::vector<TEST_TREE::Entry> entries = randomEntries( 20000, rng );
+    TEST_TREE                     inserted;
+
+    for( const TEST_TREE::Entry& entry : entries )
+        inserted.Insert( entry.m_min, entry.m_max, entry.m_data );
+
+    TEST_TREE loaded( entries );
+
+    BOOST_CHECK_LT( loaded.MemoryUsage(), inserted.MemoryUsage() );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
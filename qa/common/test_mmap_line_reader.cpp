@@ -0,0 +1,171 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for MMAP_LINE_READER and its use by DSNLEXER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <dsnlexer.h>
+#include <richio.h>
+
+#include <wx/filename.h>
+
+#include <fstream>
+
+
+/**
+ * Writes a temporary file, removed again at the end of the test
+ */
+struct MMAP_LINE_READER_FIXTURE
+{
+    MMAP_LINE_READER_FIXTURE() : m_fileName( wxFileName::CreateTempFileName( "mmap_lr" ) )
+    {
+    }
+
+    ~MMAP_LINE_READER_FIXTURE()
+    {
+        wxRemoveFile( m_fileName );
+    }
+
+    void Write( const std::string& aContent )
+    {
+        std::ofstream out( m_fileName.ToStdString(), std::ios::binary | std::ios::trunc );
+        out << aContent;
+    }
+
+    wxString m_fileName;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( MmapLineReader, MMAP_LINE_READER_FIXTURE )
+
+
+/**
+ * The lines are the same as the ones of a FILE_LINE_READER, including a last line
+ * without a newline
+ */
+BOOST_AUTO_TEST_CASE( SameLines )
+{
+    Write( "first\n\nthird line\nno newline" );
+
+    FILE_LINE_READER ref( m_fileName );
+    MMAP_LINE_READER reader( m_fileName );
+
+    while( ref.ReadLine() )
+    {
+        BOOST_REQUIRE( reader.ReadLine() );
+        BOOST_CHECK_EQUAL( reader.Line(), ref.Line() );
+        BOOST_CHECK_EQUAL( reader.Length(), ref.Length() );
+        BOOST_CHECK_EQUAL( reader.LineNumber(), ref.LineNumber() );
+    }
+
+    BOOST_CHECK( !reader.ReadLine() );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), ref.LineNumber() );
+
+    reader.Rewind();
+    const char* line = reader.ReadLineView();
+
+    BOOST_REQUIRE( line );
+    BOOST_CHECK_EQUAL( std::string( line, reader.Length() ), "first\n" );
+    BOOST_CHECK_EQUAL( reader.LineNumber(), 1 );
+}
+
+
+/**
+ * The remaining text starts after the last line read, and nothing is left after it
+ */
+BOOST_AUTO_TEST_CASE( RemainingView )
+{
+    Write( "first\nsecond\nno newline" );
+
+    MMAP_LINE_READER reader( m_fileName );
+    size_t           length;
+
+    BOOST_REQUIRE( reader.ReadLineView() );
+
+    const char* rest = reader.ReadRemainingView( &length );
+
+    BOOST_REQUIRE( rest );
+    BOOST_CHECK_EQUAL( std::string( rest, length ), "second\nno newline" );
+    BOOST_CHECK( !reader.ReadLineView() );
+
+    FILE_LINE_READER fileReader( m_fileName );
+
+    BOOST_CHECK( !fileReader.ReadRemainingView( &length ) );
+    BOOST_CHECK_EQUAL( length, 0u );
+}
+
+
+/**
+ * An empty file has no lines
+ */
+BOOST_AUTO_TEST_CASE( Empty )
+{
+    Write( "" );
+
+    MMAP_LINE_READER reader( m_fileName );
+
+    BOOST_CHECK( !reader.ReadLineView() );
+    BOOST_CHECK( !reader.ReadLine() );
+}
+
+
+/**
+ * DSNLEXER reads the same tokens from lines returned in place, and still reports
+ * nul terminated lines in its errors
+ */
+BOOST_AUTO_TEST_CASE( Lexer )
+{
+    Write( "(kicad_pcb (version 20171130)\n  (net 1 \"a b\")\n  (name \"x\\x41\")" );
+
+    std::vector<std::string> tokens;
+
+    {
+        FILE_LINE_READER ref( m_fileName );
+        DSNLEXER         lexer( NULL, 0, &ref );
+
+        while( lexer.NextTok() != DSN_EOF )
+            tokens.push_back( lexer.CurText() );
+    }
+
+    MMAP_LINE_READER reader( m_fileName );
+    DSNLEXER         lexer( NULL, 0, &reader );
+
+    for( const std::string& token : tokens )
+    {
+        BOOST_REQUIRE( lexer.NextTok() != DSN_EOF );
+        BOOST_CHECK_EQUAL( lexer.CurText(), token );
+
+        if( lexer.CurLineNumber() == 2 )
+            BOOST_CHECK_EQUAL( lexer.CurLine(), "  (net 1 \"a b\")\n" );
+    }
+
+    BOOST_CHECK_EQUAL( lexer.NextTok(), DSN_EOF );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
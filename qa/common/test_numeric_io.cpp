@@ -0,0 +1,201 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for the locale independent number reading and writing of numeric_io.h
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+// Code under test
+#include <numeric_io.h>
+
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+
+BOOST_AUTO_TEST_SUITE( NumericIo )
+
+
+/**
+ * ParseDouble() reads the same values and stops at the same place as strtod() (the tests
+ * run in the "C" locale)
+ */
+BOOST_AUTO_TEST_CASE( ParseDoubleLikeStrtod )
+{
+    const char* cases[] = {
+        "0", "-0", "1", "-1.5", "+2.25", "  3.0 4", "0.1", ".5", "5.", "1e3", "1.5E-7",
+        "123456789012345678901234", "0.000000000000000000000001", "1.7976931348623157e308",
+        "4.9e-324", "2.2250738585072014e-308", "9007199254740993", "0.30000000000000004",
+        "1e", "1e+", "12abc", "0x1p4", "inf", "-nan", "1.25.5", "1,5"
+    };
+
+    for( const char* text : cases )
+    {
+        char*       refEnd;
+        const char* end;
+        double      ref = strtod( text, &refEnd );
+        double      value = ParseDouble( text, &end );
+
+        BOOST_TEST_CONTEXT( "Text: \"" << text << "\"" )
+        {
+            if( std::isnan( ref ) )
+                BOOST_CHECK( std::isnan( value ) );
+            else
+                BOOST_CHECK( std::memcmp( &value, &ref, sizeof( double ) ) == 0 );
+
+            BOOST_CHECK_EQUAL( end - text, refEnd - text );
+        }
+    }
+}
+
+
+/**
+ * Text without a number reads as 0, and the end is the start of the text
+ */
+BOOST_AUTO_TEST_CASE( ParseDoubleNoNumber )
+{
+    const char* text = "  abc";
+    const char* end;
+
+    BOOST_CHECK_EQUAL( ParseDouble( text, &end ), 0.0 );
+    BOOST_CHECK( end == text );
+
+    text = "-.";
+    BOOST_CHECK_EQUAL( ParseDouble( text, &end ), 0.0 );
+    BOOST_CHECK( end == text );
+}
+
+
+/**
+ * Out of range numbers set errno, as strtod() does
+ */
+BOOST_AUTO_TEST_CASE( ParseDoubleRange )
+{
+    errno = 0;
+    BOOST_CHECK( std::isinf( ParseDouble( "1e400" ) ) );
+    BOOST_CHECK_EQUAL( errno, ERANGE );
+
+    errno = 0;
+    BOOST_CHECK_EQUAL( ParseDouble( "123.456" ), 123.456 );
+    BOOST_CHECK_EQUAL( errno, 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( ParseLongBases )
+{
+    const char* end;
+    const char* text = " -1234 5";
+
+    BOOST_CHECK_EQUAL( ParseLong( text, &end ), -1234 );
+    BOOST_CHECK_EQUAL( end - text, 6 );
+
+    BOOST_CHECK_EQUAL( ParseLong( "7fffffff", nullptr, 16 ), 0x7fffffffL );
+    BOOST_CHECK_EQUAL( ParseLong( "0x1A", nullptr, 16 ), 0x1A );
+    BOOST_CHECK_EQUAL( ParseLong( "0x1A" ), 0 );
+
+    // "0x" without hex digits is the number 0 followed by "x"
+    text = "0xg";
+    BOOST_CHECK_EQUAL( ParseLong( text, &end, 16 ), 0 );
+    BOOST_CHECK_EQUAL( end - text, 1 );
+
+    text = "x";
+    BOOST_CHECK_EQUAL( ParseLong( text, &end ), 0 );
+    BOOST_CHECK( end == text );
+}
+
+
+BOOST_AUTO_TEST_CASE( ParseLongRange )
+{
+    errno = 0;
+    BOOST_CHECK_EQUAL( ParseLong( "99999999999999999999999" ), LONG_MAX );
+    BOOST_CHECK_EQUAL( errno, ERANGE );
+
+    errno = 0;
+    BOOST_CHECK_EQUAL( ParseLong( "-99999999999999999999999" ), LONG_MIN );
+    BOOST_CHECK_EQUAL( errno, ERANGE );
+
+    errno = 0;
+    std::string min = std::to_string( LONG_MIN );
+    BOOST_CHECK_EQUAL( ParseLong( min.c_str() ), LONG_MIN );
+    BOOST_CHECK_EQUAL( errno, 0 );
+}
+
+
+BOOST_AUTO_TEST_CASE( Snprintf )
+{
+    char buf[8];
+
+    BOOST_CHECK_EQUAL( SnprintfC( buf, sizeof( buf ), "%.2f", 1.5 ), 4 );
+    BOOST_CHECK_EQUAL( std::string( buf ), "1.50" );
+
+    // Too small buffers are truncated, and the needed size returned
+    BOOST_CHECK_EQUAL( SnprintfC( buf, sizeof( buf ), "%s", "0123456789" ), 10 );
+    BOOST_CHECK_EQUAL( std::string( buf ), "0123456" );
+}
+
+
+/**
+ * FormatDouble() writes short texts when they are exact, and more digits when needed
+ */
+BOOST_AUTO_TEST_CASE( FormatDoubleShortest )
+{
+    BOOST_CHECK_EQUAL( FormatDouble( 0.1 ), "0.1" );
+    BOOST_CHECK_EQUAL( FormatDouble( -2.5 ), "-2.5" );
+    BOOST_CHECK_EQUAL( FormatDouble( 100.0 ), "100" );
+    BOOST_CHECK_EQUAL( FormatDouble( 0.1 + 0.2 ), "0.30000000000000004" );
+}
+
+
+/**
+ * Random values survive a FormatDouble() and ParseDouble() round trip
+ */
+BOOST_AUTO_TEST_CASE( RoundTrip )
+{
+    std::mt19937_64                        rng( 42 );
+    std::uniform_real_distribution<double> mm( -1000.0, 1000.0 );
+    std::uniform_int_distribution<int>     exponent( -300, 300 );
+
+    for( int i = 0; i < 10000; ++i )
+    {
+        double value = mm( rng );
+
+        if( i % 2 )
+            value = std::ldexp( value, exponent( rng ) );
+
+        std::string text = FormatDouble( value );
+
+        BOOST_TEST_CONTEXT( "Text: " << text )
+        {
+            BOOST_CHECK_EQUAL( ParseDouble( text.c_str() ), value );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,127 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <thread_pool.h>
+
+#include <atomic>
+#include <stdexcept>
+
+
+BOOST_AUTO_TEST_SUITE( ThreadPool )
+
+
+/**
+ * Every item is processed exactly once, including by nested calls, whatever the pool size
+ */
+BOOST_AUTO_TEST_CASE( ParallelForEachItemOnce )
+{
+    for( size_t threads : { 1, 2, 4, 8 } )
+    {
+        BOOST_TEST_CONTEXT( threads << " threads" )
+        {
+            THREAD_POOL pool( threads );
+
+            std::vector<std::atomic<int>> counts( 1000 );
+            std::atomic<int>              nested( 0 );
+
+            for( auto& count : counts )
+                count = 0;
+
+            pool.ParallelFor( counts.size(),
+                    [&]( size_t i )
+                    {
+                        counts[i]++;
+
+                        BOOST_CHECK_LT( pool.GetSlot(), pool.GetSlotCount() );
+
+                        if( i % 100 == 0 )
+                            pool.ParallelFor( 10, [&]( size_t ) { nested++; } );
+                    } );
+
+            for( auto& count : counts )
+                BOOST_CHECK_EQUAL( count, 1 );
+
+            BOOST_CHECK_EQUAL( nested, 100 );
+        }
+    }
+}
+
+
+/**
+ * Submitted tasks return their result through the future
+ */
+BOOST_AUTO_TEST_CASE( SubmitFuture )
+{
+    THREAD_POOL pool( 4 );
+
+    std::vector<std::future<int>> results;
+
+    for( int i = 0; i < 100; ++i )
+        results.push_back( pool.Submit( [i]() { return i * i; } ) );
+
+    for( int i = 0; i < 100; ++i )
+        BOOST_CHECK_EQUAL( results[i].get(), i * i );
+}
+
+
+/**
+ * The wait hook can cancel the items not started yet
+ */
+BOOST_AUTO_TEST_CASE( HookCancels )
+{
+    THREAD_POOL      pool( 2 );
+    std::atomic<int> done( 0 );
+
+    bool completed = pool.ParallelFor( 100,
+            [&]( size_t )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+                done++;
+            },
+            []() { return false; } );
+
+    BOOST_CHECK( !completed );
+    BOOST_CHECK_LT( done, 100 );
+}
+
+
+/**
+ * Exceptions thrown by an item are rethrown to the caller
+ */
+BOOST_AUTO_TEST_CASE( Exception )
+{
+    THREAD_POOL pool( 4 );
+
+    BOOST_CHECK_THROW( pool.ParallelFor( 100,
+                               []( size_t i )
+                               {
+                                   if( i == 50 )
+                                       throw std::runtime_error( "item 50" );
+                               } ),
+            std::runtime_error );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -25,6 +25,7 @@
 
 #include "tools/coroutines/coroutine_tools.h"
 #include "tools/io_benchmark/io_benchmark.h"
+#include "tools/rtree_benchmark/rtree_benchmark.h"
 #include "tools/sexpr_parser/sexpr_parse.h"
 
 /**
@@ -36,6 +37,7 @@
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
     &coroutine_tool,
     &io_benchmark_tool,
+    &rtree_benchmark_tool,
     &sexpr_parser_tool,
 };
 
@@ -25,6 +25,7 @@
 
 #include <wx/wx.h>
 #include <richio.h>
+#include <dsnlexer.h>
 
 #include <chrono>
 #include <ios>
@@ -157,6 +158,75 @@ static void bench_line_reader_reuse( const wxFileName& aFile, int aReps, BENCH_R
 }
 
 
+/**
+ * Benchmark using a given LINE_READER implementation, reading the lines with
+ * ReadLineView(), i.e. in place if the reader supports it.
+ * The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_line_reader_view( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR fstr( aFile.GetFullPath() );
+        const char* line;
+
+        while( ( line = fstr.ReadLineView() ) != NULL )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+        }
+    }
+}
+
+
+/**
+ * Benchmark using a given LINE_READER implementation, reading the lines with
+ * ReadLineView(), i.e. in place if the reader supports it.
+ * The LINE_READER is rewound for each cycle, not recreated.
+ */
+template<typename LR>
+static void bench_line_reader_view_reuse( const wxFileName& aFile, int aReps,
+        BENCH_REPORT& report )
+{
+    LR fstr( aFile.GetFullPath() );
+    for( int i = 0; i < aReps; ++i)
+    {
+        const char* line;
+
+        while( ( line = fstr.ReadLineView() ) != NULL )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) line[0];
+        }
+
+        fstr.Rewind();
+    }
+}
+
+
+/**
+ * Benchmark tokenising the file with a DSNLEXER reading from a given LINE_READER
+ * implementation.  This reports the number of tokens rather than lines.
+ * The LINE_READER is recreated for each cycle.
+ */
+template<typename LR>
+static void bench_dsnlexer( const wxFileName& aFile, int aReps, BENCH_REPORT& report )
+{
+    for( int i = 0; i < aReps; ++i)
+    {
+        LR       fstr( aFile.GetFullPath() );
+        DSNLEXER lexer( NULL, 0, &fstr );
+
+        while( lexer.NextTok() != DSN_EOF )
+        {
+            report.linesRead++;
+            report.charAcc += (unsigned char) lexer.CurText()[0];
+        }
+    }
+}
+
+
 /**
  * Benchmark using STRING_LINE_READER on string data read into memory from a file
  * using std::ifstream, but read the data fresh from the file each time
@@ -313,6 +383,12 @@ static std::vector<BENCHMARK> benchmarkList =
     { 'F', bench_fstream_reuse, "std::fstream, reused" },
     { 'r', bench_line_reader<FILE_LINE_READER>, "RichIO FILE_L_R" },
     { 'R', bench_line_reader_reuse<FILE_LINE_READER>, "RichIO FILE_L_R, reused" },
+    { 'm', bench_line_reader<MMAP_LINE_READER>, "RichIO MMAP_L_R" },
+    { 'M', bench_line_reader_reuse<MMAP_LINE_READER>, "RichIO MMAP_L_R, reused" },
+    { 'v', bench_line_reader_view<MMAP_LINE_READER>, "RichIO MMAP_L_R, view" },
+    { 'V', bench_line_reader_view_reuse<MMAP_LINE_READER>, "RichIO MMAP_L_R, view, reused" },
+    { 'l', bench_dsnlexer<FILE_LINE_READER>, "DSNLEXER on FILE_L_R (tokens)" },
+    { 'L', bench_dsnlexer<MMAP_LINE_READER>, "DSNLEXER on MMAP_L_R (tokens)" },
     { 'n', bench_line_reader<IFSTREAM_LINE_READER>, "std::ifstream L_R" },
     { 'N', bench_line_reader_reuse<IFSTREAM_LINE_READER>, "std::ifstream L_R, reused" },
     { 's', bench_string_lr, "RichIO STRING_L_R"},
@@ -0,0 +1,269 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "rtree_benchmark.h"
+
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <geometry/rtree.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+/// The tree of the VIEW layers and SHAPE_INDEX, items being pointers
+using BENCH_TREE = RTree<void*, int, 2, double>;
+
+using BENCH_DURATION = std::chrono::microseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "items",
+            _( "number of items in the tree (default 200000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "q",
+            "queries",
+            _( "number of queries (default 100000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "w",
+            "window",
+            _( "size of the query windows in mm (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "seed",
+            _( "seed of the random items and queries (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum RTREE_BENCHMARK_RET_CODES
+{
+    RESULTS_DIFFER = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+};
+
+
+/// The measures of a way of building a tree
+struct BENCH_REPORT
+{
+    BENCH_DURATION buildTime;
+    BENCH_DURATION queryTime;
+    size_t         memory;
+    long long      found;       ///< items found by all the queries, to check the trees match
+};
+
+
+/**
+ * Generates random items looking like the items of a 300 x 200 mm board: mostly pads, vias
+ * and track segments from 0.2 to 5 mm, and some long tracks and zones.
+ */
+static std::vector<BENCH_TREE::Entry> generateItems( long aCount, std::mt19937& aRng )
+{
+    const int MM = 1000000;
+
+    std::uniform_int_distribution<int> x( 0, 300 * MM );
+    std::uniform_int_distribution<int> y( 0, 200 * MM );
+    std::uniform_int_distribution<int> small( MM / 5, 5 * MM );
+    std::uniform_int_distribution<int> large( 5 * MM, 50 * MM );
+    std::uniform_int_distribution<int> kind( 0, 99 );
+
+    std::vector<BENCH_TREE::Entry> items( aCount );
+
+    for( long i = 0; i < aCount; ++i )
+    {
+        bool isLarge = kind( aRng ) < 5;
+        int  w = isLarge ? large( aRng ) : small( aRng );
+        int  h = isLarge ? small( aRng ) : small( aRng );
+
+        if( kind( aRng ) < 50 )
+            std::swap( w, h );
+
+        items[i].m_min[0] = x( aRng );
+        items[i].m_min[1] = y( aRng );
+        items[i].m_max[0] = items[i].m_min[0] + w;
+        items[i].m_max[1] = items[i].m_min[1] + h;
+        items[i].m_data = reinterpret_cast<void*>( i + 1 );
+    }
+
+    return items;
+}
+
+
+static void runQueries( const BENCH_TREE& aTree, const std::vector<BENCH_TREE::Entry>& aQueries,
+                        BENCH_REPORT& aReport )
+{
+    SCOPED_TIMER<BENCH_DURATION> timer( aReport.queryTime );
+
+    aReport.found = 0;
+
+    for( const BENCH_TREE::Entry& query : aQueries )
+    {
+        aReport.found += aTree.Search( query.m_min, query.m_max,
+                                       []( void* const& ) { return true; } );
+    }
+}
+
+
+static void printReport( const std::string& aName, const BENCH_REPORT& aReport )
+{
+    std::cout << std::left << std::setw( 12 ) << aName << std::right
+              << std::setw( 12 ) << aReport.buildTime.count() / 1000.0
+              << std::setw( 12 ) << aReport.queryTime.count() / 1000.0
+              << std::setw( 14 ) << aReport.found
+              << std::setw( 12 ) << aReport.memory / 1024 << std::endl;
+}
+
+
+int rtree_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program builds an R-tree from random board items, once by inserting the "
+               "items one by one and once by bulk loading them, and compares the build time, "
+               "the time taken by random queries and the memory used by the trees." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long itemCount = 200000;
+    cl_parser.Found( "items", &itemCount );
+
+    long queryCount = 100000;
+    cl_parser.Found( "queries", &queryCount );
+
+    long window = 5;
+    cl_parser.Found( "window", &window );
+
+    long seed = 1;
+    cl_parser.Found( "seed", &seed );
+
+    if( itemCount < 0 || queryCount < 0 || window <= 0 )
+    {
+        std::cerr << "The counts cannot be negative and the window must be positive"
+                  << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    std::mt19937                   rng( seed );
+    std::vector<BENCH_TREE::Entry> items = generateItems( itemCount, rng );
+    std::vector<BENCH_TREE::Entry> queries = generateItems( queryCount, rng );
+
+    for( BENCH_TREE::Entry& query : queries )
+    {
+        query.m_max[0] = query.m_min[0] + window * 1000000;
+        query.m_max[1] = query.m_min[1] + window * 1000000;
+    }
+
+    std::cout << itemCount << " items, " << queryCount << " queries of " << window << " mm"
+              << std::endl << std::endl;
+    std::cout << std::left << std::setw( 12 ) << "" << std::right
+              << std::setw( 12 ) << "build ms" << std::setw( 12 ) << "query ms"
+              << std::setw( 14 ) << "found" << std::setw( 12 ) << "memory KiB" << std::endl;
+
+    BENCH_REPORT inserted;
+
+    {
+        BENCH_TREE tree;
+
+        {
+            SCOPED_TIMER<BENCH_DURATION> timer( inserted.buildTime );
+
+            for( const BENCH_TREE::Entry& item : items )
+                tree.Insert( item.m_min, item.m_max, item.m_data );
+        }
+
+        inserted.memory = tree.MemoryUsage();
+        runQueries( tree, queries, inserted );
+    }
+
+    printReport( "insert", inserted );
+
+    BENCH_REPORT loaded;
+
+    {
+        BENCH_TREE tree;
+
+        {
+            SCOPED_TIMER<BENCH_DURATION> timer( loaded.buildTime );
+            tree.BulkLoad( items );
+        }
+
+        loaded.memory = tree.MemoryUsage();
+        runQueries( tree, queries, loaded );
+    }
+
+    printReport( "bulk load", loaded );
+
+    if( inserted.found != loaded.found )
+    {
+        std::cerr << "The trees do not find the same items" << std::endl;
+        return RESULTS_DIFFER;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM rtree_benchmark_tool = {
+    "rtree_benchmark",
+    "Benchmark building an R-tree by insertion and by bulk loading",
+    rtree_benchmark_main_func,
+};
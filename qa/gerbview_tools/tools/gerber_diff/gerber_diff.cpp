@@ -0,0 +1,541 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "gerber_diff.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <convert_to_biu.h>
+#include <thread_pool.h>
+
+#include <gerber_file_image.h>
+#include <excellon_image.h>
+#include <gerber_rasterizer.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using DIFF_DURATION = std::chrono::milliseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "d",
+            "dpi",
+            _( "resolution of the comparison in dots per inch (default 1000)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "directory to write the difference image of each layer to, as a PBM file" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "rows",
+            _( "number of rows of a tile, the unit of work of a thread (default 32)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "report the time taken by each step" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "reference Gerber or drill file, or directory of files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "compared Gerber or drill file, or directory of files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum GERBER_DIFF_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    WRITE_FAILED,
+    DIFFERENCES_FOUND,
+};
+
+
+/// The files of a layer in the two revisions.  The file can be missing in one of them.
+struct LAYER_PAIR
+{
+    wxString                           m_files[2];
+    std::unique_ptr<GERBER_FILE_IMAGE> m_images[2];
+    std::unique_ptr<GERBER_RASTERIZER> m_rasters[2];
+};
+
+
+/// The pixel grid the layers are rendered on
+struct RASTER_GRID
+{
+    VECTOR2I m_origin;
+    int      m_width;
+    int      m_height;
+};
+
+
+struct PIXEL_COUNTS
+{
+    uint64_t m_dark[2];     ///< dark pixels of the reference and compared layer
+    uint64_t m_diff;        ///< pixels which differ
+};
+
+
+/**
+ * Files are recognised by their extension, as in the zip archives loaded by GerbView:
+ * .g* (except job files) and .pho are Gerber files, .drl are drill files.
+ */
+static bool isDrillFile( const wxString& aFile )
+{
+    return wxFileName( aFile ).GetExt().Lower() == "drl";
+}
+
+
+static bool isFabricationFile( const wxString& aFile )
+{
+    wxString ext = wxFileName( aFile ).GetExt().Lower();
+
+    return ( ext.StartsWith( "g" ) && ext != "gbrjob" ) || ext == "pho" || ext == "drl";
+}
+
+
+/**
+ * Fill the file names of revision aRev (0 or 1) of aLayers, from a file or a directory.
+ */
+static bool listFiles( const wxString& aPath, int aRev, std::map<wxString, LAYER_PAIR>& aLayers )
+{
+    if( wxFileName::FileExists( aPath ) )
+    {
+        aLayers[wxFileName( aPath ).GetFullName()].m_files[aRev] = aPath;
+        return true;
+    }
+
+    if( !wxFileName::DirExists( aPath ) )
+    {
+        std::cerr << "Cannot find " << aPath << std::endl;
+        return false;
+    }
+
+    wxArrayString files;
+    wxDir::GetAllFiles( aPath, &files, wxEmptyString, wxDIR_FILES );
+
+    for( const wxString& file : files )
+    {
+        if( isFabricationFile( file ) )
+            aLayers[wxFileName( file ).GetFullName()].m_files[aRev] = file;
+    }
+
+    return true;
+}
+
+
+/**
+ * Render the two revisions of a layer and compare them, tile by tile.  A tile is a band of
+ * full rows; a few tiles per thread are rendered at once and written to the difference
+ * image before the next ones, so the full bitmaps are never in memory.
+ *
+ * @param aOutput is the PBM file to write the difference to, none if empty.
+ */
+static bool compareLayer( const LAYER_PAIR& aLayer, const RASTER_GRID& aGrid, int aTileRows,
+                          const wxString& aOutput, PIXEL_COUNTS& aCounts )
+{
+    THREAD_POOL& pool = THREAD_POOL::GetPool();
+    FILE*        out = nullptr;
+
+    if( !aOutput.IsEmpty() )
+    {
+        out = wxFopen( aOutput, "wb" );
+
+        if( !out )
+        {
+            std::cerr << "Cannot create " << aOutput << std::endl;
+            return false;
+        }
+
+        fprintf( out, "P4\n%d %d\n", aGrid.m_width, aGrid.m_height );
+    }
+
+    const size_t rowBytes = ( aGrid.m_width + 7 ) / 8;
+    const size_t tilePixels = (size_t) aGrid.m_width * aTileRows;
+    const int    tileCount = ( aGrid.m_height + aTileRows - 1 ) / aTileRows;
+    const int    tilesPerPass = pool.GetSlotCount() * 2;
+
+    // Difference bits of the tiles of a pass, and pixels of the two revisions per thread
+    std::vector<uint8_t>              bits( tilesPerPass * aTileRows * rowBytes );
+    std::vector<std::vector<uint8_t>> pixels( pool.GetSlotCount() );
+    std::vector<PIXEL_COUNTS>         tileCounts( tilesPerPass );
+
+    memset( &aCounts, 0, sizeof( aCounts ) );
+
+    for( int firstTile = 0; firstTile < tileCount; firstTile += tilesPerPass )
+    {
+        int passTiles = std::min( tilesPerPass, tileCount - firstTile );
+
+        auto compareTile = [&]( size_t aTile )
+        {
+            int           firstRow = ( firstTile + aTile ) * aTileRows;
+            int           rows = std::min( aTileRows, aGrid.m_height - firstRow );
+            PIXEL_COUNTS& counts = tileCounts[aTile];
+            uint8_t*      diff = bits.data() + aTile * aTileRows * rowBytes;
+
+            std::vector<uint8_t>& buffer = pixels[pool.GetSlot()];
+            buffer.resize( 2 * tilePixels );
+
+            uint8_t* revs[2] = { buffer.data(), buffer.data() + tilePixels };
+
+            for( int rev = 0; rev < 2; rev++ )
+            {
+                if( aLayer.m_rasters[rev] )
+                {
+                    aLayer.m_rasters[rev]->RasterizeRows( aGrid.m_origin, aGrid.m_width,
+                                                          firstRow, rows, revs[rev] );
+                }
+                else
+                {
+                    memset( revs[rev], 0, tilePixels );
+                }
+            }
+
+            memset( &counts, 0, sizeof( counts ) );
+            memset( diff, 0, rows * rowBytes );
+
+            for( int row = 0; row < rows; row++ )
+            {
+                const uint8_t* ref = revs[0] + (size_t) row * aGrid.m_width;
+                const uint8_t* cmp = revs[1] + (size_t) row * aGrid.m_width;
+                uint8_t*       line = diff + row * rowBytes;
+
+                for( int col = 0; col < aGrid.m_width; col++ )
+                {
+                    counts.m_dark[0] += ref[col];
+                    counts.m_dark[1] += cmp[col];
+
+                    if( ref[col] != cmp[col] )
+                    {
+                        counts.m_diff++;
+                        line[col >> 3] |= 0x80 >> ( col & 7 );
+                    }
+                }
+            }
+        };
+
+        pool.ParallelFor( passTiles, compareTile );
+
+        for( int ii = 0; ii < passTiles; ii++ )
+        {
+            aCounts.m_dark[0] += tileCounts[ii].m_dark[0];
+            aCounts.m_dark[1] += tileCounts[ii].m_dark[1];
+            aCounts.m_diff += tileCounts[ii].m_diff;
+        }
+
+        if( out )
+        {
+            int rows = std::min( passTiles * aTileRows, aGrid.m_height - firstTile * aTileRows );
+
+            fwrite( bits.data(), rowBytes, rows, out );
+        }
+    }
+
+    if( out )
+    {
+        bool ok = !ferror( out );
+
+        if( fclose( out ) != 0 || !ok )
+        {
+            std::cerr << "Cannot write " << aOutput << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+
+int gerber_diff_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program compares the Gerber and NC drill files of two board revisions: "
+               "each layer is rendered at the given resolution, without display, and the "
+               "pixels which differ are counted.  Files of two directories are paired by "
+               "name.  The return code is non zero if a layer differs." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    long dpi = 1000;
+    cl_parser.Found( "dpi", &dpi );
+
+    long tileRows = 32;
+    cl_parser.Found( "rows", &tileRows );
+
+    if( dpi <= 0 || tileRows <= 0 )
+    {
+        std::cerr << "The resolution and the number of rows must be positive" << std::endl;
+        return KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxString outputDir;
+
+    if( cl_parser.Found( "output", &outputDir ) && !wxFileName::DirExists( outputDir )
+            && !wxFileName::Mkdir( outputDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+    {
+        std::cerr << "Cannot create " << outputDir << std::endl;
+        return WRITE_FAILED;
+    }
+
+    const bool verbose = cl_parser.Found( "verbose" );
+
+    std::map<wxString, LAYER_PAIR> layers;
+    const wxString                 paths[2] = { cl_parser.GetParam( 0 ), cl_parser.GetParam( 1 ) };
+
+    // Two files are compared with each other, whatever their names
+    if( wxFileName::FileExists( paths[0] ) && wxFileName::FileExists( paths[1] ) )
+    {
+        LAYER_PAIR& layer = layers[wxFileName( paths[0] ).GetFullName()];
+        layer.m_files[0] = paths[0];
+        layer.m_files[1] = paths[1];
+    }
+    else if( !listFiles( paths[0], 0, layers ) || !listFiles( paths[1], 1, layers ) )
+    {
+        return LOAD_FAILED;
+    }
+
+    std::vector<LAYER_PAIR*> layerList;
+    std::vector<std::pair<LAYER_PAIR*, int>> files;
+
+    for( auto& layer : layers )
+    {
+        layerList.push_back( &layer.second );
+
+        for( int rev = 0; rev < 2; rev++ )
+        {
+            if( !layer.second.m_files[rev].IsEmpty() )
+                files.emplace_back( &layer.second, rev );
+        }
+    }
+
+    THREAD_POOL&  pool = THREAD_POOL::GetPool();
+    DIFF_DURATION loadTime{};
+    DIFF_DURATION prepareTime{};
+    DIFF_DURATION compareTime{};
+
+    // The files are independent: parse them all at the same time
+    {
+        SCOPED_TIMER<DIFF_DURATION> timer( loadTime );
+
+        pool.ParallelFor( files.size(),
+                [&]( size_t aIdx )
+                {
+                    LAYER_PAIR&     layer = *files[aIdx].first;
+                    int             rev = files[aIdx].second;
+                    const wxString& file = layer.m_files[rev];
+                    bool            ok;
+
+                    if( isDrillFile( file ) )
+                    {
+                        EXCELLON_IMAGE* drill = new EXCELLON_IMAGE( 0 );
+                        layer.m_images[rev].reset( drill );
+                        ok = drill->LoadFile( file );
+                    }
+                    else
+                    {
+                        layer.m_images[rev].reset( new GERBER_FILE_IMAGE( 0 ) );
+                        ok = layer.m_images[rev]->LoadGerberFile( file );
+                    }
+
+                    if( !ok )
+                        layer.m_images[rev].reset();
+                } );
+    }
+
+    for( const auto& file : files )
+    {
+        if( !file.first->m_images[file.second] )
+        {
+            std::cerr << "Cannot read " << file.first->m_files[file.second] << std::endl;
+            return LOAD_FAILED;
+        }
+    }
+
+    // Convert the items of each image to polygons
+    const double pixelSize = IU_PER_MILS * 1000.0 / dpi;
+
+    {
+        SCOPED_TIMER<DIFF_DURATION> timer( prepareTime );
+
+        pool.ParallelFor( files.size(),
+                [&]( size_t aIdx )
+                {
+                    LAYER_PAIR& layer = *files[aIdx].first;
+                    int         rev = files[aIdx].second;
+
+                    layer.m_rasters[rev].reset(
+                            new GERBER_RASTERIZER( layer.m_images[rev].get(), pixelSize ) );
+                } );
+    }
+
+    // All the layers use the same grid, so their images can be stacked
+    BOX2I extents;
+    bool  hasItems = false;
+
+    for( const auto& file : files )
+    {
+        const BOX2I& bbox = file.first->m_rasters[file.second]->GetBoundingBox();
+
+        if( bbox.GetWidth() == 0 && bbox.GetHeight() == 0 )
+            continue;
+
+        if( hasItems )
+            extents.Merge( bbox );
+        else
+            extents = bbox;
+
+        hasItems = true;
+    }
+
+    if( !hasItems )
+    {
+        std::cout << "No items to compare" << std::endl;
+        return KI_TEST::RET_CODES::OK;
+    }
+
+    extents.Inflate( KiROUND( pixelSize ) );
+
+    RASTER_GRID grid;
+    grid.m_origin = extents.GetOrigin();
+    grid.m_width = KiROUND( std::ceil( extents.GetWidth() / pixelSize ) );
+    grid.m_height = KiROUND( std::ceil( extents.GetHeight() / pixelSize ) );
+
+    std::cout << "Comparing " << layerList.size() << " layers on " << grid.m_width << "x"
+              << grid.m_height << " pixels at " << dpi << " dpi" << std::endl;
+
+    const double pixelArea = ( 25.4 / dpi ) * ( 25.4 / dpi );    // in mm2
+    bool         differ = false;
+    bool         written = true;
+
+    {
+        SCOPED_TIMER<DIFF_DURATION> timer( compareTime );
+
+        for( const auto& layer : layers )
+        {
+            const LAYER_PAIR& pair = layer.second;
+            PIXEL_COUNTS      counts;
+            wxString          output;
+
+            if( !outputDir.IsEmpty() )
+                output = wxFileName( outputDir, layer.first + ".diff.pbm" ).GetFullPath();
+
+            if( !compareLayer( pair, grid, tileRows, output, counts ) )
+                written = false;
+
+            std::cout << layer.first << ": ";
+
+            if( !pair.m_rasters[0] )
+                std::cout << "missing in the reference, ";
+            else if( !pair.m_rasters[1] )
+                std::cout << "missing in the compared files, ";
+
+            std::cout << counts.m_diff << " different pixels (" << std::fixed
+                      << std::setprecision( 3 ) << counts.m_diff * pixelArea << " mm2), "
+                      << counts.m_dark[0] << " / " << counts.m_dark[1] << " dark pixels";
+
+            if( ( pair.m_rasters[0] && pair.m_rasters[0]->HasNegativeItems() )
+                    || ( pair.m_rasters[1] && pair.m_rasters[1]->HasNegativeItems() ) )
+            {
+                std::cout << ", with negative items";
+            }
+
+            std::cout << std::endl;
+
+            if( counts.m_diff || !pair.m_rasters[0] || !pair.m_rasters[1] )
+                differ = true;
+        }
+    }
+
+    if( verbose )
+    {
+        std::cout << "Load: " << loadTime.count() << "ms, shapes: " << prepareTime.count()
+                  << "ms, rasters: " << compareTime.count() << "ms" << std::endl;
+    }
+
+    if( !written )
+        return WRITE_FAILED;
+
+    return differ ? DIFFERENCES_FOUND : KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM gerber_diff_tool = {
+    "gerber_diff",
+    "Compare the Gerber and drill files of two board revisions pixel by pixel",
+    gerber_diff_main_func,
+};
@@ -0,0 +1,84 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_track.h>
+
+#include <drc/drc_dirty_region.h>
+
+
+BOOST_AUTO_TEST_SUITE( DrcDirtyRegion )
+
+
+/**
+ * Boxes only intersect the region when they come within the margin of a recorded area
+ */
+BOOST_AUTO_TEST_CASE( AreaMargin )
+{
+    DRC_DIRTY_REGION region;
+
+    BOOST_CHECK( region.IsEmpty() );
+    BOOST_CHECK( !region.Intersects( EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), 1000 ) );
+
+    region.Add( EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ) );
+    region.Add( EDA_RECT( wxPoint( 10000, 0 ), wxSize( 100, 100 ) ) );
+
+    BOOST_CHECK( !region.IsEmpty() );
+
+    // Between the two areas: inside the overall bounding box, but far from both
+    const EDA_RECT between( wxPoint( 5000, 0 ), wxSize( 100, 100 ) );
+
+    BOOST_CHECK( region.GetBoundingBox().Intersects( between ) );
+    BOOST_CHECK( !region.Intersects( between ) );
+    BOOST_CHECK( !region.Intersects( between, 4000 ) );
+    BOOST_CHECK( region.Intersects( between, 5000 ) );
+
+    region.Clear();
+
+    BOOST_CHECK( region.IsEmpty() );
+    BOOST_CHECK( !region.Intersects( EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ) ) );
+}
+
+
+/**
+ * Recorded items are found by pointer, and also mark their bounding box
+ */
+BOOST_AUTO_TEST_CASE( Items )
+{
+    DRC_DIRTY_REGION region;
+    TRACK            changed( nullptr );
+    TRACK            other( nullptr );
+
+    changed.SetStart( wxPoint( 0, 0 ) );
+    changed.SetEnd( wxPoint( 1000, 0 ) );
+    changed.SetWidth( 100 );
+
+    region.Add( &changed );
+
+    BOOST_CHECK( region.Contains( &changed ) );
+    BOOST_CHECK( !region.Contains( &other ) );
+    BOOST_CHECK( region.Intersects( EDA_RECT( wxPoint( 500, 0 ), wxSize( 10, 10 ) ) ) );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,134 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the interaction of the incremental DRC with full runs
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_zone.h>
+#include <convert_to_biu.h>
+#include <drc.h>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+#include "drc_test_utils.h"
+
+
+struct DRC_INCREMENTAL_FIXTURE
+{
+    DRC_INCREMENTAL_FIXTURE()
+    {
+        m_module = new MODULE( &m_board );
+        m_board.Add( m_module );
+
+        // Two overlapping pads: a single pad to pad error
+        m_pad = AddPad( wxPoint( 0, 0 ) );
+        AddPad( wxPoint( Millimeter2iu( 0.5 ), 0 ) );
+
+        // And a zone for the full run to refill
+        ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+        const int       size = Millimeter2iu( 10 );
+        const wxPoint   origin( Millimeter2iu( 5 ), 0 );
+
+        zone->SetLayer( F_Cu );
+        zone->AppendCorner( origin, -1 );
+        zone->AppendCorner( origin + wxPoint( size, 0 ), -1 );
+        zone->AppendCorner( origin + wxPoint( size, size ), -1 );
+        zone->AppendCorner( origin + wxPoint( 0, size ), -1 );
+        m_board.Add( zone );
+
+        m_board.BuildConnectivity();
+    }
+
+    D_PAD* AddPad( const wxPoint& aPos )
+    {
+        return KI_TEST::AddRoundPad( *m_module, aPos, D_PAD::SMDMask(), false );
+    }
+
+    BOARD   m_board;
+    MODULE* m_module;
+    D_PAD*  m_pad;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcIncremental, DRC_INCREMENTAL_FIXTURE )
+
+
+/**
+ * Changes committed while a full run refills the zones do not trigger incremental runs,
+ * which would report the errors of the full run a second time
+ */
+BOOST_AUTO_TEST_CASE( NoIncrementalRunDuringFullRun )
+{
+    // Only the pad to pad errors: other tests are not run by incremental runs
+    size_t markerCount = 0;
+    bool   commitDuringRun = false;
+    DRC*   drcPtr = nullptr;
+
+    DRC drc( &m_board, EDA_UNITS_T::MILLIMETRES,
+             [&]( MARKER_PCB* aMarker )
+             {
+                 if( KI_TEST::IsDrcMarkerOfType( *aMarker, DRCE_PAD_NEAR_PAD1 ) )
+                     markerCount++;
+
+                 delete aMarker;
+
+                 // What a BOARD_COMMIT pushed during the run does, once
+                 if( commitDuringRun )
+                 {
+                     commitDuringRun = false;
+                     drcPtr->MarkDirty( m_pad );
+                     drcPtr->RunIncrementalTests();
+                 }
+             } );
+
+    drcPtr = &drc;
+    drc.SetRefillZones( true );
+
+    drc.RunTests();
+
+    BOOST_CHECK_EQUAL( markerCount, 1 );
+
+    // A second run, once incremental runs are possible
+    markerCount = 0;
+    commitDuringRun = true;
+    drc.RunTests();
+
+    BOOST_CHECK( !commitDuringRun );
+    BOOST_CHECK_EQUAL( markerCount, 1 );
+
+    // After the run, changes are tested again
+    markerCount = 0;
+    drc.MarkDirty( m_pad );
+    drc.RunIncrementalTests();
+
+    BOOST_CHECK_EQUAL( markerCount, 1 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,148 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_zone.h>
+#include <convert_to_biu.h>
+#include <drc.h>
+
+#include <set>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+#include "drc_test_utils.h"
+
+
+struct KEEPOUT_TEST_FIXTURE
+{
+    KEEPOUT_TEST_FIXTURE()
+    {
+        m_module = new MODULE( &m_board );
+        m_board.Add( m_module );
+    }
+
+    /**
+     * Add a square keepout area on the front copper layer
+     */
+    void AddKeepout( const wxPoint& aOrigin, int aSize, bool aNoTracks, bool aNoVias )
+    {
+        ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+
+        zone->SetLayer( F_Cu );
+        zone->SetIsKeepout( true );
+        zone->SetDoNotAllowCopperPour( true );
+        zone->SetDoNotAllowTracks( aNoTracks );
+        zone->SetDoNotAllowVias( aNoVias );
+
+        zone->AppendCorner( aOrigin, -1 );
+        zone->AppendCorner( aOrigin + wxPoint( aSize, 0 ), -1 );
+        zone->AppendCorner( aOrigin + wxPoint( aSize, aSize ), -1 );
+        zone->AppendCorner( aOrigin + wxPoint( 0, aSize ), -1 );
+
+        m_board.Add( zone );
+    }
+
+    /**
+     * Add a 1mm round pad, SMD or plated through hole
+     */
+    D_PAD* AddPad( const wxPoint& aPos, LSET aLayers, bool aDrilled )
+    {
+        return KI_TEST::AddRoundPad( *m_module, aPos, aLayers, aDrilled );
+    }
+
+    /**
+     * Run the DRC and return the pads reported inside a keepout area
+     */
+    std::set<const void*> PadsInKeepouts()
+    {
+        std::set<const void*> pads;
+
+        DRC drc( &m_board, EDA_UNITS_T::MILLIMETRES,
+                 [&]( MARKER_PCB* aMarker )
+                 {
+                     if( KI_TEST::IsDrcMarkerOfType( *aMarker, DRCE_PAD_INSIDE_KEEPOUT ) )
+                         pads.insert( aMarker->GetReporter().GetMainItemWeakRef() );
+
+                     delete aMarker;
+                 } );
+
+        drc.RunTests();
+
+        return pads;
+    }
+
+    BOARD   m_board;
+    MODULE* m_module;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcKeepout, KEEPOUT_TEST_FIXTURE )
+
+
+/**
+ * Pads touching a keepout area which forbids tracks are reported, on its layer only
+ */
+BOOST_AUTO_TEST_CASE( PadInTrackKeepout )
+{
+    AddKeepout( wxPoint( 0, 0 ), Millimeter2iu( 10 ), true, false );
+
+    const LSET front = D_PAD::SMDMask();
+    const LSET back( 3, B_Cu, B_Paste, B_Mask );
+
+    D_PAD* inside = AddPad( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 5 ) ), front, false );
+    D_PAD* crossing = AddPad( wxPoint( Millimeter2iu( 10 ), Millimeter2iu( 5 ) ), front, false );
+    AddPad( wxPoint( Millimeter2iu( 20 ), Millimeter2iu( 5 ) ), front, false );
+    AddPad( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 8 ) ), back, false );
+
+    const std::set<const void*> expected = { inside, crossing };
+    const std::set<const void*> found = PadsInKeepouts();
+
+    BOOST_CHECK_EQUAL( found.size(), expected.size() );
+    BOOST_CHECK( found == expected );
+}
+
+
+/**
+ * Only plated holes are reported in a keepout area which only forbids vias
+ */
+BOOST_AUTO_TEST_CASE( PadInViaKeepout )
+{
+    AddKeepout( wxPoint( 0, 0 ), Millimeter2iu( 10 ), false, true );
+
+    D_PAD* tht = AddPad( wxPoint( Millimeter2iu( 3 ), Millimeter2iu( 3 ) ),
+                         D_PAD::StandardMask(), true );
+    AddPad( wxPoint( Millimeter2iu( 7 ), Millimeter2iu( 7 ) ), D_PAD::SMDMask(), false );
+
+    const std::set<const void*> expected = { tht };
+    const std::set<const void*> found = PadsInKeepouts();
+
+    BOOST_CHECK_EQUAL( found.size(), expected.size() );
+    BOOST_CHECK( found == expected );
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
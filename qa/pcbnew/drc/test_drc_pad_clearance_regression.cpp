@@ -0,0 +1,251 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file test_drc_pad_clearance_regression.cpp
+ * Compare the markers of the sweep-line pad and drilled hole DRC with the ones of the
+ * reference full scans of the QA utilities on a dense board.  The drc_pad_benchmark tool
+ * compares their times.
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <convert_to_biu.h>
+#include <drc.h>
+
+#include <pcbnew_utils/drc_reference_scans.h>
+
+#include <set>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "drc_test_utils.h"
+
+
+/**
+ * A DRC violation between two items, independent of the order in which they were tested
+ */
+using PAIR_MARKER = std::tuple<int, const void*, const void*>;
+
+
+static PAIR_MARKER makePairMarker( int aCode, const void* aA, const void* aB )
+{
+    return PAIR_MARKER( aCode, std::min( aA, aB ), std::max( aA, aB ) );
+}
+
+
+struct PAD_CLEARANCE_FIXTURE
+{
+    PAD_CLEARANCE_FIXTURE() :
+            m_pitch( Millimeter2iu( 0.8 ) ),
+            m_padSize( Millimeter2iu( 0.45 ) ),
+            m_clearance( Millimeter2iu( 0.2 ) )
+    {
+        m_board.GetDesignSettings().m_HoleToHoleMin = Millimeter2iu( 0.25 );
+    }
+
+    /**
+     * Add a BGA-like grid of round SMD pads.  Every 7th pad is moved towards its right
+     * neighbour, closer than the clearance.
+     */
+    void AddBga( int aColumns, int aRows )
+    {
+        MODULE* module = new MODULE( &m_board );
+        m_board.Add( module );
+
+        for( int row = 0; row < aRows; ++row )
+        {
+            for( int col = 0; col < aColumns; ++col )
+            {
+                int     n = row * aColumns + col;
+                wxPoint pos( col * m_pitch, row * m_pitch );
+
+                if( n % 7 == 0 )
+                    pos.x += Millimeter2iu( 0.3 );
+
+                D_PAD* pad = new D_PAD( module );
+                pad->SetName( wxString::Format( "%d", n ) );
+                pad->SetShape( PAD_SHAPE_CIRCLE );
+                pad->SetAttribute( PAD_ATTRIB_SMD );
+                pad->SetLayerSet( D_PAD::SMDMask() );
+                pad->SetSize( wxSize( m_padSize, m_padSize ) );
+                pad->SetPosition( pos );
+                pad->SetPos0( pos );
+                pad->SetLocalClearance( m_clearance );
+                module->Add( pad );
+            }
+        }
+    }
+
+    /**
+     * Add a grid of through vias below the pads.  Every 5th via is moved towards its right
+     * neighbour, closer than the hole to hole minimum.
+     */
+    void AddVias( int aColumns, int aRows )
+    {
+        const int viaPitch = Millimeter2iu( 1.0 );
+        const int yOffset = Millimeter2iu( -100 );
+
+        for( int row = 0; row < aRows; ++row )
+        {
+            for( int col = 0; col < aColumns; ++col )
+            {
+                wxPoint pos( col * viaPitch, yOffset + row * viaPitch );
+
+                if( ( row * aColumns + col ) % 5 == 0 )
+                    pos.x += Millimeter2iu( 0.5 );
+
+                VIA* via = new VIA( &m_board );
+                via->SetViaType( VIA_THROUGH );
+                via->SetLayerPair( F_Cu, B_Cu );
+                via->SetPosition( pos );
+                via->SetWidth( Millimeter2iu( 0.6 ) );
+                via->SetDrill( Millimeter2iu( 0.3 ) );
+                m_board.Add( via );
+            }
+        }
+    }
+
+    /**
+     * Collect the pad and hole markers of a DRC in m_markers.
+     */
+    void CollectMarker( MARKER_PCB* aMarker )
+    {
+        const DRC_ITEM& item = aMarker->GetReporter();
+
+        switch( item.GetErrorCode() )
+        {
+        case DRCE_PAD_NEAR_PAD1:
+        case DRCE_HOLE_NEAR_PAD:
+        case DRCE_DRILLED_HOLES_TOO_CLOSE:
+            m_markers.insert( makePairMarker( item.GetErrorCode(), item.GetMainItemWeakRef(),
+                                              item.GetAuxiliaryItemWeakRef() ) );
+            break;
+
+        default:
+            break;
+        }
+
+        delete aMarker;
+    }
+
+    /**
+     * Run the full DRC and return its pad and hole markers.
+     */
+    std::set<PAIR_MARKER> RunDrc()
+    {
+        m_markers.clear();
+
+        DRC drc( &m_board, EDA_UNITS_T::MILLIMETRES,
+                 [&]( MARKER_PCB* aMarker ) { CollectMarker( aMarker ); } );
+
+        drc.RunTests();
+
+        return m_markers;
+    }
+
+    /**
+     * Run the reference full scans of the pads and holes and return their markers.
+     */
+    std::set<PAIR_MARKER> RunReference()
+    {
+        m_markers.clear();
+
+        DRC drc( &m_board, EDA_UNITS_T::MILLIMETRES,
+                 [&]( MARKER_PCB* aMarker ) { CollectMarker( aMarker ); } );
+
+        KI_TEST::DRC_REFERENCE_SCANS::TestPad2Pad( drc );
+        KI_TEST::DRC_REFERENCE_SCANS::TestDrilledHoles( drc );
+
+        return m_markers;
+    }
+
+    BOARD m_board;
+    int   m_pitch;
+    int   m_padSize;
+    int   m_clearance;
+
+    std::set<PAIR_MARKER> m_markers;
+};
+
+
+/**
+ * The markers of a set with one of the given error codes
+ */
+static std::set<PAIR_MARKER> markersWithCodes( const std::set<PAIR_MARKER>& aMarkers,
+                                               const std::set<int>&         aCodes )
+{
+    std::set<PAIR_MARKER> result;
+
+    for( const PAIR_MARKER& marker : aMarkers )
+    {
+        if( aCodes.count( std::get<0>( marker ) ) )
+            result.insert( marker );
+    }
+
+    return result;
+}
+
+
+BOOST_FIXTURE_TEST_SUITE( DrcPadClearanceRegression, PAD_CLEARANCE_FIXTURE )
+
+
+/**
+ * The sweep-line tests find the same violations as the full scans
+ */
+BOOST_AUTO_TEST_CASE( SameMarkers )
+{
+    AddBga( 60, 60 );
+    AddVias( 40, 40 );
+
+    const std::set<PAIR_MARKER> expected = RunReference();
+    const std::set<PAIR_MARKER> found = RunDrc();
+
+    const std::vector<std::pair<std::string, std::set<int>>> codeGroups = {
+        { "pad to pad", { DRCE_PAD_NEAR_PAD1 } },
+        { "holes", { DRCE_HOLE_NEAR_PAD, DRCE_DRILLED_HOLES_TOO_CLOSE } },
+    };
+
+    for( const auto& group : codeGroups )
+    {
+        BOOST_TEST_CONTEXT( group.first )
+        {
+            const std::set<PAIR_MARKER> groupExpected = markersWithCodes( expected, group.second );
+            const std::set<PAIR_MARKER> groupFound = markersWithCodes( found, group.second );
+
+            // Make sure the board really has violations of this kind
+            BOOST_CHECK_GT( groupExpected.size(), 0 );
+
+            BOOST_CHECK_EQUAL( groupFound.size(), groupExpected.size() );
+            BOOST_CHECK( groupFound == groupExpected );
+        }
+    }
+}
+
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <drc/drc_rtree.h>
+
+
+BOOST_AUTO_TEST_SUITE( DrcRtree )
+
+
+/**
+ * Items on other layers, or too far away, are not returned
+ */
+BOOST_AUTO_TEST_CASE( LayerAndDistance )
+{
+    DRC_RTREE index;
+
+    index.Insert( 0, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET( F_Cu ) );
+    index.Insert( 1, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET( B_Cu ) );
+    index.Insert( 2, EDA_RECT( wxPoint( 1000, 1000 ), wxSize( 100, 100 ) ), LSET( F_Cu ) );
+    index.Insert( 3, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET( F_SilkS ) );
+
+    BOOST_CHECK_EQUAL( index.Size(), 4 );
+
+    std::vector<int> ids;
+
+    index.Query( EDA_RECT( wxPoint( 50, 50 ), wxSize( 10, 10 ) ), LSET( F_Cu ), ids );
+    const std::vector<int> exp_front = { 0 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), exp_front.begin(), exp_front.end() );
+
+    index.Query( EDA_RECT( wxPoint( 50, 50 ), wxSize( 2000, 2000 ) ), LSET::AllCuMask(), ids );
+    const std::vector<int> exp_all = { 0, 1, 2 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), exp_all.begin(), exp_all.end() );
+}
+
+
+/**
+ * Items on several layers are reported once, and results are sorted by id
+ */
+BOOST_AUTO_TEST_CASE( SortedUnique )
+{
+    DRC_RTREE index;
+
+    index.Insert( 5, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET::AllCuMask() );
+    index.Insert( 2, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET( F_Cu ) );
+    index.Insert( 7, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET( 2, F_Cu, B_Cu ) );
+
+    std::vector<int> ids;
+    index.Query( EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ), LSET::AllCuMask(), ids );
+
+    const std::vector<int> exp_ids = { 2, 5, 7 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), exp_ids.begin(), exp_ids.end() );
+
+    index.Remove( 5, EDA_RECT( wxPoint( 0, 0 ), wxSize( 100, 100 ) ), LSET::AllCuMask() );
+    index.Query( EDA_RECT( wxPoint( 0, 0 ), wxSize( 10, 10 ) ), LSET::AllCuMask(), ids );
+
+    const std::vector<int> exp_removed = { 2, 7 };
+    BOOST_CHECK_EQUAL_COLLECTIONS( ids.begin(), ids.end(), exp_removed.begin(),
+            exp_removed.end() );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,159 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <convert_to_biu.h>
+#include <connectivity/connectivity_data.h>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+
+/**
+ * Two SMD pads of the same net, joined by a track
+ */
+struct CONNECTIVITY_SYNC_FIXTURE
+{
+    CONNECTIVITY_SYNC_FIXTURE()
+    {
+        m_board.Add( new NETINFO_ITEM( &m_board, "N1", 1 ) );
+
+        m_module = new MODULE( &m_board );
+        m_board.Add( m_module );
+
+        m_padA = AddPad( wxPoint( 0, 0 ) );
+        m_padB = AddPad( wxPoint( Millimeter2iu( 10 ), 0 ) );
+
+        m_track = new TRACK( &m_board );
+        m_track->SetLayer( F_Cu );
+        m_track->SetWidth( Millimeter2iu( 0.25 ) );
+        m_track->SetStart( m_padA->GetPosition() );
+        m_track->SetEnd( m_padB->GetPosition() );
+        m_track->SetNetCode( 1 );
+        m_board.Add( m_track );
+
+        m_board.BuildConnectivity();
+    }
+
+    D_PAD* AddPad( const wxPoint& aPos )
+    {
+        D_PAD* pad = KI_TEST::AddRoundPad( *m_module, aPos, D_PAD::SMDMask(), false );
+        pad->SetNetCode( 1 );
+
+        return pad;
+    }
+
+    BOARD   m_board;
+    MODULE* m_module;
+    D_PAD*  m_padA;
+    D_PAD*  m_padB;
+    TRACK*  m_track;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ConnectivitySync, CONNECTIVITY_SYNC_FIXTURE )
+
+
+/**
+ * Items marked dirty are updated by Sync(), and give the same result as a full rebuild
+ */
+BOOST_AUTO_TEST_CASE( DirtyItemEdit )
+{
+    auto connectivity = m_board.GetConnectivity();
+
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 0 );
+
+    connectivity->MarkItemDirty( m_track );
+    m_track->SetEnd( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 5 ) ) );
+
+    BOOST_CHECK( connectivity->Sync( &m_board, true ) );
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 1 );
+
+    connectivity->MarkItemDirty( m_track );
+    m_track->SetEnd( m_padB->GetPosition() );
+
+    BOOST_CHECK( connectivity->Sync( &m_board, true ) );
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 0 );
+}
+
+
+/**
+ * Only the marked items are updated: an unmarked edit is missed, which the verification
+ * against a full rebuild reports and repairs
+ */
+BOOST_AUTO_TEST_CASE( UnmarkedEdit )
+{
+    auto connectivity = m_board.GetConnectivity();
+
+    m_track->SetEnd( wxPoint( Millimeter2iu( 5 ), Millimeter2iu( 5 ) ) );
+
+    BOOST_CHECK( !connectivity->Sync( &m_board, true ) );
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 1 );
+}
+
+
+/**
+ * A marked item removed and deleted before the update is not dereferenced by Sync()
+ */
+BOOST_AUTO_TEST_CASE( DirtyItemDelete )
+{
+    auto connectivity = m_board.GetConnectivity();
+
+    connectivity->MarkItemDirty( m_track );
+    m_board.Remove( m_track );
+    delete m_track;
+    m_track = nullptr;
+
+    BOOST_CHECK( connectivity->Sync( &m_board, true ) );
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 1 );
+}
+
+/**
+ * A pad shape change is picked up even when the bounding box and position stay the same
+ */
+BOOST_AUTO_TEST_CASE( DirtyPadShapeEdit )
+{
+    auto connectivity = m_board.GetConnectivity();
+
+    // In the corner of the bounding box of the round pad, but outside the pad
+    connectivity->MarkItemDirty( m_track );
+    m_track->SetStart( m_padA->GetPosition() + wxPoint( Millimeter2iu( 0.45 ),
+                                                        Millimeter2iu( 0.45 ) ) );
+
+    BOOST_CHECK( connectivity->Sync( &m_board, true ) );
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 1 );
+
+    // A square pad of the same size has the same bounding box, and covers the track end
+    connectivity->MarkItemDirty( m_padA );
+    m_padA->SetShape( PAD_SHAPE_RECT );
+
+    BOOST_CHECK( connectivity->Sync( &m_board, true ) );
+    BOOST_CHECK_EQUAL( connectivity->GetUnconnectedCount(), 0 );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,193 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the footprint cache of the .pretty libraries
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_module.h>
+#include <kicad_plugin.h>
+
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <fstream>
+
+
+/**
+ * A temporary .pretty library, removed again at the end of the test
+ */
+struct FP_CACHE_FIXTURE
+{
+    FP_CACHE_FIXTURE()
+    {
+        m_libPath = wxFileName::CreateTempFileName( "fp_cache" );
+        wxRemoveFile( m_libPath );
+        m_libPath += ".pretty";
+        wxFileName::Mkdir( m_libPath );
+    }
+
+    ~FP_CACHE_FIXTURE()
+    {
+        wxArrayString files;
+
+        wxDir::GetAllFiles( m_libPath, &files );
+
+        for( const wxString& file : files )
+            wxRemoveFile( file );
+
+        wxRmdir( m_libPath );
+    }
+
+    wxString FileName( const wxString& aName ) const
+    {
+        return wxFileName( m_libPath, aName, "kicad_mod" ).GetFullPath();
+    }
+
+    /**
+     * Write a footprint file, modified \a aTime seconds after a fixed date so that the
+     * tests do not depend on the resolution of the file times
+     */
+    void Write( const wxString& aName, const std::string& aContent, int aTime )
+    {
+        {
+            std::ofstream out( FileName( aName ).ToStdString(), std::ios::trunc );
+            out << aContent;
+        }
+
+        wxDateTime time = wxDateTime( 1, wxDateTime::Jan, 2019 ) + wxTimeSpan::Seconds( aTime );
+
+        wxFileName( FileName( aName ) ).SetTimes( nullptr, &time, nullptr );
+    }
+
+    void WriteFootprint( const wxString& aName, const wxString& aDescription, int aTime )
+    {
+        Write( aName, "(module " + aName.ToStdString() + " (layer F.Cu) (descr \""
+                              + aDescription.ToStdString() + "\"))\n", aTime );
+    }
+
+    wxArrayString Enumerate()
+    {
+        wxArrayString names;
+
+        m_io.FootprintEnumerate( names, m_libPath );
+        names.Sort();
+        return names;
+    }
+
+    wxString Description( const wxString& aName )
+    {
+        const MODULE* footprint = m_io.GetEnumeratedFootprint( m_libPath, aName );
+
+        BOOST_REQUIRE( footprint );
+        return footprint->GetDescription();
+    }
+
+    wxString m_libPath;
+    PCB_IO   m_io;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( FpCache, FP_CACHE_FIXTURE )
+
+
+/**
+ * A file added to the library is listed without being read: a broken one only fails
+ * when its footprint is loaded
+ */
+BOOST_AUTO_TEST_CASE( NewFileAddedUnread )
+{
+    WriteFootprint( "A", "first", 0 );
+
+    BOOST_CHECK_EQUAL( Enumerate().size(), 1u );
+    BOOST_CHECK_EQUAL( Description( "A" ), "first" );
+
+    Write( "B", "(module B (layer F.Cu) (descr", 10 );
+
+    wxArrayString names;
+
+    BOOST_CHECK_NO_THROW( names = Enumerate() );
+    BOOST_REQUIRE_EQUAL( names.size(), 2u );
+    BOOST_CHECK_EQUAL( names[1], "B" );
+
+    BOOST_CHECK_EQUAL( Description( "A" ), "first" );
+    BOOST_CHECK_THROW( m_io.GetEnumeratedFootprint( m_libPath, "B" ), IO_ERROR );
+
+    // Until the file changes, its error is kept
+    BOOST_CHECK_THROW( m_io.GetEnumeratedFootprint( m_libPath, "B" ), IO_ERROR );
+
+    WriteFootprint( "B", "fixed", 20 );
+    Enumerate();
+
+    BOOST_CHECK_EQUAL( Description( "B" ), "fixed" );
+}
+
+
+/**
+ * The footprint of a file removed from the library is dropped
+ */
+BOOST_AUTO_TEST_CASE( DeletedFileDropped )
+{
+    WriteFootprint( "A", "first", 0 );
+    WriteFootprint( "B", "second", 0 );
+
+    BOOST_CHECK_EQUAL( Enumerate().size(), 2u );
+    BOOST_CHECK_EQUAL( Description( "B" ), "second" );
+
+    wxRemoveFile( FileName( "B" ) );
+
+    wxArrayString names = Enumerate();
+
+    BOOST_REQUIRE_EQUAL( names.size(), 1u );
+    BOOST_CHECK_EQUAL( names[0], "A" );
+    BOOST_CHECK( m_io.GetEnumeratedFootprint( m_libPath, "B" ) == nullptr );
+    BOOST_CHECK_EQUAL( Description( "A" ), "first" );
+}
+
+
+/**
+ * When a file changes, only its footprint is read again
+ */
+BOOST_AUTO_TEST_CASE( OnlyChangedFileReread )
+{
+    WriteFootprint( "A", "first", 0 );
+    WriteFootprint( "B", "second", 0 );
+
+    Enumerate();
+
+    BOOST_CHECK_EQUAL( Description( "A" ), "first" );
+    BOOST_CHECK_EQUAL( Description( "B" ), "second" );
+
+    // A changes without its time changing: it is only read again if the whole library is
+    WriteFootprint( "A", "first changed", 0 );
+    WriteFootprint( "B", "second changed", 10 );
+
+    BOOST_CHECK_EQUAL( Enumerate().size(), 2u );
+    BOOST_CHECK_EQUAL( Description( "A" ), "first" );
+    BOOST_CHECK_EQUAL( Description( "B" ), "second changed" );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
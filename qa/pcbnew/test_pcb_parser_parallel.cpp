@@ -0,0 +1,226 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+
+/**
+ * @file
+ * Test suite for the parallel mode of PCB_PARSER
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <convert_to_biu.h>
+#include <kicad_plugin.h>
+#include <pcb_parser.h>
+#include <richio.h>
+
+#include <wx/filename.h>
+
+#include <fstream>
+
+
+/**
+ * A board with a footprint and enough tracks and vias, of interleaved nets, to be parsed
+ * in several chunks
+ */
+struct PCB_PARSER_PARALLEL_FIXTURE
+{
+    PCB_PARSER_PARALLEL_FIXTURE()
+    {
+        for( int net = 1; net <= 3; ++net )
+            m_board.Add( new NETINFO_ITEM( &m_board, wxString::Format( "N%d", net ), net ) );
+
+        MODULE* module = new MODULE( &m_board );
+        module->SetFPID( LIB_ID( "lib", "R" ) );
+        m_board.Add( module );
+
+        for( int i = 0; i < 2; ++i )
+        {
+            D_PAD* pad = new D_PAD( module );
+
+            pad->SetName( wxString::Format( "%d", i + 1 ) );
+            pad->SetShape( PAD_SHAPE_CIRCLE );
+            pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+            pad->SetAttribute( PAD_ATTRIB_SMD );
+            pad->SetLayerSet( D_PAD::SMDMask() );
+            pad->SetPosition( wxPoint( Millimeter2iu( 10 * i ), 0 ) );
+            pad->SetPos0( pad->GetPosition() );
+            pad->SetNetCode( i + 1 );
+            module->Add( pad );
+        }
+
+        for( int i = 0; i < 500; ++i )
+        {
+            TRACK* track = new TRACK( &m_board );
+
+            track->SetLayer( i % 2 ? F_Cu : B_Cu );
+            track->SetWidth( Millimeter2iu( 0.25 ) );
+            track->SetStart( wxPoint( Millimeter2iu( i ), 0 ) );
+            track->SetEnd( wxPoint( Millimeter2iu( i ), Millimeter2iu( 5 ) ) );
+            track->SetNetCode( 3 - i % 3 );
+            m_board.Add( track, ADD_APPEND );
+
+            if( i % 10 == 0 )
+            {
+                VIA* via = new VIA( &m_board );
+
+                via->SetViaType( VIA_THROUGH );
+                via->SetLayerPair( F_Cu, B_Cu );
+                via->SetPosition( track->GetEnd() );
+                via->SetWidth( Millimeter2iu( 0.6 ) );
+                via->SetDrill( Millimeter2iu( 0.4 ) );
+                via->SetNetCode( track->GetNetCode() );
+                m_board.Add( via, ADD_APPEND );
+            }
+        }
+
+        m_text = Format( &m_board );
+    }
+
+    static std::string Format( BOARD* aBoard )
+    {
+        PCB_IO io;
+
+        io.Format( aBoard );
+        return io.GetStringOutput( true );
+    }
+
+    static std::unique_ptr<BOARD> Parse( const std::string& aText, bool aParallel )
+    {
+        STRING_LINE_READER reader( aText, "test" );
+        PCB_PARSER         parser;
+
+        parser.SetLineReader( &reader );
+        parser.SetParallel( aParallel );
+
+        return std::unique_ptr<BOARD>( static_cast<BOARD*>( parser.Parse() ) );
+    }
+
+    /**
+     * Parse a board from a mapped file, whose sections are split in place.
+     */
+    static std::unique_ptr<BOARD> ParseMapped( const std::string& aText, bool aParallel )
+    {
+        const wxString fileName = wxFileName::CreateTempFileName( "pcb_parser" );
+
+        {
+            std::ofstream out( fileName.ToStdString(), std::ios::binary | std::ios::trunc );
+            out << aText;
+        }
+
+        std::unique_ptr<BOARD> board;
+
+        {
+            MMAP_LINE_READER reader( fileName );
+            PCB_PARSER       parser;
+
+            parser.SetLineReader( &reader );
+            parser.SetParallel( aParallel );
+
+            board.reset( static_cast<BOARD*>( parser.Parse() ) );
+        }
+
+        wxRemoveFile( fileName );
+
+        return board;
+    }
+
+    BOARD       m_board;
+    std::string m_text;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( PcbParserParallel, PCB_PARSER_PARALLEL_FIXTURE )
+
+
+/**
+ * Both modes read the same board, with the items in the same order
+ */
+BOOST_AUTO_TEST_CASE( SameBoard )
+{
+    std::unique_ptr<BOARD> serial = Parse( m_text, false );
+    std::unique_ptr<BOARD> parallel = Parse( m_text, true );
+
+    BOOST_CHECK_EQUAL( parallel->m_Track.GetCount(), m_board.m_Track.GetCount() );
+    BOOST_CHECK_EQUAL( parallel->m_Modules.GetCount(), 1u );
+    BOOST_CHECK_EQUAL( Format( parallel.get() ), Format( serial.get() ) );
+}
+
+
+/**
+ * The parallel mode reads the same board from a mapped file
+ */
+BOOST_AUTO_TEST_CASE( SameBoardMapped )
+{
+    std::unique_ptr<BOARD> serial = Parse( m_text, false );
+    std::unique_ptr<BOARD> parallel = ParseMapped( m_text, true );
+
+    BOOST_CHECK_EQUAL( parallel->m_Track.GetCount(), m_board.m_Track.GetCount() );
+    BOOST_CHECK_EQUAL( Format( parallel.get() ), Format( serial.get() ) );
+}
+
+
+/**
+ * Both modes report the first error of the file at the same place
+ */
+BOOST_AUTO_TEST_CASE( SameError )
+{
+    size_t pos = 0;
+
+    for( int i = 0; i < 300; ++i )
+        pos = m_text.find( "(segment", pos + 1 );
+
+    pos = m_text.find( "(width", pos );
+    BOOST_REQUIRE( pos != std::string::npos );
+
+    std::string text = m_text;
+
+    text.replace( pos, 6, "(wdith" );
+
+    int lines[2] = { 0, 0 };
+    int offsets[2] = { 0, 0 };
+
+    for( int parallel = 0; parallel < 2; ++parallel )
+    {
+        try
+        {
+            Parse( text, parallel );
+            BOOST_ERROR( "no parse error" );
+        }
+        catch( const PARSE_ERROR& error )
+        {
+            lines[parallel] = error.lineNumber;
+            offsets[parallel] = error.byteIndex;
+        }
+    }
+
+    BOOST_CHECK_GT( lines[0], 0 );
+    BOOST_CHECK_EQUAL( lines[1], lines[0] );
+    BOOST_CHECK_EQUAL( offsets[1], offsets[0] );
+}
+
+BOOST_AUTO_TEST_SUITE_END()
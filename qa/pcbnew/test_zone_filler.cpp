@@ -0,0 +1,187 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file
+ * Test suite for the zone filler
+ */
+
+#include <unit_test_utils/unit_test_utils.h>
+
+#include <class_board.h>
+#include <class_drawsegment.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <class_zone.h>
+#include <convert_to_biu.h>
+#include <thread_pool.h>
+#include <zone_filler.h>
+
+#include <pcbnew_utils/board_construction_utils.h>
+
+
+/**
+ * A board with two nets: a grid of through hole pads, tracks on both sides, a zone on each
+ * side and a smaller zone of higher priority on the front
+ */
+struct ZONE_FILLER_FIXTURE
+{
+    ZONE_FILLER_FIXTURE()
+    {
+        const int size = Millimeter2iu( 40 );
+
+        m_board.Add( new NETINFO_ITEM( &m_board, "N1", 1 ) );
+        m_board.Add( new NETINFO_ITEM( &m_board, "N2", 2 ) );
+
+        const wxPoint corners[] = { { 0, 0 }, { size, 0 }, { size, size }, { 0, size } };
+
+        for( int ii = 0; ii < 4; ++ii )
+        {
+            DRAWSEGMENT* edge = new DRAWSEGMENT( &m_board );
+            edge->SetLayer( Edge_Cuts );
+            edge->SetWidth( Millimeter2iu( 0.1 ) );
+            edge->SetStart( corners[ii] );
+            edge->SetEnd( corners[( ii + 1 ) % 4] );
+            m_board.Add( edge );
+        }
+
+        MODULE* module = new MODULE( &m_board );
+        m_board.Add( module );
+
+        const int pitch = Millimeter2iu( 2.54 );
+
+        for( int row = 1; row < 15; ++row )
+        {
+            for( int col = 1; col < 15; ++col )
+            {
+                D_PAD* pad = KI_TEST::AddRoundPad( *module, wxPoint( col * pitch, row * pitch ),
+                                                   D_PAD::StandardMask(), true );
+                pad->SetNetCode( ( row + col ) % 2 + 1 );
+            }
+        }
+
+        // Diagonal tracks between the pads, net 1 on the front and net 2 on the back
+        for( int ii = 1; ii < 14; ++ii )
+        {
+            AddTrack( wxPoint( ii * pitch, pitch ), wxPoint( 14 * pitch, ( 15 - ii ) * pitch ),
+                      F_Cu, 1 );
+            AddTrack( wxPoint( pitch, ii * pitch ), wxPoint( ( 15 - ii ) * pitch, 14 * pitch ),
+                      B_Cu, 2 );
+        }
+
+        AddZone( wxPoint( 0, 0 ), size, F_Cu, 1, 0 );
+        AddZone( wxPoint( 0, 0 ), size, B_Cu, 2, 0 );
+        AddZone( wxPoint( size / 4, size / 4 ), size / 2, F_Cu, 2, 1 );
+
+        m_board.BuildConnectivity();
+    }
+
+    void AddTrack( const wxPoint& aStart, const wxPoint& aEnd, PCB_LAYER_ID aLayer, int aNet )
+    {
+        TRACK* track = new TRACK( &m_board );
+        track->SetLayer( aLayer );
+        track->SetWidth( Millimeter2iu( 0.25 ) );
+        track->SetStart( aStart );
+        track->SetEnd( aEnd );
+        track->SetNetCode( aNet );
+        m_board.Add( track );
+    }
+
+    void AddZone( const wxPoint& aOrigin, int aSize, PCB_LAYER_ID aLayer, int aNet,
+                  unsigned aPriority )
+    {
+        ZONE_CONTAINER* zone = new ZONE_CONTAINER( &m_board );
+
+        zone->SetLayer( aLayer );
+        zone->SetNetCode( aNet );
+        zone->SetPriority( aPriority );
+        zone->AppendCorner( aOrigin, -1 );
+        zone->AppendCorner( aOrigin + wxPoint( aSize, 0 ), -1 );
+        zone->AppendCorner( aOrigin + wxPoint( aSize, aSize ), -1 );
+        zone->AppendCorner( aOrigin + wxPoint( 0, aSize ), -1 );
+        m_board.Add( zone );
+    }
+
+    /**
+     * @return the filled areas of all zones, in board order
+     */
+    std::vector<SHAPE_POLY_SET> FilledAreas()
+    {
+        std::vector<SHAPE_POLY_SET> areas;
+
+        for( ZONE_CONTAINER* zone : m_board.Zones() )
+            areas.push_back( zone->GetFilledPolysList() );
+
+        return areas;
+    }
+
+    BOARD m_board;
+};
+
+
+BOOST_FIXTURE_TEST_SUITE( ZoneFiller, ZONE_FILLER_FIXTURE )
+
+
+/**
+ * Filling the zones concurrently gives the same outlines as filling them one at a time
+ */
+BOOST_AUTO_TEST_CASE( SerialEqualsParallel )
+{
+    // A single zone is filled on the calling thread only
+    THREAD_POOL serialPool( 1 );
+
+    for( ZONE_CONTAINER* zone : m_board.Zones() )
+    {
+        ZONE_FILLER filler( &m_board );
+        filler.SetThreadPool( serialPool );
+        filler.SetTiledFill( false );
+
+        BOOST_REQUIRE( filler.Fill( { zone } ) );
+    }
+
+    const std::vector<SHAPE_POLY_SET> serial = FilledAreas();
+
+    THREAD_POOL parallelPool( 4 );
+    ZONE_FILLER filler( &m_board );
+    filler.SetThreadPool( parallelPool );
+    filler.SetTiledFill( false );
+
+    BOOST_REQUIRE( filler.Fill( m_board.Zones() ) );
+
+    const std::vector<SHAPE_POLY_SET> parallel = FilledAreas();
+
+    BOOST_REQUIRE_EQUAL( serial.size(), parallel.size() );
+
+    for( size_t ii = 0; ii < serial.size(); ++ii )
+    {
+        BOOST_TEST_CONTEXT( "Zone " << ii )
+        {
+            BOOST_CHECK_GT( serial[ii].TotalVertices(), 0 );
+            BOOST_CHECK_EQUAL( serial[ii].TotalVertices(), parallel[ii].TotalVertices() );
+            BOOST_CHECK( serial[ii].GetHash() == parallel[ii].GetHash() );
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -23,10 +23,17 @@
 
 #include <qa_utils/utility_program.h>
 
+#include "tools/drc_batch/drc_batch.h"
+#include "tools/drc_pad_benchmark/drc_pad_benchmark.h"
 #include "tools/drc_tool/drc_tool.h"
 #include "tools/pcb_parser/pcb_parser_tool.h"
 #include "tools/polygon_generator/polygon_generator.h"
 #include "tools/polygon_triangulation/polygon_triangulation.h"
+#include "tools/ratsnest_benchmark/ratsnest_benchmark.h"
+#include "tools/zone_fill_benchmark/zone_fill_benchmark.h"
+#include "tools/model_cache_benchmark/model_cache_benchmark.h"
+#include "tools/raytrace_render/raytrace_render.h"
+#include "tools/router_replay/router_replay.h"
 
 /**
  * List of registered tools.
@@ -35,10 +42,17 @@
  * it's effective enough. When you have a new tool, add it to this list.
  */
 const static std::vector<KI_TEST::UTILITY_PROGRAM*> known_tools = {
+    &drc_batch_tool,
+    &drc_pad_benchmark_tool,
     &drc_tool,
     &pcb_parser_tool,
     &polygon_generator_tool,
     &polygon_triangulation_tool,
+    &ratsnest_benchmark_tool,
+    &zone_fill_benchmark_tool,
+    &model_cache_benchmark_tool,
+    &raytrace_render_tool,
+    &router_replay_tool,
 };
 
 
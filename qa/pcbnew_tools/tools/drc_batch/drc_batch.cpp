@@ -0,0 +1,308 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "drc_batch.h"
+
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <convert_to_biu.h>
+#include <drc.h>
+#include <drc_item.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/scoped_timer.h>
+
+
+using DRC_DURATION = std::chrono::microseconds;
+
+
+/**
+ * Escape a string for use as a JSON string value (without the quotes)
+ */
+static std::string jsonEscape( const wxString& aStr )
+{
+    std::ostringstream ss;
+
+    for( char c : std::string( aStr.ToUTF8() ) )
+    {
+        switch( c )
+        {
+        case '"':  ss << "\\\""; break;
+        case '\\': ss << "\\\\"; break;
+        case '\n': ss << "\\n";  break;
+        case '\r': ss << "\\r";  break;
+        case '\t': ss << "\\t";  break;
+        default:
+            if( (unsigned char) c < 0x20 )
+                ss << "\\u" << std::hex << std::setw( 4 ) << std::setfill( '0' ) << (int) c
+                   << std::dec;
+            else
+                ss << c;
+        }
+    }
+
+    return ss.str();
+}
+
+
+/**
+ * Write a DRC item (marker or unconnected item) as a JSON object
+ */
+static void writeDrcItem( std::ostream& os, const DRC_ITEM& aItem, const std::string& aIndent )
+{
+    os << aIndent << "{\n";
+    os << aIndent << "  \"code\": " << aItem.GetErrorCode() << ",\n";
+    os << aIndent << "  \"description\": \"" << jsonEscape( aItem.GetErrorText() ) << "\",\n";
+    os << aIndent << "  \"items\": [\n";
+
+    os << aIndent << "    { \"description\": \"" << jsonEscape( aItem.GetMainText() )
+       << "\", \"x_mm\": " << aItem.GetPointA().x / IU_PER_MM
+       << ", \"y_mm\": " << aItem.GetPointA().y / IU_PER_MM << " }";
+
+    if( aItem.HasSecondItem() )
+    {
+        os << ",\n";
+        os << aIndent << "    { \"description\": \"" << jsonEscape( aItem.GetAuxiliaryText() )
+           << "\", \"x_mm\": " << aItem.GetPointB().x / IU_PER_MM
+           << ", \"y_mm\": " << aItem.GetPointB().y / IU_PER_MM << " }";
+    }
+
+    os << "\n" << aIndent << "  ]\n";
+    os << aIndent << "}";
+}
+
+
+/**
+ * Write the result of a DRC run as a JSON document
+ */
+static void writeJsonReport( std::ostream& os, const std::string& aFilename,
+        const DRC_DURATION& aLoadTime, const DRC_DURATION& aDrcTime, const DRC& aDrc,
+        const std::vector<std::unique_ptr<MARKER_PCB>>& aMarkers )
+{
+    os << "{\n";
+    os << "  \"board\": \"" << jsonEscape( aFilename ) << "\",\n";
+    os << "  \"load_time_us\": " << aLoadTime.count() << ",\n";
+    os << "  \"drc_time_us\": " << aDrcTime.count() << ",\n";
+
+    os << "  \"passes\": [";
+
+    const char* sep = "\n";
+
+    for( const DRC_PASS_STATS& pass : aDrc.GetPassStats() )
+    {
+        os << sep << "    { \"name\": \"" << pass.m_Name << "\", \"time_us\": "
+           << pass.m_Duration.count() << ", \"items\": " << pass.m_ItemCount
+           << ", \"violations\": " << pass.m_MarkerCount << " }";
+        sep = ",\n";
+    }
+
+    os << "\n  ],\n";
+
+    os << "  \"violations\": [";
+    sep = "\n";
+
+    for( const auto& marker : aMarkers )
+    {
+        os << sep;
+        writeDrcItem( os, marker->GetReporter(), "    " );
+        sep = ",\n";
+    }
+
+    os << "\n  ],\n";
+
+    os << "  \"unconnected\": [";
+    sep = "\n";
+
+    for( const DRC_ITEM* item : aDrc.GetUnconnectedItems() )
+    {
+        os << sep;
+        writeDrcItem( os, *item, "    " );
+        sep = ",\n";
+    }
+
+    os << "\n  ]\n";
+    os << "}\n";
+}
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print progress information on stderr" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "r",
+            "refill-zones",
+            _( "refill all zones before running the checks" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "z",
+            "track-zone-clearance",
+            _( "also test track to copper zone clearances (slow)" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "a",
+            "all-track-errors",
+            _( "report all errors of each track, not only the first one" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "write the JSON report to this file instead of stdout" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum DRC_BATCH_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    OUTPUT_FAILED,
+};
+
+
+int drc_batch_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program loads a PCB file and runs all the DRC tests on it, without "
+               "any user interface. The violations found and the time taken by each test "
+               "are reported in JSON format." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool        verbose = cl_parser.Found( "verbose" );
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    std::unique_ptr<BOARD> board;
+    DRC_DURATION           loadTime{};
+
+    {
+        SCOPED_TIMER<DRC_DURATION> timer( loadTime );
+        board = KI_TEST::LoadBoardForTests( filename );
+    }
+
+    if( !board )
+        return DRC_BATCH_RET_CODES::LOAD_FAILED;
+
+    if( verbose )
+        std::cerr << "Loaded " << filename << " in " << loadTime.count() << "us" << std::endl;
+
+    std::vector<std::unique_ptr<MARKER_PCB>> markers;
+
+    DRC drc( board.get(), EDA_UNITS_T::MILLIMETRES,
+             [&]( MARKER_PCB* aMarker )
+             {
+                 markers.push_back( std::unique_ptr<MARKER_PCB>( aMarker ) );
+             } );
+
+    drc.SetRefillZones( cl_parser.Found( "refill-zones" ) );
+    drc.SetZonesTest( cl_parser.Found( "track-zone-clearance" ) );
+    drc.SetReportAllTrackErrors( cl_parser.Found( "all-track-errors" ) );
+
+    DRC_DURATION drcTime{};
+    {
+        SCOPED_TIMER<DRC_DURATION> timer( drcTime );
+        drc.RunTests();
+    }
+
+    if( verbose )
+    {
+        std::cerr << "DRC took " << drcTime.count() << "us, " << markers.size()
+                  << " violations, " << drc.GetUnconnectedItems().size()
+                  << " unconnected items" << std::endl;
+    }
+
+    wxString outputName;
+
+    if( cl_parser.Found( "output", &outputName ) )
+    {
+        std::ofstream out( outputName.ToStdString() );
+
+        if( !out )
+        {
+            std::cerr << "Cannot write " << outputName << std::endl;
+            return DRC_BATCH_RET_CODES::OUTPUT_FAILED;
+        }
+
+        writeJsonReport( out, filename, loadTime, drcTime, drc, markers );
+    }
+    else
+    {
+        writeJsonReport( std::cout, filename, loadTime, drcTime, drc, markers );
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM drc_batch_tool = {
+    "drc_batch",
+    "Run the full DRC on a PCB and report the results as JSON",
+    drc_batch_main_func,
+};
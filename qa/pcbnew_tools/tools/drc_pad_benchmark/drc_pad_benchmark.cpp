@@ -0,0 +1,269 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "drc_pad_benchmark.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <string>
+#include <tuple>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+#include <class_marker_pcb.h>
+#include <drc.h>
+#include <drc_item.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <pcbnew_utils/drc_reference_scans.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+/**
+ * A DRC violation between two items, independent of the order in which they were tested
+ */
+using PAIR_MARKER = std::tuple<int, const void*, const void*>;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of runs of each test, the best time is reported (default 5)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum DRC_PAD_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    MARKERS_DIFFER,
+};
+
+
+/**
+ * Result of the runs of one of the pad scans
+ */
+struct PAD_SCAN_RESULT
+{
+    std::set<PAIR_MARKER>                            m_Markers;
+    std::map<std::string, std::chrono::microseconds> m_BestTimes;   ///< by pass name
+
+    /**
+     * Keep the pad and hole markers, and delete them all.
+     */
+    void AddMarker( MARKER_PCB* aMarker )
+    {
+        const DRC_ITEM& item = aMarker->GetReporter();
+        const void*     a = item.GetMainItemWeakRef();
+        const void*     b = item.GetAuxiliaryItemWeakRef();
+
+        switch( item.GetErrorCode() )
+        {
+        case DRCE_PAD_NEAR_PAD1:
+        case DRCE_HOLE_NEAR_PAD:
+        case DRCE_DRILLED_HOLES_TOO_CLOSE:
+            m_Markers.insert( PAIR_MARKER( item.GetErrorCode(), std::min( a, b ),
+                                           std::max( a, b ) ) );
+            break;
+
+        default:
+            break;
+        }
+
+        delete aMarker;
+    }
+
+    /**
+     * Keep the best of the times of a pass.
+     */
+    void AddTime( const std::string& aPass, std::chrono::microseconds aDuration )
+    {
+        auto it = m_BestTimes.find( aPass );
+
+        if( it == m_BestTimes.end() )
+            m_BestTimes[aPass] = aDuration;
+        else
+            it->second = std::min( it->second, aDuration );
+    }
+};
+
+
+/**
+ * Run the DRC \a aRepeat times, and collect the pad and hole markers and the best time of
+ * the pad and hole passes.
+ */
+static PAD_SCAN_RESULT runSweepLine( BOARD& aBoard, long aRepeat )
+{
+    PAD_SCAN_RESULT result;
+
+    for( long i = 0; i < aRepeat; ++i )
+    {
+        DRC drc( &aBoard, EDA_UNITS_T::MILLIMETRES,
+                 [&]( MARKER_PCB* aMarker ) { result.AddMarker( aMarker ); } );
+
+        drc.RunTests();
+
+        for( const DRC_PASS_STATS& pass : drc.GetPassStats() )
+        {
+            if( pass.m_Name == "pad2pad" || pass.m_Name == "drilled_holes" )
+                result.AddTime( pass.m_Name, pass.m_Duration );
+        }
+    }
+
+    return result;
+}
+
+
+/**
+ * Run the reference full scans of the pads and holes \a aRepeat times, and collect their
+ * markers and best times.
+ */
+static PAD_SCAN_RESULT runFullScan( BOARD& aBoard, long aRepeat )
+{
+    PAD_SCAN_RESULT result;
+
+    for( long i = 0; i < aRepeat; ++i )
+    {
+        // Only the last run keeps its markers, they are the same for all of them
+        result.m_Markers.clear();
+
+        DRC drc( &aBoard, EDA_UNITS_T::MILLIMETRES,
+                 [&]( MARKER_PCB* aMarker ) { result.AddMarker( aMarker ); } );
+
+        std::chrono::microseconds duration;
+
+        {
+            SCOPED_TIMER<std::chrono::microseconds> timer( duration );
+            KI_TEST::DRC_REFERENCE_SCANS::TestPad2Pad( drc );
+        }
+
+        result.AddTime( "pad2pad", duration );
+
+        {
+            SCOPED_TIMER<std::chrono::microseconds> timer( duration );
+            KI_TEST::DRC_REFERENCE_SCANS::TestDrilledHoles( drc );
+        }
+
+        result.AddTime( "drilled_holes", duration );
+    }
+
+    return result;
+}
+
+
+int drc_pad_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program loads a PCB file and runs the DRC with the sweep line pad and "
+               "drilled hole tests, then the reference full scans.  It reports the time "
+               "taken by both, and fails if they do not find the same violations." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    long repeat = 5;
+    cl_parser.Found( "repeat", &repeat );
+    repeat = std::max( 1L, repeat );
+
+    std::unique_ptr<BOARD> board = KI_TEST::LoadBoardForTests( filename );
+
+    if( !board )
+        return DRC_PAD_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    std::cout << "Board: " << board->GetPadCount() << " pads, " << board->m_Track.GetCount()
+              << " tracks and vias" << std::endl;
+
+    const PAD_SCAN_RESULT sweep = runSweepLine( *board, repeat );
+    const PAD_SCAN_RESULT fullScan = runFullScan( *board, repeat );
+
+    for( const auto& pass : sweep.m_BestTimes )
+    {
+        auto fullScanTime = fullScan.m_BestTimes.find( pass.first );
+
+        std::cout << pass.first << ": sweep line " << pass.second.count() << "us";
+
+        if( fullScanTime != fullScan.m_BestTimes.end() )
+            std::cout << ", full scan " << fullScanTime->second.count() << "us";
+
+        std::cout << std::endl;
+    }
+
+    std::cout << "Violations: sweep line " << sweep.m_Markers.size() << ", full scan "
+              << fullScan.m_Markers.size() << std::endl;
+
+    if( sweep.m_Markers != fullScan.m_Markers )
+    {
+        std::cerr << "The pad and hole tests do not find the same violations" << std::endl;
+        return DRC_PAD_BENCHMARK_RET_CODES::MARKERS_DIFFER;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM drc_pad_benchmark_tool = {
+    "drc_pad_benchmark",
+    "Compare the time of the pad and drilled hole DRC tests with the reference full scans",
+    drc_pad_benchmark_main_func,
+};
@@ -0,0 +1,266 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "model_cache_benchmark.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+#include <wx/dir.h>
+#include <wx/filename.h>
+
+#include <3d-viewer/3d_cache/3d_mesh_cache.h>
+#include <plugins/3dapi/ifsg_api.h>
+
+#include <qa_utils/scoped_timer.h>
+
+
+using LOAD_DURATION = std::chrono::microseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "o",
+            "output",
+            _( "directory receiving the mesh cache files (default: a temporary directory)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "3D cache directory, holding .3dc files" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum MODEL_CACHE_BENCHMARK_RET_CODES
+{
+    NO_CACHE_FILES = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    WRITE_FAILED,
+};
+
+
+/// Plugin tag recorded in the mesh files, which this tool does not check
+static const std::string g_pluginInfo = "model_cache_benchmark";
+
+
+/**
+ * Load a model the way the 3D cache does from a .3dc file: read the scene graph and
+ * flatten it to render data.
+ *
+ * @return the render data, or NULL if the file cannot be read.
+ */
+static S3DMODEL* loadFromSceneCache( const wxString& aFileName )
+{
+    SGNODE* scene = S3D::ReadCache( aFileName.ToUTF8(), nullptr, nullptr );
+
+    if( !scene )
+        return nullptr;
+
+    S3DMODEL* model = S3D::GetModel( (SCENEGRAPH*) scene );
+    S3D::DestroyNode( scene );
+
+    return model;
+}
+
+
+static size_t vertexCount( const S3DMODEL& aModel )
+{
+    size_t count = 0;
+
+    for( unsigned int ii = 0; ii < aModel.m_MeshesSize; ii++ )
+        count += aModel.m_Meshes[ii].m_VertexSize;
+
+    return count;
+}
+
+
+int model_cache_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program loads all the models of a 3D cache directory from their .3dc "
+               "files, then from mesh cache files written for them, and compares the load "
+               "times.  Both passes read files the system has cached in memory, so only the "
+               "parsing costs are compared." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    wxArrayString sceneFiles;
+    wxDir::GetAllFiles( cl_parser.GetParam( 0 ), &sceneFiles, "*.3dc", wxDIR_FILES );
+    sceneFiles.Sort();
+
+    if( sceneFiles.empty() )
+    {
+        std::cerr << "No .3dc file in " << cl_parser.GetParam( 0 ) << std::endl;
+        return MODEL_CACHE_BENCHMARK_RET_CODES::NO_CACHE_FILES;
+    }
+
+    wxString outputDir;
+    bool     ownOutputDir = !cl_parser.Found( "output", &outputDir );
+
+    if( ownOutputDir )
+    {
+        outputDir = wxFileName::CreateTempFileName( "model_cache_benchmark" );
+        wxRemoveFile( outputDir );
+    }
+
+    if( !wxFileName::Mkdir( outputDir, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL ) )
+    {
+        std::cerr << "Cannot create " << outputDir << std::endl;
+        return MODEL_CACHE_BENCHMARK_RET_CODES::WRITE_FAILED;
+    }
+
+    std::vector<wxString> meshFiles;
+    size_t                meshCount = 0;
+    size_t                vertices = 0;
+    LOAD_DURATION         sceneTime{};
+
+    // First pass: the current load path, and the mesh files for the second pass (not timed)
+    for( const wxString& sceneFile : sceneFiles )
+    {
+        S3DMODEL* model = nullptr;
+
+        {
+            SCOPED_TIMER<LOAD_DURATION> timer( sceneTime );
+            model = loadFromSceneCache( sceneFile );
+        }
+
+        if( !model )
+        {
+            std::cerr << "Skipping unreadable " << sceneFile << std::endl;
+            continue;
+        }
+
+        wxFileName meshFile( sceneFile );
+        meshFile.SetPath( outputDir );
+        meshFile.SetExt( "3dm" );
+
+        if( !S3D_MESH_CACHE_FILE::Write( meshFile.GetFullPath(), *model, g_pluginInfo ) )
+        {
+            std::cerr << "Cannot write " << meshFile.GetFullPath() << std::endl;
+            S3D::Destroy3DModel( &model );
+            return MODEL_CACHE_BENCHMARK_RET_CODES::WRITE_FAILED;
+        }
+
+        meshFiles.push_back( meshFile.GetFullPath() );
+        meshCount += model->m_MeshesSize;
+        vertices += vertexCount( *model );
+
+        S3D::Destroy3DModel( &model );
+    }
+
+    // Second pass: map the mesh files
+    LOAD_DURATION meshTime{};
+    size_t        mapped = 0;
+    size_t        meshVertices = 0;
+
+    for( const wxString& meshFile : meshFiles )
+    {
+        std::unique_ptr<S3D_MESH_CACHE_FILE> file;
+        std::string                          pluginInfo;
+
+        {
+            SCOPED_TIMER<LOAD_DURATION> timer( meshTime );
+            file = S3D_MESH_CACHE_FILE::Read( meshFile, pluginInfo );
+        }
+
+        if( !file )
+        {
+            std::cerr << "Cannot read back " << meshFile << std::endl;
+            continue;
+        }
+
+        if( file->IsMapped() )
+            mapped++;
+
+        meshVertices += vertexCount( *file->GetModel() );
+    }
+
+    if( ownOutputDir )
+    {
+        for( const wxString& meshFile : meshFiles )
+            wxRemoveFile( meshFile );
+
+        wxRmdir( outputDir );
+    }
+
+    size_t models = std::max<size_t>( 1, meshFiles.size() );
+
+    std::cout << meshFiles.size() << " models, " << meshCount << " meshes, " << vertices
+              << " vertices" << std::endl;
+    std::cout << ".3dc files:  " << sceneTime.count() / 1000.0 << "ms ("
+              << sceneTime.count() / models << "us per model)" << std::endl;
+    std::cout << "mesh files:  " << meshTime.count() / 1000.0 << "ms ("
+              << meshTime.count() / models << "us per model, " << mapped << " mapped)"
+              << std::endl;
+    std::cout << "speedup:     x"
+              << (double) sceneTime.count() / std::max<long long>( 1, meshTime.count() )
+              << std::endl;
+
+    if( meshVertices != vertices )
+    {
+        std::cerr << "Vertex count mismatch: " << vertices << " in .3dc files, " << meshVertices
+                  << " in mesh files" << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM model_cache_benchmark_tool = {
+    "model_cache_benchmark",
+    "Compare the load times of 3D models from .3dc and mesh cache files",
+    model_cache_benchmark_main_func,
+};
@@ -47,9 +47,10 @@ using PARSE_DURATION = std::chrono::microseconds;
  * Parse a PCB or footprint file from the given input stream
  *
  * @param aStream the input stream to read from
+ * @param aParallel parse the board items on the thread pool
  * @return success, duration (in us)
  */
-bool parse( std::istream& aStream, bool aVerbose )
+bool parse( std::istream& aStream, bool aVerbose, bool aParallel )
 {
     // Take input from stdin
     STDISTREAM_LINE_READER reader;
@@ -58,6 +59,7 @@ bool parse( std::istream& aStream, bool aVerbose )
     PCB_PARSER parser;
 
     parser.SetLineReader( &reader );
+    parser.SetParallel( aParallel );
 
     BOARD_ITEM* board = nullptr;
 
@@ -87,6 +89,7 @@ static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
     { wxCMD_LINE_SWITCH, "h", "help", _( "displays help on the command line parameters" ).mb_str(),
             wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
     { wxCMD_LINE_SWITCH, "v", "verbose", _( "print parsing information" ).mb_str() },
+    { wxCMD_LINE_SWITCH, "p", "parallel", _( "parse board items in parallel" ).mb_str() },
     { wxCMD_LINE_PARAM, nullptr, nullptr, _( "input file" ).mb_str(), wxCMD_LINE_VAL_STRING,
             wxCMD_LINE_PARAM_OPTIONAL | wxCMD_LINE_PARAM_MULTIPLE },
     { wxCMD_LINE_NONE }
@@ -121,6 +124,7 @@ int pcb_parser_main_func( int argc, char** argv )
     }
 
     const bool verbose = cl_parser.Found( "verbose" );
+    const bool parallel = cl_parser.Found( "parallel" );
 
     bool ok = true;
 
@@ -132,7 +136,7 @@ int pcb_parser_main_func( int argc, char** argv )
         // program
         // while (__AFL_LOOP(2))
         {
-            ok = parse( std::cin, verbose );
+            ok = parse( std::cin, verbose, parallel );
         }
     }
     else
@@ -150,7 +154,7 @@ int pcb_parser_main_func( int argc, char** argv )
             std::ifstream fin;
             fin.open( filename );
 
-            ok = ok && parse( fin, verbose );
+            ok = ok && parse( fin, verbose, parallel );
         }
     }
 
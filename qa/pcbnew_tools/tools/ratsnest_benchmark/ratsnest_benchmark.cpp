@@ -0,0 +1,267 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "ratsnest_benchmark.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_netinfo.h>
+#include <connectivity/connectivity_data.h>
+#include <convert_to_biu.h>
+#include <ratsnest_data.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/scoped_timer.h>
+
+
+using RN_DURATION = std::chrono::microseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the time of each step" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "f",
+            "full-rebuild",
+            _( "triangulate the net from scratch at each step" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "net",
+            _( "name of the net (default GND)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "m",
+            "module",
+            _( "reference of the footprint to move (default: the one with most pads on the "
+               "net)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "steps",
+            _( "number of moves (default 100)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum RN_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    NET_NOT_FOUND,
+    MODULE_NOT_FOUND,
+};
+
+
+/**
+ * @return the number of pads of a footprint which belong to a net
+ */
+static int padsOnNet( MODULE* aModule, int aNetCode )
+{
+    int count = 0;
+
+    for( auto pad : aModule->Pads() )
+    {
+        if( pad->GetNetCode() == aNetCode )
+            count++;
+    }
+
+    return count;
+}
+
+
+int ratsnest_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program loads a PCB file, moves a footprint connected to a net in small "
+               "steps, as when it is dragged, and measures the time taken to update the "
+               "connectivity and the ratsnest after each step." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool        verbose = cl_parser.Found( "verbose" );
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    wxString netName = "GND";
+    cl_parser.Found( "net", &netName );
+
+    long steps = 100;
+    cl_parser.Found( "steps", &steps );
+
+    std::unique_ptr<BOARD> board = KI_TEST::LoadBoardForTests( filename );
+
+    if( !board )
+        return RN_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    NETINFO_ITEM* net = board->FindNet( netName );
+
+    if( !net )
+    {
+        std::cerr << "No net named " << netName << std::endl;
+        return RN_BENCHMARK_RET_CODES::NET_NOT_FOUND;
+    }
+
+    const int netCode = net->GetNet();
+    MODULE*   module = nullptr;
+    wxString  reference;
+
+    if( cl_parser.Found( "module", &reference ) )
+    {
+        module = board->FindModuleByReference( reference );
+    }
+    else
+    {
+        int mostPads = 0;
+
+        for( auto candidate : board->Modules() )
+        {
+            int count = padsOnNet( candidate, netCode );
+
+            if( count > mostPads )
+            {
+                mostPads = count;
+                module = candidate;
+            }
+        }
+    }
+
+    if( !module )
+    {
+        std::cerr << "No footprint to move" << std::endl;
+        return RN_BENCHMARK_RET_CODES::MODULE_NOT_FOUND;
+    }
+
+    auto    connectivity = board->GetConnectivity();
+    RN_NET* rnNet = connectivity->GetRatsnestForNet( netCode );
+
+    rnNet->SetIncremental( !cl_parser.Found( "full-rebuild" ) );
+
+    // The footprint goes around a circle, one step being about one grid step
+    const wxPoint  center = module->GetPosition();
+    const double   radius = Millimeter2iu( 2.0 );
+    std::vector<RN_DURATION> durations;
+
+    for( long i = 1; i <= steps; i++ )
+    {
+        double  angle = 2.0 * M_PI * i / std::max( 1L, steps );
+        wxPoint target = center + wxPoint( KiROUND( radius * ( std::cos( angle ) - 1.0 ) ),
+                                           KiROUND( radius * std::sin( angle ) ) );
+
+        module->Move( target - module->GetPosition() );
+
+        RN_DURATION duration{};
+        {
+            SCOPED_TIMER<RN_DURATION> timer( duration );
+            connectivity->Update( module );
+            connectivity->RecalculateRatsnest();
+        }
+
+        durations.push_back( duration );
+
+        if( verbose )
+            std::cerr << "Step " << i << ": " << duration.count() << "us" << std::endl;
+    }
+
+    double length = 0.0;
+
+    for( const CN_EDGE& edge : rnNet->GetUnconnected() )
+        length += ( edge.GetTargetPos() - edge.GetSourcePos() ).EuclideanNorm();
+
+    std::cout << "Net " << netName << ": " << rnNet->GetNodeCount() << " anchors, "
+              << rnNet->GetUnconnected().size() << " ratsnest lines ("
+              << length / IU_PER_MM << "mm)" << std::endl;
+    std::cout << "Moved " << module->GetReference() << " (" << padsOnNet( module, netCode )
+              << " pads on the net) in " << steps << " steps" << std::endl;
+
+    if( !durations.empty() )
+    {
+        std::sort( durations.begin(), durations.end() );
+
+        RN_DURATION total = std::accumulate( durations.begin(), durations.end(), RN_DURATION{} );
+
+        std::cout << "Update time: min " << durations.front().count() << "us, median "
+                  << durations[durations.size() / 2].count() << "us, mean "
+                  << total.count() / (long long) durations.size() << "us, max "
+                  << durations.back().count() << "us" << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM ratsnest_benchmark_tool = {
+    "ratsnest_benchmark",
+    "Measure the ratsnest update time while moving a footprint",
+    ratsnest_benchmark_main_func,
+};
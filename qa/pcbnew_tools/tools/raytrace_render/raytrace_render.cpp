@@ -0,0 +1,343 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "raytrace_render.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+#include <wx/filename.h>
+#include <wx/image.h>
+
+#include <class_board.h>
+#include <reporter.h>
+
+#include <3d_cache/3d_cache.h>
+#include <3d_canvas/cinfo3d_visu.h>
+#include <3d_rendering/3d_render_raytracing/c3d_render_raytracing.h>
+#include <3d_rendering/3d_render_raytracing/raypacket_simd.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/scoped_timer.h>
+
+
+using RENDER_DURATION = std::chrono::milliseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "s",
+            "size",
+            _( "size of the image in pixels, as WIDTHxHEIGHT (default 1600x1200)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "rotate",
+            _( "rotations of the camera around X,Y,Z in degrees, applied in this order "
+               "(default 0,0,0: top view)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "z",
+            "zoom",
+            _( "zoom factor of the camera (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_DOUBLE,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "m",
+            "no-models",
+            _( "render the bare board, without the 3D models of the footprints" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "f",
+            "fast",
+            _( "disable the post processing, anti-aliasing, reflections and refractions" )
+                    .mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "repeat",
+            _( "number of renders, to measure the trace time alone (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "i",
+            "simd",
+            _( "instruction set of the ray packet tests: none, sse or avx (default: the best "
+               "supported by the CPU)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "report the progress of the render" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input board file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "output image file, the type is given by the extension (png, jpg, ...)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum RAYTRACE_RENDER_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    SAVE_FAILED,
+};
+
+
+/**
+ * Set the display options as the 3D viewer defaults them.
+ */
+static void setViewerDefaults( CINFO3D_VISU& aSettings, bool aFast )
+{
+    aSettings.RenderEngineSet( RENDER_ENGINE_RAYTRACING );
+
+    aSettings.m_BgColorBot       = SFVEC3D( 0.4, 0.4, 0.5 );
+    aSettings.m_BgColorTop       = SFVEC3D( 0.8, 0.8, 0.9 );
+    aSettings.m_BoardBodyColor   = SFVEC3D( 51.0 / 255.0, 43.0 / 255.0, 22.0 / 255.0 );
+
+    aSettings.SetFlag( FL_USE_REALISTIC_MODE, true );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_SHADOWS, true );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_BACKFLOOR, true );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_PROCEDURAL_TEXTURES, true );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_REFRACTIONS, !aFast );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_REFLECTIONS, !aFast );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_POST_PROCESSING, !aFast );
+    aSettings.SetFlag( FL_RENDER_RAYTRACING_ANTI_ALIASING, !aFast );
+}
+
+
+int raytrace_render_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program renders a PCB file with the raytracer of the 3D viewer, without "
+               "OpenGL or display, and saves the image.  With --repeat, the render time is "
+               "measured once the board and its models are loaded." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const wxString boardFile = cl_parser.GetParam( 0 );
+    const wxString imageFile = cl_parser.GetParam( 1 );
+
+    wxSize   size( 1600, 1200 );
+    wxString sizeStr;
+
+    if( cl_parser.Found( "size", &sizeStr ) )
+    {
+        long width = 0, height = 0;
+
+        if( !sizeStr.BeforeFirst( 'x' ).ToLong( &width )
+                || !sizeStr.AfterFirst( 'x' ).ToLong( &height ) || width <= 0 || height <= 0 )
+        {
+            std::cerr << "Invalid image size " << sizeStr << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        size = wxSize( width, height );
+    }
+
+    double   rotation[3] = { 0.0, 0.0, 0.0 };
+    wxString rotateStr;
+
+    if( cl_parser.Found( "rotate", &rotateStr ) )
+    {
+        wxArrayString angles = wxSplit( rotateStr, ',' );
+
+        if( angles.size() != 3 || !angles[0].ToCDouble( &rotation[0] )
+                || !angles[1].ToCDouble( &rotation[1] ) || !angles[2].ToCDouble( &rotation[2] ) )
+        {
+            std::cerr << "Invalid rotation " << rotateStr << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+    }
+
+    double zoom = 1.0;
+    cl_parser.Found( "zoom", &zoom );
+
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+    repeat = std::max( 1L, repeat );
+
+    static const char* const simdNames[] = { "none", "sse", "avx" };
+    wxString                 simdStr;
+
+    if( cl_parser.Found( "simd", &simdStr ) )
+    {
+        const char* const* name = std::find( std::begin( simdNames ), std::end( simdNames ),
+                                             simdStr.Lower() );
+
+        if( name == std::end( simdNames ) )
+        {
+            std::cerr << "Invalid instruction set " << simdStr << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+
+        RAYPACKET_SetSimd( (RAYPACKET_SIMD) ( name - std::begin( simdNames ) ) );
+    }
+
+    REPORTER* reporter = cl_parser.Found( "verbose" ) ? &STDOUT_REPORTER::GetInstance() : nullptr;
+
+    std::unique_ptr<BOARD> board = KI_TEST::LoadBoardForTests( boardFile, false );
+
+    if( !board )
+        return RAYTRACE_RENDER_RET_CODES::LOAD_FAILED;
+
+    CINFO3D_VISU settings;
+    settings.SetBoard( board.get() );
+    setViewerDefaults( settings, cl_parser.Found( "fast" ) );
+
+    // Models are searched from the board directory, and in the paths of the environment
+    std::unique_ptr<S3D_CACHE> modelCache;
+
+    if( !cl_parser.Found( "no-models" ) )
+    {
+        wxFileName configDir;
+        configDir.AssignDir( GetKicadConfigPath() );
+        configDir.AppendDir( wxT( "3d" ) );
+
+        modelCache.reset( new S3D_CACHE );
+        modelCache->Set3DConfigDir( configDir.GetFullPath() );
+        modelCache->SetProjectDir( wxFileName( boardFile ).GetPath() );
+
+        settings.Set3DCacheManager( modelCache.get() );
+    }
+
+    // The board look-at position is set when the renderer loads the board, the rotations
+    // and the zoom are kept
+    CCAMERA& camera = settings.CameraGet();
+    camera.SetCurWindowSize( size );
+    camera.Reset();
+    camera.RotateX( glm::radians( (float) rotation[0] ) );
+    camera.RotateY( glm::radians( (float) rotation[1] ) );
+    camera.RotateZ( glm::radians( (float) rotation[2] ) );
+    camera.Zoom( (float) zoom );
+
+    C3D_RENDER_RAYTRACING renderer( settings );
+    wxImage               image;
+    wxImage               firstImage;
+    RENDER_DURATION       firstRender{};
+    RENDER_DURATION       best = RENDER_DURATION::max();
+    bool                  deterministic = true;
+
+    for( long i = 0; i < repeat; i++ )
+    {
+        RENDER_DURATION duration{};
+
+        {
+            SCOPED_TIMER<RENDER_DURATION> timer( duration );
+            renderer.RenderToImage( size, image, reporter );
+        }
+
+        if( i == 0 )
+        {
+            firstRender = duration;
+            firstImage = image.Copy();
+        }
+        else
+        {
+            best = std::min( best, duration );
+
+            if( memcmp( image.GetData(), firstImage.GetData(), size.x * size.y * 3 ) != 0 )
+                deterministic = false;
+        }
+    }
+
+    std::cout << "Rendered " << size.x << "x" << size.y << " in " << firstRender.count()
+              << "ms, with the load of the board and models (" << simdNames[RAYPACKET_GetSimd()]
+              << " packet tests)" << std::endl;
+
+    if( repeat > 1 )
+    {
+        std::cout << "Render alone: " << best.count() << "ms (best of " << repeat - 1 << "), "
+                  << ( deterministic ? "identical images" : "IMAGES DIFFER" ) << std::endl;
+    }
+
+    wxInitAllImageHandlers();
+
+    if( !image.SaveFile( imageFile ) )
+    {
+        std::cerr << "Cannot save " << imageFile << std::endl;
+        return RAYTRACE_RENDER_RET_CODES::SAVE_FAILED;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM raytrace_render_tool = {
+    "raytrace_render",
+    "Render a board with the raytracer of the 3D viewer to an image file",
+    raytrace_render_main_func,
+};
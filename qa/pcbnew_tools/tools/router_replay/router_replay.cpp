@@ -0,0 +1,358 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "router_replay.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+
+#include <class_board.h>
+
+#include <router/pns_kicad_iface.h>
+#include <router/pns_logger.h>
+#include <router/pns_router.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/scoped_timer.h>
+
+
+using REPLAY_DURATION = std::chrono::microseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "v",
+            "verbose",
+            _( "print the time of each event" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "m",
+            "mode",
+            _( "routing mode replacing the recorded one: shove, walkaround or mark" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of times the events are replayed (default 1)" ).mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_SWITCH,
+            "c",
+            "concurrent",
+            _( "run the alternative router searches concurrently" ).mb_str(),
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "board file, as it was when the events were recorded" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "routing event log" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum ROUTER_REPLAY_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    EVENTS_LOAD_FAILED,
+};
+
+
+static const char* const eventNames[] = { "start route", "start drag", "move", "fix", "stop" };
+
+static const char* const algoNames[PNS::PA_COUNT] = { "SHOVE", "WALKAROUND", "DRAGGER",
+                                                      "OPTIMIZER" };
+
+
+/**
+ * Finds the item of the world the recorded event was given, by its kind, net and layers
+ * at the event position.
+ * @return the item, or NULL if the event had no item or if it is not found.
+ */
+static PNS::ITEM* findEventItem( PNS::ROUTER& aRouter, const PNS::LOGGER::EVENT_ENTRY& aEvent )
+{
+    if( !aEvent.m_itemKind )
+        return nullptr;
+
+    PNS::ITEM_SET candidates = aRouter.QueryHoverItems( aEvent.m_p );
+
+    for( PNS::ITEM* item : candidates.Items() )
+    {
+        if( item->Kind() == aEvent.m_itemKind && item->Net() == aEvent.m_itemNet
+                && item->Layers().Start() == aEvent.m_itemLayerStart
+                && item->Layers().End() == aEvent.m_itemLayerEnd )
+        {
+            return item;
+        }
+    }
+
+    return nullptr;
+}
+
+
+/**
+ * Passes an event to the router, with the settings it was recorded with.
+ * @return false if the item of the event was not found.
+ */
+static bool replayEvent( PNS::ROUTER& aRouter, BOARD* aBoard,
+                         const PNS::LOGGER::EVENT_ENTRY& aEvent, OPT<PNS::PNS_MODE> aMode )
+{
+    PNS::ITEM* item = findEventItem( aRouter, aEvent );
+
+    if( aEvent.m_type == PNS::LOGGER::EVT_START_ROUTE
+            || aEvent.m_type == PNS::LOGGER::EVT_START_DRAG )
+    {
+        PNS::SIZES_SETTINGS sizes( aRouter.Sizes() );
+
+        // Done by the router tool before starting
+        sizes.Init( aBoard, item );
+        sizes.SetTrackWidth( aEvent.m_trackWidth );
+        sizes.SetViaDiameter( aEvent.m_viaDiameter );
+        sizes.SetViaDrill( aEvent.m_viaDrill );
+
+        aRouter.UpdateSizes( sizes );
+        aRouter.SetMode( (PNS::ROUTER_MODE) aEvent.m_routerMode );
+        aRouter.Settings().SetMode( aMode ? *aMode : (PNS::PNS_MODE) aEvent.m_routingMode );
+    }
+
+    switch( aEvent.m_type )
+    {
+    case PNS::LOGGER::EVT_START_ROUTE:
+        aRouter.StartRouting( aEvent.m_p, item, aEvent.m_param );
+        break;
+
+    case PNS::LOGGER::EVT_START_DRAG:
+        aRouter.StartDragging( aEvent.m_p, item, aEvent.m_param );
+        break;
+
+    case PNS::LOGGER::EVT_MOVE:
+        aRouter.Move( aEvent.m_p, item );
+        break;
+
+    case PNS::LOGGER::EVT_FIX:
+        aRouter.FixRoute( aEvent.m_p, item, aEvent.m_param != 0 );
+        break;
+
+    case PNS::LOGGER::EVT_STOP:
+        aRouter.StopRouting();
+        break;
+    }
+
+    return item || !aEvent.m_itemKind;
+}
+
+
+/**
+ * Prints the count and the latency percentiles of a set of durations, in milliseconds
+ */
+static void printLatencies( const std::string& aName, std::vector<REPLAY_DURATION> aTimes )
+{
+    if( aTimes.empty() )
+        return;
+
+    std::sort( aTimes.begin(), aTimes.end() );
+
+    auto percentile = [&]( double aPercent )
+    {
+        size_t rank = (size_t) std::ceil( aPercent / 100.0 * aTimes.size() );
+        return aTimes[std::max<size_t>( rank, 1 ) - 1].count() / 1000.0;
+    };
+
+    std::cout << std::left << std::setw( 14 ) << aName << std::right << std::fixed
+              << std::setprecision( 3 )
+              << std::setw( 8 ) << aTimes.size()
+              << std::setw( 10 ) << percentile( 50 )
+              << std::setw( 10 ) << percentile( 90 )
+              << std::setw( 10 ) << percentile( 99 )
+              << std::setw( 10 ) << aTimes.back().count() / 1000.0 << std::endl;
+}
+
+
+int router_replay_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program loads a PCB file and replays the interactive routing events "
+               "recorded by Pcbnew (see the RecordRouterEvents advanced option) through the "
+               "router, without display.  It reports the latency percentiles of each kind "
+               "of event and of the time spent in each router algorithm during an event." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const bool        verbose = cl_parser.Found( "verbose" );
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+    const std::string logname = cl_parser.GetParam( 1 ).ToStdString();
+
+    long repeat = 1;
+    cl_parser.Found( "repeat", &repeat );
+
+    OPT<PNS::PNS_MODE> mode;
+    wxString           modeName;
+
+    if( cl_parser.Found( "mode", &modeName ) )
+    {
+        if( modeName == "shove" )
+            mode = PNS::RM_Shove;
+        else if( modeName == "walkaround" )
+            mode = PNS::RM_Walkaround;
+        else if( modeName == "mark" )
+            mode = PNS::RM_MarkObstacles;
+        else
+        {
+            std::cerr << "Unknown routing mode " << modeName << std::endl;
+            return KI_TEST::RET_CODES::BAD_CMDLINE;
+        }
+    }
+
+    std::vector<PNS::LOGGER::EVENT_ENTRY> events;
+
+    if( !PNS::LOGGER::LoadEvents( logname, events ) )
+    {
+        std::cerr << "Cannot read the routing events of " << logname << std::endl;
+        return EVENTS_LOAD_FAILED;
+    }
+
+    std::unique_ptr<BOARD> board = KI_TEST::LoadBoardForTests( filename );
+
+    if( !board )
+        return LOAD_FAILED;
+
+    // Without a view nor a tool, the interface neither displays nor commits anything
+    PNS_KICAD_IFACE iface;
+    iface.SetBoard( board.get() );
+
+    PNS::ROUTER router;
+    router.SetInterface( &iface );
+    router.SetProfiling( true );
+    router.Settings().SetConcurrentSearch( cl_parser.Found( "concurrent" ) );
+
+    std::vector<REPLAY_DURATION> eventTimes[PNS::LOGGER::EVT_STOP + 1];
+    std::vector<REPLAY_DURATION> algoTimes[PNS::PA_COUNT];
+    int                          missingItems = 0;
+
+    for( long pass = 0; pass < repeat; ++pass )
+    {
+        // The world is rebuilt from the board, which the replay does not modify
+        router.SyncWorld();
+
+        for( size_t i = 0; i < events.size(); ++i )
+        {
+            const PNS::LOGGER::EVENT_ENTRY& evt = events[i];
+            REPLAY_DURATION                 duration;
+
+            router.ResetAlgoTimes();
+
+            {
+                SCOPED_TIMER<REPLAY_DURATION> timer( duration );
+
+                if( !replayEvent( router, board.get(), evt, mode ) && pass == 0 )
+                    missingItems++;
+            }
+
+            eventTimes[evt.m_type].push_back( duration );
+
+            for( int algo = 0; algo < PNS::PA_COUNT; ++algo )
+            {
+                int64_t time = router.AlgoTime( (PNS::PROFILED_ALGO) algo );
+
+                if( time > 0 )
+                    algoTimes[algo].push_back( REPLAY_DURATION( time ) );
+            }
+
+            if( verbose )
+            {
+                std::cout << i << " " << eventNames[evt.m_type] << " (" << evt.m_p.x << ", "
+                          << evt.m_p.y << "): " << duration.count() << " us" << std::endl;
+            }
+        }
+
+        router.StopRouting();
+    }
+
+    if( missingItems )
+    {
+        std::cerr << missingItems << " events refer to items which are not on the board: was "
+                  << "the board modified since the events were recorded?" << std::endl;
+    }
+
+    std::cout << std::left << std::setw( 14 ) << "latency (ms)" << std::right
+              << std::setw( 8 ) << "count" << std::setw( 10 ) << "p50" << std::setw( 10 )
+              << "p90" << std::setw( 10 ) << "p99" << std::setw( 10 ) << "max" << std::endl;
+
+    for( int type = 0; type <= PNS::LOGGER::EVT_STOP; ++type )
+        printLatencies( eventNames[type], eventTimes[type] );
+
+    for( int algo = 0; algo < PNS::PA_COUNT; ++algo )
+        printLatencies( algoNames[algo], algoTimes[algo] );
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM router_replay_tool = {
+    "router_replay",
+    "Replay recorded interactive routing events and measure the router latency",
+    router_replay_main_func,
+};
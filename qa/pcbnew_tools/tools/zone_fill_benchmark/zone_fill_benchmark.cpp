@@ -0,0 +1,265 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see CHANGELOG.TXT for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include "zone_fill_benchmark.h"
+
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common.h>
+
+#include <wx/cmdline.h>
+#include <wx/tokenzr.h>
+
+#include <class_board.h>
+#include <class_zone.h>
+#include <thread_pool.h>
+#include <zone_filler.h>
+
+#include <pcbnew_utils/board_file_utils.h>
+#include <qa_utils/scoped_timer.h>
+
+
+using FILL_DURATION = std::chrono::milliseconds;
+
+
+static const wxCmdLineEntryDesc g_cmdLineDesc[] = {
+    {
+            wxCMD_LINE_SWITCH,
+            "h",
+            "help",
+            _( "displays help on the command line parameters" ).mb_str(),
+            wxCMD_LINE_VAL_NONE,
+            wxCMD_LINE_OPTION_HELP,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "n",
+            "net",
+            _( "net of the zone to fill (default: the biggest copper zone)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "t",
+            "threads",
+            _( "comma separated list of thread counts (default 2,4,16)" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    {
+            wxCMD_LINE_OPTION,
+            "r",
+            "repeat",
+            _( "number of fills per measure, the fastest one is reported (default 3)" )
+                    .mb_str(),
+            wxCMD_LINE_VAL_NUMBER,
+    },
+    {
+            wxCMD_LINE_PARAM,
+            nullptr,
+            nullptr,
+            _( "input file" ).mb_str(),
+            wxCMD_LINE_VAL_STRING,
+    },
+    { wxCMD_LINE_NONE }
+};
+
+/**
+ * Tool-specific return codes
+ */
+enum FILL_BENCHMARK_RET_CODES
+{
+    LOAD_FAILED = KI_TEST::RET_CODES::TOOL_SPECIFIC,
+    ZONE_NOT_FOUND,
+};
+
+
+/**
+ * @return the area of a set of polygons with holes
+ */
+static double polySetArea( const SHAPE_POLY_SET& aPolys )
+{
+    double area = 0.0;
+
+    for( int ii = 0; ii < aPolys.OutlineCount(); ii++ )
+    {
+        area += std::abs( aPolys.COutline( ii ).Area() );
+
+        for( int jj = 0; jj < aPolys.HoleCount( ii ); jj++ )
+            area -= std::abs( aPolys.CHole( ii, jj ).Area() );
+    }
+
+    return area;
+}
+
+
+/**
+ * Fill \a aZone \a aRepeat times and return the fastest fill.
+ */
+static FILL_DURATION timeFill( BOARD* aBoard, ZONE_CONTAINER* aZone, THREAD_POOL& aPool,
+                               bool aTiled, long aRepeat )
+{
+    FILL_DURATION best = FILL_DURATION::max();
+
+    for( long i = 0; i < aRepeat; i++ )
+    {
+        // Defeat the fill cache: the zone did not change since the previous fill
+        aZone->SetFillInputsHash( MD5_HASH() );
+
+        ZONE_FILLER filler( aBoard );
+        filler.SetThreadPool( aPool );
+        filler.SetTiledFill( aTiled );
+
+        FILL_DURATION duration{};
+        {
+            SCOPED_TIMER<FILL_DURATION> timer( duration );
+            filler.Fill( { aZone } );
+        }
+
+        best = std::min( best, duration );
+    }
+
+    return best;
+}
+
+
+int zone_fill_benchmark_main_func( int argc, char** argv )
+{
+    wxMessageOutput::Set( new wxMessageOutputStderr );
+    wxCmdLineParser cl_parser( argc, argv );
+    cl_parser.SetDesc( g_cmdLineDesc );
+    cl_parser.AddUsageText(
+            _( "This program loads a PCB file and fills one of its zones in one piece and "
+               "in tiles, with pools of several sizes, to show how the fill time scales with "
+               "the number of threads." ) );
+
+    int cmd_parsed_ok = cl_parser.Parse();
+    if( cmd_parsed_ok != 0 )
+    {
+        // Help and invalid input both stop here
+        return ( cmd_parsed_ok == -1 ) ? KI_TEST::RET_CODES::OK : KI_TEST::RET_CODES::BAD_CMDLINE;
+    }
+
+    const std::string filename = cl_parser.GetParam( 0 ).ToStdString();
+
+    wxString threadList = "2,4,16";
+    cl_parser.Found( "threads", &threadList );
+
+    std::vector<long> threadCounts;
+
+    for( const wxString& token : wxSplit( threadList, ',' ) )
+    {
+        long count = 0;
+
+        if( token.ToLong( &count ) && count > 0 )
+            threadCounts.push_back( count );
+    }
+
+    long repeat = 3;
+    cl_parser.Found( "repeat", &repeat );
+    repeat = std::max( 1L, repeat );
+
+    std::unique_ptr<BOARD> board = KI_TEST::LoadBoardForTests( filename );
+
+    if( !board )
+        return FILL_BENCHMARK_RET_CODES::LOAD_FAILED;
+
+    wxString        netName;
+    bool            byNet = cl_parser.Found( "net", &netName );
+    ZONE_CONTAINER* zone = nullptr;
+    double          biggest = 0.0;
+
+    for( int ii = 0; ii < board->GetAreaCount(); ii++ )
+    {
+        ZONE_CONTAINER* candidate = board->GetArea( ii );
+
+        if( candidate->GetIsKeepout() || !candidate->IsOnCopperLayer() )
+            continue;
+
+        if( byNet && candidate->GetNetname() != netName )
+            continue;
+
+        double area = polySetArea( *candidate->Outline() );
+
+        if( area > biggest )
+        {
+            biggest = area;
+            zone = candidate;
+        }
+    }
+
+    if( !zone )
+    {
+        std::cerr << "No copper zone to fill" << std::endl;
+        return FILL_BENCHMARK_RET_CODES::ZONE_NOT_FOUND;
+    }
+
+    std::cout << "Zone " << zone->GetNetname() << " on " << zone->GetLayerName() << ", "
+              << zone->GetNumCorners() << " corners" << std::endl;
+
+    FILL_DURATION reference{};
+    double        referenceArea = 0.0;
+    size_t        referenceThreads = 0;
+
+    for( long threads : threadCounts )
+    {
+        // The calling thread works too: a pool has at least one worker, so at least two threads
+        THREAD_POOL pool( std::max( 1L, threads - 1 ) );
+
+        FILL_DURATION single = timeFill( board.get(), zone, pool, false, repeat );
+        double        singleArea = polySetArea( zone->GetFilledPolysList() );
+
+        FILL_DURATION tiled = timeFill( board.get(), zone, pool, true, repeat );
+        double        tiledArea = polySetArea( zone->GetFilledPolysList() );
+
+        if( reference == FILL_DURATION{} )
+        {
+            reference = single;
+            referenceArea = singleArea;
+            referenceThreads = pool.GetSlotCount();
+        }
+
+        std::cout << pool.GetSlotCount() << " threads: one piece " << single.count() << "ms, tiled "
+                  << tiled.count() << "ms (x"
+                  << (double) reference.count() / std::max<long long>( 1, tiled.count() )
+                  << " from one piece on " << referenceThreads << " threads), "
+                  << "area difference "
+                  << ( tiledArea - referenceArea ) / std::max( 1.0, referenceArea ) * 100.0
+                  << "%" << std::endl;
+    }
+
+    return KI_TEST::RET_CODES::OK;
+}
+
+
+/*
+ * Define the tool interface
+ */
+KI_TEST::UTILITY_PROGRAM zone_fill_benchmark_tool = {
+    "zone_fill_benchmark",
+    "Measure how the fill time of a big zone scales with the number of threads",
+    zone_fill_benchmark_main_func,
+};
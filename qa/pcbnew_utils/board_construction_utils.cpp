@@ -25,6 +25,8 @@
 
 #include <class_edge_mod.h>
 #include <class_module.h>
+#include <class_pad.h>
+#include <convert_to_biu.h>
 #include <drc.h>
 
 #include <geometry/seg.h>
@@ -109,4 +111,25 @@ void DrawRect( MODULE& aMod, const VECTOR2I& aPos, const VECTOR2I& aSize, int aR
     }
 }
 
+
+D_PAD* AddRoundPad( MODULE& aMod, const VECTOR2I& aPos, LSET aLayers, bool aDrilled )
+{
+    D_PAD* pad = new D_PAD( &aMod );
+
+    pad->SetName( wxString::Format( "%d", (int) aMod.Pads().GetCount() + 1 ) );
+    pad->SetShape( PAD_SHAPE_CIRCLE );
+    pad->SetSize( wxSize( Millimeter2iu( 1 ), Millimeter2iu( 1 ) ) );
+    pad->SetAttribute( aDrilled ? PAD_ATTRIB_STANDARD : PAD_ATTRIB_SMD );
+    pad->SetLayerSet( aLayers );
+
+    if( aDrilled )
+        pad->SetDrillSize( wxSize( Millimeter2iu( 0.5 ), Millimeter2iu( 0.5 ) ) );
+
+    pad->SetPosition( (wxPoint) aPos );
+    pad->SetPos0( (wxPoint) aPos );
+    aMod.Add( pad );
+
+    return pad;
+}
+
 } // namespace KI_TEST
@@ -98,4 +98,32 @@ std::unique_ptr<BOARD> ReadBoardFromFileOrStream(
     return ReadItemFromStream<BOARD>( *in_stream );
 }
 
+
+std::unique_ptr<BOARD> LoadBoardForTests( const std::string& aFilename, bool aBuildConnectivity )
+{
+    std::unique_ptr<BOARD> board;
+
+    try
+    {
+        PCB_IO io;
+        board.reset( io.Load( aFilename, nullptr ) );
+    }
+    catch( const IO_ERROR& ioe )
+    {
+        std::cerr << ioe.What() << std::endl;
+    }
+
+    if( !board )
+        return board;
+
+    // Done by the editor frame after loading, not by the plugin
+    board->BuildListOfNets();
+    board->SynchronizeNetsAndNetClasses();
+
+    if( aBuildConnectivity )
+        board->BuildConnectivity();
+
+    return board;
+}
+
 } // namespace KI_TEST
\ No newline at end of file
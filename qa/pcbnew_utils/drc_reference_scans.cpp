@@ -0,0 +1,132 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+#include <pcbnew_utils/drc_reference_scans.h>
+
+#include <class_board.h>
+#include <class_module.h>
+#include <class_pad.h>
+#include <class_track.h>
+#include <drc.h>
+#include <trigo.h>
+
+
+namespace KI_TEST
+{
+
+void DRC_REFERENCE_SCANS::TestPad2Pad( DRC& aDrc )
+{
+    std::vector<D_PAD*> sortedPads;
+
+    aDrc.m_pcb->GetSortedPadListByXthenYCoord( sortedPads );
+
+    if( sortedPads.size() == 0 )
+        return;
+
+    // find the max size of the pads (used to stop the test)
+    int max_size = 0;
+
+    for( D_PAD* pad : sortedPads )
+    {
+        // GetBoundingRadius() is the radius of the minimum sized circle fully containing the pad
+        max_size = std::max( max_size, pad->GetBoundingRadius() );
+    }
+
+    // Upper limit of pad list (limit not included)
+    D_PAD** listEnd = &sortedPads[0] + sortedPads.size();
+
+    // Test the pads
+    for( unsigned i = 0; i < sortedPads.size(); ++i )
+    {
+        D_PAD* pad = sortedPads[i];
+
+        int    x_limit = max_size + pad->GetClearance() +
+                         pad->GetBoundingRadius() + pad->GetPosition().x;
+
+        if( !aDrc.doPadToPadsDrc( pad, &sortedPads[i], listEnd, x_limit ) )
+        {
+            wxASSERT( aDrc.m_currentMarker );
+            aDrc.addMarkerToPcb( aDrc.m_currentMarker );
+            aDrc.m_currentMarker = nullptr;
+        }
+    }
+}
+
+
+void DRC_REFERENCE_SCANS::TestDrilledHoles( DRC& aDrc )
+{
+    BOARD* board = aDrc.m_pcb;
+    int    holeToHoleMin = board->GetDesignSettings().m_HoleToHoleMin;
+
+    if( holeToHoleMin == 0 )    // No min setting turns testing off.
+        return;
+
+    struct DRILLED_HOLE
+    {
+        wxPoint     m_location;
+        int         m_drillRadius;
+        BOARD_ITEM* m_owner;
+    };
+
+    std::vector<DRILLED_HOLE> holes;
+
+    for( D_PAD* pad : board->GetPads() )
+    {
+        if( pad->GetDrillSize().x && pad->GetDrillShape() == PAD_DRILL_SHAPE_CIRCLE )
+            holes.push_back( { pad->GetPosition(), pad->GetDrillSize().x / 2, pad } );
+    }
+
+    for( TRACK* track : board->Tracks() )
+    {
+        VIA* via = dynamic_cast<VIA*>( track );
+
+        if( via && via->GetViaType() == VIA_THROUGH )
+            holes.push_back( { via->GetPosition(), via->GetDrillValue() / 2, via } );
+    }
+
+    for( size_t ii = 0; ii < holes.size(); ++ii )
+    {
+        const DRILLED_HOLE& refHole = holes[ ii ];
+
+        for( size_t jj = ii + 1; jj < holes.size(); ++jj )
+        {
+            const DRILLED_HOLE& checkHole = holes[ jj ];
+
+            // Holes with identical locations are allowable
+            if( checkHole.m_location == refHole.m_location )
+                continue;
+
+            if( KiROUND( GetLineLength( checkHole.m_location, refHole.m_location ) )
+                    <  checkHole.m_drillRadius + refHole.m_drillRadius + holeToHoleMin )
+            {
+                aDrc.addMarkerToPcb( new MARKER_PCB( aDrc.userUnits(),
+                                                     DRCE_DRILLED_HOLES_TOO_CLOSE,
+                                                     refHole.m_location,
+                                                     refHole.m_owner, refHole.m_location,
+                                                     checkHole.m_owner, checkHole.m_location ) );
+            }
+        }
+    }
+}
+
+} // namespace KI_TEST
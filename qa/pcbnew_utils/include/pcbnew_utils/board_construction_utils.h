@@ -34,6 +34,7 @@
 #include <layers_id_colors_and_visibility.h>
 #include <math/vector2d.h>
 
+class D_PAD;
 class MODULE;
 class SEG;
 
@@ -84,6 +85,16 @@ void DrawArc( MODULE& aMod, const VECTOR2I& aCentre, const VECTOR2I& aStart, dou
 void DrawRect( MODULE& aMod, const VECTOR2I& aPos, const VECTOR2I& aSize, int aRadius, int aWidth,
         PCB_LAYER_ID aLayer );
 
+/**
+ * Add a 1 mm round pad to a module, named after the number of pads already there
+ * @param aMod     The module to add the pad to
+ * @param aPos     The pad position
+ * @param aLayers  The pad layers
+ * @param aDrilled Give the pad a 0.5 mm plated hole (else it is a SMD pad)
+ * @return         The new pad, owned by the module
+ */
+D_PAD* AddRoundPad( MODULE& aMod, const VECTOR2I& aPos, LSET aLayers, bool aDrilled );
+
 } // namespace KI_TEST
 
 #endif // QA_PCBNEW_BOARD_CONSTRUCTION_UTILS__H
\ No newline at end of file
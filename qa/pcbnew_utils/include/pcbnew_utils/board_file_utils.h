@@ -95,6 +95,20 @@ template <typename ITEM> std::unique_ptr<ITEM> ReadItemFromStream( std::istream&
 std::unique_ptr<BOARD> ReadBoardFromFileOrStream(
         const std::string& aFilename, std::istream& aFallback = std::cin );
 
+/**
+ * Load a board file with #PCB_IO and prepare it as the editor frame does after loading:
+ * build the list of nets, synchronise the nets and net classes and, optionally, build
+ * the connectivity.
+ *
+ * Load errors are printed to std::cerr.
+ *
+ * @param aFilename the board file to read
+ * @param aBuildConnectivity build the connectivity data of the board
+ * @return the board, or nullptr if it cannot be read
+ */
+std::unique_ptr<BOARD> LoadBoardForTests( const std::string& aFilename,
+                                          bool aBuildConnectivity = true );
+
 } // namespace KI_TEST
 
 #endif // QA_PCBNEW_UTILS_BOARD_FILE_UTILS__H
\ No newline at end of file
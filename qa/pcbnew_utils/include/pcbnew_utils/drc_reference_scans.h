@@ -0,0 +1,60 @@
+/*
+ * This program source code file is part of KiCad, a free EDA CAD application.
+ *
+ * Copyright (C) 2019 KiCad Developers, see AUTHORS.txt for contributors.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, you may find one here:
+ * http://www.gnu.org/licenses/old-licenses/gpl-2.0.html
+ * or you may search the http://www.gnu.org website for the version 2 license,
+ * or you may write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA
+ */
+
+/**
+ * @file drc_reference_scans.h
+ * The pad to pad and drilled hole DRC tests as they were before the sweep line, as the
+ * reference of the regression tests and benchmarks of the faster tests
+ */
+
+#ifndef QA_PCBNEW_DRC_REFERENCE_SCANS__H
+#define QA_PCBNEW_DRC_REFERENCE_SCANS__H
+
+class DRC;
+
+
+namespace KI_TEST
+{
+
+/**
+ * The reference scans use the single pad tests of the DRC, and send their markers to the
+ * marker handler of the DRC, as the DRC passes do.
+ */
+class DRC_REFERENCE_SCANS
+{
+public:
+    /**
+     * Test every pad against the next ones of the list sorted by X, up to an X limit found
+     * from the biggest pad.
+     */
+    static void TestPad2Pad( DRC& aDrc );
+
+    /**
+     * Test every drilled hole against every later one.
+     */
+    static void TestDrilledHoles( DRC& aDrc );
+};
+
+} // namespace KI_TEST
+
+#endif // QA_PCBNEW_DRC_REFERENCE_SCANS__H